@@ -20,6 +20,7 @@ struct VSInput
   float2 instScale  : INST_SCALE; // 子弹宽高 (scaleX, scaleY)
   float instRot     : INST_ROT;   // 子弹旋转弧度
   float4 instColor  : INST_COLOR; // 子弹颜色 (r, g, b, a)
+  float4 instUV     : INST_UV;    // 贴图区域 (u0, v0, u1, v1)
 };
 
 // 顶点着色器传给像素着色器的数据结构
@@ -56,8 +57,8 @@ PSInput VSMain(VSInput input)
   float4 finalPos = float4(pos, 0.0f, 1.0f);
   output.position = mul(finalPos, projection);
   
-  // 直接传递纹理坐标和实例颜色
-  output.texCoord = input.texCoord;
+  // 把单位正方形的纹理坐标映射到图集中的区域, 直接传递实例颜色
+  output.texCoord = lerp(input.instUV.xy, input.instUV.zw, input.texCoord);
   output.color = input.instColor;
   
   return output;
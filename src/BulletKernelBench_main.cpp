@@ -0,0 +1,125 @@
+#include "Core/Simd.hpp"
+#include "Game/Bullet.hpp"
+#include "Game/BulletKernel.hpp"
+#include "Game/BulletPattern.hpp"
+#include "Game/BulletSoA.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <vector>
+
+// 子弹积分内核的开销: SoA 存储 + SIMD 内核 (integrateBullets)
+// 与原来的 AoS 逐颗更新 (Bullet::updatePosition + swap-and-pop) 对比
+// 分别在 1 万, 10 万, 100 万颗子弹下测量; SIMD 指令集在编译期由 TOUHOU_SIMD 选择, 各配置分别构建运行
+// 子弹绕圈运动, 存活区域取得足够大, 计时只包含积分与出界检测, 两种存储的子弹个数与顺序始终相同, 最后比较两者的坐标
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t Counts[] = { 10'000, 100'000, 1'000'000 };
+constexpr std::size_t StepsPerCase = 10'000'000; // 每种规模的总积分次数 (子弹数 x 轮数), 规模越小轮数越多
+
+constexpr Game::BulletBounds Bounds{ -1.0e6f, 1.0e6f, -1.0e6f, 1.0e6f };
+
+double elapsedNanos(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// 固定种子生成的子弹: 位置在画面内, 半径约 20 ~ 100 像素的圆周运动, 部分带切向加速度
+std::vector<Game::Bullet> makeBullets(std::size_t count)
+{
+  std::vector<Game::Bullet> bullets(count);
+  Game::PatternRng rng;
+  for (Game::Bullet& b : bullets) {
+    b.x = rng.nextFloat() * 1280.0f;
+    b.y = rng.nextFloat() * 960.0f;
+    b.angle = rng.nextFloat() * 6.2831853f;
+    b.angVel = 0.02f + rng.nextFloat() * 0.03f;
+    b.speed = 1.0f + rng.nextFloat() * 2.0f;
+    b.tanAccel = rng.nextU32() % 4 == 0 ? 1.0e-5f : 0.0f;
+    b.type = static_cast<std::uint16_t>(rng.nextU32() % 16);
+  }
+  return bullets;
+}
+
+// 对照: 原来 BulletManager::update 的 AoS 循环, 出界时用末尾的子弹填补空位
+std::size_t updateAoS(std::vector<Game::Bullet>& bullets, std::size_t activeCount, Game::BulletBounds const& bounds)
+{
+  for (std::size_t i = 0; i < activeCount;) {
+    Game::Bullet& b = bullets[i];
+    b.updatePosition();
+    if (b.x < bounds.left || b.x > bounds.right || b.y < bounds.top || b.y > bounds.bottom) {
+      bullets[i] = bullets[--activeCount];
+    } else {
+      ++i;
+    }
+  }
+  return activeCount;
+}
+
+void benchmark(std::size_t count)
+{
+  std::size_t const rounds = std::max<std::size_t>(StepsPerCase / count, 1);
+  std::vector<Game::Bullet> aos = makeBullets(count);
+
+  Game::BulletSoA soa;
+  soa.resize(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    soa.store(i, aos[i]);
+  }
+  std::vector<std::uint32_t> killList(count);
+
+  std::size_t aosCount = count;
+  auto const aosStart = Clock::now();
+  for (std::size_t r = 0; r < rounds; ++r) {
+    aosCount = updateAoS(aos, aosCount, Bounds);
+  }
+  double const aosNanos = elapsedNanos(aosStart);
+
+  std::size_t killed = 0;
+  auto const soaStart = Clock::now();
+  for (std::size_t r = 0; r < rounds; ++r) {
+    killed += Game::integrateBullets(soa, 0, count, Bounds, killList.data());
+  }
+  double const soaNanos = elapsedNanos(soaStart);
+
+  // 浮点模式下两者逐位相同; 定点模式下 SoA 以整数运算积分, 只在舍入误差范围内一致
+  double maxError = 0.0;
+  for (std::size_t i = 0; i < std::min(aosCount, count); ++i) {
+    Game::Bullet const b = soa.load(i);
+    maxError = std::max<double>(maxError, std::fabs(b.x - aos[i].x));
+    maxError = std::max<double>(maxError, std::fabs(b.y - aos[i].y));
+  }
+
+  double const steps = static_cast<double>(rounds) * static_cast<double>(count);
+  std::cout << std::format("{:>9} bullets x {:>4} rounds  AoS {:>7.3f} ns  SoA {:>7.3f} ns  speedup {:>5.2f}x  "
+                           "max |dpos| {:.3e}{}\n",
+                           count,
+                           rounds,
+                           aosNanos / steps,
+                           soaNanos / steps,
+                           aosNanos / soaNanos,
+                           maxError,
+                           aosCount == count && killed == 0 ? "" : "  (bullets left the bounds)");
+}
+} // namespace
+
+int main()
+{
+#if defined(TOUHOU_FIXED_POINT)
+  char const* const mode = "fixed point";
+#else
+  char const* const mode = "float";
+#endif
+  std::cout << std::format("bullet integrate, ns per bullet per frame: SIMD = {}, {}\n", Core::Simd::IsaName, mode);
+  for (std::size_t const count : Counts) {
+    benchmark(count);
+  }
+  return 0;
+}
@@ -0,0 +1,147 @@
+#include "Game/BulletTypeTable.hpp"
+
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 子弹类型表编译器: 把文本格式的类型表 (assets/data/bullet_types.txt) 编译为引擎加载的二进制文件
+// 用法: BulletTableCompiler <input.txt> <output.bin>
+//
+// 文本格式 (以 # 开头的行与空行被忽略):
+//   types <typeCount>
+//   colors <colorCount>
+//   <type> <color> <u0> <v0> <u1> <v1> <width> <height> <hitRadius> <grazeRadius> <alpha|additive>
+// type / color 可以写 * 表示全部; 后面的行覆盖前面的行, 未指定的组合使用默认样式
+
+namespace {
+struct ParseError : std::runtime_error
+{
+  ParseError(std::size_t line, std::string const& message)
+    : std::runtime_error(std::format("line {}: {}", line, message))
+  {
+  }
+};
+
+// 解析 * (返回空) 或不超过 limit 的下标
+std::optional<std::uint16_t> parseIndex(std::string const& token, std::uint16_t limit, std::size_t line)
+{
+  if (token == "*") {
+    return std::nullopt;
+  }
+  std::size_t consumed = 0;
+  unsigned long value = 0;
+  try {
+    value = std::stoul(token, &consumed);
+  } catch (std::exception const&) {
+    consumed = 0;
+  }
+  if (consumed != token.size() || value >= limit) {
+    throw ParseError(line, std::format("index '{}' is not '*' or a number below {}", token, limit));
+  }
+  return static_cast<std::uint16_t>(value);
+}
+
+Game::BulletTypeTable compile(std::istream& input)
+{
+  std::uint16_t typeCount = 0;
+  std::uint16_t colorCount = 0;
+  std::vector<Game::BulletStyle> styles;
+
+  std::string text;
+  for (std::size_t line = 1; std::getline(input, text); ++line) {
+    std::istringstream tokens(text.substr(0, text.find('#')));
+    std::string head;
+    if (!(tokens >> head)) {
+      continue;
+    }
+
+    if (head == "types" || head == "colors") {
+      unsigned long count = 0;
+      if (!(tokens >> count) || count == 0 || count > 0xFFFF) {
+        throw ParseError(line, "expected a count between 1 and 65535");
+      }
+      if (!styles.empty()) {
+        throw ParseError(line, "'types' and 'colors' must come before all styles");
+      }
+      (head == "types" ? typeCount : colorCount) = static_cast<std::uint16_t>(count);
+      continue;
+    }
+
+    if (typeCount == 0 || colorCount == 0) {
+      throw ParseError(line, "'types' and 'colors' must be declared first");
+    }
+    if (styles.empty()) {
+      styles.resize(static_cast<std::size_t>(typeCount) * colorCount);
+    }
+
+    std::string colorToken;
+    std::string blendToken;
+    Game::BulletStyle style;
+    if (!(tokens >> colorToken >> style.u0 >> style.v0 >> style.u1 >> style.v1 >> style.width >> style.height >>
+          style.hitRadius >> style.grazeRadius >> blendToken)) {
+      throw ParseError(line, "expected: type color u0 v0 u1 v1 width height hitRadius grazeRadius blend");
+    }
+    if (blendToken == "alpha") {
+      style.blend = Game::BulletBlend::Alpha;
+    } else if (blendToken == "additive") {
+      style.blend = Game::BulletBlend::Additive;
+    } else {
+      throw ParseError(line, "blend must be 'alpha' or 'additive', got '" + blendToken + "'");
+    }
+    if (style.hitRadius < 0.0f || style.grazeRadius < 0.0f) {
+      throw ParseError(line, "radii must not be negative");
+    }
+
+    std::optional<std::uint16_t> const type = parseIndex(head, typeCount, line);
+    std::optional<std::uint16_t> const color = parseIndex(colorToken, colorCount, line);
+    for (std::uint16_t t = type.value_or(0); t < (type ? *type + 1 : typeCount); ++t) {
+      for (std::uint16_t c = color.value_or(0); c < (color ? *color + 1 : colorCount); ++c) {
+        styles[static_cast<std::size_t>(t) * colorCount + c] = style;
+      }
+    }
+  }
+
+  if (typeCount == 0 || colorCount == 0) {
+    throw std::runtime_error("missing 'types' or 'colors' declaration");
+  }
+  if (styles.empty()) {
+    styles.resize(static_cast<std::size_t>(typeCount) * colorCount);
+  }
+
+  Game::BulletTypeTable table;
+  table.build(typeCount, colorCount, std::move(styles));
+  return table;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  if (argc != 3) {
+    std::cerr << "Usage: BulletTableCompiler <input.txt> <output.bin>\n";
+    return 1;
+  }
+
+  try {
+    std::ifstream input(argv[1]);
+    if (!input) {
+      throw std::runtime_error(std::string("cannot open ") + argv[1]);
+    }
+    Game::BulletTypeTable const table = compile(input);
+    table.saveToFile(argv[2]);
+    std::cout << std::format("{} -> {}: {} types x {} colors\n",
+                             argv[1],
+                             argv[2],
+                             table.getTypeCount(),
+                             table.getColorCount());
+  } catch (std::exception const& e) {
+    std::cerr << std::format("{}: {}\n", argv[1], e.what());
+    return 1;
+  }
+  return 0;
+}
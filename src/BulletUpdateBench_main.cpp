@@ -0,0 +1,113 @@
+#include "Core/JobSystem.hpp"
+#include "Core/Simd.hpp"
+#include "Game/BulletManager.hpp"
+#include "Game/BulletPattern.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// BulletManager::update 的吞吐量 (每毫秒更新的子弹数) 随工作线程数的变化
+// 0 表示不设置线程池 (单线程更新), 之后按 1, 2, 4, ... 直到最大工作线程数; 每种配置都检查状态哈希与单线程一致
+// 子弹在画面中央区域绕圈运动, 不会出界, 各轮的子弹数保持不变
+// 参数: [最大工作线程数], 默认为 CPU 核数 - 1 (单核时为 3, 只用于观察调度开销)
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr float ScreenWidth = 1280.0f;
+constexpr float ScreenHeight = 960.0f;
+constexpr std::size_t Counts[] = { 100'000, 1'000'000 };
+constexpr std::size_t StepsPerCase = 20'000'000; // 每种配置的总积分次数 (子弹数 x 帧数)
+
+// 圆周半径不超过 3 / 0.02 = 150 像素, 圆心距画面边缘至少 200 像素, 加上回收边距后不会出界
+void fillBullets(Game::BulletManager& bullets, std::size_t count)
+{
+  bullets.clearBullets();
+  Game::PatternRng rng;
+  for (std::size_t i = 0; i < count; ++i) {
+    float const x = 200.0f + rng.nextFloat() * (ScreenWidth - 400.0f);
+    float const y = 200.0f + rng.nextFloat() * (ScreenHeight - 400.0f);
+    float const angle = rng.nextFloat() * 6.2831853f;
+    float const angVel = 0.02f + rng.nextFloat() * 0.03f;
+    float const speed = 1.0f + rng.nextFloat() * 2.0f;
+    bullets.spawnBulletA(x, y, angle, angVel, 0.0f, speed, 0.0f, 0, 0);
+  }
+}
+
+struct Result
+{
+  double bulletsPerMs;
+  std::uint64_t hash;
+};
+
+Result measure(Game::BulletManager& bullets, std::size_t count)
+{
+  fillBullets(bullets, count);
+  std::size_t const frames = std::max<std::size_t>(StepsPerCase / count, 1);
+  bullets.update(ScreenWidth, ScreenHeight); // 预热, 同时让工作线程从休眠中醒来
+
+  auto const start = Clock::now();
+  for (std::size_t f = 0; f < frames; ++f) {
+    bullets.update(ScreenWidth, ScreenHeight);
+  }
+  double const ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  return { static_cast<double>(frames) * static_cast<double>(count) / ms, bullets.computeStateHash() };
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  unsigned const hardwareThreads = std::thread::hardware_concurrency();
+  std::size_t maxWorkers = hardwareThreads > 1 ? hardwareThreads - 1 : 3;
+  if (argc > 1) {
+    maxWorkers = std::stoul(argv[1]);
+  }
+
+  std::vector<std::size_t> workerCounts{ 0 };
+  for (std::size_t w = 1; w < maxWorkers; w *= 2) {
+    workerCounts.push_back(w);
+  }
+  if (maxWorkers > 0) {
+    workerCounts.push_back(maxWorkers);
+  }
+
+  std::cout << std::format("BulletManager::update throughput: {} hardware threads, SIMD = {}\n",
+                           hardwareThreads,
+                           Core::Simd::IsaName);
+  for (std::size_t const count : Counts) {
+    Game::BulletManager bullets;
+    bullets.init(count);
+
+    double baseline = 0.0;
+    std::uint64_t baselineHash = 0;
+    for (std::size_t const workers : workerCounts) {
+      std::unique_ptr<Core::JobSystem> jobSystem;
+      if (workers > 0) {
+        jobSystem = std::make_unique<Core::JobSystem>(workers);
+      }
+      bullets.setJobSystem(jobSystem.get());
+
+      Result const result = measure(bullets, count);
+      bullets.setJobSystem(nullptr);
+      if (workers == 0) {
+        baseline = result.bulletsPerMs;
+        baselineHash = result.hash;
+      }
+      std::cout << std::format("{:>9} bullets  {:>2} threads  {:>10.0f} bullets/ms  {:>5.2f}x  {}\n",
+                               count,
+                               workers + 1,
+                               result.bulletsPerMs,
+                               result.bulletsPerMs / baseline,
+                               result.hash == baselineHash ? "hash OK" : "HASH MISMATCH");
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,191 @@
+#include "Core/Simd.hpp"
+#include "Game/BulletManager.hpp"
+#include "Game/BulletPattern.hpp"
+#include "Game/ItemManager.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <vector>
+
+// 消弹的开销测量: 10 万颗子弹均匀分布在画面中
+// 全屏 / 圆形 / 矩形消弹 (SIMD 区域查询 + 一次压实 + 整批转换为道具) 与逐颗 kill() 再 update 的对比,
+// 以及 10 万个道具的每帧更新开销
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double elapsedMicros(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+constexpr float ScreenWidth = 1280.0f;
+constexpr float ScreenHeight = 960.0f;
+constexpr std::size_t BulletCount = 100'000;
+constexpr int Rounds = 20;
+
+// 用静止的子弹填满内存池, 位置由固定种子决定
+void fillBullets(Game::BulletManager& bullets)
+{
+  bullets.clearBullets();
+  Game::PatternRng rng;
+  for (std::size_t i = 0; i < BulletCount; ++i) {
+    float const x = rng.nextFloat() * ScreenWidth;
+    float const y = rng.nextFloat() * ScreenHeight;
+    bullets.spawnBulletA(x, y, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0, 0);
+  }
+}
+
+struct Scratch
+{
+  std::vector<float> x = std::vector<float>(BulletCount);
+  std::vector<float> y = std::vector<float>(BulletCount);
+};
+
+// 对每一轮: 填满子弹, 计时 cancel(bullets, scratch) 与整批生成道具
+template <typename F>
+void benchmarkCancel(char const* name, Game::BulletManager& bullets, Game::ItemManager& items, F&& cancel)
+{
+  Scratch scratch;
+  double cancelMicros = 0.0;
+  double spawnMicros = 0.0;
+  std::size_t cancelled = 0;
+  for (int r = 0; r < Rounds; ++r) {
+    fillBullets(bullets);
+    items.clear();
+
+    auto const cancelStart = Clock::now();
+    std::size_t const count = cancel(bullets, scratch);
+    cancelMicros += elapsedMicros(cancelStart);
+
+    auto const spawnStart = Clock::now();
+    items.spawnBatch(scratch.x.data(), scratch.y.data(), count, Game::ItemType::Cancel, false);
+    spawnMicros += elapsedMicros(spawnStart);
+    cancelled = count;
+  }
+  std::cout << std::format("{:<22} cancel {:>8.1f} us  to items {:>6.1f} us  ({} of {} bullets, {} left)\n",
+                           name,
+                           cancelMicros / Rounds,
+                           spawnMicros / Rounds,
+                           cancelled,
+                           BulletCount,
+                           bullets.getActiveCount());
+}
+
+// 对照: 逐颗遍历, 对圆内的子弹读出坐标并 kill(), 再由下一次 update 统一回收
+void benchmarkKillLoop(Game::BulletManager& bullets, float cx, float cy, float radius)
+{
+  std::vector<Game::BulletHandle> handles(BulletCount);
+  Scratch scratch;
+  double micros = 0.0;
+  std::size_t cancelled = 0;
+  for (int r = 0; r < Rounds; ++r) {
+    bullets.clearBullets();
+    Game::PatternRng rng;
+    for (std::size_t i = 0; i < BulletCount; ++i) {
+      float const x = rng.nextFloat() * ScreenWidth;
+      float const y = rng.nextFloat() * ScreenHeight;
+      handles[i] = bullets.spawnBulletA(x, y, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0, 0);
+    }
+
+    auto const start = Clock::now();
+    std::size_t count = 0;
+    for (Game::BulletHandle const handle : handles) {
+      Game::Bullet bullet;
+      if (!bullets.getBullet(handle, bullet)) {
+        continue;
+      }
+      float const dx = bullet.x - cx;
+      float const dy = bullet.y - cy;
+      if (dx * dx + dy * dy <= radius * radius) {
+        scratch.x[count] = bullet.x;
+        scratch.y[count] = bullet.y;
+        ++count;
+        bullets.kill(handle);
+      }
+    }
+    bullets.update(ScreenWidth, ScreenHeight);
+    micros += elapsedMicros(start);
+    cancelled = count;
+  }
+  std::cout << std::format("{:<22} cancel {:>8.1f} us  ({} bullets, per-handle kill + update)\n",
+                           "circle (kill loop)",
+                           micros / Rounds,
+                           cancelled);
+}
+
+// 10 万个道具: 一半自由下落, 一半被吸向自机
+void benchmarkItems()
+{
+  Game::ItemManager items;
+  items.init(BulletCount);
+
+  Scratch scratch;
+  Game::PatternRng rng;
+  for (std::size_t i = 0; i < BulletCount; ++i) {
+    scratch.x[i] = rng.nextFloat() * ScreenWidth;
+    scratch.y[i] = rng.nextFloat() * ScreenHeight;
+  }
+  std::size_t const half = BulletCount / 2;
+  items.spawnBatch(scratch.x.data(), scratch.y.data(), half, Game::ItemType::Cancel, false);
+  items.spawnBatch(scratch.x.data() + half, scratch.y.data() + half, half, Game::ItemType::Cancel, true);
+
+  Game::ItemCollector const collector{ .x = ScreenWidth / 2.0f, .y = ScreenHeight * 0.85f, .collectAll = false };
+  constexpr int frames = 60;
+  double micros = 0.0;
+  std::size_t collected = 0;
+  for (int f = 0; f < frames; ++f) {
+    auto const start = Clock::now();
+    collected += items.update(collector, ScreenHeight);
+    micros += elapsedMicros(start);
+  }
+  std::cout << std::format("items {} -> {} after {} frames: update {:>7.1f} us per frame ({} collected)\n",
+                           BulletCount,
+                           items.getActiveCount(),
+                           frames,
+                           micros / frames,
+                           collected);
+}
+} // namespace
+
+int main()
+{
+  std::cout << std::format("== bullet cancel ({}, {} bullets) ==\n", Core::Simd::IsaName, BulletCount);
+
+  Game::BulletManager bullets;
+  bullets.init(BulletCount);
+  Game::ItemManager items;
+  items.init(BulletCount);
+
+  // 半径约 300 像素的圆覆盖画面的约 23%
+  constexpr float cx = ScreenWidth / 2.0f;
+  constexpr float cy = ScreenHeight / 2.0f;
+  constexpr float radius = 300.0f;
+
+  benchmarkCancel("all", bullets, items, [](Game::BulletManager& b, Scratch& s) {
+    return b.cancelAll(s.x.data(), s.y.data());
+  });
+  benchmarkCancel("circle r=300", bullets, items, [&](Game::BulletManager& b, Scratch& s) {
+    return b.cancelCircle(cx, cy, radius, s.x.data(), s.y.data());
+  });
+  benchmarkCancel("circle r=2000 (all)", bullets, items, [&](Game::BulletManager& b, Scratch& s) {
+    return b.cancelCircle(cx, cy, 2000.0f, s.x.data(), s.y.data());
+  });
+  benchmarkCancel("rect top half", bullets, items, [](Game::BulletManager& b, Scratch& s) {
+    Game::BulletBounds const rect{ .left = 0.0f, .right = ScreenWidth, .top = 0.0f, .bottom = ScreenHeight / 2.0f };
+    return b.cancelRect(rect, s.x.data(), s.y.data());
+  });
+  benchmarkCancel("circle r=300 (swap)", bullets, items, [&](Game::BulletManager& b, Scratch& s) {
+    b.setRemovalMode(Game::BulletManager::RemovalMode::SwapAndPop);
+    std::size_t const count = b.cancelCircle(cx, cy, radius, s.x.data(), s.y.data());
+    b.setRemovalMode(Game::BulletManager::RemovalMode::Stable);
+    return count;
+  });
+  benchmarkKillLoop(bullets, cx, cy, radius);
+
+  benchmarkItems();
+  return 0;
+}
@@ -0,0 +1,182 @@
+#include "Game/BulletManager.hpp"
+#include "Game/BulletPattern.hpp"
+#include "Game/BulletTypeTable.hpp"
+#include "Game/CollisionGrid.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <vector>
+
+// 碰撞查询: 均匀网格粗筛 (每帧重建一次 + 每次查询) 与逐颗遍历全部子弹的暴力判定对比
+//   - 自机被弹 / 擦弹: 与 Stage 相同的 32 像素格子与自机判定半径, 暴力判定一次遍历同时得到两者
+//   - 圆形查询: 模拟炸弹, 子机, 追踪弹等每帧的额外查询, 每帧 QueriesPerFrame 次
+// 重建的开销由一帧内的全部查询分摊, 最后给出网格开始占优的每帧查询次数
+// 每帧把查询放在随机位置, 检查两者选出的子弹集合完全相同 (判定公式相同, 浮点结果逐位一致)
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr float ScreenWidth = 1280.0f;
+constexpr float ScreenHeight = 960.0f;
+constexpr std::size_t Counts[] = { 1'000, 10'000, 100'000 };
+constexpr int Frames = 200;
+constexpr int QueriesPerFrame = 8;
+constexpr float QueryRadius = 16.0f;
+
+double elapsedMicros(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+// 对照: 逐颗计算与自机的距离, 判定与 CollisionGrid::queryHit / queryGraze 相同
+void bruteForce(Game::BulletSoA const& bullets,
+                std::size_t count,
+                Game::BulletTypeTable const& table,
+                Game::PlayerHitbox const& player,
+                std::vector<std::uint32_t>& hits,
+                std::vector<std::uint32_t>& grazes)
+{
+  hits.clear();
+  grazes.clear();
+  for (std::size_t i = 0; i < count; ++i) {
+    std::uint32_t const style = table.indexOf(bullets.type[i], bullets.color[i]);
+    float const dx = Game::fromSimScalar(bullets.x[i]) - player.x;
+    float const dy = Game::fromSimScalar(bullets.y[i]) - player.y;
+    float const distSq = dx * dx + dy * dy;
+    float const hitR = player.hitRadius + table.getHitRadius(style);
+    float const grazeR = player.grazeRadius + table.getGrazeRadius(style);
+    if (distSq <= hitR * hitR) {
+      hits.push_back(static_cast<std::uint32_t>(i));
+    } else if (distSq <= grazeR * grazeR) {
+      grazes.push_back(static_cast<std::uint32_t>(i));
+    }
+  }
+}
+
+// 对照: 逐颗判断与圆 (x, y, radius) 是否相交, 判定与 CollisionGrid::queryCircle 相同
+void bruteForceCircle(Game::BulletSoA const& bullets,
+                      std::size_t count,
+                      Game::BulletTypeTable const& table,
+                      float x,
+                      float y,
+                      float radius,
+                      std::vector<std::uint32_t>& found)
+{
+  found.clear();
+  for (std::size_t i = 0; i < count; ++i) {
+    float const dx = Game::fromSimScalar(bullets.x[i]) - x;
+    float const dy = Game::fromSimScalar(bullets.y[i]) - y;
+    float const r = radius + table.getHitRadius(table.indexOf(bullets.type[i], bullets.color[i]));
+    if (dx * dx + dy * dy <= r * r) {
+      found.push_back(static_cast<std::uint32_t>(i));
+    }
+  }
+}
+
+// 网格按格子顺序输出, 排序后与暴力判定的结果比较
+bool sameSet(std::uint32_t* found, std::size_t count, std::vector<std::uint32_t> const& expected)
+{
+  std::sort(found, found + count);
+  return std::equal(found, found + count, expected.begin(), expected.end());
+}
+
+void benchmark(std::size_t count)
+{
+  Game::BulletManager manager;
+  manager.init(count);
+  Game::PatternRng rng;
+  for (std::size_t i = 0; i < count; ++i) {
+    manager.spawnBulletA(rng.nextFloat() * ScreenWidth, rng.nextFloat() * ScreenHeight, 0, 0, 0, 0, 0, 0, 0);
+  }
+  Game::BulletSoA const& bullets = manager.getActiveBullets();
+  Game::BulletTypeTable const& table = Game::BulletTypeTable::getDefault();
+
+  constexpr float margin = Game::BulletManager::OFFSCREEN_MARGIN;
+  Game::CollisionGrid grid;
+  grid.init({ -margin, ScreenWidth + margin, -margin, ScreenHeight + margin }, 32.0f, count);
+
+  std::vector<std::uint32_t> hitOut(count);
+  std::vector<std::uint32_t> grazeOut(count);
+  std::vector<std::uint32_t> expectedHits;
+  std::vector<std::uint32_t> expectedGrazes;
+  expectedHits.reserve(count);
+  expectedGrazes.reserve(count);
+
+  double rebuildMicros = 0.0;
+  double playerMicros = 0.0;
+  double playerBruteMicros = 0.0;
+  double circleMicros = 0.0;
+  double circleBruteMicros = 0.0;
+  std::size_t totalGrazes = 0;
+  int mismatches = 0;
+  for (int f = 0; f < Frames; ++f) {
+    Game::PlayerHitbox const player{
+      .x = rng.nextFloat() * ScreenWidth, .y = rng.nextFloat() * ScreenHeight, .hitRadius = 2.0f, .grazeRadius = 24.0f
+    };
+
+    auto start = Clock::now();
+    grid.rebuild(bullets, count);
+    rebuildMicros += elapsedMicros(start);
+
+    start = Clock::now();
+    std::size_t const hits = grid.queryHit(player, hitOut.data(), count);
+    std::size_t const grazes = grid.queryGraze(player, grazeOut.data(), count);
+    playerMicros += elapsedMicros(start);
+
+    start = Clock::now();
+    bruteForce(bullets, count, table, player, expectedHits, expectedGrazes);
+    playerBruteMicros += elapsedMicros(start);
+
+    totalGrazes += grazes;
+    bool match = sameSet(hitOut.data(), hits, expectedHits) && sameSet(grazeOut.data(), grazes, expectedGrazes);
+
+    for (int q = 0; q < QueriesPerFrame; ++q) {
+      float const x = rng.nextFloat() * ScreenWidth;
+      float const y = rng.nextFloat() * ScreenHeight;
+
+      start = Clock::now();
+      std::size_t const found = grid.queryCircle(x, y, QueryRadius, hitOut.data(), count);
+      circleMicros += elapsedMicros(start);
+
+      start = Clock::now();
+      bruteForceCircle(bullets, count, table, x, y, QueryRadius, expectedHits);
+      circleBruteMicros += elapsedMicros(start);
+
+      match = match && sameSet(hitOut.data(), found, expectedHits);
+    }
+    mismatches += match ? 0 : 1;
+  }
+
+  double const circleQueries = static_cast<double>(Frames) * QueriesPerFrame;
+  double const circleGrid = circleMicros / circleQueries;
+  double const circleBrute = circleBruteMicros / circleQueries;
+  // 每帧 n 次圆形查询时, 网格的开销为 rebuild + n * circleGrid, 暴力判定为 n * circleBrute
+  double const breakEven = rebuildMicros / Frames / (circleBrute - circleGrid);
+  std::cout << std::format("{:>7} bullets  rebuild {:>8.2f}  hit+graze {:>6.2f} vs {:>8.2f}  "
+                           "circle {:>6.2f} vs {:>8.2f}  grid wins above {:>4.1f} queries/frame  "
+                           "({:.1f} grazes/frame, {})\n",
+                           count,
+                           rebuildMicros / Frames,
+                           playerMicros / Frames,
+                           playerBruteMicros / Frames,
+                           circleGrid,
+                           circleBrute,
+                           breakEven,
+                           static_cast<double>(totalGrazes) / Frames,
+                           mismatches == 0 ? "results match" : std::format("{} MISMATCHED FRAMES", mismatches));
+}
+} // namespace
+
+int main()
+{
+  std::cout << std::format("collision queries, {} frames per case, us per frame or per query (grid vs brute force)\n",
+                           Frames);
+  for (std::size_t const count : Counts) {
+    benchmark(count);
+  }
+  return 0;
+}
@@ -0,0 +1,180 @@
+#include "Core/Simd.hpp"
+#include "Game/BulletKernel.hpp"
+#include "Game/BulletPattern.hpp"
+#include "Game/BulletSoA.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <vector>
+
+// 子弹回收的开销随死亡比例的变化: 10 万颗子弹中随机选出一定比例回收
+//   - swap-and-pop: 用末尾的子弹填补空位 (RemovalMode::SwapAndPop), 打乱顺序
+//   - compactStable: BulletManager 的保序压实 (RemovalMode::Stable), 稀疏时按段搬移, 密集时按位图 left-pack
+//   - 按段搬移: 始终按存活段整段搬移, 即不带位图路径的保序压实
+//   - 逐元素分支: 最直接的保序压实, 逐个元素与下一个死亡下标比较
+// 与 BulletManager::removeKilled 一样对每个字段数组分别压实, 并计入稀疏表 (槽位 -> 下标) 的维护
+// 各保序实现的结果逐元素相同, swap-and-pop 只检查剩余个数
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t BulletCount = 100'000;
+constexpr int Rounds = 50;
+constexpr double KillRates[] = { 0.001, 0.01, 0.05, 0.1, 0.25, 0.5, 0.75, 0.9 };
+
+Game::BulletSoA makeBullets()
+{
+  Game::BulletSoA bullets;
+  bullets.resize(BulletCount);
+  Game::PatternRng rng;
+  for (std::size_t i = 0; i < BulletCount; ++i) {
+    bullets.store(i, { rng.nextFloat() * 1280.0f, rng.nextFloat() * 960.0f, rng.nextFloat(), 0.01f, 0.0f, 2.0f });
+    bullets.id[i] = static_cast<std::uint32_t>(i);
+  }
+  return bullets;
+}
+
+// 每颗子弹以概率 rate 死亡, 下标升序
+std::vector<std::uint32_t> makeKillList(double rate, Game::PatternRng& rng)
+{
+  std::vector<std::uint32_t> kills;
+  for (std::size_t i = 0; i < BulletCount; ++i) {
+    if (rng.nextFloat() < rate) {
+      kills.push_back(static_cast<std::uint32_t>(i));
+    }
+  }
+  return kills;
+}
+
+// 与 BulletManager::removeKilled 的 SwapAndPop 分支相同
+std::size_t swapAndPop(Game::BulletSoA& b, std::vector<std::uint32_t>& sparse, std::vector<std::uint32_t> const& kills)
+{
+  std::size_t count = BulletCount;
+  for (std::size_t k = kills.size(); k-- > 0;) {
+    std::size_t const dead = kills[k];
+    std::size_t const last = --count;
+    if (dead != last) {
+      b.move(dead, last);
+      sparse[b.id[dead]] = static_cast<std::uint32_t>(dead);
+    }
+  }
+  return count;
+}
+
+// 保序压实后, 第一个死亡下标之后的子弹都移动过, 更新它们在稀疏表中的下标
+template <typename Compact>
+std::size_t stable(Game::BulletSoA& b,
+                   std::vector<std::uint32_t>& sparse,
+                   std::vector<std::uint32_t> const& kills,
+                   Compact&& compact)
+{
+  if (kills.empty()) {
+    return BulletCount;
+  }
+  b.forEachArray([&](auto& array) { compact(array.data(), BulletCount, kills.data(), kills.size()); });
+  std::size_t const count = BulletCount - kills.size();
+  for (std::size_t i = kills[0]; i < count; ++i) {
+    sparse[b.id[i]] = static_cast<std::uint32_t>(i);
+  }
+  return count;
+}
+
+// 对照: 始终按存活段整段搬移
+template <typename T>
+std::size_t compactRuns(T* data, std::size_t count, std::uint32_t const* kills, std::size_t killCount)
+{
+  std::size_t write = kills[0];
+  for (std::size_t k = 0; k < killCount; ++k) {
+    std::size_t const runBegin = kills[k] + 1;
+    std::size_t const runEnd = k + 1 < killCount ? kills[k + 1] : count;
+    std::copy(data + runBegin, data + runEnd, data + write);
+    write += runEnd - runBegin;
+  }
+  return write;
+}
+
+// 对照: 逐元素与下一个死亡下标比较, 分支随死亡分布变化
+template <typename T>
+std::size_t compactBranchy(T* data, std::size_t count, std::uint32_t const* kills, std::size_t killCount)
+{
+  std::size_t write = kills[0];
+  std::size_t k = 0;
+  for (std::size_t read = kills[0]; read < count; ++read) {
+    if (k < killCount && kills[k] == read) {
+      ++k;
+    } else {
+      data[write++] = data[read];
+    }
+  }
+  return write;
+}
+
+struct Result
+{
+  double micros;
+  std::size_t remaining;
+  Game::BulletSoA::Array<std::uint32_t> ids; // 回收后的 id 数组, 用于比较各保序实现
+};
+
+template <typename Remove>
+Result measure(Game::BulletSoA const& pristine, std::vector<std::uint32_t> const& kills, Remove&& remove)
+{
+  Game::BulletSoA bullets;
+  std::vector<std::uint32_t> sparse(BulletCount);
+  double micros = 0.0;
+  std::size_t remaining = 0;
+  for (int r = 0; r < Rounds; ++r) {
+    bullets = pristine;
+    auto const start = Clock::now();
+    remaining = remove(bullets, sparse, kills);
+    micros += std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+  }
+  bullets.id.resize(remaining);
+  return { micros / Rounds, remaining, std::move(bullets.id) };
+}
+} // namespace
+
+int main()
+{
+  Game::BulletSoA const pristine = makeBullets();
+  Game::PatternRng rng;
+
+  std::cout << std::format("bullet removal, {} bullets, us per frame (SIMD = {})\n", BulletCount, Core::Simd::IsaName);
+  std::cout << std::format(
+    "{:>7}{:>14}{:>16}{:>12}{:>14}  {}\n", "killed", "swap-and-pop", "compactStable", "runs only", "branchy", "check");
+  for (double const rate : KillRates) {
+    std::vector<std::uint32_t> const kills = makeKillList(rate, rng);
+
+    Result const swap = measure(pristine, kills, swapAndPop);
+    Result const compacted = measure(pristine, kills, [](auto& b, auto& sparse, auto const& k) {
+      return stable(b, sparse, k, [](auto* data, std::size_t n, std::uint32_t const* list, std::size_t count) {
+        return Game::compactStable(data, n, list, count);
+      });
+    });
+    Result const runs = measure(pristine, kills, [](auto& b, auto& sparse, auto const& k) {
+      return stable(b, sparse, k, [](auto* data, std::size_t n, std::uint32_t const* list, std::size_t count) {
+        return compactRuns(data, n, list, count);
+      });
+    });
+    Result const branchy = measure(pristine, kills, [](auto& b, auto& sparse, auto const& k) {
+      return stable(b, sparse, k, [](auto* data, std::size_t n, std::uint32_t const* list, std::size_t count) {
+        return compactBranchy(data, n, list, count);
+      });
+    });
+
+    bool const ok = swap.remaining == BulletCount - kills.size() && compacted.ids == runs.ids &&
+                    compacted.ids == branchy.ids;
+    std::cout << std::format("{:>6.1f}%{:>14.1f}{:>16.1f}{:>12.1f}{:>14.1f}  {}\n",
+                             100.0 * static_cast<double>(kills.size()) / BulletCount,
+                             swap.micros,
+                             compacted.micros,
+                             runs.micros,
+                             branchy.micros,
+                             ok ? "OK" : "MISMATCH");
+  }
+  return 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace Core {
+// 按 VAlignment 字节对齐分配内存的分配器, 用于 SIMD 批处理的连续数组 (如 std::vector<float, AlignedAllocator<float>>)
+template <typename T, std::size_t VAlignment = 64>
+struct AlignedAllocator
+{
+  static_assert(VAlignment >= alignof(T) && (VAlignment & (VAlignment - 1)) == 0, "Alignment must be a power of two.");
+
+  using value_type = T;
+
+  template <typename U>
+  struct rebind
+  {
+    using other = AlignedAllocator<U, VAlignment>;
+  };
+
+  AlignedAllocator() noexcept = default;
+  template <typename U>
+  AlignedAllocator(AlignedAllocator<U, VAlignment> const&) noexcept
+  {
+  }
+
+  T* allocate(std::size_t n)
+  {
+    return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ VAlignment }));
+  }
+
+  void deallocate(T* p, std::size_t) noexcept { ::operator delete(p, std::align_val_t{ VAlignment }); }
+
+  template <typename U>
+  bool operator==(AlignedAllocator<U, VAlignment> const&) const noexcept
+  {
+    return true;
+  }
+};
+} // namespace Core
@@ -1,24 +1,52 @@
 #include "Application.hpp"
+#include "FramePacer.hpp"
 #include "Graphics/DX11Device.hpp"
 #include "Graphics/SpriteRenderer.hpp"
+#include "JobSystem.hpp"
 #include "Logger.hpp"
 #include "MathUtils.hpp"
+#include "Metrics.hpp"
+#include "Profiler.hpp"
 #include "Timer.hpp"
 #include "Window.hpp"
 
+#include "Game/SimulationThread.hpp"
+
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 
+#include <algorithm>
+#include <filesystem>
 #include <memory>
 #include <numbers>
 
 namespace Core {
 
+namespace {
+// 渲染帧: 由主线程在每次渲染后结束一帧
+constexpr Metrics::Timeline RenderTimeline = Metrics::Timeline::Render;
+Counter const updateMetric("frame.updates", RenderTimeline);      // 每次渲染之间的逻辑更新次数, 追赶时为 2
+Gauge const frameTimeMetric("frame.ms", RenderTimeline);          // 相邻两次渲染的间隔
+Gauge const paceErrorMetric("frame.paceErrorUs", RenderTimeline); // 等待下一次更新时醒来的时刻晚于截止时间多少
+// 模拟帧: 由模拟线程在每一步之后结束一帧, 与 HeadlessRunner 的逐步指标一致
+Gauge const activeBulletMetric("bullets.active");
+Gauge const activeLaserMetric("lasers.active");
+Gauge const activeItemMetric("items.active");
+} // namespace
+
+// 类型表中的混合方式直接转换为渲染器的混合方式
+static_assert(static_cast<int>(Game::BulletBlend::Alpha) == static_cast<int>(Graphics::BlendMode::Alpha) &&
+                static_cast<int>(Game::BulletBlend::Additive) == static_cast<int>(Graphics::BlendMode::Additive),
+              "Game::BulletBlend must match Graphics::BlendMode");
+
 Application::Application(Config const& config)
   : m_config(config)
   , m_isRunning(true)
 {
+  // 日志由后台线程格式化与写出, 逐帧的警告不阻塞主循环
+  Logger::startAsync();
+  PROFILE_THREAD_NAME("Main");
   LOG_INFO("Initializing application...");
 
   // 初始化窗口
@@ -31,6 +59,8 @@ Application::Application(Config const& config)
 
   // 初始化计时器
   m_timer = std::make_unique<Timer>();
+  m_pacer = std::make_unique<FramePacer>();
+  m_simThread = std::make_unique<Game::SimulationThread>();
 
   // 初始化渲染管线
   m_spriteRenderer = std::make_unique<Graphics::SpriteRenderer>(m_gfx.get());
@@ -41,7 +71,40 @@ Application::Application(Config const& config)
   auto texPath = std::filesystem::current_path() / "assets/textures/yukari.png";
   m_textureYukari = std::make_unique<Graphics::Texture>(m_gfx.get(), texPath.string());
 
-  m_bulletManager.init(20000); // 初始化弹幕池, 最多支持 20000 发子弹
+  // 初始化线程池, 供子弹等批量更新并行使用
+  m_jobSystem = std::make_unique<JobSystem>();
+
+  // 初始化游戏模拟, 弹幕池最多支持 20000 发子弹
+  Game::Stage::Config const stageConfig{ .width = static_cast<float>(m_config.width),
+                                         .height = static_cast<float>(m_config.height),
+                                         .bulletCapacity = 20000 };
+  m_stage.init(stageConfig, m_jobSystem.get());
+
+  // 加载子弹类型表 (由 BulletTableCompiler 编译), 不存在时所有子弹使用默认样式
+  auto tablePath = std::filesystem::current_path() / "assets/data/bullet_types.bin";
+  if (std::filesystem::exists(tablePath)) {
+    Game::BulletTypeTable table;
+    table.loadFromFile(tablePath.string());
+    m_stage.setBulletTypeTable(table);
+  } else {
+    LOG_WARN("Bullet type table missing, using default style: {}", tablePath.string());
+  }
+
+  if (!m_config.recordReplayPath.empty()) {
+    m_replayRecorder = std::make_unique<Game::ReplayRecorder>();
+    m_replayRecorder->begin(m_stage);
+    LOG_INFO("Recording replay to: {}", m_config.recordReplayPath);
+  }
+
+  // 从进入主循环前开始采集, 初始化的耗时不计入
+  if (!m_config.profileTracePath.empty()) {
+#if defined(TOUHOU_PROFILE)
+    Profiler::beginCapture();
+    LOG_INFO("Profiling to: {}", m_config.profileTracePath);
+#else
+    LOG_WARN("Built without TOUHOU_PROFILE, profiling is unavailable.");
+#endif
+  }
 
   LOG_INFO("Application initialized successfully.");
 }
@@ -49,92 +112,225 @@ Application::Application(Config const& config)
 Application::~Application()
 {
   LOG_INFO("Application shutting down.");
+
+  // 先停止模拟线程, 之后才能在主线程上访问 Stage 与录像
+  if (m_simThread) {
+    m_simThread->stop();
+  }
+
+  if (m_replayRecorder) {
+    try {
+      m_replayRecorder->getReplay().saveToFile(m_config.recordReplayPath);
+    } catch (std::exception const&) {
+      // 错误已在 saveToFile 中记录, 析构函数中不再抛出
+    }
+  }
+  if (m_pacer) {
+    FramePacer::Stats const stats = m_pacer->getStats();
+    LOG_INFO("Frame pacing: {} waits, error p50 {:.1f} us, p99 {:.1f} us, max {:.1f} us, "
+             "sleep overshoot {:.1f} us, spin {:.1f} us per wait",
+             stats.waits,
+             stats.errorP50Us,
+             stats.errorP99Us,
+             stats.errorMaxUs,
+             stats.overshootMeanUs,
+             stats.spinMeanUs);
+  }
+  if (!m_config.metricsPath.empty()) {
+    writeMetrics();
+    LOG_INFO("Frame time: p50 {:.2f} ms, p90 {:.2f} ms, p99 {:.2f} ms",
+             Metrics::percentile(frameTimeMetric.getId(), 50.0),
+             Metrics::percentile(frameTimeMetric.getId(), 90.0),
+             Metrics::percentile(frameTimeMetric.getId(), 99.0));
+  }
+  if (Profiler::isCapturing()) {
+    try {
+      Profiler::writeChromeTrace(m_config.profileTracePath);
+    } catch (std::exception const&) {
+      // 错误已在 writeChromeTrace 中记录
+    }
+  }
+  Logger::stopAsync();
 }
 
 void Application::run()
 {
-  double accumulatedTime = 0.0; // 累积的未处理时间
-  // 主循环
+  // 逻辑更新 (Update) 在模拟线程上以固定步长 (1/60s) 执行, 每一步发布一份 FramePacket
+  // 若由于卡顿等原因落后, 模拟线程最多连续追赶 2 步, 即通过处理落机制最多降低到 30fps
+  Game::SimulationThread::Config const simConfig{ .stepSeconds = SECONDS_PER_FRAME, .maxCatchUp = 2 };
+  m_simThread->start(m_stage, simConfig, [this] { update(); });
+
+  // 主循环: 处理窗口消息与渲染提交, 与模拟并行
   while (m_isRunning) {
-    if (!m_window->processMessages()) {
+    PROFILE_FRAME();
+    // 处理窗口消息, 如果窗口被关闭或模拟线程出错则停止循环
+    if (!m_window->processMessages() || !m_simThread->isRunning()) {
       m_isRunning = false;
       break;
     }
     // TODO: 添加其他退出逻辑
 
-    // 处理窗口消息, 如果窗口被关闭则停止循环
-    // 获取当前经过的时间, 并累积到 accumulatedTime 中
     m_timer->tick();
-    accumulatedTime += m_timer->getDeltaTime();
-
-    // 逻辑更新 (Update)
-    // 只有累积的时间经过了一帧的时间 (1/60s), 才执行一次更新循环
-    // 若由于卡顿等原因 accumulatedTime 积累了 2 帧或更多,
-    // 则连续执行多次更新循环而不渲染, 以追赶上当前时间
-    bool isUpdated = false;
-    int updateCount = 0; // 统计连续更新的次数, 用于限制最大连续更新次数, 模拟处理落机制
-    while (accumulatedTime >= SECONDS_PER_FRAME &&
-           updateCount++ < 2) { // 最多连续更新 2 次, 即通过处理落机制最多降低到 30fps
-      update();
-      accumulatedTime -= SECONDS_PER_FRAME; // 减去一帧的时间
-      isUpdated = true;
-    }
+    bool fresh = false;
+    Game::FramePacket const& packet = m_simThread->acquire(&fresh);
 
     // 渲染提交 (Render)
-    // 只有逻辑更新过 (画面有变化) 才重新渲染
-    if (isUpdated) {
-      render();
-    } else if (!m_config.vsync) {
-      // 如果没有更新, 就等一会儿再渲染, 避免 CPU 占用过高
-      Sleep(1);
+    // 有新的一帧 (画面有变化) 时渲染; 开启 vsync 或插值时每次循环都渲染, 频率由 vsync 或显示器决定
+    if (fresh || m_config.vsync || m_config.interpolate) {
+      render(packet, interpolationAlpha(packet));
+      recordFrameMetrics();
+    } else {
+      // 没有新的一帧时, 等到下一帧预计发布的时刻: 先粗略休眠再自旋到截止时间
+      // 原来的 Sleep(1) 依系统计时器精度会睡 1 ~ 15.6 ms, 醒来的时刻不确定, 表现为输入延迟与画面卡顿
+      // 模拟线程落后于预计时刻时只短暂等待, 避免空转
+      std::int64_t const expected = packet.publishCounter + Timer::toCounter(SECONDS_PER_FRAME);
+      std::int64_t const deadline = std::max(expected, Timer::getCounter() + Timer::toCounter(MIN_RENDER_WAIT));
+      paceErrorMetric.set(m_pacer->waitUntil(deadline) * 1e6);
+    }
+
+    // F9: 立即导出当前的指标历史
+    bool const metricsKeyDown =
+      GetForegroundWindow() == m_window->getHandle() && (GetAsyncKeyState(VK_F9) & 0x8000) != 0;
+    if (metricsKeyDown && !m_metricsKeyDown && !m_config.metricsPath.empty()) {
+      writeMetrics();
+    }
+    m_metricsKeyDown = metricsKeyDown;
+  }
+  m_simThread->stop();
+}
+
+float Application::interpolationAlpha(Game::FramePacket const& packet) const
+{
+  if (!m_config.interpolate) {
+    return 1.0f;
+  }
+  // 距离最新一帧发布经过的时间占一步的比例: 画面总是比模拟晚一步, 换来逐帧平滑的运动
+  double const elapsed = (Timer::getCounter() - packet.publishCounter) * Timer::getSecondsPerCount();
+  return static_cast<float>(std::clamp(elapsed / SECONDS_PER_FRAME, 0.0, 1.0));
+}
+
+void Application::recordFrameMetrics()
+{
+  double const now = m_timer->getTotalTime();
+  frameTimeMetric.set((now - m_lastFrameTime) * 1000.0);
+  m_lastFrameTime = now;
+  Metrics::endFrame(RenderTimeline);
+}
+
+void Application::writeMetrics() const
+{
+  std::string const& path = m_config.metricsPath;
+  try {
+    if (path.ends_with(".json")) {
+      Metrics::writeJson(path);
+    } else {
+      // CSV 每条时间线一个文件, 渲染帧写到同目录下的 <名称>.render<扩展名>
+      std::filesystem::path renderPath(path);
+      renderPath.replace_extension(".render" + renderPath.extension().string());
+      Metrics::writeCsv(path, Metrics::Timeline::Simulation);
+      Metrics::writeCsv(renderPath.string(), RenderTimeline);
     }
+  } catch (std::exception const&) {
+    // 错误已在 Metrics 中记录, 不因导出失败中断游戏
+  }
+}
+
+Game::FrameInput Application::pollInput() const
+{
+  Game::FrameInput input{};
+  if (GetForegroundWindow() != m_window->getHandle()) {
+    return input;
   }
+
+  // GetAsyncKeyState 返回值的最高位表示按键当前处于按下状态
+  auto const bind = [&input](int virtualKey, Game::FrameInput::Button button) {
+    if (GetAsyncKeyState(virtualKey) & 0x8000) {
+      input.buttons |= button;
+    }
+  };
+  bind(VK_UP, Game::FrameInput::Up);
+  bind(VK_DOWN, Game::FrameInput::Down);
+  bind(VK_LEFT, Game::FrameInput::Left);
+  bind(VK_RIGHT, Game::FrameInput::Right);
+  bind('Z', Game::FrameInput::Shot);
+  bind('X', Game::FrameInput::Bomb);
+  bind(VK_SHIFT, Game::FrameInput::Focus);
+  bind(VK_CONTROL, Game::FrameInput::Skip);
+  return input;
 }
 
 void Application::update()
 {
-  ++m_frameCount;
-
-  constexpr float PI_2_3 = std::numbers::pi_v<float> * 2 / 3.0f; // 120度的弧度值
-  static constexpr float spawnAngAccel = 0.001f;
-  static float spawnAngle = 0.0f;
-  static float spawnAngVel = 0.0f;
-  spawnAngVel += spawnAngAccel; // 逐渐加速旋转
-  spawnAngle += spawnAngVel;
-  Game::Bullet b{ .x = m_config.width / 2.0f, .y = m_config.height / 2.0f };
-  b.angle = spawnAngle;
-  b.speed = 8.0f;
-
-  // 每帧生成 3 颗子弹
-  m_bulletManager.spawnBullet(b);
-  b.angle += PI_2_3;
-  m_bulletManager.spawnBullet(b);
-  b.angle += PI_2_3;
-  m_bulletManager.spawnBullet(b);
-
-  // 更新子弹位置, 并回收出界子弹
-  m_bulletManager.update(static_cast<float>(m_config.width), static_cast<float>(m_config.height));
+  PROFILE_FUNCTION();
+  updateMetric.add();
+
+  Game::FrameInput const input = pollInput();
+
+  // 模拟只由输入决定, 录制时逐帧记录输入, 并定期保存检查点
+  if (m_replayRecorder) {
+    m_replayRecorder->recordFrame(m_stage, input);
+  }
+  m_stage.step(input);
+  if (m_replayRecorder) {
+    m_replayRecorder->recordCheckpoint(m_stage);
+  }
+
+  activeBulletMetric.set(static_cast<double>(m_stage.getBulletManager().getActiveCount()));
+  activeLaserMetric.set(static_cast<double>(m_stage.getLaserManager().getLaserCount()));
+  activeItemMetric.set(static_cast<double>(m_stage.getItemManager().getActiveCount()));
+  Metrics::endFrame(Metrics::Timeline::Simulation);
 }
 
-void Application::render()
+void Application::render(Game::FramePacket const& packet, float alpha)
 {
+  PROFILE_FUNCTION();
+
   m_gfx->clear(0.3f, 0.0f, 0.3f, 1.0f); // 清屏(背景)
   m_spriteRenderer->begin();            // 开启渲染管线状态
   float time = static_cast<float>(m_timer->getTotalTime());
 
-  Game::Bullet const* bullets = m_bulletManager.getActiveBullets();
-  size_t count = m_bulletManager.getActiveCount();
+  // 类型表在模拟开始后不再修改, 可以与模拟线程同时读取
+  Game::BulletTypeTable const& typeTable = m_stage.getBulletTypeTable();
+
+  // 曲线激光画在子弹下面, 每条激光是一条实例化的带
+  for (Game::FramePacket::LaserRange const& laser : packet.lasers) {
+    Game::BulletStyle const& style = typeTable.getStyle(typeTable.indexOf(laser.type, laser.color));
+    m_spriteRenderer->drawStrip(m_textureYukari.get(),
+                                &packet.laserX[laser.first],
+                                &packet.laserY[laser.first],
+                                laser.count,
+                                style.width,
+                                { style.u0, style.v0, style.u1, style.v1 },
+                                static_cast<Graphics::BlendMode>(style.blend));
+  }
+
+  // 暂时复用八云紫的贴图作为子弹图集, 外观按 (type, color) 查类型表
+  // 分两遍绘制: 先画普通混合的子弹, 再把发光弹叠加在上面, 每遍只有一个批次
+  // 位置与朝向在上一次与最新一次模拟之间插值 (未开启插值时 alpha 为 1, 即最新一次的状态)
+  for (Game::BulletBlend const pass : { Game::BulletBlend::Alpha, Game::BulletBlend::Additive }) {
+    PROFILE_SCOPE("Application::render bullet instances");
+    for (size_t i = 0; i < packet.bulletCount; i++) {
+      Game::BulletStyle const& style = typeTable.getStyle(typeTable.indexOf(packet.type[i], packet.color[i]));
+      if (style.blend != pass) {
+        continue;
+      }
+      float bulletX, bulletY, bulletAngle;
+      packet.bulletAt(i, alpha, bulletX, bulletY, bulletAngle);
+      m_spriteRenderer->drawSprite(m_textureYukari.get(),
+                                   bulletX,
+                                   bulletY,
+                                   bulletAngle - std::numbers::pi_v<float> / 2, // 子弹总是面向运动方向
+                                   style.width,
+                                   style.height,
+                                   { style.u0, style.v0, style.u1, style.v1 },
+                                   static_cast<Graphics::BlendMode>(style.blend));
+    }
+  }
 
-  // 暂时复用八云紫的贴图来当做子弹, 缩小到 20x20
-  for (size_t i = 0; i < count; i++) {
-    Game::Bullet const& b = bullets[i];
-    m_spriteRenderer->drawSprite(m_textureYukari.get(),
-                                 b.x,
-                                 b.y,
-                                 b.angle - std::numbers::pi_v<float> / 2, // 子弹总是面向运动方向
-                                 30.0f,
-                                 30.0f // 子弹大小
-    );
+  // 消弹产生的道具画在子弹上面, 暂时同样复用八云紫的贴图
+  static constexpr float itemSize = 12.0f;
+  for (size_t i = 0; i < packet.itemCount; i++) {
+    m_spriteRenderer->drawSprite(m_textureYukari.get(), packet.itemX[i], packet.itemY[i], 0.0f, itemSize, itemSize);
   }
 
   // float x = std::sin(time) * 200.0f + 400.0f;
@@ -148,6 +344,6 @@ void Application::render()
   m_spriteRenderer->end(); // 结束渲染管线状态
   m_gfx->present();        // 呈现到屏幕
 
-  // LOG_DEBUG(std::format("Active Bullets: {}", m_bulletManager.getActiveCount()));
+  // LOG_DEBUG("Active Bullets: {}", m_stage.getBulletManager().getActiveCount());
 }
 } // namespace Core
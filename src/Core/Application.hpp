@@ -1,6 +1,7 @@
 #pragma once
 
-#include "Game/BulletManager.hpp"
+#include "Game/Replay.hpp"
+#include "Game/Stage.hpp"
 #include "Graphics/SpriteRenderer.hpp"
 #include "Graphics/Texture.hpp"
 
@@ -10,12 +11,19 @@
 namespace Core {
 class Window;
 class Timer;
+class FramePacer;
+class JobSystem;
 }
 
 namespace Graphics {
 class DX11Device;
 }
 
+namespace Game {
+class SimulationThread;
+struct FramePacket;
+}
+
 namespace Core {
 class Application
 {
@@ -26,6 +34,10 @@ public:
     int width;
     int height;
     bool vsync;
+    std::string recordReplayPath; // 非空时录制本局录像, 退出时写入该文件
+    std::string profileTracePath; // 非空时采集 CPU 剖析数据, 退出时写入该 Chrome trace 文件 (需 TOUHOU_PROFILE)
+    std::string metricsPath;      // 非空时退出或按 F9 时导出逐帧指标, .json 写 JSON, 否则写 CSV (渲染帧另写一个)
+    bool interpolate = false;     // 在最近两次模拟之间插值, 每次循环都渲染 (高刷新率显示器下运动更平滑, 画面晚一步)
   };
 
 public:
@@ -41,10 +53,18 @@ public:
 public:
   static constexpr double TARGET_FPS = 60.0;
   static constexpr double SECONDS_PER_FRAME = 1.0 / TARGET_FPS; // 约为 0.0166667 秒
+  static constexpr double MIN_RENDER_WAIT = 0.0005;              // 等待新一帧时每次至少等待的时间 (s)
 
 private:
-  void update(); // 处理逻辑更新, 每帧调用
-  void render(); // 处理渲染提交, 尽可能快, 或被 vsync 限制
+  void update(); // 处理逻辑更新, 每帧在模拟线程上调用
+  // 处理渲染提交, 在主线程上绘制模拟线程发布的一帧, alpha 为插值系数
+  void render(Game::FramePacket const& packet, float alpha);
+  float interpolationAlpha(Game::FramePacket const& packet) const;
+
+  Game::FrameInput pollInput() const; // 读取本帧的键盘状态, 窗口不在前台时视为无输入
+
+  void recordFrameMetrics(); // 每次渲染后记录帧间隔并结束一个渲染帧; 模拟帧的指标在 update 中结束
+  void writeMetrics() const; // 导出指标历史到 m_config.metricsPath, 失败时只记录日志
 
 private:
   Config m_config;
@@ -53,11 +73,17 @@ private:
   std::unique_ptr<Core::Window> m_window;
   std::unique_ptr<Graphics::DX11Device> m_gfx;
   std::unique_ptr<Core::Timer> m_timer;
+  std::unique_ptr<Core::FramePacer> m_pacer;
   std::unique_ptr<Graphics::SpriteRenderer> m_spriteRenderer;
+  std::unique_ptr<Core::JobSystem> m_jobSystem;
+  std::unique_ptr<Game::SimulationThread> m_simThread;
 
   // for test
   std::unique_ptr<Graphics::Texture> m_textureYukari;
-  Game::BulletManager m_bulletManager;
-  int m_frameCount = 0;
+  Game::Stage m_stage;
+  std::unique_ptr<Game::ReplayRecorder> m_replayRecorder; // 未开启录制时为空
+
+  double m_lastFrameTime = 0.0;  // 上一次渲染时计时器的总时间 (s), 用于计算帧时间
+  bool m_metricsKeyDown = false; // 上一次循环时 F9 是否按下, 只在按下的瞬间导出
 };
 } // namespace Core
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace Core {
+// 字节流写入器, 用于回放文件, 状态快照等二进制数据
+// 按本机字节序 (x86-64 为小端) 直接写入平凡可复制类型, 不做跨字节序的转换
+class BinaryWriter
+{
+public:
+  explicit BinaryWriter(std::vector<std::uint8_t>& buffer) noexcept
+    : m_buffer(buffer)
+  {
+  }
+
+  template <typename T>
+  void write(T const& value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "BinaryWriter only writes trivially copyable types");
+    writeBytes(&value, sizeof(T));
+  }
+
+  template <typename T>
+  void writeArray(T const* data, std::size_t count)
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "BinaryWriter only writes trivially copyable types");
+    writeBytes(data, count * sizeof(T));
+  }
+
+  // LEB128 变长整数: 每字节 7 位有效数据, 最高位表示后面还有字节, 小数值只占 1 字节
+  void writeVarint(std::uint64_t value)
+  {
+    while (value >= 0x80) {
+      m_buffer.push_back(static_cast<std::uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    m_buffer.push_back(static_cast<std::uint8_t>(value));
+  }
+
+  void writeBytes(void const* data, std::size_t size)
+  {
+    // 按区间插入只拷贝一遍, 不像 resize 那样先清零
+    auto const* bytes = static_cast<std::uint8_t const*>(data);
+    m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+  }
+
+  std::size_t size() const noexcept { return m_buffer.size(); }
+
+private:
+  std::vector<std::uint8_t>& m_buffer;
+};
+
+// 字节流读取器, 与 BinaryWriter 对应; 数据不足或格式错误时抛出 std::runtime_error
+class BinaryReader
+{
+public:
+  explicit BinaryReader(std::span<std::uint8_t const> data) noexcept
+    : m_data(data)
+  {
+  }
+
+  template <typename T>
+  T read()
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "BinaryReader only reads trivially copyable types");
+    T value;
+    readBytes(&value, sizeof(T));
+    return value;
+  }
+
+  template <typename T>
+  void readArray(T* data, std::size_t count)
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "BinaryReader only reads trivially copyable types");
+    readBytes(data, count * sizeof(T));
+  }
+
+  std::uint64_t readVarint()
+  {
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      std::uint8_t const byte = read<std::uint8_t>();
+      value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    throw std::runtime_error("BinaryReader: malformed varint.");
+  }
+
+  void readBytes(void* data, std::size_t size)
+  {
+    if (size > remaining()) {
+      throw std::runtime_error("BinaryReader: unexpected end of data.");
+    }
+    if (size > 0) {
+      std::memcpy(data, m_data.data() + m_offset, size);
+    }
+    m_offset += size;
+  }
+
+  // 不复制地取出接下来的 size 个字节
+  std::span<std::uint8_t const> readSpan(std::size_t size)
+  {
+    if (size > remaining()) {
+      throw std::runtime_error("BinaryReader: unexpected end of data.");
+    }
+    std::span<std::uint8_t const> const result = m_data.subspan(m_offset, size);
+    m_offset += size;
+    return result;
+  }
+
+  std::size_t remaining() const noexcept { return m_data.size() - m_offset; }
+  bool atEnd() const noexcept { return m_offset == m_data.size(); }
+
+private:
+  std::span<std::uint8_t const> m_data;
+  std::size_t m_offset = 0;
+};
+} // namespace Core
@@ -0,0 +1,99 @@
+#include "DeltaCodec.hpp"
+#include "BinaryStream.hpp"
+#include "Platform.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Core::Delta {
+
+namespace {
+constexpr std::size_t wordSize = sizeof(std::uint32_t);
+
+// 读取第 i 个字, 超出数据末尾的部分视为 0
+__forceinline std::uint32_t loadWord(std::uint8_t const* data, std::size_t size, std::size_t i) noexcept
+{
+  std::size_t const offset = i * wordSize;
+  std::uint32_t word = 0;
+  if (offset + wordSize <= size) {
+    std::memcpy(&word, data + offset, wordSize);
+  } else if (offset < size) {
+    std::memcpy(&word, data + offset, size - offset);
+  }
+  return word;
+}
+} // namespace
+
+void xorRleEncode(std::span<std::uint8_t const> base,
+                  std::span<std::uint8_t const> target,
+                  std::vector<std::uint8_t>& out)
+{
+  out.clear();
+  BinaryWriter writer(out);
+
+  std::uint8_t const* const a = base.data();
+  std::uint8_t const* const b = target.data();
+  std::size_t const wordCount = (std::max(base.size(), target.size()) + wordSize - 1) / wordSize;
+  std::size_t const commonWords = std::min(base.size(), target.size()) / wordSize; // 两边都完整的字, 无需边界检查
+
+  auto const wordsEqual = [&](std::size_t i) {
+    if (i < commonWords) {
+      return std::memcmp(a + i * wordSize, b + i * wordSize, wordSize) == 0;
+    }
+    return loadWord(a, base.size(), i) == loadWord(b, target.size(), i);
+  };
+
+  std::size_t i = 0;
+  while (i < wordCount) {
+    std::size_t const zeroBegin = i;
+    // 相同的部分按 8 字节一组跳过
+    while (i + 2 <= commonWords && std::memcmp(a + i * wordSize, b + i * wordSize, 2 * wordSize) == 0) {
+      i += 2;
+    }
+    while (i < wordCount && wordsEqual(i)) {
+      ++i;
+    }
+    std::size_t const literalBegin = i;
+    while (i < wordCount && !wordsEqual(i)) {
+      ++i;
+    }
+
+    writer.writeVarint(literalBegin - zeroBegin);
+    writer.writeVarint(i - literalBegin);
+    // 非零字直接写入输出缓冲区的末尾
+    std::size_t const offset = out.size();
+    out.resize(offset + (i - literalBegin) * wordSize);
+    std::uint8_t* dst = out.data() + offset;
+    for (std::size_t k = literalBegin; k < i; ++k, dst += wordSize) {
+      std::uint32_t const value = loadWord(a, base.size(), k) ^ loadWord(b, target.size(), k);
+      std::memcpy(dst, &value, wordSize);
+    }
+  }
+}
+
+void xorRleApply(std::span<std::uint8_t const> delta, std::vector<std::uint8_t>& buffer, std::size_t resultSize)
+{
+  // 先按字补齐 (补 0), 使每个字都能整体异或
+  std::size_t const paddedSize = (std::max(buffer.size(), resultSize) + wordSize - 1) / wordSize * wordSize;
+  buffer.resize(paddedSize, 0);
+
+  BinaryReader reader(delta);
+  std::size_t word = 0;
+  std::size_t const wordCount = paddedSize / wordSize;
+  while (!reader.atEnd()) {
+    word += static_cast<std::size_t>(reader.readVarint());
+    std::size_t const literalCount = static_cast<std::size_t>(reader.readVarint());
+    if (word > wordCount || literalCount > wordCount - word) {
+      throw std::runtime_error("Delta data is corrupted.");
+    }
+    std::span<std::uint8_t const> const literals = reader.readSpan(literalCount * wordSize);
+    std::uint8_t* dst = buffer.data() + word * wordSize;
+    for (std::size_t k = 0; k < literals.size(); ++k) {
+      dst[k] ^= literals[k];
+    }
+    word += literalCount;
+  }
+  buffer.resize(resultSize);
+}
+} // namespace Core::Delta
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// 两份相近的二进制数据之间的差分编码, 用于状态快照等逐帧变化不大的数据
+// 以 4 字节为单位做 XOR, 相同的字异或为 0, 再对 0 做游程编码 (RLE):
+//   重复 { 变长整数 零字个数, 变长整数 非零字个数, 非零字原样 }
+// 两份数据长度不同时, 较短的一份视为以 0 补齐
+namespace Core::Delta {
+// 把 base 与 target 的差分写入 out (覆盖原内容); out 的容量足够时不分配内存
+void xorRleEncode(std::span<std::uint8_t const> base,
+                  std::span<std::uint8_t const> target,
+                  std::vector<std::uint8_t>& out);
+
+// 把差分应用到 buffer 上 (原地 XOR), 结果截断为 resultSize 字节
+// buffer 为编码时的 base 则得到 target, 为 target 则得到 base; 差分数据损坏时抛出 std::runtime_error
+void xorRleApply(std::span<std::uint8_t const> delta, std::vector<std::uint8_t>& buffer, std::size_t resultSize);
+} // namespace Core::Delta
@@ -0,0 +1,199 @@
+#include "FastMath.hpp"
+#include "Simd.hpp"
+
+namespace Core::Math {
+
+#if defined(TOUHOU_SIMD_AVX2)
+
+namespace {
+__forceinline __m256 atan2V(__m256 y, __m256 x) noexcept
+{
+  __m256 const signMask = _mm256_set1_ps(-0.0f);
+  __m256 const zero = _mm256_setzero_ps();
+
+  __m256 const ax = _mm256_andnot_ps(signMask, x);
+  __m256 const ay = _mm256_andnot_ps(signMask, y);
+  __m256 const xGreater = _mm256_cmp_ps(ax, ay, _CMP_GT_OQ);
+  __m256 const maxV = _mm256_blendv_ps(ay, ax, xGreater);
+  __m256 const minV = _mm256_blendv_ps(ax, ay, xGreater);
+
+  __m256 const a = _mm256_and_ps(_mm256_div_ps(minV, maxV), _mm256_cmp_ps(maxV, zero, _CMP_GT_OQ));
+  __m256 const s = _mm256_mul_ps(a, a);
+  __m256 r = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(AtanC5), s), _mm256_set1_ps(AtanC4));
+  r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(AtanC3));
+  r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(AtanC2));
+  r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(AtanC1));
+  r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(AtanC0));
+  r = _mm256_mul_ps(r, a);
+
+  __m256 const halfPi = _mm256_set1_ps(std::numbers::pi_v<float> / 2.0f);
+  __m256 const pi = _mm256_set1_ps(std::numbers::pi_v<float>);
+  r = _mm256_blendv_ps(r, _mm256_sub_ps(halfPi, r), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+  r = _mm256_blendv_ps(r, _mm256_sub_ps(pi, r), _mm256_cmp_ps(x, zero, _CMP_LT_OQ));
+  return _mm256_xor_ps(r, _mm256_and_ps(signMask, _mm256_cmp_ps(y, zero, _CMP_LT_OQ)));
+}
+
+__forceinline __m256 rsqrtV(__m256 x) noexcept
+{
+  __m256i const bits = _mm256_sub_epi32(_mm256_set1_epi32(0x5F37'5A86), _mm256_srli_epi32(_mm256_castps_si256(x), 1));
+  __m256 r = _mm256_castsi256_ps(bits);
+  __m256 const halfX = _mm256_mul_ps(_mm256_set1_ps(0.5f), x);
+  __m256 const threeHalves = _mm256_set1_ps(1.5f);
+  r = _mm256_mul_ps(r, _mm256_sub_ps(threeHalves, _mm256_mul_ps(_mm256_mul_ps(halfX, r), r)));
+  r = _mm256_mul_ps(r, _mm256_sub_ps(threeHalves, _mm256_mul_ps(_mm256_mul_ps(halfX, r), r)));
+  return r;
+}
+
+__forceinline __m256 hypotV(__m256 x, __m256 y) noexcept
+{
+  __m256 const sq = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+  __m256 const positive = _mm256_cmp_ps(sq, _mm256_setzero_ps(), _CMP_GT_OQ);
+  return _mm256_and_ps(_mm256_mul_ps(sq, rsqrtV(sq)), positive);
+}
+} // namespace
+
+void fastAtan2Batch(float const* y, float const* x, float* out, std::size_t count) noexcept
+{
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    _mm256_storeu_ps(out + i, atan2V(_mm256_loadu_ps(y + i), _mm256_loadu_ps(x + i)));
+  }
+  for (; i < count; ++i) {
+    out[i] = fastAtan2(y[i], x[i]);
+  }
+}
+
+void fastRsqrtBatch(float const* x, float* out, std::size_t count) noexcept
+{
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    _mm256_storeu_ps(out + i, rsqrtV(_mm256_loadu_ps(x + i)));
+  }
+  for (; i < count; ++i) {
+    out[i] = fastRsqrt(x[i]);
+  }
+}
+
+void fastHypotBatch(float const* x, float const* y, float* out, std::size_t count) noexcept
+{
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    _mm256_storeu_ps(out + i, hypotV(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+  }
+  for (; i < count; ++i) {
+    out[i] = fastHypot(x[i], y[i]);
+  }
+}
+
+#elif defined(TOUHOU_SIMD_SSE2)
+
+namespace {
+// SSE2 没有 blendv, 用与/或运算按掩码选择
+__forceinline __m128 select(__m128 mask, __m128 ifTrue, __m128 ifFalse) noexcept
+{
+  return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+}
+
+__forceinline __m128 atan2V(__m128 y, __m128 x) noexcept
+{
+  __m128 const signMask = _mm_set1_ps(-0.0f);
+  __m128 const zero = _mm_setzero_ps();
+
+  __m128 const ax = _mm_andnot_ps(signMask, x);
+  __m128 const ay = _mm_andnot_ps(signMask, y);
+  __m128 const xGreater = _mm_cmpgt_ps(ax, ay);
+  __m128 const maxV = select(xGreater, ax, ay);
+  __m128 const minV = select(xGreater, ay, ax);
+
+  __m128 const a = _mm_and_ps(_mm_div_ps(minV, maxV), _mm_cmpgt_ps(maxV, zero));
+  __m128 const s = _mm_mul_ps(a, a);
+  __m128 r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(AtanC5), s), _mm_set1_ps(AtanC4));
+  r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(AtanC3));
+  r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(AtanC2));
+  r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(AtanC1));
+  r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(AtanC0));
+  r = _mm_mul_ps(r, a);
+
+  __m128 const halfPi = _mm_set1_ps(std::numbers::pi_v<float> / 2.0f);
+  __m128 const pi = _mm_set1_ps(std::numbers::pi_v<float>);
+  r = select(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(halfPi, r), r);
+  r = select(_mm_cmplt_ps(x, zero), _mm_sub_ps(pi, r), r);
+  return _mm_xor_ps(r, _mm_and_ps(signMask, _mm_cmplt_ps(y, zero)));
+}
+
+__forceinline __m128 rsqrtV(__m128 x) noexcept
+{
+  __m128i const bits = _mm_sub_epi32(_mm_set1_epi32(0x5F37'5A86), _mm_srli_epi32(_mm_castps_si128(x), 1));
+  __m128 r = _mm_castsi128_ps(bits);
+  __m128 const halfX = _mm_mul_ps(_mm_set1_ps(0.5f), x);
+  __m128 const threeHalves = _mm_set1_ps(1.5f);
+  r = _mm_mul_ps(r, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(halfX, r), r)));
+  r = _mm_mul_ps(r, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(halfX, r), r)));
+  return r;
+}
+
+__forceinline __m128 hypotV(__m128 x, __m128 y) noexcept
+{
+  __m128 const sq = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+  return _mm_and_ps(_mm_mul_ps(sq, rsqrtV(sq)), _mm_cmpgt_ps(sq, _mm_setzero_ps()));
+}
+} // namespace
+
+void fastAtan2Batch(float const* y, float const* x, float* out, std::size_t count) noexcept
+{
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_ps(out + i, atan2V(_mm_loadu_ps(y + i), _mm_loadu_ps(x + i)));
+  }
+  for (; i < count; ++i) {
+    out[i] = fastAtan2(y[i], x[i]);
+  }
+}
+
+void fastRsqrtBatch(float const* x, float* out, std::size_t count) noexcept
+{
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_ps(out + i, rsqrtV(_mm_loadu_ps(x + i)));
+  }
+  for (; i < count; ++i) {
+    out[i] = fastRsqrt(x[i]);
+  }
+}
+
+void fastHypotBatch(float const* x, float const* y, float* out, std::size_t count) noexcept
+{
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_ps(out + i, hypotV(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+  }
+  for (; i < count; ++i) {
+    out[i] = fastHypot(x[i], y[i]);
+  }
+}
+
+#else
+
+void fastAtan2Batch(float const* y, float const* x, float* out, std::size_t count) noexcept
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = fastAtan2(y[i], x[i]);
+  }
+}
+
+void fastRsqrtBatch(float const* x, float* out, std::size_t count) noexcept
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = fastRsqrt(x[i]);
+  }
+}
+
+void fastHypotBatch(float const* x, float const* y, float* out, std::size_t count) noexcept
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = fastHypot(x[i], y[i]);
+  }
+}
+
+#endif
+} // namespace Core::Math
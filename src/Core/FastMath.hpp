@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Core/Platform.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+
+// 快速近似函数 (atan2, rsqrt, hypot), 用于生成子弹等不要求完全精确的场合
+// 只使用 IEEE 754 精确的运算 (加减乘除, 比较, 整数位运算), 不依赖 CRT 的实现或 rsqrtps 等近似指令,
+// 因此标量版本与批量版本 (各 SIMD 路径) 的结果逐位相同, 也与编译器无关
+namespace Core::Math {
+// 反正切多项式系数 (在 [0, 1] 上的极小极大逼近)
+inline constexpr float AtanC0 = 0.99997726f;
+inline constexpr float AtanC1 = -0.33262347f;
+inline constexpr float AtanC2 = 0.19354346f;
+inline constexpr float AtanC3 = -0.11643287f;
+inline constexpr float AtanC4 = 0.05265332f;
+inline constexpr float AtanC5 = -0.01172120f;
+
+// 近似 atan2(y, x), 返回值范围 [-pi, pi], 最大绝对误差约 2e-6 弧度; atan2(0, 0) 返回 0
+__forceinline float fastAtan2(float y, float x) noexcept
+{
+  float const ax = std::fabs(x);
+  float const ay = std::fabs(y);
+  float const maxV = ax > ay ? ax : ay;
+  float const minV = ax > ay ? ay : ax;
+
+  // 先把角度化归到 [0, pi/4], 再用多项式逼近 atan
+  float const a = maxV > 0.0f ? minV / maxV : 0.0f;
+  float const s = a * a;
+  float r = (((((AtanC5 * s + AtanC4) * s + AtanC3) * s + AtanC2) * s + AtanC1) * s + AtanC0) * a;
+
+  if (ay > ax) {
+    r = std::numbers::pi_v<float> / 2.0f - r;
+  }
+  if (x < 0.0f) {
+    r = std::numbers::pi_v<float> - r;
+  }
+  if (y < 0.0f) {
+    r = -r;
+  }
+  return r;
+}
+
+// 近似 1 / sqrt(x) (x > 0), 位运算初值加两次牛顿迭代, 最大相对误差约 4.8e-6
+__forceinline float fastRsqrt(float x) noexcept
+{
+  float r = std::bit_cast<float>(0x5F37'5A86u - (std::bit_cast<std::uint32_t>(x) >> 1));
+  float const halfX = 0.5f * x;
+  r = r * (1.5f - halfX * r * r);
+  r = r * (1.5f - halfX * r * r);
+  return r;
+}
+
+// 近似 sqrt(x * x + y * y), 最大相对误差约 4.8e-6; 不做防溢出的缩放, 适用于屏幕坐标量级的输入
+__forceinline float fastHypot(float x, float y) noexcept
+{
+  float const sq = x * x + y * y;
+  return sq > 0.0f ? sq * fastRsqrt(sq) : 0.0f;
+}
+
+// 批量版本: 对 count 个元素逐个计算, 与对应的标量函数逐位一致, 按 TOUHOU_SIMD 选择的指令集向量化
+// 输入与输出可以是同一个数组
+void fastAtan2Batch(float const* y, float const* x, float* out, std::size_t count) noexcept;
+void fastRsqrtBatch(float const* x, float* out, std::size_t count) noexcept;
+void fastHypotBatch(float const* x, float const* y, float* out, std::size_t count) noexcept;
+} // namespace Core::Math
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <numbers>
+
+// 定点数与二进制角, 用于确定性模拟 (CMake 选项 TOUHOU_FIXED_POINT)
+// 模拟过程中只有整数加减乘与移位, 结果与编译器, 优化级别和 SIMD 路径无关
+// 与 float 之间的换算只在生成子弹和读出状态 (渲染, 碰撞) 时进行, 换算本身也是确定的
+namespace Core::Math {
+// 16.16 定点数: 整数部分 16 位 (±32768 像素), 小数部分 16 位 (约 1.5e-5 像素)
+using Fixed = std::int32_t;
+inline constexpr int FixedFracBits = 16;
+inline constexpr Fixed FixedOne = Fixed{ 1 } << FixedFracBits;
+
+// 就近舍入; float * 2^16 在 double 中是精确的, 因此结果只取决于输入
+constexpr Fixed toFixed(float value) noexcept
+{
+  double const scaled = static_cast<double>(value) * static_cast<double>(FixedOne);
+  return static_cast<Fixed>(scaled >= 0.0 ? scaled + 0.5 : scaled - 0.5);
+}
+
+constexpr float fixedToFloat(Fixed value) noexcept
+{
+  return static_cast<float>(static_cast<double>(value) / static_cast<double>(FixedOne));
+}
+
+// 两个 16.16 定点数相乘, 中间结果用 64 位, 向负无穷舍入 (C++20 起有符号右移为算术移位)
+constexpr Fixed fixedMul(Fixed a, Fixed b) noexcept
+{
+  return static_cast<Fixed>((static_cast<std::int64_t>(a) * b) >> FixedFracBits);
+}
+
+// 二进制角 (binary angle): 一周为 2^32, 无符号加法的回绕即为对 2pi 取模
+// 角速度, 角加速度也用同一单位, 负值以补码形式存储, 直接相加即可
+using Angle = std::uint32_t;
+inline constexpr int AngleBits = 32;
+inline constexpr double AngleUnitsPerRadian = 4294967296.0 / (std::numbers::pi * 2.0);
+
+constexpr Angle toAngle(float radians) noexcept
+{
+  double const units = static_cast<double>(radians) * AngleUnitsPerRadian;
+  // 先取整为 64 位有符号数, 再按模 2^32 截断, 负角度与大于一周的角度都能正确回绕
+  return static_cast<Angle>(static_cast<std::int64_t>(units >= 0.0 ? units + 0.5 : units - 0.5));
+}
+
+// 换算为 [-pi, pi) 范围内的弧度
+constexpr float angleToRadians(Angle angle) noexcept
+{
+  return static_cast<float>(static_cast<double>(static_cast<std::int32_t>(angle)) / AngleUnitsPerRadian);
+}
+} // namespace Core::Math
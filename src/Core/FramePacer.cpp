@@ -0,0 +1,97 @@
+#include "FramePacer.hpp"
+#include "Timer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+#include <immintrin.h>
+
+namespace Core {
+
+namespace {
+constexpr double overshootSmoothing = 1.0 / 16.0; // 滑动平均的权重, 约为最近 16 次休眠
+constexpr double deviationScale = 4.0;
+} // namespace
+
+FramePacer::FramePacer()
+  : m_secondsPerCount(Timer::getSecondsPerCount())
+{
+#if defined(_WIN32)
+  // 默认的系统计时器精度为 15.6 ms, Sleep(1) 可能睡满一整个周期
+  timeBeginPeriod(1);
+#endif
+}
+
+FramePacer::~FramePacer()
+{
+#if defined(_WIN32)
+  timeEndPeriod(1);
+#endif
+}
+
+double FramePacer::spinMargin() const noexcept
+{
+  return std::clamp(m_overshootMean + deviationScale * m_overshootDeviation, MIN_SPIN_MARGIN, MAX_SPIN_MARGIN);
+}
+
+double FramePacer::waitUntil(std::int64_t deadline)
+{
+  // 粗略休眠一次, 并用这次休眠更新超时量的估计
+  double const sleepTime = (deadline - Timer::getCounter()) * m_secondsPerCount - spinMargin();
+  if (sleepTime >= MIN_SLEEP) {
+    std::int64_t const sleepStart = Timer::getCounter();
+    std::this_thread::sleep_for(std::chrono::duration<double>(sleepTime));
+    double const overshoot = (Timer::getCounter() - sleepStart) * m_secondsPerCount - sleepTime;
+    m_overshootMean += (overshoot - m_overshootMean) * overshootSmoothing;
+    m_overshootDeviation += (std::abs(overshoot - m_overshootMean) - m_overshootDeviation) * overshootSmoothing;
+  }
+
+  // 剩余的时间自旋, pause 指令降低自旋时的功耗并让出超线程的执行资源
+  std::int64_t const spinStart = Timer::getCounter();
+  std::int64_t now = spinStart;
+  while (now < deadline) {
+    _mm_pause();
+    now = Timer::getCounter();
+  }
+  m_spinTotal += (now - spinStart) * m_secondsPerCount;
+
+  double const error = (now - deadline) * m_secondsPerCount;
+  m_errors[m_waits % HISTORY] = static_cast<float>(error * 1e6);
+  ++m_waits;
+  return error;
+}
+
+FramePacer::Stats FramePacer::getStats() const
+{
+  Stats stats;
+  stats.waits = m_waits;
+  stats.overshootMeanUs = m_overshootMean * 1e6;
+  stats.spinMarginUs = spinMargin() * 1e6;
+  if (m_waits == 0) {
+    return stats;
+  }
+
+  std::vector<float> errors(m_errors.begin(), m_errors.begin() + std::min<std::uint64_t>(m_waits, HISTORY));
+  std::sort(errors.begin(), errors.end());
+  double sum = 0.0;
+  for (float const error : errors) {
+    sum += error;
+  }
+  stats.errorMeanUs = sum / static_cast<double>(errors.size());
+  stats.errorP50Us = errors[(errors.size() - 1) / 2];
+  stats.errorP99Us = errors[(errors.size() - 1) * 99 / 100];
+  stats.errorMaxUs = errors.back();
+  stats.spinMeanUs = m_spinTotal / static_cast<double>(m_waits) * 1e6;
+  return stats;
+}
+} // namespace Core
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Core {
+// 帧节奏控制: 等待到截止时间时先粗略休眠, 在离截止时间还剩自旋余量时醒来, 再自旋到截止时间
+// 休眠的超时量 (实际休眠 - 请求休眠) 因平台, 系统计时器精度与负载而异, 由每次休眠自行测量,
+// 自旋余量取超时量的滑动均值加上 4 倍滑动平均偏差, 使绝大多数休眠在截止时间之前醒来
+// 截止时间使用 Timer::getCounter 的时间基准; Windows 上构造时把系统计时器精度提高到 1 ms, 析构时恢复
+class FramePacer
+{
+public:
+  static constexpr std::size_t HISTORY = 1024;      // 统计分位数时保留最近多少次等待
+  static constexpr double MIN_SPIN_MARGIN = 0.0002; // 自旋余量的下限 (s)
+  static constexpr double MAX_SPIN_MARGIN = 0.010;  // 自旋余量的上限 (s), 超时量再大也不会整帧自旋
+  static constexpr double MIN_SLEEP = 0.0005;       // 剩余时间减去余量后不足该值时直接自旋 (s)
+
+  struct Stats
+  {
+    std::uint64_t waits = 0;  // 已等待的次数
+    double errorMeanUs = 0.0; // 醒来时刻 - 截止时间, 以下均为最近 HISTORY 次等待
+    double errorP50Us = 0.0;
+    double errorP99Us = 0.0;
+    double errorMaxUs = 0.0;
+    double overshootMeanUs = 0.0; // 当前估计的休眠超时量
+    double spinMarginUs = 0.0;    // 当前的自旋余量
+    double spinMeanUs = 0.0;      // 平均每次等待的自旋时间, 即等待的 CPU 开销
+  };
+
+public:
+  FramePacer();
+  ~FramePacer();
+
+  FramePacer(FramePacer const&) = delete;
+  FramePacer& operator=(FramePacer const&) = delete;
+
+  // 等待到计数值 deadline, 返回醒来时超过截止时间的秒数 (截止时间已过时立即返回)
+  double waitUntil(std::int64_t deadline);
+
+  Stats getStats() const;
+
+private:
+  double spinMargin() const noexcept;
+
+private:
+  double m_secondsPerCount;
+  // 休眠超时量的滑动均值与滑动平均偏差 (s), 初值偏保守, 数次休眠后收敛
+  double m_overshootMean = 0.001;
+  double m_overshootDeviation = 0.0005;
+
+  std::array<float, HISTORY> m_errors{}; // 最近的等待误差 (us), 环形
+  std::uint64_t m_waits = 0;
+  double m_spinTotal = 0.0; // 累计自旋时间 (s)
+};
+} // namespace Core
@@ -0,0 +1,358 @@
+#include "JobSystem.hpp"
+#include "Logger.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <immintrin.h>
+
+namespace Core {
+
+namespace {
+// 当前线程作为工作线程所属的线程池与队列下标; 对其它线程池 (以及外部线程) 而言为 0 号队列
+thread_local JobSystem const* t_owner = nullptr;
+thread_local std::size_t t_queueIndex = 0;
+
+constexpr std::uint32_t spinsBeforeYield = 64; // 等待计数器时, 先用 pause 自旋, 之后改为让出时间片
+
+// 把当前线程固定在第 cpu 个逻辑处理器上
+bool pinCurrentThread(std::size_t cpu) noexcept
+{
+#if defined(_WIN32)
+  if (cpu >= sizeof(DWORD_PTR) * 8) {
+    return false;
+  }
+  return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#else
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+}
+
+void lockCounter(std::atomic<bool>& locked) noexcept
+{
+  while (locked.exchange(true, std::memory_order_acquire)) {
+    while (locked.load(std::memory_order_relaxed)) {
+      _mm_pause();
+    }
+  }
+}
+} // namespace
+
+JobSystem::JobSystem(std::size_t workerCount)
+  : JobSystem(Config{ .workerCount = workerCount })
+{
+}
+
+JobSystem::JobSystem(Config const& config)
+  : m_config(config)
+{
+  std::size_t workerCount = config.workerCount;
+  unsigned const hardwareThreads = std::thread::hardware_concurrency();
+  if (workerCount == 0) {
+    workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+  }
+
+  m_queues.reserve(workerCount + 1);
+  for (std::size_t i = 0; i <= workerCount; ++i) {
+    m_queues.push_back(std::make_unique<Queue>(QUEUE_CAPACITY));
+  }
+
+  m_workers.reserve(workerCount);
+  for (std::size_t i = 1; i <= workerCount; ++i) {
+    m_workers.emplace_back(&JobSystem::workerLoop, this, i);
+  }
+
+  LOG_INFO("JobSystem initialized with {} worker threads{}.",
+           workerCount,
+           config.affinity == Affinity::Pinned ? ", pinned" : "");
+}
+
+JobSystem::~JobSystem()
+{
+  m_stop.store(true, std::memory_order_seq_cst);
+  m_wakeEpoch.fetch_add(1, std::memory_order_release);
+  m_wakeEpoch.notify_all();
+
+  for (std::thread& worker : m_workers) {
+    worker.join();
+  }
+}
+
+std::size_t JobSystem::queueIndex() const noexcept
+{
+  return t_owner == this ? t_queueIndex : 0;
+}
+
+Detail::Job& JobSystem::allocateJob()
+{
+  // 环形分配, 向前跳过仍被占用的槽位 (例如 runAfter 挂起, 等待较慢依赖的任务), 槽位由 execute 释放
+  // 0 号任务池由外部线程共用, 每次探测都从共享下标取号, 用 exchange 占用槽位, 两个线程不会拿到同一个槽位
+  // 探测一整圈都被占用, 才说明任务池确实已满
+  std::size_t const index = queueIndex();
+  Queue& queue = *m_queues[index];
+  for (std::size_t probe = 0; probe < JOB_POOL_SIZE; ++probe) {
+    std::size_t const slot =
+      index == 0 ? m_externalNextJob.fetch_add(1, std::memory_order_relaxed) : queue.nextJob++;
+    Detail::Job& job = queue.jobs[slot & (JOB_POOL_SIZE - 1)];
+    if (!job.busy.load(std::memory_order_relaxed) && !job.busy.exchange(true, std::memory_order_acquire)) {
+      return job;
+    }
+  }
+
+  std::string const message = std::format(
+    "JobSystem job pool of queue {} exhausted: all {} jobs (JOB_POOL_SIZE) are still pending", index, JOB_POOL_SIZE);
+  LOG_ERROR(message);
+  throw std::runtime_error(message);
+}
+
+void JobSystem::submit(Detail::Job* const* jobs, std::size_t count)
+{
+  std::size_t const index = queueIndex();
+  Queue& queue = *m_queues[index];
+  std::size_t pushed = 0;
+  {
+    std::unique_lock<std::mutex> lock;
+    if (index == 0) {
+      lock = std::unique_lock(m_externalMutex);
+    }
+    while (pushed < count && queue.deque.push(jobs[pushed])) {
+      ++pushed;
+    }
+  }
+
+  // 入队之后再检查有没有休眠的线程; 与 idle 中先登记休眠再检查队列配对, 保证不会错过唤醒
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_sleepers.load(std::memory_order_relaxed) > 0) {
+    m_wakeEpoch.fetch_add(1, std::memory_order_release);
+    if (count == 1) {
+      m_wakeEpoch.notify_one();
+    } else {
+      m_wakeEpoch.notify_all();
+    }
+  }
+
+  // 队列已满时剩下的任务直接在当前线程执行
+  for (; pushed < count; ++pushed) {
+    execute(*jobs[pushed]);
+  }
+}
+
+bool JobSystem::deferUntil(JobCounter& dependency, Detail::Job& job) noexcept
+{
+  lockCounter(dependency.m_locked);
+  bool const pending = dependency.m_value.load(std::memory_order_acquire) > 0;
+  if (pending) {
+    job.next = dependency.m_waiters;
+    dependency.m_waiters = &job;
+  }
+  dependency.m_locked.store(false, std::memory_order_release);
+  return pending;
+}
+
+void JobSystem::complete(JobCounter& counter)
+{
+  // 不是最后一个任务时直接减 1; 最后一个任务在锁内归零并取走等待链表, 与 deferUntil 互斥
+  std::uint32_t value = counter.m_value.load(std::memory_order_relaxed);
+  while (true) {
+    if (value > 1) {
+      if (counter.m_value.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel)) {
+        return;
+      }
+      continue;
+    }
+
+    lockCounter(counter.m_locked);
+    value = 1;
+    if (counter.m_value.compare_exchange_strong(value, 0, std::memory_order_acq_rel)) {
+      break;
+    }
+    counter.m_locked.store(false, std::memory_order_release); // 期间又有新任务提交, 重试
+  }
+
+  Detail::Job* waiters = counter.m_waiters;
+  counter.m_waiters = nullptr;
+  // 解锁是对计数器的最后一次访问: wait 看到归零后还要获取一次锁才返回, 之后计数器才可能被销毁
+  counter.m_locked.store(false, std::memory_order_release);
+
+  while (waiters != nullptr) {
+    Detail::Job* const next = waiters->next;
+    submit(&waiters, 1);
+    waiters = next;
+  }
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+  std::size_t const self = queueIndex();
+  std::uint32_t spins = 0;
+  while (!counter.isDone()) {
+    if (Detail::Job* job = findJob(self)) {
+      execute(*job);
+      spins = 0;
+    } else if (++spins < spinsBeforeYield) {
+      _mm_pause();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  // 等待归零的线程释放计数器的锁
+  lockCounter(counter.m_locked);
+  counter.m_locked.store(false, std::memory_order_release);
+}
+
+void JobSystem::dispatch(std::size_t count, std::size_t grain, RangeFn fn, void* context)
+{
+  if (count == 0) {
+    return;
+  }
+
+  grain = std::max<std::size_t>(grain, 1);
+  std::size_t taskCount = (count + grain - 1) / grain;
+  if (taskCount > MAX_TASKS_PER_DISPATCH) {
+    grain = (count + MAX_TASKS_PER_DISPATCH - 1) / MAX_TASKS_PER_DISPATCH;
+    taskCount = (count + grain - 1) / grain;
+  }
+
+  // 只有一个任务或没有工作线程时, 直接在调用线程上执行
+  if (taskCount == 1 || m_workers.empty()) {
+    fn(context, 0, count);
+    return;
+  }
+
+  // 全部任务压入调用线程自己的队列, 其它线程来窃取
+  // 逆序压入, 使调用线程从队尾取任务时按下标升序执行, 窃取者从另一端拿走下标大的任务
+  JobCounter counter;
+  Detail::Job* jobs[MAX_TASKS_PER_DISPATCH];
+  for (std::size_t t = 0; t < taskCount; ++t) {
+    std::size_t const begin = (taskCount - 1 - t) * grain;
+    Detail::Job* allocated = nullptr;
+    try {
+      allocated = &allocateJob();
+    } catch (...) {
+      // 已分配的任务还没有提交, 释放它们的槽位后再抛出
+      for (std::size_t k = 0; k < t; ++k) {
+        jobs[k]->busy.store(false, std::memory_order_release);
+      }
+      throw;
+    }
+    Detail::Job& job = *allocated;
+    ::new (static_cast<void*>(job.data)) RangeTask{ fn, context, begin, std::min(begin + grain, count) };
+    job.fn = [](Detail::Job& self) noexcept {
+      RangeTask const& task = *std::launder(reinterpret_cast<RangeTask*>(self.data));
+      task.fn(task.context, task.begin, task.end);
+    };
+    job.counter = &counter;
+    job.next = nullptr;
+    jobs[t] = &job;
+  }
+  counter.m_value.store(static_cast<std::uint32_t>(taskCount), std::memory_order_relaxed);
+  submit(jobs, taskCount);
+
+  wait(counter);
+}
+
+void JobSystem::workerLoop(std::size_t index)
+{
+  t_owner = this;
+  t_queueIndex = index;
+  PROFILE_THREAD_NAME(std::format("Worker {}", index));
+
+  if (m_config.affinity == Affinity::Pinned) {
+    std::size_t const cpuCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    if (!pinCurrentThread(index % cpuCount)) {
+      LOG_WARN("JobSystem: failed to pin worker {} to CPU {}.", index, index % cpuCount);
+    }
+  }
+
+  while (!m_stop.load(std::memory_order_acquire)) {
+    if (Detail::Job* job = findJob(index)) {
+      execute(*job);
+    } else {
+      idle();
+    }
+  }
+}
+
+void JobSystem::idle()
+{
+  // 先自旋一小段时间: 一帧中的任务往往成批到来, 自旋可以省去休眠与唤醒的系统调用
+  for (std::uint32_t spin = 0; spin < m_config.idleSpins; ++spin) {
+    if (hasQueuedJobs() || m_stop.load(std::memory_order_relaxed)) {
+      return;
+    }
+    _mm_pause();
+  }
+
+  // 登记休眠后再检查一次队列, 与 submit 中先入队再检查休眠人数配对
+  m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+  std::uint32_t const epoch = m_wakeEpoch.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!hasQueuedJobs() && !m_stop.load(std::memory_order_acquire)) {
+    PROFILE_SCOPE("JobSystem::park");
+    m_wakeEpoch.wait(epoch, std::memory_order_acquire);
+  }
+  m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+Detail::Job* JobSystem::findJob(std::size_t index)
+{
+  Detail::Job* job = nullptr;
+
+  // 自己的队列: 0 号队列由外部线程共用, pop 需要加锁
+  Queue& own = *m_queues[index];
+  if (index == 0) {
+    std::lock_guard lock(m_externalMutex);
+    if (own.deque.pop(job)) {
+      return job;
+    }
+  } else if (own.deque.pop(job)) {
+    return job;
+  }
+
+  // 从下一个队列开始轮流窃取, 避免所有线程同时去抢同一个队列
+  std::size_t const queueCount = m_queues.size();
+  for (std::size_t offset = 1; offset < queueCount; ++offset) {
+    if (m_queues[(index + offset) % queueCount]->deque.steal(job)) {
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+bool JobSystem::hasQueuedJobs() const noexcept
+{
+  for (std::unique_ptr<Queue> const& queue : m_queues) {
+    if (!queue->deque.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void JobSystem::execute(Detail::Job& job)
+{
+  PROFILE_SCOPE("JobSystem::execute");
+  JobCounter* const counter = job.counter;
+  job.fn(job);
+  // 函数对象已析构 (任务函数均为 noexcept, 不会跳过这里), 释放槽位; 此后不能再访问 job, 它可能已被重新分配
+  job.busy.store(false, std::memory_order_release);
+  if (counter != nullptr) {
+    complete(*counter);
+  }
+}
+} // namespace Core
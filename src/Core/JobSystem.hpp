@@ -0,0 +1,213 @@
+#pragma once
+
+#include "Core/WorkStealingDeque.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Core {
+class JobCounter;
+
+namespace Detail {
+// 一个任务, 占一条缓存行; 函数对象 (或 parallelFor 的区间) 按值保存在 data 中
+struct alignas(64) Job
+{
+  static constexpr std::size_t DATA_SIZE = 32;
+
+  using Fn = void (*)(Job& job) noexcept;
+
+  Fn fn;
+  JobCounter* counter;             // 任务完成时减 1
+  Job* next;                       // 等待依赖时, 在依赖计数器的等待链表中的下一个任务
+  std::atomic<bool> busy{ false }; // 已分配且尚未执行完, 环形分配时跳过被占用的槽位
+  alignas(8) std::byte data[DATA_SIZE];
+};
+static_assert(sizeof(Job) == 64);
+} // namespace Detail
+
+// 任务计数器: 提交任务时加 1, 任务完成时减 1, 归零即表示这一组任务全部完成
+// 计数器可以作为其它任务的依赖 (JobSystem::runAfter), 归零时等待它的任务才被放入队列, 由此把一帧表示成一张小的任务图
+// 计数器必须在 JobSystem::wait 返回之后才能销毁
+class JobCounter
+{
+public:
+  JobCounter() = default;
+
+  JobCounter(JobCounter const&) = delete;
+  JobCounter& operator=(JobCounter const&) = delete;
+
+  bool isDone() const noexcept { return m_value.load(std::memory_order_acquire) == 0; }
+
+private:
+  friend class JobSystem;
+
+  std::atomic<std::uint32_t> m_value{ 0 };
+  std::atomic<bool> m_locked{ false }; // 保护 m_waiters, 归零与挂入等待链表互斥
+  Detail::Job* m_waiters = nullptr;    // 等待计数器归零的任务
+};
+
+// 工作窃取 (work-stealing) 线程池
+// 每个工作线程有自己的 Chase-Lev 无锁队列: 自己从队尾取任务 (LIFO, 缓存友好), 空闲时从其它队列的队首窃取任务 (FIFO)
+// 外部线程 (主线程, 模拟线程等) 共用 0 号队列, 它们之间的 push / pop 由互斥锁串行化, 窃取仍然无锁
+// 空闲的工作线程先自旋一段时间再休眠, 有新任务时只在确实有线程休眠时才发出唤醒 (系统调用)
+class JobSystem
+{
+public:
+  enum class Affinity
+  {
+    None,   // 由操作系统调度
+    Pinned, // 第 i 个工作线程固定在第 i 个逻辑处理器上 (0 号留给主线程), 减少迁移造成的缓存失效
+  };
+
+  struct Config
+  {
+    std::size_t workerCount = 0;        // 后台工作线程数, 0 表示 hardware_concurrency - 1 (调用线程也参与执行)
+    Affinity affinity = Affinity::None; // 工作线程的处理器亲和性
+    std::uint32_t idleSpins = 2048;     // 找不到任务时, 休眠前自旋检查的次数 (每次约几十纳秒)
+  };
+
+  static constexpr std::size_t QUEUE_CAPACITY = 4096; // 每个队列最多容纳的任务数 (2 的幂), 满时任务直接在提交线程执行
+  // 每个线程的任务池大小 (2 的幂); 同一线程 (外部线程合计) 未完成的任务, 包括 runAfter 挂起的任务, 不能超过该数
+  // 环形分配时跳过仍未执行完的槽位, 全部槽位都被占用时抛出 std::runtime_error
+  static constexpr std::size_t JOB_POOL_SIZE = 4096;
+
+  // parallelFor 一次最多切出的任务数, 超过时增大块长
+  static constexpr std::size_t MAX_TASKS_PER_DISPATCH = 1024;
+
+public:
+  explicit JobSystem(std::size_t workerCount = 0);
+  explicit JobSystem(Config const& config);
+  ~JobSystem();
+
+  JobSystem(JobSystem const&) = delete;
+  JobSystem& operator=(JobSystem const&) = delete;
+
+  // 参与并行执行的线程总数 (后台工作线程 + 调用线程)
+  std::size_t getThreadCount() const noexcept { return m_workers.size() + 1; }
+
+  // 提交一个任务 fn(), counter 加 1, 任务完成时减 1; 任务池的全部槽位都被占用时抛出 std::runtime_error
+  // fn 按值保存在任务中, 大小不超过 Detail::Job::DATA_SIZE (通常是捕获几个指针或引用的 lambda)
+  // fn 必须声明为 noexcept: 任务中途抛出的异常无处传递, 计数器将永远不能归零
+  template <typename F>
+  void run(JobCounter& counter, F&& fn)
+  {
+    Detail::Job& job = makeJob(counter, std::forward<F>(fn));
+    counter.m_value.fetch_add(1, std::memory_order_relaxed);
+    submit(job);
+  }
+
+  // 提交一个在 dependency 归零之后才开始执行的任务; dependency 已经为零时立即提交
+  // dependency 的任务应当先于依赖它的任务提交, 否则可能在它们提交之前就被视为已完成
+  template <typename F>
+  void runAfter(JobCounter& dependency, JobCounter& counter, F&& fn)
+  {
+    Detail::Job& job = makeJob(counter, std::forward<F>(fn));
+    counter.m_value.fetch_add(1, std::memory_order_relaxed);
+    if (!deferUntil(dependency, job)) {
+      submit(job);
+    }
+  }
+
+  // 等待 counter 归零, 调用线程在等待期间也会执行任务
+  void wait(JobCounter& counter);
+
+  // 把 [0, count) 按 grain 大小切块, 并行执行 fn(begin, end), 全部完成后才返回
+  // 调用线程在等待期间也会执行任务, fn 必须可以被多个线程同时调用; 可以在任务中嵌套调用
+  // 与 run 相同, fn 必须声明为 noexcept
+  template <typename F>
+  void parallelFor(std::size_t count, std::size_t grain, F&& fn)
+  {
+    static_assert(std::is_nothrow_invocable_v<F&, std::size_t, std::size_t>, "job functions must be noexcept");
+    auto invoke = [](void* context, std::size_t begin, std::size_t end) noexcept {
+      (*static_cast<std::remove_reference_t<F>*>(context))(begin, end);
+    };
+    dispatch(count, grain, invoke, const_cast<void*>(static_cast<void const*>(&fn)));
+  }
+
+private:
+  using RangeFn = void (*)(void* context, std::size_t begin, std::size_t end) noexcept;
+
+  struct RangeTask
+  {
+    RangeFn fn;
+    void* context;
+    std::size_t begin;
+    std::size_t end;
+  };
+
+  // 队列 0 属于所有外部线程, 队列 i (i >= 1) 属于第 i 个工作线程
+  struct Queue
+  {
+    explicit Queue(std::size_t capacity)
+      : deque(capacity)
+    {
+    }
+
+    WorkStealingDeque<Detail::Job*> deque;
+    std::unique_ptr<Detail::Job[]> jobs = std::make_unique<Detail::Job[]>(JOB_POOL_SIZE); // 环形任务池
+    std::size_t nextJob = 0; // 只由拥有者使用; 外部线程使用 m_externalNextJob
+  };
+
+  template <typename F>
+  Detail::Job& makeJob(JobCounter& counter, F&& fn)
+  {
+    using Fn = std::decay_t<F>;
+    static_assert(sizeof(Fn) <= Detail::Job::DATA_SIZE && alignof(Fn) <= 8, "job function object is too large");
+    static_assert(std::is_nothrow_invocable_v<Fn&>, "job functions must be noexcept");
+
+    Detail::Job& job = allocateJob();
+    ::new (static_cast<void*>(job.data)) Fn(std::forward<F>(fn));
+    job.fn = [](Detail::Job& self) noexcept {
+      Fn& target = *std::launder(reinterpret_cast<Fn*>(self.data));
+      target();
+      target.~Fn();
+    };
+    job.counter = &counter;
+    job.next = nullptr;
+    return job;
+  }
+
+  std::size_t queueIndex() const noexcept;
+  // 从当前线程的任务池取下一个槽位并标记为占用, 该槽位的任务尚未执行完时抛出 std::runtime_error
+  Detail::Job& allocateJob();
+  // 把任务放入当前线程的队列并唤醒休眠的工作线程
+  void submit(Detail::Job* const* jobs, std::size_t count);
+  void submit(Detail::Job& job)
+  {
+    Detail::Job* const jobs[] = { &job };
+    submit(jobs, 1);
+  }
+  // dependency 尚未归零时把 job 挂到它的等待链表上并返回 true
+  bool deferUntil(JobCounter& dependency, Detail::Job& job) noexcept;
+  void complete(JobCounter& counter);
+
+  void dispatch(std::size_t count, std::size_t grain, RangeFn fn, void* context);
+  void workerLoop(std::size_t index);
+  void idle();
+
+  Detail::Job* findJob(std::size_t index);
+  bool hasQueuedJobs() const noexcept;
+  void execute(Detail::Job& job);
+
+private:
+  Config m_config;
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::vector<std::thread> m_workers;
+
+  std::mutex m_externalMutex;                    // 串行化外部线程对 0 号队列的 push / pop
+  std::atomic<std::size_t> m_externalNextJob{ 0 }; // 外部线程共用的任务池下标
+
+  // 休眠: 工作线程等待 m_wakeEpoch 变化, 提交任务时若 m_sleepers 非零则推进并通知
+  alignas(64) std::atomic<std::uint32_t> m_wakeEpoch{ 0 };
+  std::atomic<std::uint32_t> m_sleepers{ 0 };
+  std::atomic<bool> m_stop{ false };
+};
+} // namespace Core
@@ -0,0 +1,221 @@
+#include "Logger.hpp"
+
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Core {
+
+namespace {
+// 后台线程空闲时的轮询间隔
+constexpr auto idleInterval = std::chrono::milliseconds(1);
+
+struct AsyncState
+{
+  std::mutex ringMutex; // 保护 rings 的登记与回收
+  std::vector<std::unique_ptr<Detail::LogRing>> rings;
+  std::mutex drainMutex; // 同一时刻只有一个线程 (后台线程或 flush 的调用者) 读取缓冲区
+  std::ostream* os = &std::cout;
+  std::thread worker;
+  std::atomic<bool> stopRequested{ false };
+  std::atomic<std::uint64_t> dropped{ 0 };
+  std::uint64_t reportedDropped = 0;
+  // 把 steady_clock 计数换算为系统时间的基准
+  std::chrono::steady_clock::time_point steadyBase;
+  std::chrono::system_clock::time_point systemBase;
+
+  // 未调用 stopAsync 就退出 (如初始化时抛出异常) 时, 在静态析构中停止后台线程
+  ~AsyncState()
+  {
+    if (worker.joinable()) {
+      stopRequested.store(true, std::memory_order_release);
+      worker.join();
+    }
+  }
+};
+
+AsyncState& asyncState()
+{
+  static AsyncState state;
+  return state;
+}
+
+// 一条格式化好的日志, 排序后一次写出
+struct PendingLine
+{
+  std::int64_t timestamp;
+  std::string text;
+};
+
+std::string formatLine(AsyncState const& state,
+                       std::int64_t timestamp,
+                       Logger::LogLevel level,
+                       std::string_view message,
+                       std::uint32_t suppressed)
+{
+  auto const time =
+    state.systemBase + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                         std::chrono::steady_clock::duration(timestamp) - state.steadyBase.time_since_epoch());
+  std::string line = std::format("{} [{}] {}", Logger::formatTime(time), Logger::getLevelName(level), message);
+  if (suppressed > 0) {
+    line += std::format(" ({} similar messages suppressed)", suppressed);
+  }
+  line += '\n';
+  return line;
+}
+
+// 读出全部缓冲区中已写入的日志, 按时间戳排序后写出; 返回写出的条数. 调用者持有 drainMutex
+std::size_t drainRings(AsyncState& state)
+{
+  std::vector<PendingLine> lines;
+  std::string message;
+  {
+    std::lock_guard lock(state.ringMutex);
+    for (std::unique_ptr<Detail::LogRing> const& ring : state.rings) {
+      std::uint64_t const head = ring->head.load(std::memory_order_acquire);
+      std::uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+      for (; tail != head; ++tail) {
+        Detail::LogRecord const& record = ring->records[tail & (Detail::LogRing::CAPACITY - 1)];
+        record.format(record, message);
+        lines.push_back(
+          { record.timestamp, formatLine(state, record.timestamp, record.level, message, record.suppressed) });
+      }
+      ring->tail.store(tail, std::memory_order_release);
+    }
+    // 线程退出后留下的缓冲区已排空, 回收
+    std::erase_if(state.rings, [](std::unique_ptr<Detail::LogRing> const& ring) {
+      return ring->retired.load(std::memory_order_acquire) &&
+             ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire);
+    });
+  }
+
+  std::uint64_t const dropped = state.dropped.load(std::memory_order_relaxed);
+  if (dropped != state.reportedDropped) {
+    std::int64_t const now = std::chrono::steady_clock::now().time_since_epoch().count();
+    std::string const text = std::format("{} log messages dropped (ring buffer full)", dropped - state.reportedDropped);
+    lines.push_back({ now, formatLine(state, now, Logger::LogLevel::WARN_, text, 0) });
+    state.reportedDropped = dropped;
+  }
+  if (lines.empty()) {
+    return 0;
+  }
+
+  // 各线程的缓冲区分别有序, 合并后按时间戳排序
+  std::stable_sort(lines.begin(), lines.end(), [](PendingLine const& a, PendingLine const& b) {
+    return a.timestamp < b.timestamp;
+  });
+  std::string output;
+  for (PendingLine const& line : lines) {
+    output += line.text;
+  }
+  *state.os << output << std::flush;
+  return lines.size();
+}
+
+void workerLoop(AsyncState& state)
+{
+  while (!state.stopRequested.load(std::memory_order_acquire)) {
+    std::size_t written;
+    {
+      std::lock_guard lock(state.drainMutex);
+      written = drainRings(state);
+    }
+    if (written == 0) {
+      std::this_thread::sleep_for(idleInterval);
+    }
+  }
+}
+
+// 线程退出时标记其缓冲区, 由后台线程排空后回收
+struct ThreadRingOwner
+{
+  Detail::LogRing* ring = nullptr;
+
+  ~ThreadRingOwner()
+  {
+    if (ring != nullptr) {
+      ring->retired.store(true, std::memory_order_release);
+    }
+  }
+};
+} // namespace
+
+Detail::LogRing& Detail::threadLogRing()
+{
+  thread_local ThreadRingOwner owner;
+  if (owner.ring == nullptr) {
+    auto ring = std::make_unique<LogRing>();
+    owner.ring = ring.get();
+    AsyncState& state = asyncState();
+    std::lock_guard lock(state.ringMutex);
+    state.rings.push_back(std::move(ring));
+  }
+  return *owner.ring;
+}
+
+void Detail::countDroppedLog() noexcept
+{
+  asyncState().dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Logger::startAsync(std::ostream& os)
+{
+  if (isAsync()) {
+    return;
+  }
+  AsyncState& state = asyncState();
+  state.os = &os;
+  state.steadyBase = std::chrono::steady_clock::now();
+  state.systemBase = std::chrono::system_clock::now();
+  state.stopRequested.store(false, std::memory_order_relaxed);
+  state.worker = std::thread(workerLoop, std::ref(state));
+  s_asyncRunning.store(true, std::memory_order_release);
+}
+
+void Logger::stopAsync()
+{
+  if (!isAsync()) {
+    return;
+  }
+  // 先切回同步路径, 之后的日志不再进入缓冲区, 再排空已有的日志
+  // 关闭前已读到 isAsync 为真的调用者仍可能入队, 它们入队后会再检查一次并自己排空 (见 Logger::write)
+  s_asyncRunning.store(false, std::memory_order_release);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  AsyncState& state = asyncState();
+  state.stopRequested.store(true, std::memory_order_release);
+  state.worker.join();
+  flush();
+}
+
+void Logger::flush()
+{
+  AsyncState& state = asyncState();
+  std::lock_guard lock(state.drainMutex);
+  drainRings(state);
+}
+
+std::uint64_t Logger::getDroppedCount() noexcept
+{
+  return asyncState().dropped.load(std::memory_order_relaxed);
+}
+
+void Logger::writeSync(LogLevel level, std::string_view message, std::uint32_t suppressed)
+{
+  std::string line = std::format("{} [{}] {}", getCurrentTime(), getLevelName(level), message);
+  if (suppressed > 0) {
+    line += std::format(" ({} similar messages suppressed)", suppressed);
+  }
+  line += '\n';
+
+  if (!isAsync()) {
+    std::cout << line;
+    return;
+  }
+  // 异步后端运行时先写出缓冲区中更早的日志, 再与后台线程写入同一个流
+  AsyncState& state = asyncState();
+  std::lock_guard lock(state.drainMutex);
+  drainRings(state);
+  *state.os << line << std::flush;
+}
+} // namespace Core
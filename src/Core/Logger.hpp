@@ -1,11 +1,43 @@
 #pragma once
 
+#include "Core/Platform.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <format>
 #include <iostream>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// 编译期日志级别: 低于该级别的 LOG_* 调用连同参数的求值一起被去除 (0 DEBUG, 1 INFO, 2 WARN, 3 ERROR)
+// 由 CMake 选项 TOUHOU_LOG_LEVEL 设置, 未设置时 Debug 构建保留全部级别, Release 构建去除 DEBUG
+#if !defined(TOUHOU_LOG_LEVEL)
+#if defined(NDEBUG)
+#define TOUHOU_LOG_LEVEL 1
+#else
+#define TOUHOU_LOG_LEVEL 0
+#endif
+#endif
 
 namespace Core {
+// 一个 LOG_* 调用点的限流状态, 由日志宏在每个调用点定义为静态变量
+// 每个调用点每秒最多输出 limit 条, 其余丢弃并计数, 在该调用点下一条输出的日志末尾报告; ERROR 及以上级别不限流
+struct LogSite
+{
+  std::uint32_t limit = 20;
+  std::atomic<std::int64_t> windowStart{ 0 }; // 当前一秒窗口的起点 (steady_clock 计数)
+  std::atomic<std::uint32_t> windowCount{ 0 };
+  std::atomic<std::uint32_t> suppressed{ 0 };
+};
+
 class Logger
 {
 public:
@@ -34,46 +66,283 @@ public:
     }
   }
 
+  // ---- 异步后端 ----
+  // 启动后, ERROR 以下级别的 LOG_* 调用只把级别, 时间戳计数, 格式串与参数写入调用线程自己的无锁环形缓冲区,
+  // 由后台线程统一格式化并写入 os; 缓冲区满时丢弃并计数, 调用线程从不阻塞
+  // ERROR 及以上级别 (随后通常抛出异常) 先排空缓冲区, 再在调用线程上同步写出, 保证不丢失且顺序正确
+  // 未启动时所有级别都同步写入 std::cout, 与原来的行为相同
+  static void startAsync(std::ostream& os = std::cout);
+  // 排空全部缓冲区后停止后台线程
+  static void stopAsync();
+  // 在调用线程上排空全部缓冲区并写出
+  static void flush();
+  static bool isAsync() noexcept { return s_asyncRunning.load(std::memory_order_relaxed); }
+  // 因缓冲区满而丢弃的日志条数 (累计)
+  static std::uint64_t getDroppedCount() noexcept;
+
+  // LOG_* 宏的入口: 限流后按 std::format 的格式串与参数写一条日志, 格式串在编译期检查
+  // 字符串参数被复制进缓冲区 (过长时截断, 以 "..." 结尾), 其余参数必须可平凡复制, 在后台线程上才格式化
+  template <auto VLogLevel, typename... Args>
+    requires(sizeof...(Args) > 0)
+  static void write(LogSite& site, std::format_string<Args...> format, Args&&... args);
+  // 单个参数为整条消息 (如 LOG_ERROR(message) 后抛出同一条消息), 不做格式化
+  // 异步时整条消息与其它字符串参数一样受 LogRecord::PAYLOAD_SIZE 限制, 带参数的日志应使用格式串写法
+  template <auto VLogLevel>
+  static void write(LogSite& site, std::string_view message)
+  {
+    write<VLogLevel>(site, "{}", std::move(message));
+  }
+
+  static std::string_view getLevelName(LogLevel level) noexcept
+  {
+    switch (level) {
+      case LogLevel::DEBUG_:
+        return getEnumName<LogLevel::DEBUG_>();
+      case LogLevel::INFO_:
+        return getEnumName<LogLevel::INFO_>();
+      case LogLevel::WARN_:
+        return getEnumName<LogLevel::WARN_>();
+      case LogLevel::ERROR_:
+        return getEnumName<LogLevel::ERROR_>();
+      case LogLevel::FATAL_:
+        return getEnumName<LogLevel::FATAL_>();
+      case LogLevel::DX11_ERROR_:
+        return getEnumName<LogLevel::DX11_ERROR_>();
+    }
+    return {};
+  }
+
+  static std::string formatTime(std::chrono::system_clock::time_point time) noexcept
+  {
+    using namespace std::chrono;
+
+    auto const ms = duration_cast<milliseconds>(time.time_since_epoch()) % 1000ms;
+    std::time_t const time_t_value = system_clock::to_time_t(time);
+
+    std::tm time_tm{};
+    localTime(time_t_value, time_tm);
+
+    return std::format("{:04}-{:02}-{:02} {:02}:{:02}:{:02}.{:03}",
+                       time_tm.tm_year + 1900,
+                       time_tm.tm_mon + 1,
+                       time_tm.tm_mday,
+                       time_tm.tm_hour,
+                       time_tm.tm_min,
+                       time_tm.tm_sec,
+                       ms.count());
+  }
+
 private:
   template <auto V>
   static constexpr std::string_view getEnumName() noexcept
   {
-    constexpr std::string_view sig = __FUNCSIG__;
-    constexpr std::string_view prefix = "<Core::Logger::LogLevel::";
-    constexpr std::string_view suffix = "_>(void) noexcept";
+    // 签名中模板实参的写法因编译器而异, 例如
+    // MSVC:  "... getEnumName<Core::Logger::LogLevel::INFO_>(void) noexcept"
+    // GCC:   "... getEnumName() [with auto V = Core::Logger::LogLevel::INFO_; ...]"
+    // 取前缀之后的标识符, 去掉末尾的 '_'
+    constexpr std::string_view sig = TOUHOU_FUNCSIG;
+    constexpr std::string_view prefix = "Core::Logger::LogLevel::";
+    constexpr std::string_view identifier = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_";
 
     std::size_t start = sig.find(prefix) + prefix.size();
-    std::size_t end = sig.rfind(suffix);
+    std::size_t end = sig.find_first_not_of(identifier, start) - 1;
 
     return sig.substr(start, end - start);
   }
 
-  static std::string getCurrentTime() noexcept
+  static std::string getCurrentTime() noexcept { return formatTime(std::chrono::system_clock::now()); }
+
+  // 限流: 通过时返回 true, 并取出该调用点此前被丢弃的条数
+  static bool acquireSite(LogSite& site, std::int64_t now, std::uint32_t& suppressed) noexcept
   {
-    using namespace std::chrono;
+    constexpr std::int64_t window = std::chrono::steady_clock::duration(std::chrono::seconds(1)).count();
+    std::int64_t start = site.windowStart.load(std::memory_order_relaxed);
+    if (now - start >= window && site.windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+      site.windowCount.store(0, std::memory_order_relaxed);
+    }
+    if (site.windowCount.fetch_add(1, std::memory_order_relaxed) >= site.limit) {
+      site.suppressed.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+  }
 
-    auto const now = system_clock::now();
-    auto const ms = duration_cast<milliseconds>(now.time_since_epoch()) % 1000ms;
-    std::time_t const now_time_t = system_clock::to_time_t(now);
+  // 同步路径: 排空异步缓冲区后在调用线程上写出
+  static void writeSync(LogLevel level, std::string_view message, std::uint32_t suppressed);
 
-    std::tm now_tm{};
-    localtime_s(&now_tm, &now_time_t);
+private:
+  static inline std::atomic<bool> s_asyncRunning{ false };
+};
 
-    return std::format("{:04}-{:02}-{:02} {:02}:{:02}:{:02}.{:03}",
-                       now_tm.tm_year + 1900,
-                       now_tm.tm_mon + 1,
-                       now_tm.tm_mday,
-                       now_tm.tm_hour,
-                       now_tm.tm_min,
-                       now_tm.tm_sec,
-                       ms.count());
-  }
+namespace Detail {
+// 缓冲区中的一条日志, 固定 256 字节; 参数按顺序紧凑地写入 payload, 由 format 还原并格式化
+struct LogRecord
+{
+  static constexpr std::size_t PAYLOAD_SIZE = 216;
+
+  using FormatFn = void (*)(LogRecord const& record, std::string& out);
+
+  FormatFn format;
+  char const* formatString; // 格式串为字面量, 地址一直有效
+  std::int64_t timestamp;   // steady_clock 计数
+  std::uint32_t formatSize;
+  std::uint32_t suppressed;
+  Logger::LogLevel level;
+  std::byte payload[PAYLOAD_SIZE];
 };
+static_assert(sizeof(LogRecord) == 256);
+
+// 调用线程的单生产者单消费者环形缓冲区, 第一次写日志时分配并登记到后台
+struct LogRing
+{
+  static constexpr std::size_t CAPACITY = 1024; // 条数, 2 的幂
+
+  std::array<LogRecord, CAPACITY> records;
+  alignas(64) std::atomic<std::uint64_t> head{ 0 }; // 生产者写入的下一条
+  alignas(64) std::atomic<std::uint64_t> tail{ 0 }; // 消费者读取的下一条
+  std::atomic<bool> retired{ false };               // 所属线程已退出, 排空后回收
+};
+
+// 调用线程的缓冲区 (首次调用时创建)
+LogRing& threadLogRing();
+// 缓冲区满时计数
+void countDroppedLog() noexcept;
+
+template <typename T>
+inline constexpr bool IsLogString = std::is_convertible_v<T const&, std::string_view>;
+
+// 参数在缓冲区中的存放类型: 字符串存为长度加字符, 读出时为指向 payload 的 string_view
+template <typename T>
+using LogStored = std::conditional_t<IsLogString<std::decay_t<T>>, std::string_view, std::decay_t<T>>;
+
+template <typename T>
+inline constexpr std::size_t LogFixedSize = IsLogString<std::decay_t<T>> ? sizeof(std::uint32_t) : sizeof(T);
+
+inline constexpr std::string_view LogTruncationMarker = "...";
+
+template <typename T>
+void encodeLogArg(std::byte*& cursor, std::size_t& stringBudget, T const& value) noexcept
+{
+  if constexpr (IsLogString<T>) {
+    std::string_view const text = value;
+    std::size_t size = std::min(text.size(), stringBudget);
+    std::size_t marker = 0;
+    // 放不下时截断, 末尾留出标记的位置, 并退到 UTF-8 字符的边界上
+    if (size < text.size()) {
+      marker = std::min(LogTruncationMarker.size(), stringBudget);
+      size = stringBudget - marker;
+      while (size > 0 && (static_cast<unsigned char>(text[size]) & 0xC0) == 0x80) {
+        --size;
+      }
+    }
+    std::uint32_t const stored = static_cast<std::uint32_t>(size + marker);
+    stringBudget -= stored;
+    std::memcpy(cursor, &stored, sizeof(stored));
+    std::memcpy(cursor + sizeof(stored), text.data(), size);
+    std::memcpy(cursor + sizeof(stored) + size, LogTruncationMarker.data(), marker);
+    cursor += sizeof(stored) + stored;
+  } else {
+    static_assert(std::is_trivially_copyable_v<T>, "Async log arguments must be strings or trivially copyable.");
+    std::memcpy(cursor, &value, sizeof(T));
+    cursor += sizeof(T);
+  }
+}
+
+template <typename T>
+T decodeLogArg(std::byte const*& cursor) noexcept
+{
+  if constexpr (std::is_same_v<T, std::string_view>) {
+    std::uint32_t size;
+    std::memcpy(&size, cursor, sizeof(size));
+    std::string_view const text(reinterpret_cast<char const*>(cursor + sizeof(size)), size);
+    cursor += sizeof(size) + size;
+    return text;
+  } else {
+    T value;
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return value;
+  }
+}
+
+template <typename... Stored>
+void formatLogRecord(LogRecord const& record, std::string& out)
+{
+  std::byte const* cursor = record.payload;
+  // 花括号初始化保证按从左到右的顺序读出
+  std::tuple<Stored...> args{ decodeLogArg<Stored>(cursor)... };
+  std::apply(
+    [&](auto&... values) {
+      out = std::vformat(std::string_view(record.formatString, record.formatSize), std::make_format_args(values...));
+    },
+    args);
+}
+} // namespace Detail
+
+template <auto VLogLevel, typename... Args>
+  requires(sizeof...(Args) > 0)
+void Logger::write(LogSite& site, std::format_string<Args...> format, Args&&... args)
+{
+  std::int64_t const now = std::chrono::steady_clock::now().time_since_epoch().count();
+  std::uint32_t suppressed = 0;
+  // ERROR 及以上级别不限流: 它们之后通常紧跟着抛出异常, 必须写出
+  if constexpr (VLogLevel < LogLevel::ERROR_) {
+    if (!acquireSite(site, now, suppressed)) {
+      return;
+    }
+  }
+
+  if (VLogLevel >= LogLevel::ERROR_ || !isAsync()) {
+    writeSync(VLogLevel, std::format(format, std::forward<Args>(args)...), suppressed);
+    return;
+  }
+
+  Detail::LogRing& ring = Detail::threadLogRing();
+  std::uint64_t const head = ring.head.load(std::memory_order_relaxed);
+  if (head - ring.tail.load(std::memory_order_acquire) == Detail::LogRing::CAPACITY) {
+    Detail::countDroppedLog();
+    return;
+  }
+
+  constexpr std::size_t fixedSize = (Detail::LogFixedSize<Args> + ...);
+  static_assert(fixedSize <= Detail::LogRecord::PAYLOAD_SIZE, "Too many async log arguments.");
+  std::string_view const formatString = format.get();
+
+  Detail::LogRecord& record = ring.records[head & (Detail::LogRing::CAPACITY - 1)];
+  record.format = &Detail::formatLogRecord<Detail::LogStored<Args>...>;
+  record.formatString = formatString.data();
+  record.formatSize = static_cast<std::uint32_t>(formatString.size());
+  record.timestamp = now;
+  record.suppressed = suppressed;
+  record.level = VLogLevel;
+  std::byte* cursor = record.payload;
+  std::size_t stringBudget = Detail::LogRecord::PAYLOAD_SIZE - fixedSize; // 各字符串按顺序分配剩余空间
+  (Detail::encodeLogArg(cursor, stringBudget, args), ...);
+  ring.head.store(head + 1, std::memory_order_release);
+
+  // stopAsync 可能在上面读取 isAsync 之后才关闭异步后端, 它最后一次排空时未必看得到这一条;
+  // 入队后再检查一次, 已关闭时自己排空 (与 stopAsync 中关闭后的屏障配对, 两边至少有一方看到对方的写入)
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!isAsync()) {
+    flush();
+  }
+}
 } // namespace Core
 
-#define LOG_DEBUG(msg) ::Core::Logger::log<Core::Logger::LogLevel::DEBUG_>(msg)
-#define LOG_INFO(msg) ::Core::Logger::log<Core::Logger::LogLevel::INFO_>(msg)
-#define LOG_WARN(msg) ::Core::Logger::log<Core::Logger::LogLevel::WARN_>(msg)
-#define LOG_ERROR(msg) ::Core::Logger::log<Core::Logger::LogLevel::ERROR_>(msg)
-#define LOG_FATAL(msg) ::Core::Logger::log<Core::Logger::LogLevel::FATAL_>(msg)
+// 低于 TOUHOU_LOG_LEVEL 的调用在编译期去除; 每个调用点各有一个限流状态
+#define TOUHOU_LOG_AT(level, ...)                                                                                      \
+  do {                                                                                                                 \
+    if constexpr (static_cast<int>(level) >= TOUHOU_LOG_LEVEL) {                                                       \
+      static ::Core::LogSite touhouLogSite;                                                                            \
+      ::Core::Logger::write<level>(touhouLogSite, __VA_ARGS__);                                                        \
+    }                                                                                                                  \
+  } while (false)
+
+// 用法: LOG_INFO("message") 或 LOG_INFO("{} bullets dropped", count), 参数在后台线程上才格式化
+#define LOG_DEBUG(...) TOUHOU_LOG_AT(::Core::Logger::LogLevel::DEBUG_, __VA_ARGS__)
+#define LOG_INFO(...) TOUHOU_LOG_AT(::Core::Logger::LogLevel::INFO_, __VA_ARGS__)
+#define LOG_WARN(...) TOUHOU_LOG_AT(::Core::Logger::LogLevel::WARN_, __VA_ARGS__)
+#define LOG_ERROR(...) TOUHOU_LOG_AT(::Core::Logger::LogLevel::ERROR_, __VA_ARGS__)
+#define LOG_FATAL(...) TOUHOU_LOG_AT(::Core::Logger::LogLevel::FATAL_, __VA_ARGS__)
 #define LOG_DX11_CHECK(hr, msg) ::Core::Logger::checkDX11(hr, msg)
@@ -0,0 +1,170 @@
+#include "MathUtils.hpp"
+#include "Simd.hpp"
+
+#include <cstdint>
+
+namespace Core::Math {
+
+namespace {
+#if defined(TOUHOU_SIMD_AVX2)
+using FloatV = __m256;
+
+__forceinline void sincosTableV(float const* radians, FloatV& outSin, FloatV& outCos) noexcept
+{
+  // 与 DefaultTrigTable::sin/cos 相同的截断取整与查表
+  __m256i const index = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_loadu_ps(radians), _mm256_set1_ps(RadToIndex)));
+  __m256i const mask = _mm256_set1_epi32(DefaultTrigTable::MASK);
+  __m256i const quarter = _mm256_set1_epi32(DefaultTrigTable::QUARTER);
+  outSin = _mm256_i32gather_ps(sinTable.data(), _mm256_and_si256(index, mask), 4);
+  outCos = _mm256_i32gather_ps(sinTable.data(), _mm256_and_si256(_mm256_add_epi32(index, quarter), mask), 4);
+}
+
+// 运算顺序与 sincosPoly 完全相同, 不使用 FMA
+__forceinline void sincosPolyV(float const* radians, FloatV& outSin, FloatV& outCos) noexcept
+{
+  __m256 const x = _mm256_loadu_ps(radians);
+  __m256i const quadrant = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(TwoOverPi))); // 就近舍入, 同 nearbyint
+  __m256 const q = _mm256_cvtepi32_ps(quadrant);
+  __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(q, _mm256_set1_ps(PiOver2A)));
+  r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(PiOver2B)));
+  r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(PiOver2C)));
+
+  __m256 const r2 = _mm256_mul_ps(r, r);
+  __m256 s = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(SinC3), r2), _mm256_set1_ps(SinC2));
+  s = _mm256_add_ps(_mm256_mul_ps(s, r2), _mm256_set1_ps(SinC1));
+  s = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(s, r2), r), r);
+  __m256 c = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(CosC3), r2), _mm256_set1_ps(CosC2));
+  c = _mm256_add_ps(_mm256_mul_ps(c, r2), _mm256_set1_ps(CosC1));
+  c = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(c, r2), r2), _mm256_mul_ps(_mm256_set1_ps(0.5f), r2));
+  c = _mm256_add_ps(c, _mm256_set1_ps(1.0f));
+
+  // 按象限交换 sin / cos 并设置符号位
+  __m256i const one = _mm256_set1_epi32(1);
+  __m256i const two = _mm256_set1_epi32(2);
+  __m256 const swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, one), one));
+  __m256 const sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, two), 30));
+  __m256 const cosSign =
+    _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, one), two), 30));
+  outSin = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sinSign);
+  outCos = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosSign);
+}
+
+__forceinline void store(float* out, FloatV value) noexcept
+{
+  _mm256_storeu_ps(out, value);
+}
+#elif defined(TOUHOU_SIMD_SSE2)
+using FloatV = __m128;
+
+__forceinline void sincosTableV(float const* radians, FloatV& outSin, FloatV& outCos) noexcept
+{
+  // SSE2 没有 gather 指令, 下标算好后逐通道查表
+  alignas(16) std::int32_t index[4];
+  _mm_store_si128(reinterpret_cast<__m128i*>(index),
+                  _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(radians), _mm_set1_ps(RadToIndex))));
+  constexpr int mask = DefaultTrigTable::MASK;
+  constexpr int quarter = DefaultTrigTable::QUARTER;
+  outSin = _mm_setr_ps(
+    sinTable[index[0] & mask], sinTable[index[1] & mask], sinTable[index[2] & mask], sinTable[index[3] & mask]);
+  outCos = _mm_setr_ps(sinTable[(index[0] + quarter) & mask],
+                       sinTable[(index[1] + quarter) & mask],
+                       sinTable[(index[2] + quarter) & mask],
+                       sinTable[(index[3] + quarter) & mask]);
+}
+
+// SSE2 没有 blendv, 用与/或运算按掩码选择
+__forceinline __m128 select(__m128 mask, __m128 ifTrue, __m128 ifFalse) noexcept
+{
+  return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+}
+
+__forceinline void sincosPolyV(float const* radians, FloatV& outSin, FloatV& outCos) noexcept
+{
+  __m128 const x = _mm_loadu_ps(radians);
+  __m128i const quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TwoOverPi)));
+  __m128 const q = _mm_cvtepi32_ps(quadrant);
+  __m128 r = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(PiOver2A)));
+  r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(PiOver2B)));
+  r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(PiOver2C)));
+
+  __m128 const r2 = _mm_mul_ps(r, r);
+  __m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SinC3), r2), _mm_set1_ps(SinC2));
+  s = _mm_add_ps(_mm_mul_ps(s, r2), _mm_set1_ps(SinC1));
+  s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, r2), r), r);
+  __m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(CosC3), r2), _mm_set1_ps(CosC2));
+  c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(CosC1));
+  c = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(c, r2), r2), _mm_mul_ps(_mm_set1_ps(0.5f), r2));
+  c = _mm_add_ps(c, _mm_set1_ps(1.0f));
+
+  __m128i const one = _mm_set1_epi32(1);
+  __m128i const two = _mm_set1_epi32(2);
+  __m128 const swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+  __m128 const sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+  __m128 const cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+  outSin = _mm_xor_ps(select(swap, c, s), sinSign);
+  outCos = _mm_xor_ps(select(swap, s, c), cosSign);
+}
+
+__forceinline void store(float* out, FloatV value) noexcept
+{
+  _mm_storeu_ps(out, value);
+}
+#endif
+
+// 公共的批量驱动: 按向量宽度处理主体, 尾部交给标量函数; outSin / outCos 为空时不写入
+void sincosDriver(float const* radians, float* outSin, float* outCos, std::size_t count, TrigMethod method) noexcept
+{
+  std::size_t i = 0;
+#if !defined(TOUHOU_SIMD_SCALAR)
+  constexpr std::size_t lanes = Simd::FloatLanes;
+  for (; i + lanes <= count; i += lanes) {
+    FloatV s;
+    FloatV c;
+    if (method == TrigMethod::Table) {
+      sincosTableV(radians + i, s, c);
+    } else {
+      sincosPolyV(radians + i, s, c);
+    }
+    if (outSin) {
+      store(outSin + i, s);
+    }
+    if (outCos) {
+      store(outCos + i, c);
+    }
+  }
+#endif
+
+  for (; i < count; ++i) {
+    float s;
+    float c;
+    if (method == TrigMethod::Table) {
+      s = sin(radians[i]);
+      c = cos(radians[i]);
+    } else {
+      sincosPoly(radians[i], s, c);
+    }
+    if (outSin) {
+      outSin[i] = s;
+    }
+    if (outCos) {
+      outCos[i] = c;
+    }
+  }
+}
+} // namespace
+
+void sinBatch(float const* radians, float* out, std::size_t count, TrigMethod method) noexcept
+{
+  sincosDriver(radians, out, nullptr, count, method);
+}
+
+void cosBatch(float const* radians, float* out, std::size_t count, TrigMethod method) noexcept
+{
+  sincosDriver(radians, nullptr, out, count, method);
+}
+
+void sincosBatch(float const* radians, float* outSin, float* outCos, std::size_t count, TrigMethod method) noexcept
+{
+  sincosDriver(radians, outSin, outCos, count, method);
+}
+} // namespace Core::Math
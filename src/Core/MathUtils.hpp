@@ -1,70 +1,255 @@
 #pragma once
 
-#include "Core/Logger.hpp"
+#include "Core/FixedPoint.hpp"
+#include "Core/Platform.hpp"
 
 #include <array>
+#include <bit>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <numbers>
 
 namespace Core::Math {
-inline constexpr float RadToIndex = 1024.0f / (std::numbers::pi_v<float> * 2.0f);
+// 查表的插值方式
+enum class TrigInterp
+{
+  Nearest, // 直接截断取整查表, 最快
+  Linear,  // 相邻两项线性插值, 误差约小两个数量级
+};
 
-alignas(64) inline static std::array<float, 1024> const sinTable = []() {
-  std::array<float, 1024> table{};
-  constexpr float step = std::numbers::pi_v<float> * 2.0f / table.size(); // 每个表项代表的角度步长
-  for (int i = 0; i < table.size(); ++i) {
-    table[i] = std::sin(step * i); // std::sin 不是 constexpr 函数, 只能在运行时初始化
+namespace Detail {
+// 编译期求 sin / cos 的泰勒级数, x ∈ [0, pi/2], 双精度下截断误差远小于 float 的舍入误差
+constexpr double sinSeries(double x) noexcept
+{
+  double const x2 = x * x;
+  double term = x;
+  double sum = x;
+  for (int k = 1; k < 12; ++k) {
+    term *= -x2 / static_cast<double>((2 * k) * (2 * k + 1));
+    sum += term;
   }
+  return sum;
+}
 
-  constexpr int ii = table.size() / 4; // Integral Index, sin 值为整数的索引间隔
+constexpr double cosSeries(double x) noexcept
+{
+  double const x2 = x * x;
+  double term = 1.0;
+  double sum = 1.0;
+  for (int k = 1; k < 12; ++k) {
+    term *= -x2 / static_cast<double>((2 * k - 1) * (2 * k));
+    sum += term;
+  }
+  return sum;
+}
 
-  table[ii * 0] = 0.0f;  // sin(0) = 0
-  table[ii * 1] = 1.0f;  // sin(pi/2) = 1
-  table[ii * 2] = 0.0f;  // sin(pi) = 0
-  table[ii * 3] = -1.0f; // sin(3pi/2) = -1
+// 按象限对称性生成 sin 表, 只在第一象限求级数, 因此 0, ±1 这些整数值是精确的
+template <std::size_t VSize>
+constexpr std::array<float, VSize> makeSinTable() noexcept
+{
+  std::array<float, VSize> table{};
+  constexpr std::size_t quarter = VSize / 4;
+  constexpr double step = std::numbers::pi * 2.0 / static_cast<double>(VSize); // 每个表项代表的角度步长
+  for (std::size_t i = 0; i < VSize; ++i) {
+    double const x = static_cast<double>(i % quarter) * step;
+    switch (i / quarter) {
+    case 0: table[i] = static_cast<float>(sinSeries(x)); break;
+    case 1: table[i] = static_cast<float>(cosSeries(x)); break;
+    case 2: table[i] = static_cast<float>(-sinSeries(x)); break;
+    default: table[i] = static_cast<float>(-cosSeries(x)); break;
+    }
+  }
+  return table;
+}
 
+// 定点版本的 sin 表 (16.16), 同样在编译期由级数生成, 双精度结果就近舍入
+template <std::size_t VSize>
+constexpr std::array<Fixed, VSize> makeFixedSinTable() noexcept
+{
+  std::array<Fixed, VSize> table{};
+  constexpr std::size_t quarter = VSize / 4;
+  constexpr double step = std::numbers::pi * 2.0 / static_cast<double>(VSize);
+  for (std::size_t i = 0; i < VSize; ++i) {
+    double const x = static_cast<double>(i % quarter) * step;
+    double value = 0.0;
+    switch (i / quarter) {
+    case 0: value = sinSeries(x); break;
+    case 1: value = cosSeries(x); break;
+    case 2: value = -sinSeries(x); break;
+    default: value = -cosSeries(x); break;
+    }
+    double const scaled = value * static_cast<double>(FixedOne);
+    table[i] = static_cast<Fixed>(scaled >= 0.0 ? scaled + 0.5 : scaled - 0.5);
+  }
   return table;
-}();
+}
+} // namespace Detail
+
+// 三角函数查找表, 表长与插值方式在编译期选择, 表在编译期生成
+// 表长越大精度越高, 但每次查表的缓存压力也越大 (表长 1024 时为 4 KiB)
+template <std::size_t VSize = 1024, TrigInterp VInterp = TrigInterp::Nearest>
+struct TrigTable
+{
+  static_assert(VSize >= 4 && std::has_single_bit(VSize), "TrigTable size must be a power of two");
+
+  static constexpr std::size_t SIZE = VSize;
+  static constexpr int MASK = static_cast<int>(VSize) - 1;    // 下标取模, 处理负数和大于 2pi 的情况
+  static constexpr int QUARTER = static_cast<int>(VSize) / 4; // pi/2 对应的下标偏移量
+  static constexpr float RAD_TO_INDEX = static_cast<float>(VSize) / (std::numbers::pi_v<float> * 2.0f);
+  static constexpr int ANGLE_SHIFT = AngleBits - std::countr_zero(VSize); // 二进制角的高位即为下标
+
+  alignas(64) static constexpr std::array<float, VSize> values = Detail::makeSinTable<VSize>();
+  alignas(64) static constexpr std::array<Fixed, VSize> fixedValues = Detail::makeFixedSinTable<VSize>();
+
+  static __forceinline float sin(float radians) noexcept
+  {
+    if constexpr (VInterp == TrigInterp::Nearest) {
+      return values[static_cast<int>(radians * RAD_TO_INDEX) & MASK];
+    } else {
+      float floatIndex = radians * RAD_TO_INDEX;
+      int i = static_cast<int>(std::floor(floatIndex));
+      float fraction = floatIndex - static_cast<float>(i); // 计算小数部分
+
+      int idx1 = i & MASK;
+      int idx2 = (i + 1) & MASK;
+
+      // 线性插值：a + f * (b - a)
+      return values[idx1] + fraction * (values[idx2] - values[idx1]);
+    }
+  }
+
+  static __forceinline float cos(float radians) noexcept
+  {
+    if constexpr (VInterp == TrigInterp::Nearest) {
+      // cos(x) = sin(x + pi/2)
+      return values[(static_cast<int>(radians * RAD_TO_INDEX) + QUARTER) & MASK];
+    } else {
+      return sin(radians + std::numbers::pi_v<float> / 2.0f);
+    }
+  }
+
+  // 定点版本: 二进制角直接移位得到下标, 全程整数运算
+  static __forceinline Fixed sinFixed(Angle angle) noexcept
+  {
+    if constexpr (VInterp == TrigInterp::Nearest) {
+      return fixedValues[angle >> ANGLE_SHIFT];
+    } else {
+      static_assert(ANGLE_SHIFT >= FixedFracBits, "TrigTable is too large for fixed-point interpolation");
+      std::uint32_t const i = angle >> ANGLE_SHIFT;
+      Fixed const fraction = static_cast<Fixed>((angle >> (ANGLE_SHIFT - FixedFracBits)) & (FixedOne - 1));
+      Fixed const a = fixedValues[i];
+      Fixed const b = fixedValues[(i + 1) & MASK];
+      return a + fixedMul(b - a, fraction);
+    }
+  }
+
+  static __forceinline Fixed cosFixed(Angle angle) noexcept
+  {
+    return sinFixed(angle + (Angle{ 1 } << (AngleBits - 2))); // cos(x) = sin(x + pi/2)
+  }
+};
+
+// 引擎默认使用的表 (1024 项), 子弹积分内核的 SIMD 路径直接按这些常量查表
+using DefaultTrigTable = TrigTable<1024, TrigInterp::Nearest>;
+
+inline constexpr float RadToIndex = DefaultTrigTable::RAD_TO_INDEX;
+inline constexpr auto const& sinTable = DefaultTrigTable::values;
 
 __forceinline float sin(float radians) noexcept
 {
-  // 将角度转换为 [0, 1024) 范围内的索引
-  int index = static_cast<int>(radians * RadToIndex) & 1023; // 1023 = 0x3FF = 0b11'1111'1111, 处理负数和大于 2pi 的情况
-  return sinTable[index];
+  return DefaultTrigTable::sin(radians);
 }
 
 __forceinline float cos(float radians) noexcept
 {
-  // cos(x) = sin(x + pi/2)。在 1024 长度的表中，pi/2 偏移量是 256
-  int index = (static_cast<int>(radians * RadToIndex) + 256) & 1023;
-  return sinTable[index];
+  return DefaultTrigTable::cos(radians);
 }
 
-__forceinline float sinLerp(float radians) noexcept
+__forceinline Fixed sinFixed(Angle angle) noexcept
 {
-  float floatIndex = radians * RadToIndex;
-  int i = static_cast<int>(std::floor(floatIndex));
-  float fraction = floatIndex - static_cast<float>(i); // 计算小数部分
+  return DefaultTrigTable::sinFixed(angle);
+}
 
-  int idx1 = i & 1023;
-  int idx2 = (i + 1) & 1023;
+__forceinline Fixed cosFixed(Angle angle) noexcept
+{
+  return DefaultTrigTable::cosFixed(angle);
+}
 
-  // 线性插值：a + f * (b - a)
-  return sinTable[idx1] + fraction * (sinTable[idx2] - sinTable[idx1]);
+__forceinline float sinLerp(float radians) noexcept
+{
+  return TrigTable<1024, TrigInterp::Linear>::sin(radians);
 }
 
 __forceinline float cosLerp(float radians) noexcept
 {
-  return sinLerp(radians + std::numbers::pi_v<float> / 2.0f);
+  return TrigTable<1024, TrigInterp::Linear>::cos(radians);
 }
 
-inline void initMathUtils()
+// 多项式 (极小极大逼近) 版本: 不查表, 没有缓存压力, 最大误差约 1 ulp 量级, |radians| < 8192 时有效
+// 先按 pi/2 做三段式 (Cody-Waite) 范围化归, 再在 [-pi/4, pi/4] 上分别用 sin 和 cos 多项式
+inline constexpr float TwoOverPi = 0.636619772f;
+inline constexpr float PiOver2A = 1.5703125f; // pi/2 的三段拆分, 前两段的乘积在范围内是精确的
+inline constexpr float PiOver2B = 4.837512969970703125e-4f;
+inline constexpr float PiOver2C = 7.54978995489188216e-8f;
+
+inline constexpr float SinC1 = -1.6666654611e-1f;
+inline constexpr float SinC2 = 8.3321608736e-3f;
+inline constexpr float SinC3 = -1.9515295891e-4f;
+inline constexpr float CosC1 = 4.166664568298827e-2f;
+inline constexpr float CosC2 = -1.388731625493765e-3f;
+inline constexpr float CosC3 = 2.443315711809948e-5f;
+
+__forceinline void sincosPoly(float radians, float& outSin, float& outCos) noexcept
 {
-  LOG_INFO("Initializing MathUtils...");
+  float const q = std::nearbyint(radians * TwoOverPi);
+  int const quadrant = static_cast<int>(q);
+  float r = radians - q * PiOver2A;
+  r = r - q * PiOver2B;
+  r = r - q * PiOver2C;
+
+  float const r2 = r * r;
+  float const s = ((SinC3 * r2 + SinC2) * r2 + SinC1) * r2 * r + r;
+  float const c = ((CosC3 * r2 + CosC2) * r2 + CosC1) * r2 * r2 - 0.5f * r2 + 1.0f;
+
+  switch (quadrant & 3) {
+  case 0: outSin = s; outCos = c; break;
+  case 1: outSin = c; outCos = -s; break;
+  case 2: outSin = -s; outCos = -c; break;
+  default: outSin = -c; outCos = s; break;
+  }
+}
 
-  // 触发 sinTable 的初始化
-  (void)sinTable;
+__forceinline float sinPoly(float radians) noexcept
+{
+  float s;
+  float c;
+  sincosPoly(radians, s, c);
+  return s;
+}
 
-  LOG_INFO("MathUtils initialized.");
+__forceinline float cosPoly(float radians) noexcept
+{
+  float s;
+  float c;
+  sincosPoly(radians, s, c);
+  return c;
 }
+
+// 批量三角函数, 按 TOUHOU_SIMD 选择的指令集向量化
+// Table: 与 sin / cos 逐位一致 (AVX2 下用 gather 查表); Polynomial: 与 sinPoly / cosPoly 逐位一致
+// 每帧十万量级的调用时查表的 gather 受缓存影响较大, 可按调用处的精度与吞吐需求选择
+enum class TrigMethod
+{
+  Table,
+  Polynomial,
+};
+
+void sinBatch(float const* radians, float* out, std::size_t count, TrigMethod method = TrigMethod::Polynomial) noexcept;
+void cosBatch(float const* radians, float* out, std::size_t count, TrigMethod method = TrigMethod::Polynomial) noexcept;
+void sincosBatch(float const* radians,
+                 float* outSin,
+                 float* outCos,
+                 std::size_t count,
+                 TrigMethod method = TrigMethod::Polynomial) noexcept;
 } // namespace Core::Math
@@ -0,0 +1,247 @@
+#include "Metrics.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace Core {
+
+namespace {
+struct MetricInfo
+{
+  std::string name;
+  Metrics::Kind kind;
+  Metrics::Timeline timeline;
+};
+
+// 一条时间线的历史; 每帧一行, 每个指标占 id 对应的一列, 不属于这条时间线的列不写入
+struct TimelineHistory
+{
+  std::vector<double> values = std::vector<double>(Metrics::HISTORY_FRAMES * Metrics::MAX_METRICS, 0.0);
+  std::uint64_t frameCount = 0;
+};
+
+struct MetricsState
+{
+  std::mutex mutex; // 保护注册表与历史; 记录数值不经过这里
+  std::vector<MetricInfo> metrics;
+  std::array<TimelineHistory, Metrics::TIMELINE_COUNT> timelines;
+};
+
+MetricsState& metricsState()
+{
+  static MetricsState state;
+  return state;
+}
+
+TimelineHistory& historyOf(MetricsState& state, Metrics::Timeline timeline)
+{
+  return state.timelines[static_cast<std::size_t>(timeline)];
+}
+
+char const* timelineName(Metrics::Timeline timeline)
+{
+  return timeline == Metrics::Timeline::Simulation ? "simulation" : "render";
+}
+
+[[noreturn]] void failMetrics(std::string const& message)
+{
+  LOG_ERROR(message);
+  throw std::runtime_error(message);
+}
+
+// 历史中最早一帧的编号与帧数
+std::uint64_t firstFrame(TimelineHistory const& history)
+{
+  return history.frameCount > Metrics::HISTORY_FRAMES ? history.frameCount - Metrics::HISTORY_FRAMES : 0;
+}
+
+double& historyAt(TimelineHistory& history, std::uint64_t frame, MetricId id)
+{
+  return history.values[(frame % Metrics::HISTORY_FRAMES) * Metrics::MAX_METRICS + id];
+}
+
+// 调用者持有 mutex
+std::vector<double> sortedHistory(TimelineHistory& history, MetricId id)
+{
+  std::vector<double> values;
+  values.reserve(static_cast<std::size_t>(history.frameCount - firstFrame(history)));
+  for (std::uint64_t frame = firstFrame(history); frame < history.frameCount; ++frame) {
+    values.push_back(historyAt(history, frame, id));
+  }
+  std::sort(values.begin(), values.end());
+  return values;
+}
+
+double percentileOf(std::vector<double> const& sorted, double p)
+{
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  auto const rank = static_cast<std::size_t>(std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * sorted.size()));
+  return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+void writeFile(std::string const& path, std::string const& text)
+{
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    failMetrics("Failed to open metrics file for writing: " + path);
+  }
+  file.write(text.data(), static_cast<std::streamsize>(text.size()));
+  if (!file) {
+    failMetrics("Failed to write metrics file: " + path);
+  }
+}
+} // namespace
+
+MetricId Metrics::registerMetric(std::string_view name, Kind kind, Timeline timeline)
+{
+  MetricsState& state = metricsState();
+  std::lock_guard lock(state.mutex);
+  for (std::size_t i = 0; i < state.metrics.size(); ++i) {
+    if (state.metrics[i].name == name) {
+      if (state.metrics[i].kind != kind || state.metrics[i].timeline != timeline) {
+        failMetrics(std::format("Metric registered twice with different kinds or timelines: {}", name));
+      }
+      return static_cast<MetricId>(i);
+    }
+  }
+  if (state.metrics.size() >= MAX_METRICS) {
+    failMetrics(std::format("Too many metrics (max {}): {}", MAX_METRICS, name));
+  }
+  state.metrics.push_back({ std::string(name), kind, timeline });
+  return static_cast<MetricId>(state.metrics.size() - 1);
+}
+
+void Metrics::endFrame(Timeline timeline)
+{
+  MetricsState& state = metricsState();
+  std::lock_guard lock(state.mutex);
+  TimelineHistory& history = historyOf(state, timeline);
+  for (std::size_t i = 0; i < state.metrics.size(); ++i) {
+    if (state.metrics[i].timeline != timeline) {
+      continue;
+    }
+    auto const id = static_cast<MetricId>(i);
+    historyAt(history, history.frameCount, id) =
+      state.metrics[i].kind == Kind::Counter
+        ? static_cast<double>(s_counters[i].exchange(0, std::memory_order_relaxed))
+        : s_gauges[i].load(std::memory_order_relaxed);
+  }
+  ++history.frameCount;
+}
+
+void Metrics::reset()
+{
+  MetricsState& state = metricsState();
+  std::lock_guard lock(state.mutex);
+  for (std::atomic<std::uint64_t>& counter : s_counters) {
+    counter.store(0, std::memory_order_relaxed);
+  }
+  for (TimelineHistory& history : state.timelines) {
+    history.frameCount = 0;
+  }
+}
+
+double Metrics::percentile(MetricId id, double p)
+{
+  MetricsState& state = metricsState();
+  std::lock_guard lock(state.mutex);
+  return percentileOf(sortedHistory(historyOf(state, state.metrics[id].timeline), id), p);
+}
+
+std::uint64_t Metrics::getFrameCount(Timeline timeline)
+{
+  MetricsState& state = metricsState();
+  std::lock_guard lock(state.mutex);
+  return historyOf(state, timeline).frameCount;
+}
+
+void Metrics::writeCsv(std::string const& path, Timeline timeline)
+{
+  MetricsState& state = metricsState();
+  std::lock_guard lock(state.mutex);
+  TimelineHistory& history = historyOf(state, timeline);
+
+  std::vector<MetricId> ids;
+  std::string csv = "frame";
+  for (std::size_t i = 0; i < state.metrics.size(); ++i) {
+    if (state.metrics[i].timeline == timeline) {
+      ids.push_back(static_cast<MetricId>(i));
+      csv += ',';
+      csv += state.metrics[i].name;
+    }
+  }
+  csv += '\n';
+  for (std::uint64_t frame = firstFrame(history); frame < history.frameCount; ++frame) {
+    csv += std::format("{}", frame);
+    for (MetricId const id : ids) {
+      csv += std::format(",{}", historyAt(history, frame, id));
+    }
+    csv += '\n';
+  }
+  writeFile(path, csv);
+  LOG_INFO("Metrics saved: {} ({} {} frames, {} metrics)",
+           path,
+           history.frameCount - firstFrame(history),
+           timelineName(timeline),
+           ids.size());
+}
+
+void Metrics::writeJson(std::string const& path)
+{
+  MetricsState& state = metricsState();
+  std::lock_guard lock(state.mutex);
+
+  std::string json = "{\"timelines\":[";
+  for (std::size_t t = 0; t < TIMELINE_COUNT; ++t) {
+    auto const timeline = static_cast<Timeline>(t);
+    TimelineHistory& history = historyOf(state, timeline);
+    std::uint64_t const first = firstFrame(history);
+    json += std::format("{}\n{{\"name\":\"{}\",\"firstFrame\":{},\"frameCount\":{},\"metrics\":[",
+                        t == 0 ? "" : ",",
+                        timelineName(timeline),
+                        first,
+                        history.frameCount - first);
+    bool firstMetric = true;
+    for (std::size_t i = 0; i < state.metrics.size(); ++i) {
+      if (state.metrics[i].timeline != timeline) {
+        continue;
+      }
+      auto const id = static_cast<MetricId>(i);
+      std::vector<double> const sorted = sortedHistory(history, id);
+      double sum = 0.0;
+      for (double const value : sorted) {
+        sum += value;
+      }
+      // 指标名由代码中的字面量给出, 不含需要转义的字符
+      json += std::format(
+        "{}\n{{\"name\":\"{}\",\"kind\":\"{}\",\"mean\":{},\"p50\":{},\"p90\":{},\"p99\":{},\"max\":{},\"values\":[",
+        firstMetric ? "" : ",",
+        state.metrics[i].name,
+        state.metrics[i].kind == Kind::Counter ? "counter" : "gauge",
+        sorted.empty() ? 0.0 : sum / static_cast<double>(sorted.size()),
+        percentileOf(sorted, 50.0),
+        percentileOf(sorted, 90.0),
+        percentileOf(sorted, 99.0),
+        sorted.empty() ? 0.0 : sorted.back());
+      for (std::uint64_t frame = first; frame < history.frameCount; ++frame) {
+        json += std::format("{}{}", frame == first ? "" : ",", historyAt(history, frame, id));
+      }
+      json += "]}";
+      firstMetric = false;
+    }
+    json += "\n]}";
+  }
+  json += "\n]}\n";
+  writeFile(path, json);
+  LOG_INFO("Metrics saved: {} ({} metrics)", path, state.metrics.size());
+}
+} // namespace Core
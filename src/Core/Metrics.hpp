@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Core {
+using MetricId = std::uint32_t;
+
+// 逐帧的引擎指标, 在发布版本中也保持开启
+// 计数器 (Counter) 累计本帧发生的次数, 每帧结束时清零; 仪表 (Gauge) 记录最后一次设置的值, 跨帧保留
+// 记录只是一次 relaxed 原子加法或存储, 不加锁, 可在任意线程调用
+// 每个指标属于一条时间线 (模拟帧或渲染帧), 两条时间线的帧率不同, 各自由推进它的线程调用 endFrame,
+// 把该时间线上全部指标的本帧值写入各自定长的历史环形缓冲区 (保留最近 HISTORY_FRAMES 帧)
+// 历史可随时导出为 CSV (每条时间线一个文件, 每帧一行) 或 JSON (每条时间线每个指标的分位数与逐帧数值)
+class Metrics
+{
+public:
+  static constexpr std::size_t MAX_METRICS = 32;
+  static constexpr std::size_t HISTORY_FRAMES = 4096; // 60 fps 下约 68 秒
+
+  enum class Kind : std::uint8_t
+  {
+    Counter,
+    Gauge
+  };
+
+  enum class Timeline : std::uint8_t
+  {
+    Simulation, // 模拟帧: 固定步长, 由模拟线程 (或无窗口运行的主循环) 在每一步之后结束一帧
+    Render      // 渲染帧: 随 vsync 与显示器变化, 由渲染线程在每次渲染之后结束一帧
+  };
+  static constexpr std::size_t TIMELINE_COUNT = 2;
+
+  // 注册指标并返回其 id, 同名且类型与时间线相同的指标返回同一个 id; 超过 MAX_METRICS 个或不符时抛出异常
+  static MetricId registerMetric(std::string_view name, Kind kind, Timeline timeline = Timeline::Simulation);
+
+  static void add(MetricId id, std::uint64_t value = 1) noexcept
+  {
+    s_counters[id].fetch_add(value, std::memory_order_relaxed);
+  }
+  static void set(MetricId id, double value) noexcept { s_gauges[id].store(value, std::memory_order_relaxed); }
+
+  // 结束 timeline 上的一帧: 其上计数器的本帧值与仪表的当前值写入该时间线的历史, 计数器清零
+  static void endFrame(Timeline timeline = Timeline::Simulation);
+  // 清空全部历史与计数器, 已注册的指标保留
+  static void reset();
+
+  // id 所属时间线的历史中的第 p 百分位数 (0 ~ 100, 最近邻取整), 没有历史时返回 0
+  static double percentile(MetricId id, double p);
+  // timeline 上已结束的帧数 (历史中只保留其中最近的 HISTORY_FRAMES 帧)
+  static std::uint64_t getFrameCount(Timeline timeline = Timeline::Simulation);
+
+  // 导出历史, 打开或写入文件失败时抛出异常; CSV 只包含 timeline 上的指标, JSON 包含全部时间线
+  static void writeCsv(std::string const& path, Timeline timeline = Timeline::Simulation);
+  static void writeJson(std::string const& path);
+
+private:
+  static inline std::array<std::atomic<std::uint64_t>, MAX_METRICS> s_counters{};
+  static inline std::array<std::atomic<double>, MAX_METRICS> s_gauges{};
+};
+
+// 在使用处以命名空间作用域的常量声明, 静态初始化时注册
+class Counter
+{
+public:
+  explicit Counter(std::string_view name, Metrics::Timeline timeline = Metrics::Timeline::Simulation)
+    : m_id(Metrics::registerMetric(name, Metrics::Kind::Counter, timeline))
+  {
+  }
+
+  void add(std::uint64_t value = 1) const noexcept { Metrics::add(m_id, value); }
+  MetricId getId() const noexcept { return m_id; }
+
+private:
+  MetricId m_id;
+};
+
+class Gauge
+{
+public:
+  explicit Gauge(std::string_view name, Metrics::Timeline timeline = Metrics::Timeline::Simulation)
+    : m_id(Metrics::registerMetric(name, Metrics::Kind::Gauge, timeline))
+  {
+  }
+
+  void set(double value) const noexcept { Metrics::set(m_id, value); }
+  MetricId getId() const noexcept { return m_id; }
+
+private:
+  MetricId m_id;
+};
+} // namespace Core
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <ctime>
+
+// 编译器扩展在 MSVC 与 GCC / Clang 下的等价写法, 使模拟相关的代码 (Core 的平台无关部分与 Game) 可以在 Linux 上构建
+// 窗口与图形 (Window, Application, Graphics) 仍然只支持 Windows
+
+#if defined(_MSC_VER)
+// 完整的函数签名, 含模板实参
+#define TOUHOU_FUNCSIG __FUNCSIG__
+#else
+#define TOUHOU_FUNCSIG __PRETTY_FUNCTION__
+// GCC / Clang 没有 __forceinline 关键字, 用 always_inline 属性代替
+#define __forceinline inline __attribute__((always_inline))
+#endif
+
+namespace Core {
+// 线程安全的 localtime: MSVC 为 localtime_s, POSIX 为 localtime_r, 两者参数顺序相反
+inline bool localTime(std::time_t const& time, std::tm& out) noexcept
+{
+#if defined(_MSC_VER)
+  return localtime_s(&out, &time) == 0;
+#else
+  return localtime_r(&time, &out) != nullptr;
+#endif
+}
+} // namespace Core
@@ -0,0 +1,232 @@
+#include "Profiler.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace Core {
+
+namespace {
+using Event = Profiler::Event;
+
+// 一个线程的区间缓冲区, 只由所属线程写入; count 以 release 发布, 导出时以 acquire 读取
+struct ThreadBuffer
+{
+  std::unique_ptr<Event[]> events; // 第一次记录时才分配, 从不记录的线程不占内存
+  std::atomic<std::size_t> count{ 0 };
+  std::uint32_t threadId = 0;
+  std::string name;
+};
+
+struct ProfilerState
+{
+  std::mutex mutex; // 保护 buffers 的登记与导出
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers; // 线程退出后保留, 以便采集结束后导出
+  std::atomic<std::uint64_t> dropped{ 0 };
+  // 采集开始与结束时的 RDTSC 计数与 steady_clock 时间, 用于换算微秒
+  std::uint64_t beginTicks = 0;
+  std::uint64_t endTicks = 0;
+  std::chrono::steady_clock::time_point beginTime;
+  std::chrono::steady_clock::time_point endTime;
+};
+
+ProfilerState& profilerState()
+{
+  static ProfilerState state;
+  return state;
+}
+
+ThreadBuffer& threadBuffer()
+{
+  thread_local ThreadBuffer* buffer = nullptr;
+  if (buffer == nullptr) {
+    auto owned = std::make_unique<ThreadBuffer>();
+    buffer = owned.get();
+    ProfilerState& state = profilerState();
+    std::lock_guard lock(state.mutex);
+    buffer->threadId = static_cast<std::uint32_t>(state.buffers.size() + 1);
+    state.buffers.push_back(std::move(owned));
+  }
+  return *buffer;
+}
+
+void push(char const* name, std::uint64_t begin, std::uint64_t end) noexcept
+{
+  ThreadBuffer& buffer = threadBuffer();
+  std::size_t const count = buffer.count.load(std::memory_order_relaxed);
+  if (count == 0 && !buffer.events) {
+    buffer.events.reset(new (std::nothrow) Event[Profiler::EVENTS_PER_THREAD]);
+  }
+  if (count >= Profiler::EVENTS_PER_THREAD || !buffer.events) {
+    profilerState().dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer.events[count] = { name, begin, end };
+  buffer.count.store(count + 1, std::memory_order_release);
+}
+
+// 名称来自字符串字面量或函数名, 只需转义引号与反斜杠
+void appendEscaped(std::string& out, char const* text)
+{
+  for (; *text != '\0'; ++text) {
+    if (*text == '"' || *text == '\\') {
+      out += '\\';
+    }
+    out += *text;
+  }
+}
+
+// 每个区间名的统计, 导出时写入日志, 不打开 trace 也能看到每帧的大致分布
+struct ScopeStats
+{
+  std::uint64_t calls = 0;
+  std::uint64_t ticks = 0;
+  std::uint64_t maxTicks = 0;
+};
+} // namespace
+
+void Profiler::beginCapture()
+{
+  ProfilerState& state = profilerState();
+  {
+    std::lock_guard lock(state.mutex);
+    for (std::unique_ptr<ThreadBuffer> const& buffer : state.buffers) {
+      buffer->count.store(0, std::memory_order_relaxed);
+    }
+  }
+  state.dropped.store(0, std::memory_order_relaxed);
+  state.beginTime = std::chrono::steady_clock::now();
+  state.beginTicks = now();
+  s_capturing.store(true, std::memory_order_release);
+}
+
+void Profiler::endCapture()
+{
+  if (!isCapturing()) {
+    return;
+  }
+  s_capturing.store(false, std::memory_order_release);
+  ProfilerState& state = profilerState();
+  state.endTicks = now();
+  state.endTime = std::chrono::steady_clock::now();
+}
+
+void Profiler::record(char const* name, std::uint64_t begin, std::uint64_t end) noexcept
+{
+  // 采集结束前开始的区间在结束后才提交时丢弃, 避免导出时仍在写入
+  if (isCapturing()) {
+    push(name, begin, end);
+  }
+}
+
+void Profiler::markFrame() noexcept
+{
+  if (isCapturing()) {
+    push("Frame", now(), 0);
+  }
+}
+
+void Profiler::setThreadName(std::string_view name)
+{
+  ThreadBuffer& buffer = threadBuffer();
+  std::lock_guard lock(profilerState().mutex);
+  buffer.name = name;
+}
+
+std::uint64_t Profiler::getDroppedCount() noexcept
+{
+  return profilerState().dropped.load(std::memory_order_relaxed);
+}
+
+void Profiler::writeChromeTrace(std::string const& path)
+{
+  endCapture();
+  ProfilerState& state = profilerState();
+  std::lock_guard lock(state.mutex);
+
+  double const micros = std::chrono::duration<double, std::micro>(state.endTime - state.beginTime).count();
+  double const ticksPerMicro = micros > 0.0 ? static_cast<double>(state.endTicks - state.beginTicks) / micros : 1.0;
+  auto const toMicros = [&](std::uint64_t ticks) {
+    return static_cast<double>(ticks - state.beginTicks) / ticksPerMicro;
+  };
+
+  std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  json += R"({"name":"process_name","ph":"M","pid":1,"tid":0,"args":{"name":"TouhouEngine"}})";
+  std::size_t eventCount = 0;
+  std::uint64_t frameCount = 0;
+  std::unordered_map<char const*, ScopeStats> stats;
+  for (std::unique_ptr<ThreadBuffer> const& buffer : state.buffers) {
+    std::size_t const count = buffer->count.load(std::memory_order_acquire);
+    if (count == 0 && buffer->name.empty()) {
+      continue;
+    }
+    std::string const threadName = buffer->name.empty() ? std::format("Thread {}", buffer->threadId) : buffer->name;
+    json += std::format(",\n" R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":")", buffer->threadId);
+    appendEscaped(json, threadName.c_str());
+    json += "\"}}";
+
+    for (std::size_t i = 0; i < count; ++i) {
+      Event const& event = buffer->events[i];
+      json += ",\n{\"name\":\"";
+      appendEscaped(json, event.name);
+      if (event.end == 0) {
+        json += std::format(R"(","ph":"i","s":"g","ts":{:.3f},"pid":1,"tid":{},"args":{{"frame":{}}}}})",
+                            toMicros(event.begin),
+                            buffer->threadId,
+                            frameCount++);
+        continue;
+      }
+      json += std::format(R"(","cat":"cpu","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":1,"tid":{}}})",
+                          toMicros(event.begin),
+                          static_cast<double>(event.end - event.begin) / ticksPerMicro,
+                          buffer->threadId);
+      ScopeStats& scope = stats[event.name];
+      ++scope.calls;
+      scope.ticks += event.end - event.begin;
+      scope.maxTicks = std::max(scope.maxTicks, event.end - event.begin);
+      ++eventCount;
+    }
+  }
+  json += "\n]}\n";
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    std::string const message = "Failed to open profiler trace file for writing: " + path;
+    LOG_ERROR(message);
+    throw std::runtime_error(message);
+  }
+  file.write(json.data(), static_cast<std::streamsize>(json.size()));
+  if (!file) {
+    std::string const message = "Failed to write profiler trace file: " + path;
+    LOG_ERROR(message);
+    throw std::runtime_error(message);
+  }
+
+  LOG_INFO("Profiler trace saved: {} ({} scopes, {} frames, {:.1f} ms, {} dropped)",
+           path,
+           eventCount,
+           frameCount,
+           micros / 1000.0,
+           getDroppedCount());
+
+  // 按总耗时从高到低列出各区间, 帧均值以帧标记数计
+  std::vector<std::pair<char const*, ScopeStats>> sorted(stats.begin(), stats.end());
+  std::sort(sorted.begin(), sorted.end(), [](auto const& a, auto const& b) { return a.second.ticks > b.second.ticks; });
+  double const frames = static_cast<double>(std::max<std::uint64_t>(frameCount, 1));
+  for (auto const& [name, scope] : sorted) {
+    LOG_INFO("  {:<40} {:>8} calls {:>9.3f} ms/frame {:>9.1f} us max",
+             name,
+             scope.calls,
+             static_cast<double>(scope.ticks) / ticksPerMicro / 1000.0 / frames,
+             static_cast<double>(scope.maxTicks) / ticksPerMicro);
+  }
+}
+} // namespace Core
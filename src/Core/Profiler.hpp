@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Core/Platform.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+// 编译期开关: 定义 TOUHOU_PROFILE 时 PROFILE_* 宏记录区间, 否则展开为空语句, 没有任何开销
+// PROFILE_SCOPE(name)      记录从此处到作用域结束的区间, name 必须是字符串字面量 (只保存指针)
+// PROFILE_FUNCTION()       以当前函数名记录整个函数
+// PROFILE_FRAME()          帧标记, 在主循环每次迭代开始时调用
+// PROFILE_THREAD_NAME(name) 为当前线程命名, 显示在 trace 中
+#if defined(TOUHOU_PROFILE)
+#define TOUHOU_PROFILE_CONCAT_IMPL(a, b) a##b
+#define TOUHOU_PROFILE_CONCAT(a, b) TOUHOU_PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(name) ::Core::ProfileScope const TOUHOU_PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#define PROFILE_FRAME() ::Core::Profiler::markFrame()
+#define PROFILE_THREAD_NAME(name) ::Core::Profiler::setThreadName(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_THREAD_NAME(name) ((void)0)
+#endif
+
+namespace Core {
+// 低开销的 CPU 区间记录器
+// 每个线程把 {名称指针, 开始, 结束} 写入自己的定长缓冲区, 记录时不加锁也不分配内存, 缓冲区满后的区间只做计数
+// 时间戳为 RDTSC 计数, 导出时按采集期间与 steady_clock 的比值换算为微秒
+// 采集结束后导出为 Chrome trace_event JSON, 可在 chrome://tracing 或 Perfetto 中按线程查看嵌套的区间
+class Profiler
+{
+public:
+  static constexpr std::size_t EVENTS_PER_THREAD = 1 << 18; // 每个线程最多记录的区间数 (约 6 MB)
+
+  struct Event
+  {
+    char const* name;
+    std::uint64_t begin;
+    std::uint64_t end; // 0 表示帧标记 (瞬时事件)
+  };
+
+  static __forceinline std::uint64_t now() noexcept { return __rdtsc(); }
+
+  // 清空全部线程已记录的区间并开始采集; 采集期间不应再次调用
+  static void beginCapture();
+  // 停止采集, 之后的区间不再记录
+  static void endCapture();
+  static bool isCapturing() noexcept { return s_capturing.load(std::memory_order_relaxed); }
+
+  static void record(char const* name, std::uint64_t begin, std::uint64_t end) noexcept;
+  static void markFrame() noexcept;
+  static void setThreadName(std::string_view name);
+
+  // 把已记录的区间写入 Chrome trace JSON 文件, 应在 endCapture 之后调用; 打开文件失败时抛出异常
+  static void writeChromeTrace(std::string const& path);
+
+  static std::uint64_t getDroppedCount() noexcept;
+
+private:
+  static inline std::atomic<bool> s_capturing{ false };
+};
+
+// 作用域区间: 构造时记录开始时间, 析构时提交; 构造时未在采集则什么也不做
+class ProfileScope
+{
+public:
+  explicit ProfileScope(char const* name) noexcept
+    : m_name(name)
+    , m_begin(Profiler::isCapturing() ? Profiler::now() : 0)
+  {
+  }
+
+  ~ProfileScope()
+  {
+    if (m_begin != 0) {
+      Profiler::record(m_name, m_begin, Profiler::now());
+    }
+  }
+
+  ProfileScope(ProfileScope const&) = delete;
+  ProfileScope& operator=(ProfileScope const&) = delete;
+
+private:
+  char const* m_name;
+  std::uint64_t m_begin;
+};
+} // namespace Core
@@ -0,0 +1,215 @@
+#include "Random.hpp"
+#include "Simd.hpp"
+
+namespace Core::Random {
+
+namespace {
+constexpr float unitScale = 1.0f / 16777216.0f;
+
+#if defined(TOUHOU_SIMD_AVX2)
+// 8 个通道各自的 32 x 32 -> 64 位乘法, 分别取高低 32 位
+__forceinline void mulHiLo(__m256i a, __m256i m, __m256i& hi, __m256i& lo) noexcept
+{
+  __m256i const even = _mm256_mul_epu32(a, m);                        // 通道 0, 2, 4, 6
+  __m256i const odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m); // 通道 1, 3, 5, 7
+  lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+  hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+}
+
+// 同时计算第 block ~ block + 7 块, 转置后 out[k] 依次为第 2k, 2k + 1 块的 8 个字 (即输出顺序)
+__forceinline void philoxBlocks(std::uint64_t block, std::uint32_t streamId, PhiloxKey key, __m256i* out) noexcept
+{
+  alignas(32) std::uint32_t low[8];
+  alignas(32) std::uint32_t high[8];
+  for (std::uint32_t lane = 0; lane < 8; ++lane) {
+    low[lane] = static_cast<std::uint32_t>(block + lane);
+    high[lane] = static_cast<std::uint32_t>((block + lane) >> 32);
+  }
+  __m256i c0 = _mm256_load_si256(reinterpret_cast<__m256i const*>(low));
+  __m256i c1 = _mm256_load_si256(reinterpret_cast<__m256i const*>(high));
+  __m256i c2 = _mm256_set1_epi32(static_cast<int>(streamId));
+  __m256i c3 = _mm256_setzero_si256();
+  __m256i const m0 = _mm256_set1_epi32(static_cast<int>(PhiloxM0));
+  __m256i const m1 = _mm256_set1_epi32(static_cast<int>(PhiloxM1));
+  for (int round = 0; round < PhiloxRounds; ++round) {
+    __m256i hi0, lo0, hi1, lo1;
+    mulHiLo(c0, m0, hi0, lo0);
+    mulHiLo(c2, m1, hi1, lo1);
+    c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32(static_cast<int>(key[0])));
+    c1 = lo1;
+    c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32(static_cast<int>(key[1])));
+    c3 = lo0;
+    key[0] += PhiloxW0;
+    key[1] += PhiloxW1;
+  }
+
+  // 4 x 8 转置: 每个 128 位半区先做 4 x 4 转置, 再按块号重排两个半区
+  __m256i const t0 = _mm256_unpacklo_epi32(c0, c1);
+  __m256i const t1 = _mm256_unpackhi_epi32(c0, c1);
+  __m256i const t2 = _mm256_unpacklo_epi32(c2, c3);
+  __m256i const t3 = _mm256_unpackhi_epi32(c2, c3);
+  __m256i const b04 = _mm256_unpacklo_epi64(t0, t2); // 第 0 块 | 第 4 块
+  __m256i const b15 = _mm256_unpackhi_epi64(t0, t2);
+  __m256i const b26 = _mm256_unpacklo_epi64(t1, t3);
+  __m256i const b37 = _mm256_unpackhi_epi64(t1, t3);
+  out[0] = _mm256_permute2x128_si256(b04, b15, 0x20);
+  out[1] = _mm256_permute2x128_si256(b26, b37, 0x20);
+  out[2] = _mm256_permute2x128_si256(b04, b15, 0x31);
+  out[3] = _mm256_permute2x128_si256(b26, b37, 0x31);
+}
+
+constexpr std::size_t blocksPerBatch = 8;
+#elif defined(TOUHOU_SIMD_SSE2)
+// SSE2 没有 blend, 用掩码拼出高低 32 位
+__forceinline void mulHiLo(__m128i a, __m128i m, __m128i& hi, __m128i& lo) noexcept
+{
+  __m128i const lowMask = _mm_set1_epi64x(0x0000'0000'FFFF'FFFFll);
+  __m128i const even = _mm_mul_epu32(a, m);
+  __m128i const odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+  lo = _mm_or_si128(_mm_and_si128(even, lowMask), _mm_slli_epi64(odd, 32));
+  hi = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_andnot_si128(lowMask, odd));
+}
+
+// 同时计算第 block ~ block + 3 块, 转置后 out[k] 为第 k 块的 4 个字
+__forceinline void philoxBlocks(std::uint64_t block, std::uint32_t streamId, PhiloxKey key, __m128i* out) noexcept
+{
+  alignas(16) std::uint32_t low[4];
+  alignas(16) std::uint32_t high[4];
+  for (std::uint32_t lane = 0; lane < 4; ++lane) {
+    low[lane] = static_cast<std::uint32_t>(block + lane);
+    high[lane] = static_cast<std::uint32_t>((block + lane) >> 32);
+  }
+  __m128i c0 = _mm_load_si128(reinterpret_cast<__m128i const*>(low));
+  __m128i c1 = _mm_load_si128(reinterpret_cast<__m128i const*>(high));
+  __m128i c2 = _mm_set1_epi32(static_cast<int>(streamId));
+  __m128i c3 = _mm_setzero_si128();
+  __m128i const m0 = _mm_set1_epi32(static_cast<int>(PhiloxM0));
+  __m128i const m1 = _mm_set1_epi32(static_cast<int>(PhiloxM1));
+  for (int round = 0; round < PhiloxRounds; ++round) {
+    __m128i hi0, lo0, hi1, lo1;
+    mulHiLo(c0, m0, hi0, lo0);
+    mulHiLo(c2, m1, hi1, lo1);
+    c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), _mm_set1_epi32(static_cast<int>(key[0])));
+    c1 = lo1;
+    c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), _mm_set1_epi32(static_cast<int>(key[1])));
+    c3 = lo0;
+    key[0] += PhiloxW0;
+    key[1] += PhiloxW1;
+  }
+
+  __m128i const t0 = _mm_unpacklo_epi32(c0, c1);
+  __m128i const t1 = _mm_unpackhi_epi32(c0, c1);
+  __m128i const t2 = _mm_unpacklo_epi32(c2, c3);
+  __m128i const t3 = _mm_unpackhi_epi32(c2, c3);
+  out[0] = _mm_unpacklo_epi64(t0, t2);
+  out[1] = _mm_unpackhi_epi64(t0, t2);
+  out[2] = _mm_unpacklo_epi64(t1, t3);
+  out[3] = _mm_unpackhi_epi64(t1, t3);
+}
+
+constexpr std::size_t blocksPerBatch = 4;
+#endif
+
+// 批量填充的输出方式: scalar 写入一个字, store 写入一个向量 (Core::Simd::FloatLanes 个字)
+struct U32Output
+{
+  std::uint32_t* out;
+
+  __forceinline void scalar(std::size_t i, std::uint32_t bits) const noexcept { out[i] = bits; }
+#if defined(TOUHOU_SIMD_AVX2)
+  __forceinline void store(std::size_t i, __m256i bits) const noexcept
+  {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), bits);
+  }
+#elif defined(TOUHOU_SIMD_SSE2)
+  __forceinline void store(std::size_t i, __m128i bits) const noexcept
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), bits);
+  }
+#endif
+};
+
+// base + toUnitFloat(bits) * width, 与 Stream::nextRange 的运算顺序相同 (先乘后加, 不使用 FMA)
+struct RangeOutput
+{
+  float* out;
+  float base;
+  float width;
+
+  __forceinline void scalar(std::size_t i, std::uint32_t bits) const noexcept
+  {
+    out[i] = base + toUnitFloat(bits) * width;
+  }
+#if defined(TOUHOU_SIMD_AVX2)
+  __forceinline void store(std::size_t i, __m256i bits) const noexcept
+  {
+    __m256 const unit = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(bits, 8)), _mm256_set1_ps(unitScale));
+    _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_set1_ps(base), _mm256_mul_ps(unit, _mm256_set1_ps(width))));
+  }
+#elif defined(TOUHOU_SIMD_SSE2)
+  __forceinline void store(std::size_t i, __m128i bits) const noexcept
+  {
+    __m128 const unit = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(bits, 8)), _mm_set1_ps(unitScale));
+    _mm_storeu_ps(out + i, _mm_add_ps(_mm_set1_ps(base), _mm_mul_ps(unit, _mm_set1_ps(width))));
+  }
+#endif
+};
+} // namespace
+
+template <typename Output>
+void Stream::fill(Output const& output, std::size_t count) noexcept
+{
+  std::size_t i = 0;
+  // 先逐个取数, 直到位置对齐到块的边界
+  for (; i < count && (m_position & 3) != 0; ++i) {
+    output.scalar(i, nextU32());
+  }
+  if (i == count) {
+    return;
+  }
+
+  std::uint64_t block = m_position >> 2;
+#if defined(TOUHOU_SIMD_AVX2) || defined(TOUHOU_SIMD_SSE2)
+  PhiloxKey const key{ static_cast<std::uint32_t>(m_seed), static_cast<std::uint32_t>(m_seed >> 32) };
+  for (; i + blocksPerBatch * 4 <= count; i += blocksPerBatch * 4, block += blocksPerBatch) {
+#if defined(TOUHOU_SIMD_AVX2)
+    __m256i words[4];
+#else
+    __m128i words[4];
+#endif
+    philoxBlocks(block, m_streamId, key, words);
+    for (std::size_t k = 0; k < 4; ++k) {
+      output.store(i + k * Core::Simd::FloatLanes, words[k]);
+    }
+  }
+#endif
+  for (; i + 4 <= count; i += 4, ++block) {
+    PhiloxBlock const words = generateBlock(block);
+    for (std::size_t k = 0; k < 4; ++k) {
+      output.scalar(i + k, words[k]);
+    }
+  }
+
+  // 不足一块的尾部逐个取数, 同时缓存该块供之后的 nextU32 使用
+  m_position = block << 2;
+  for (; i < count; ++i) {
+    output.scalar(i, nextU32());
+  }
+}
+
+void Stream::fillU32(std::uint32_t* out, std::size_t count) noexcept
+{
+  fill(U32Output{ out }, count);
+}
+
+void Stream::fillUniform(float* out, std::size_t count) noexcept
+{
+  // 0 + u * 1 == u, 与 nextFloat 逐位相同
+  fill(RangeOutput{ out, 0.0f, 1.0f }, count);
+}
+
+void Stream::fillRange(float* out, std::size_t count, float base, float width) noexcept
+{
+  fill(RangeOutput{ out, base, width }, count);
+}
+} // namespace Core::Random
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "Core/Platform.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// 可复现的随机数发生器, 用于随机弹幕等需要在回放中逐位重现的场合
+// std::mt19937 的状态有 2.5 KB, 播种慢, 而 std::uniform_real_distribution 等分布的实现随标准库而不同,
+// 这里的发生器只用 32 / 64 位整数运算, 浮点数由整数的高 24 位精确换算, 结果与编译器和指令集无关
+// - Xoshiro128 (xoshiro128++) 与 Pcg32: 状态 16 字节, 顺序产生随机数, 适合只在一处使用的场合
+// - Stream (Philox4x32-10): 计数器式发生器, 第 k 个数只由 (种子, 流编号, k) 决定, 不依赖之前的调用,
+//   每个发射器各用一个流编号即可得到互不重叠的随机数流, 批量填充按 TOUHOU_SIMD 选择的指令集向量化
+namespace Core::Random {
+// 取高 24 位换算为 [0, 1) 内的 float, 整数到 float 的转换与乘以 2^-24 都是精确的
+__forceinline float toUnitFloat(std::uint32_t bits) noexcept
+{
+  return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+}
+
+// 用于由一个种子展开出多个状态字 (SplitMix64)
+__forceinline std::uint64_t splitMix64(std::uint64_t& state) noexcept
+{
+  std::uint64_t z = (state += 0x9E37'79B9'7F4A'7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58'476D'1CE4'E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D0'49BB'1331'11EBull;
+  return z ^ (z >> 31);
+}
+
+// xoshiro128++: 周期 2^128 - 1, 状态不能全为 0 (由 seed 播种时不会出现)
+struct Xoshiro128
+{
+  std::array<std::uint32_t, 4> state{ 1, 2, 3, 4 };
+
+  static Xoshiro128 fromSeed(std::uint64_t seed) noexcept
+  {
+    std::uint64_t const a = splitMix64(seed);
+    std::uint64_t const b = splitMix64(seed);
+    return { { static_cast<std::uint32_t>(a),
+               static_cast<std::uint32_t>(a >> 32),
+               static_cast<std::uint32_t>(b),
+               static_cast<std::uint32_t>(b >> 32) } };
+  }
+
+  std::uint32_t nextU32() noexcept
+  {
+    std::uint32_t const result = std::rotl(state[0] + state[3], 7) + state[0];
+    std::uint32_t const t = state[1] << 9;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = std::rotl(state[3], 11);
+    return result;
+  }
+
+  float nextFloat() noexcept { return toUnitFloat(nextU32()); }
+
+  // 前进 2^64 步, 用于从同一个种子分出互不重叠的子序列
+  void jump() noexcept
+  {
+    static constexpr std::uint32_t jumpPoly[] = { 0x8764'000B, 0xF542'D2D3, 0x6FA0'35C3, 0x77F2'DB5B };
+    std::array<std::uint32_t, 4> s{};
+    for (std::uint32_t const word : jumpPoly) {
+      for (int bit = 0; bit < 32; ++bit) {
+        if ((word & (1u << bit)) != 0) {
+          for (std::size_t i = 0; i < 4; ++i) {
+            s[i] ^= state[i];
+          }
+        }
+        nextU32();
+      }
+    }
+    state = s;
+  }
+};
+
+// PCG32 (XSH RR): 64 位线性同余状态加输出置换, sequence 选择 2^63 条互不相同的序列之一
+struct Pcg32
+{
+  std::uint64_t state = 0x853C'49E6'748F'EA9Bull;
+  std::uint64_t increment = 0xDA3E'39CB'94B9'5BDBull; // 必须为奇数
+
+  static Pcg32 fromSeed(std::uint64_t seed, std::uint64_t sequence = 0) noexcept
+  {
+    Pcg32 rng{ 0, (sequence << 1) | 1 };
+    rng.nextU32();
+    rng.state += seed;
+    rng.nextU32();
+    return rng;
+  }
+
+  std::uint32_t nextU32() noexcept
+  {
+    std::uint64_t const old = state;
+    state = old * 0x5851'F42D'4C95'7F2Dull + increment;
+    std::uint32_t const xorShifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+    return std::rotr(xorShifted, static_cast<int>(old >> 59));
+  }
+
+  float nextFloat() noexcept { return toUnitFloat(nextU32()); }
+};
+
+// Philox4x32-10 的一个块: 由 128 位计数器与 64 位密钥得到 4 个 32 位随机数
+using PhiloxBlock = std::array<std::uint32_t, 4>;
+using PhiloxKey = std::array<std::uint32_t, 2>;
+
+inline constexpr std::uint32_t PhiloxM0 = 0xD251'1F53;
+inline constexpr std::uint32_t PhiloxM1 = 0xCD9E'8D57;
+inline constexpr std::uint32_t PhiloxW0 = 0x9E37'79B9; // 每轮密钥的增量
+inline constexpr std::uint32_t PhiloxW1 = 0xBB67'AE85;
+inline constexpr int PhiloxRounds = 10;
+
+constexpr PhiloxBlock philox4x32(PhiloxBlock counter, PhiloxKey key) noexcept
+{
+  for (int round = 0; round < PhiloxRounds; ++round) {
+    std::uint64_t const p0 = std::uint64_t{ PhiloxM0 } * counter[0];
+    std::uint64_t const p1 = std::uint64_t{ PhiloxM1 } * counter[2];
+    counter = { static_cast<std::uint32_t>(p1 >> 32) ^ counter[1] ^ key[0],
+                static_cast<std::uint32_t>(p1),
+                static_cast<std::uint32_t>(p0 >> 32) ^ counter[3] ^ key[1],
+                static_cast<std::uint32_t>(p0) };
+    key[0] += PhiloxW0;
+    key[1] += PhiloxW1;
+  }
+  return counter;
+}
+
+// 计数器式随机数流: 第 k 个数为 philox4x32({k / 4 的低 32 位, 高 32 位, streamId, 0}, 种子) 的第 k % 4 个字
+// 不同流编号的计数器互不相同, 因此同一种子下的各个流互不重叠; 流的全部状态只有 (种子, 流编号, 位置),
+// 保存与恢复时不需要保存发生器内部的状态, seek 可以直接跳到任意位置
+// 逐个取数与批量填充交替调用时, 结果与一直逐个取数相同
+class Stream
+{
+public:
+  Stream() noexcept
+    : Stream(0, 0)
+  {
+  }
+  Stream(std::uint64_t seed, std::uint32_t streamId, std::uint64_t position = 0) noexcept
+    : m_seed(seed)
+    , m_streamId(streamId)
+  {
+    seek(position);
+  }
+
+  std::uint32_t nextU32() noexcept
+  {
+    std::uint32_t const word = static_cast<std::uint32_t>(m_position & 3);
+    if (word == 0) {
+      m_block = generateBlock(m_position >> 2);
+    }
+    ++m_position;
+    return m_block[word];
+  }
+  float nextFloat() noexcept { return toUnitFloat(nextU32()); }
+  // [base, base + width) 内均匀分布 (width 为负时区间反向)
+  float nextRange(float base, float width) noexcept { return base + nextFloat() * width; }
+
+  // 批量取 count 个数, 与连续调用 count 次对应的单个取数函数的结果逐位相同
+  void fillU32(std::uint32_t* out, std::size_t count) noexcept;
+  void fillUniform(float* out, std::size_t count) noexcept;
+  // out[i] = base + u[i] * width, 如角度 (centerAngle - spread / 2, spread) 或速率 (speed, speedRange)
+  void fillRange(float* out, std::size_t count, float base, float width) noexcept;
+
+  // 跳到第 position 个数
+  void seek(std::uint64_t position) noexcept
+  {
+    m_position = position;
+    if ((m_position & 3) != 0) {
+      m_block = generateBlock(m_position >> 2);
+    }
+  }
+
+  std::uint64_t getSeed() const noexcept { return m_seed; }
+  std::uint32_t getStreamId() const noexcept { return m_streamId; }
+  std::uint64_t getPosition() const noexcept { return m_position; }
+
+private:
+  // 批量填充的公共实现: 对齐到块边界后按 SIMD 批量生成整块, output 决定把随机字写成何种输出 (见 Random.cpp)
+  template <typename Output>
+  void fill(Output const& output, std::size_t count) noexcept;
+
+  PhiloxBlock generateBlock(std::uint64_t index) const noexcept
+  {
+    return philox4x32(
+      { static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32), m_streamId, 0 },
+      { static_cast<std::uint32_t>(m_seed), static_cast<std::uint32_t>(m_seed >> 32) });
+  }
+
+private:
+  std::uint64_t m_seed;
+  std::uint32_t m_streamId;
+  std::uint64_t m_position = 0;
+  PhiloxBlock m_block{}; // 第 m_position / 4 块, 仅在 m_position % 4 != 0 时有效
+};
+} // namespace Core::Random
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+// SIMD 指令集在编译期选择, 由 CMake 选项 TOUHOU_SIMD 决定 (AVX2 / SSE2 / SCALAR, 见根目录 CMakeLists.txt)
+// 未定义任何选项时退回标量实现
+#if defined(TOUHOU_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(TOUHOU_SIMD_SSE2)
+#include <emmintrin.h>
+#elif !defined(TOUHOU_SIMD_SCALAR)
+#define TOUHOU_SIMD_SCALAR
+#endif
+
+namespace Core::Simd {
+#if defined(TOUHOU_SIMD_AVX2)
+inline constexpr std::size_t FloatLanes = 8; // 一个向量寄存器容纳的 float 个数
+inline constexpr char const* IsaName = "AVX2";
+#elif defined(TOUHOU_SIMD_SSE2)
+inline constexpr std::size_t FloatLanes = 4;
+inline constexpr char const* IsaName = "SSE2";
+#else
+inline constexpr std::size_t FloatLanes = 1;
+inline constexpr char const* IsaName = "Scalar";
+#endif
+} // namespace Core::Simd
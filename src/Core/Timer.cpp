@@ -1,32 +1,63 @@
 #include "Timer.hpp"
 
+#if defined(_WIN32)
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#else
+#include <chrono>
+#endif
 
 namespace Core {
 
+#if defined(_WIN32)
+std::int64_t Timer::getCounter() noexcept
+{
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+  return counter.QuadPart;
+}
+
+double Timer::getSecondsPerCount() noexcept
+{
+  // 获取高精度计时器频率, 系统启动后不会改变
+  static double const secondsPerCount = [] {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    return 1.0 / static_cast<double>(frequency.QuadPart);
+  }();
+  return secondsPerCount;
+}
+#else
+std::int64_t Timer::getCounter() noexcept
+{
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+double Timer::getSecondsPerCount() noexcept
+{
+  return static_cast<double>(std::chrono::steady_clock::period::num) / std::chrono::steady_clock::period::den;
+}
+#endif
+
 Timer::Timer()
-  : m_deltaTime(-1.0)
-  , m_baseTime(0)
+  : m_baseTime(0)
   , m_prevTime(0)
   , m_currTime(0)
+  , m_deltaTime(-1.0)
   , m_totalTime(0)
 {
-  std::int64_t countPerSec;
-  // 获取高精度计时器频率 (CPU频率)
-  QueryPerformanceFrequency(reinterpret_cast<LARGE_INTEGER*>(&countPerSec));
-  m_secondsPerCount = 1.0 / static_cast<double>(countPerSec);
+  m_secondsPerCount = getSecondsPerCount();
 
   // 初始化时间
-  QueryPerformanceCounter(reinterpret_cast<LARGE_INTEGER*>(&m_currTime));
+  m_currTime = getCounter();
   m_baseTime = m_currTime;
   m_prevTime = m_currTime;
 }
 
 void Timer::tick()
 {
-  QueryPerformanceCounter(reinterpret_cast<LARGE_INTEGER*>(&m_currTime));
+  m_currTime = getCounter();
   m_deltaTime = (m_currTime - m_prevTime) * m_secondsPerCount; // 计算两帧之间的时间差
   m_prevTime = m_currTime;                                     // 准备下一个 tick
 
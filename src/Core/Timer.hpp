@@ -3,6 +3,8 @@
 #include <cstdint>
 
 namespace Core {
+// 高精度计时器: Windows 上使用 QueryPerformanceCounter, 其他平台使用 std::chrono::steady_clock
+// (Linux 上即 clock_gettime(CLOCK_MONOTONIC)), 两者都是单调的, 不受系统时间调整影响
 class Timer
 {
 public:
@@ -17,6 +19,17 @@ public:
   // 获取从启动到现在的总时间 (Total Time, s)
   double getTotalTime() const { return m_totalTime; }
 
+  // 最近一次 tick 时的计数值, 与 getCounter 的时间基准相同
+  std::int64_t getTickCounter() const { return m_currTime; }
+
+  // 当前的计数值与每个计数代表的秒数, 供需要直接比较时间戳的地方 (如 FramePacer) 使用
+  static std::int64_t getCounter() noexcept;
+  static double getSecondsPerCount() noexcept;
+  static std::int64_t toCounter(double seconds) noexcept
+  {
+    return static_cast<std::int64_t>(seconds / getSecondsPerCount());
+  }
+
 private:
   double m_secondsPerCount; // 计数器每个 tick 代表多少秒
   std::int64_t m_baseTime;  // 启动时间
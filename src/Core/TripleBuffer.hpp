@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Core {
+// 单生产者 / 单消费者的三缓冲: 生产者与消费者各持有一份, 第三份是最近发布的一份, 双方都不会等待对方
+// 生产者写完 back() 后 publish(), 与中间的一份交换; 消费者 acquire() 时若有新发布的一份则与自己持有的交换
+// 消费者总是拿到最新发布的一份, 生产者发布得比消费者快时, 中间未被取走的旧数据被直接覆盖
+// 一份数据发布后, 直到它再次成为生产者的 back() (即下一次 publish 之后) 之前都不会被写入,
+// 因此生产者在写下一份时可以通过 published() 读取上一次发布的数据 (例如用于计算帧间差值)
+template <typename T>
+class TripleBuffer
+{
+public:
+  TripleBuffer() = default;
+
+  TripleBuffer(TripleBuffer const&) = delete;
+  TripleBuffer& operator=(TripleBuffer const&) = delete;
+
+  // 对三份数据逐一调用 fn, 只能在生产者与消费者开始工作之前调用 (预先分配内存等)
+  template <typename F>
+  void forEachSlot(F&& fn)
+  {
+    for (Slot& slot : m_slots) {
+      fn(slot.value);
+    }
+  }
+
+  // 生产者: 当前可写的一份
+  T& back() noexcept { return m_slots[m_back].value; }
+  // 生产者: 上一次发布的一份 (第一次发布之前为初始状态的一份)
+  T const& published() const noexcept { return m_slots[m_published].value; }
+  void publish() noexcept
+  {
+    m_published = m_back;
+    m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+  }
+
+  // 消费者: 有新发布的数据时换到手中并返回 true, 否则保留手中的一份并返回 false
+  bool acquire() noexcept
+  {
+    if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+      return false;
+    }
+    m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+    return true;
+  }
+  // 消费者: 手中的一份, 在下一次 acquire 之前保持不变
+  T const& front() const noexcept { return m_slots[m_front].value; }
+
+private:
+  static constexpr std::uint8_t INDEX_MASK = 0x3;
+  static constexpr std::uint8_t FRESH = 0x4; // 中间的一份是生产者新发布的, 还没有被消费者取走
+
+  // 每份独占缓存行, 避免生产者与消费者的写入互相干扰
+  struct alignas(64) Slot
+  {
+    T value{};
+  };
+
+  std::array<Slot, 3> m_slots;
+  alignas(64) std::atomic<std::uint8_t> m_middle{ 1 };
+  alignas(64) std::uint8_t m_back = 0; // 以下两项只由生产者访问
+  std::uint8_t m_published = 1;
+  alignas(64) std::uint8_t m_front = 2; // 只由消费者访问
+};
+} // namespace Core
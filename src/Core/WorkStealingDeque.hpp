@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Core {
+// Chase-Lev 工作窃取双端队列 (容量固定), 内存序按 Lê 等人 "Correct and Efficient Work-Stealing for Weak Memory Models"
+// 拥有者在队尾 push / pop (LIFO, 刚提交的任务数据还在缓存中), 其它线程在队首 steal (FIFO, 先偷走较大较早的任务)
+// push 与 pop 只能由同一时刻的唯一拥有者调用; steal 可以被任意线程同时调用, 全程无锁
+// T 为指针等可以原子读写的小类型, 队列只保存而不拥有它
+template <typename T>
+class WorkStealingDeque
+{
+public:
+  // capacity 为 2 的幂
+  explicit WorkStealingDeque(std::size_t capacity)
+    : m_mask(static_cast<std::int64_t>(capacity) - 1)
+    , m_slots(std::make_unique<std::atomic<T>[]>(capacity))
+  {
+  }
+
+  WorkStealingDeque(WorkStealingDeque const&) = delete;
+  WorkStealingDeque& operator=(WorkStealingDeque const&) = delete;
+
+  // 拥有者: 压入队尾, 队列已满时返回 false
+  bool push(T value) noexcept
+  {
+    std::int64_t const bottom = m_bottom.load(std::memory_order_relaxed);
+    std::int64_t const top = m_top.load(std::memory_order_acquire);
+    if (bottom - top > m_mask) {
+      return false;
+    }
+    m_slots[bottom & m_mask].store(value, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // 拥有者: 从队尾取出, 队列为空 (或最后一个元素被窃取者抢走) 时返回 false
+  bool pop(T& out) noexcept
+  {
+    std::int64_t const bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top = m_top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+      m_bottom.store(bottom + 1, std::memory_order_relaxed);
+      return false;
+    }
+    out = m_slots[bottom & m_mask].load(std::memory_order_relaxed);
+    if (top < bottom) {
+      return true;
+    }
+    // 只剩最后一个元素, 与窃取者竞争
+    bool const won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    return won;
+  }
+
+  // 任意线程: 从队首窃取, 队列为空或与其它线程竞争失败时返回 false
+  bool steal(T& out) noexcept
+  {
+    std::int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t const bottom = m_bottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return false;
+    }
+    out = m_slots[top & m_mask].load(std::memory_order_relaxed);
+    return m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+  }
+
+  // 近似地判断是否为空 (其它线程可能同时在修改), 只用于决定是否休眠
+  bool empty() const noexcept
+  {
+    return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::int64_t const m_mask;
+  std::unique_ptr<std::atomic<T>[]> m_slots;
+  alignas(64) std::atomic<std::int64_t> m_top{ 0 };    // 窃取者竞争的一端
+  alignas(64) std::atomic<std::int64_t> m_bottom{ 0 }; // 只由拥有者写入
+};
+} // namespace Core
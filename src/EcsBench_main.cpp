@@ -0,0 +1,288 @@
+#include "Core/MathUtils.hpp"
+#include "Game/BulletPattern.hpp"
+#include "Game/EntityWorld.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// 原型 ECS 的开销测量: 1 万个敌机 (6 个组件) 与 1 万个道具 (4 个组件)
+// 每帧运行敌机 AI / 道具下落 / 移动三个系统, 耗尽体力的敌机与落出屏幕的道具经命令缓冲区销毁并补充 (每帧约 1%)
+// 对比传统的虚函数对象 (每个对象单独分配, 逐个调用 update)
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double elapsedMicros(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+constexpr std::size_t EnemyCount = 10'000;
+constexpr std::size_t ItemCount = 10'000;
+constexpr int Frames = 600;
+constexpr float ScreenHeight = 960.0f;
+constexpr std::int32_t EnemyHealth = 100; // 每帧扣 1, 稳定后每帧约 1% 的敌机被击破
+
+struct Position
+{
+  float x;
+  float y;
+};
+
+struct Velocity
+{
+  float vx;
+  float vy;
+};
+
+struct Health
+{
+  std::int32_t hp;
+};
+
+struct Sprite
+{
+  std::uint16_t type;
+  std::uint16_t color;
+};
+
+struct Timer
+{
+  std::uint32_t frames;
+};
+
+struct Wander
+{
+  float phase;
+  float amplitude;
+};
+
+struct ItemValue
+{
+  std::uint32_t score;
+};
+
+Position randomPosition(Game::PatternRng& rng)
+{
+  return { rng.nextFloat() * 1280.0f, rng.nextFloat() * ScreenHeight * 0.5f };
+}
+
+// ---- ECS ----
+
+void spawnEnemy(Game::EntityCommandBuffer& commands, Game::PatternRng& rng)
+{
+  commands.create(randomPosition(rng),
+                  Velocity{ 0.0f, 0.5f },
+                  Health{ static_cast<std::int32_t>(rng.nextU32() % EnemyHealth) + 1 },
+                  Sprite{ 1, 0 },
+                  Timer{ 0 },
+                  Wander{ rng.nextFloat() * 6.28f, 1.5f });
+}
+
+void spawnItem(Game::EntityCommandBuffer& commands, Game::PatternRng& rng)
+{
+  commands.create(randomPosition(rng), Velocity{ 0.0f, -1.5f }, Sprite{ 2, 0 }, ItemValue{ 10 });
+}
+
+double runEcs(double& checksum, std::size_t& chunkCount, double& flushMicros)
+{
+  Game::EntityWorld world;
+  world.reserve(EnemyCount + ItemCount);
+  Game::EntityCommandBuffer& commands = world.getCommandBuffer();
+  Game::PatternRng rng;
+  for (std::size_t i = 0; i < EnemyCount; ++i) {
+    spawnEnemy(commands, rng);
+  }
+  for (std::size_t i = 0; i < ItemCount; ++i) {
+    spawnItem(commands, rng);
+  }
+  world.flush();
+
+  double micros = 0.0;
+  flushMicros = 0.0;
+  for (int f = 0; f < Frames; ++f) {
+    auto const start = Clock::now();
+
+    // 敌机 AI: 按计时器左右摆动, 每块是一段连续的数组
+    world.forEachChunk<Velocity, Health, Timer, Wander const>(
+      [](std::size_t count, Game::Entity const*, Velocity* velocity, Health* health, Timer* timer, Wander const* wander) {
+        for (std::size_t i = 0; i < count; ++i) {
+          ++timer[i].frames;
+          --health[i].hp;
+          velocity[i].vx =
+            Core::Math::sin(wander[i].phase + static_cast<float>(timer[i].frames) * 0.05f) * wander[i].amplitude;
+        }
+      });
+    // 道具下落
+    world.forEachChunk<Velocity, ItemValue const>(
+      [](std::size_t count, Game::Entity const*, Velocity* velocity, ItemValue const*) {
+        for (std::size_t i = 0; i < count; ++i) {
+          velocity[i].vy = std::min(velocity[i].vy + 0.05f, 2.5f);
+        }
+      });
+    // 移动: 匹配敌机与道具两个原型
+    world.forEachChunk<Position, Velocity const>(
+      [](std::size_t count, Game::Entity const*, Position* position, Velocity const* velocity) {
+        for (std::size_t i = 0; i < count; ++i) {
+          position[i].x += velocity[i].vx;
+          position[i].y += velocity[i].vy;
+        }
+      });
+
+    // 遍历中只记录销毁与补充, 结构性修改全部延迟到帧末
+    world.forEach<Health const>([&](Game::Entity entity, Health const& health) {
+      if (health.hp <= 0) {
+        commands.destroy(entity);
+        spawnEnemy(commands, rng);
+      }
+    });
+    world.forEach<Position const, ItemValue const>([&](Game::Entity entity, Position const& position, ItemValue const&) {
+      if (position.y > ScreenHeight) {
+        commands.destroy(entity);
+        spawnItem(commands, rng);
+      }
+    });
+    auto const flushStart = Clock::now();
+    world.flush();
+    flushMicros += elapsedMicros(flushStart);
+
+    micros += elapsedMicros(start);
+  }
+
+  checksum = 0.0;
+  world.forEach<Position const>([&](Game::Entity, Position const& p) { checksum += p.x + p.y; });
+  chunkCount = world.getChunkCount();
+  flushMicros /= Frames;
+  return micros / Frames;
+}
+
+// ---- 对照: 虚函数对象 ----
+
+struct GameObject
+{
+  virtual ~GameObject() = default;
+  virtual void update() = 0;
+  virtual bool isDead() const = 0;
+  virtual bool isItem() const = 0;
+
+  Position position{};
+  Velocity velocity{};
+  Sprite sprite{};
+};
+
+struct Enemy final : GameObject
+{
+  void update() override
+  {
+    ++timer.frames;
+    --health.hp;
+    velocity.vx = Core::Math::sin(wander.phase + static_cast<float>(timer.frames) * 0.05f) * wander.amplitude;
+    position.x += velocity.vx;
+    position.y += velocity.vy;
+  }
+  bool isDead() const override { return health.hp <= 0; }
+  bool isItem() const override { return false; }
+
+  Health health{};
+  Timer timer{};
+  Wander wander{};
+};
+
+struct Item final : GameObject
+{
+  void update() override
+  {
+    velocity.vy = std::min(velocity.vy + 0.05f, 2.5f);
+    position.x += velocity.vx;
+    position.y += velocity.vy;
+  }
+  bool isDead() const override { return position.y > ScreenHeight; }
+  bool isItem() const override { return true; }
+
+  ItemValue value{};
+};
+
+std::unique_ptr<GameObject> makeEnemy(Game::PatternRng& rng)
+{
+  auto enemy = std::make_unique<Enemy>();
+  enemy->position = randomPosition(rng);
+  enemy->velocity = { 0.0f, 0.5f };
+  enemy->sprite = { 1, 0 };
+  enemy->health = { static_cast<std::int32_t>(rng.nextU32() % EnemyHealth) + 1 };
+  enemy->wander = { rng.nextFloat() * 6.28f, 1.5f };
+  return enemy;
+}
+
+std::unique_ptr<GameObject> makeItem(Game::PatternRng& rng)
+{
+  auto item = std::make_unique<Item>();
+  item->position = randomPosition(rng);
+  item->velocity = { 0.0f, -1.5f };
+  item->sprite = { 2, 0 };
+  item->value = { 10 };
+  return item;
+}
+
+double runObjects(double& checksum)
+{
+  std::vector<std::unique_ptr<GameObject>> objects;
+  Game::PatternRng rng;
+  for (std::size_t i = 0; i < EnemyCount + ItemCount; ++i) {
+    objects.push_back(i % 2 == 0 ? makeEnemy(rng) : makeItem(rng)); // 敌机与道具交替生成, 在堆上交错分布
+  }
+
+  double micros = 0.0;
+  for (int f = 0; f < Frames; ++f) {
+    auto const start = Clock::now();
+    for (auto const& object : objects) {
+      object->update();
+    }
+    // 被销毁的对象原地替换为新分配的对象
+    for (auto& object : objects) {
+      if (object->isDead()) {
+        object = object->isItem() ? makeItem(rng) : makeEnemy(rng);
+      }
+    }
+    micros += elapsedMicros(start);
+  }
+
+  checksum = 0.0;
+  for (auto const& object : objects) {
+    checksum += object->position.x + object->position.y;
+  }
+  return micros / Frames;
+}
+} // namespace
+
+int main()
+{
+  std::cout << std::format("== archetype ECS ({} enemies x 6 components, {} items x 4 components) ==\n",
+                           EnemyCount,
+                           ItemCount);
+
+  double ecsChecksum = 0.0;
+  std::size_t chunkCount = 0;
+  double flushMicros = 0.0;
+  double const ecsMicros = runEcs(ecsChecksum, chunkCount, flushMicros);
+  std::cout << std::format("ecs      {:>8.1f} us per frame (command buffer flush {:>6.1f} us, {} chunks of {} KB, "
+                           "checksum {:.0f})\n",
+                           ecsMicros,
+                           flushMicros,
+                           chunkCount,
+                           Game::EntityWorld::CHUNK_SIZE / 1024,
+                           ecsChecksum);
+
+  double objectChecksum = 0.0;
+  double const objectMicros = runObjects(objectChecksum);
+  std::cout << std::format("objects  {:>8.1f} us per frame (virtual update, one heap block per object, checksum {:.0f})\n",
+                           objectMicros,
+                           objectChecksum);
+  return 0;
+}
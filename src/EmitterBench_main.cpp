@@ -0,0 +1,136 @@
+#include "Core/Random.hpp"
+#include "Core/Simd.hpp"
+#include "Game/BulletManager.hpp"
+#include "Game/BulletPattern.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <numbers>
+
+// 批量发射 (emitRing / emitFan / emitSpiral / emitRandomSpread) 与逐颗调用 spawnBulletA 的开销对比
+// 每轮清空内存池后用 BatchCount 颗一组的图案把 10 万颗子弹的内存池填满, 统计每颗子弹的平均耗时
+// 逐颗版本按与批量版本相同的公式计算角度和速率, 最后比较两者的状态哈希, 确认生成的子弹逐位相同
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t Capacity = 100'000;
+constexpr std::size_t BatchCounts[] = { 8, 64, 512 };
+constexpr int Rounds = 50;
+constexpr std::uint64_t Seed = 2024;
+
+Game::EmitParams const params{ .x = 640.0f, .y = 240.0f, .speed = 2.0f, .angVel = 0.001f, .type = 3, .color = 1 };
+
+// 对 fill(manager, group) 计时: 每轮从空内存池开始, 按组调用直到填满
+template <typename Fill>
+double measure(Game::BulletManager& manager, std::size_t batch, Fill&& fill)
+{
+  double nanos = 0.0;
+  for (int r = 0; r < Rounds; ++r) {
+    manager.clearBullets();
+    auto const start = Clock::now();
+    for (std::size_t group = 0; group < Capacity / batch; ++group) {
+      fill(manager, group);
+    }
+    nanos += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  }
+  return nanos / (static_cast<double>(Rounds) * static_cast<double>(Capacity / batch * batch));
+}
+
+template <typename Batched, typename Single>
+void compare(char const* name, std::size_t batch, Batched&& batched, Single&& single)
+{
+  Game::BulletManager batchManager;
+  Game::BulletManager singleManager;
+  batchManager.init(Capacity);
+  singleManager.init(Capacity);
+
+  double const batchNanos = measure(batchManager, batch, batched);
+  double const singleNanos = measure(singleManager, batch, single);
+  bool const same = batchManager.computeStateHash() == singleManager.computeStateHash();
+  std::cout << std::format("{:<14}{:>6}{:>12.2f}{:>12.2f}{:>10.2f}x  {}\n",
+                           name,
+                           batch,
+                           batchNanos,
+                           singleNanos,
+                           singleNanos / batchNanos,
+                           same ? "same bullets" : "BULLETS DIFFER");
+}
+
+void spawnOne(Game::BulletManager& manager, float angle, float speed)
+{
+  manager.spawnBulletA(
+    params.x, params.y, angle, params.angVel, params.angAccel, speed, params.tanAccel, params.type, params.color);
+}
+} // namespace
+
+int main()
+{
+  std::cout << std::format("bullet emitters, {} bullets per round, ns per bullet (SIMD = {})\n",
+                           Capacity,
+                           Core::Simd::IsaName);
+  std::cout << std::format("{:<14}{:>6}{:>12}{:>12}{:>11}\n", "pattern", "batch", "emit*", "spawnBullet", "speedup");
+
+  for (std::size_t const batch : BatchCounts) {
+    float const count = static_cast<float>(batch);
+    float const ringStep = std::numbers::pi_v<float> * 2.0f / count;
+    compare(
+      "ring",
+      batch,
+      [batch](Game::BulletManager& m, std::size_t group) { m.emitRing(params, 0.1f * group, batch); },
+      [batch, ringStep](Game::BulletManager& m, std::size_t group) {
+        for (std::size_t i = 0; i < batch; ++i) {
+          spawnOne(m, 0.1f * group + static_cast<float>(i) * ringStep, params.speed);
+        }
+      });
+
+    constexpr float spread = 1.2f;
+    float const fanStep = spread / (count - 1.0f);
+    compare(
+      "fan",
+      batch,
+      [batch](Game::BulletManager& m, std::size_t group) { m.emitFan(params, 0.1f * group, spread, batch); },
+      [batch, fanStep](Game::BulletManager& m, std::size_t group) {
+        for (std::size_t i = 0; i < batch; ++i) {
+          spawnOne(m, 0.1f * group - spread * 0.5f + static_cast<float>(i) * fanStep, params.speed);
+        }
+      });
+
+    constexpr float angleStep = 0.13f;
+    constexpr float speedStep = 0.01f;
+    compare(
+      "spiral",
+      batch,
+      [batch](Game::BulletManager& m, std::size_t group) {
+        m.emitSpiral(params, 0.1f * group, angleStep, speedStep, batch);
+      },
+      [batch](Game::BulletManager& m, std::size_t group) {
+        for (std::size_t i = 0; i < batch; ++i) {
+          float const f = static_cast<float>(i);
+          spawnOne(m, 0.1f * group + f * angleStep, params.speed + f * speedStep);
+        }
+      });
+
+    // 批量版本先取整批角度再取整批速率; 逐颗版本用两个流分别从对应的位置取数, 得到相同的数
+    constexpr float speedRange = 1.5f;
+    compare(
+      "random spread",
+      batch,
+      [batch](Game::BulletManager& m, std::size_t group) {
+        Core::Random::Stream rng(Seed, static_cast<std::uint32_t>(group));
+        m.emitRandomSpread(params, 0.0f, spread, speedRange, batch, rng);
+      },
+      [batch](Game::BulletManager& m, std::size_t group) {
+        Core::Random::Stream angles(Seed, static_cast<std::uint32_t>(group));
+        Core::Random::Stream speeds(Seed, static_cast<std::uint32_t>(group), batch);
+        for (std::size_t i = 0; i < batch; ++i) {
+          float const angle = angles.nextRange(-spread * 0.5f, spread);
+          spawnOne(m, angle, speeds.nextRange(params.speed, speedRange));
+        }
+      });
+  }
+  return 0;
+}
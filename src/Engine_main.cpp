@@ -1,6 +1,47 @@
 #include "Core/Application.hpp"
+#include "Core/JobSystem.hpp"
 #include "Core/Logger.hpp"
-#include "Core/MathUtils.hpp"
+#include "Core/Profiler.hpp"
+#include "Game/Replay.hpp"
+#include "Game/Stage.hpp"
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+namespace {
+// 无窗口回放: 不创建窗口和渲染器, 以最快速度模拟整段录像, 报告耗时与最终状态哈希
+int playReplayHeadless(std::string const& path, std::string const& profilePath)
+{
+  Game::Replay const replay = Game::Replay::loadFromFile(path);
+
+  Core::JobSystem jobSystem;
+  Game::Stage stage;
+  stage.init(replay.config, &jobSystem);
+
+  Game::ReplayPlayer player(replay);
+  player.reset(stage);
+
+  PROFILE_THREAD_NAME("Main");
+  if (!profilePath.empty()) {
+    Core::Profiler::beginCapture();
+  }
+  auto const start = std::chrono::steady_clock::now();
+  std::uint32_t const frames = player.runTo(stage, replay.frameCount);
+  auto const elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  if (!profilePath.empty()) {
+    Core::Profiler::writeChromeTrace(profilePath);
+  }
+
+  LOG_INFO("Replay finished: {} frames in {:.2f} ms ({:.1f} frames/ms), {} desyncs, final hash {:016X}",
+           frames,
+           elapsed,
+           elapsed > 0.0 ? frames / elapsed : 0.0,
+           player.getDesyncCount(),
+           stage.computeStateHash());
+  return player.getDesyncCount() == 0 ? 0 : 1;
+}
+} // namespace
 
 int main(int argc, char* argv[])
 {
@@ -9,12 +50,44 @@ int main(int argc, char* argv[])
   _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 #endif
 
-  Core::Math::initMathUtils();
+  // 命令行参数: --record <file> 录制本局录像; --replay <file> 无窗口回放录像;
+  // --profile <file> 采集 CPU 剖析数据, 退出时写入 Chrome trace (需以 TOUHOU_PROFILE 构建);
+  // --metrics <file> 退出或按 F9 时导出模拟帧与渲染帧的指标 (.json 为 JSON, 否则为两个 CSV);
+  // --interpolate 在两次模拟之间插值, 每次循环都渲染
+  std::string recordPath;
+  std::string replayPath;
+  std::string profilePath;
+  std::string metricsPath;
+  bool interpolate = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view const arg = argv[i];
+    bool const hasValue = i + 1 < argc;
+    if (arg == "--record" && hasValue) {
+      recordPath = argv[++i];
+    } else if (arg == "--replay" && hasValue) {
+      replayPath = argv[++i];
+    } else if (arg == "--profile" && hasValue) {
+      profilePath = argv[++i];
+    } else if (arg == "--metrics" && hasValue) {
+      metricsPath = argv[++i];
+    } else if (arg == "--interpolate") {
+      interpolate = true;
+    }
+  }
 
   try {
-    Core::Application::Config config{
-      .title = "東方弾幕クリエイター ~ Touhou Engine Dev", .width = 1280, .height = 960, .vsync = false
-    };
+    if (!replayPath.empty()) {
+      return playReplayHeadless(replayPath, profilePath);
+    }
+
+    Core::Application::Config config{ .title = "東方弾幕クリエイター ~ Touhou Engine Dev",
+                                      .width = 1280,
+                                      .height = 960,
+                                      .vsync = false,
+                                      .recordReplayPath = recordPath,
+                                      .profileTracePath = profilePath,
+                                      .metricsPath = metricsPath,
+                                      .interpolate = interpolate };
     Core::Application app{ config };
     app.run();
   } catch (std::exception& e) {
@@ -0,0 +1,133 @@
+#include "Core/FastMath.hpp"
+#include "Core/Simd.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <vector>
+
+// 快速近似函数 (fastAtan2 / fastRsqrt / fastHypot) 与标准库 (std::atan2 / 1 / std::sqrt / std::hypot) 的精度与吞吐对比
+// 输入为子弹速度量级的矢量 (各分量在 [-10, 10]) 与跨越 8 个数量级的正数, 误差以双精度的标准库结果为参照
+// atan2 报告最大绝对误差 (弧度), rsqrt 与 hypot 报告最大相对误差
+
+namespace {
+constexpr std::size_t Count = 100'000; // 每轮的输入个数
+constexpr int Rounds = 200;            // 计时轮数, 取平均
+
+struct Result
+{
+  double maxError;  // 相对参照值的最大误差
+  double nsPerCall; // 平均每个输入的耗时 (ns)
+};
+
+// func() 把 Count 个结果写入 out; reference(i) 为第 i 个输入的双精度参照值
+template <typename VFunc, typename VReference>
+Result measure(std::vector<float> const& out, bool relative, VFunc func, VReference reference)
+{
+  func(); // 预热
+
+  double maxError = 0.0;
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    double const expected = reference(i);
+    double const error = std::fabs(out[i] - expected);
+    maxError = std::max(maxError, relative ? error / std::fabs(expected) : error);
+  }
+
+  auto const start = std::chrono::steady_clock::now();
+  for (int r = 0; r < Rounds; ++r) {
+    func();
+  }
+  auto const elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  return { maxError, elapsed / (static_cast<double>(Rounds) * static_cast<double>(out.size())) };
+}
+
+template <typename VScalar>
+auto scalarLoop(std::vector<float> const& a, std::vector<float> const& b, std::vector<float>& out, VScalar f)
+{
+  return [&a, &b, &out, f]() {
+    for (std::size_t i = 0; i < out.size(); ++i) {
+      out[i] = f(a[i], b[i]);
+    }
+  };
+}
+} // namespace
+
+int main()
+{
+  using namespace Core::Math;
+
+  // 用固定种子的线性同余生成器得到可复现的输入
+  std::uint32_t state = 12345u;
+  auto const next = [&state] {
+    state = state * 1664525u + 1013904223u;
+    return static_cast<float>(state >> 8) / 16777216.0f;
+  };
+
+  std::vector<float> vx(Count);
+  std::vector<float> vy(Count);
+  std::vector<float> positive(Count); // rsqrt 的输入, 在 [1e-4, 1e4] 上按对数均匀分布
+  for (std::size_t i = 0; i < Count; ++i) {
+    vx[i] = (next() - 0.5f) * 20.0f;
+    vy[i] = (next() - 0.5f) * 20.0f;
+    positive[i] = std::pow(10.0f, next() * 8.0f - 4.0f);
+  }
+  std::vector<float> out(Count);
+
+  auto const atan2Reference = [&](std::size_t i) { return std::atan2(static_cast<double>(vy[i]), vx[i]); };
+  auto const rsqrtReference = [&](std::size_t i) { return 1.0 / std::sqrt(static_cast<double>(positive[i])); };
+  auto const hypotReference = [&](std::size_t i) { return std::hypot(static_cast<double>(vx[i]), vy[i]); };
+
+  struct Case
+  {
+    char const* name;
+    Result result;
+  };
+
+  Case const cases[] = {
+    { "std::atan2",
+      measure(out, false, scalarLoop(vy, vx, out, [](float y, float x) { return std::atan2(y, x); }), atan2Reference) },
+    { "fastAtan2 (scalar)",
+      measure(out, false, scalarLoop(vy, vx, out, [](float y, float x) { return fastAtan2(y, x); }), atan2Reference) },
+    { "fastAtan2Batch",
+      measure(
+        out, false, [&]() { fastAtan2Batch(vy.data(), vx.data(), out.data(), Count); }, atan2Reference) },
+    { "1 / std::sqrt",
+      measure(out,
+              true,
+              scalarLoop(positive, positive, out, [](float x, float) { return 1.0f / std::sqrt(x); }),
+              rsqrtReference) },
+    { "fastRsqrt (scalar)",
+      measure(
+        out, true, scalarLoop(positive, positive, out, [](float x, float) { return fastRsqrt(x); }), rsqrtReference) },
+    { "fastRsqrtBatch",
+      measure(
+        out, true, [&]() { fastRsqrtBatch(positive.data(), out.data(), Count); }, rsqrtReference) },
+    { "std::hypot",
+      measure(out, true, scalarLoop(vx, vy, out, [](float x, float y) { return std::hypot(x, y); }), hypotReference) },
+    { "std::sqrt(x*x + y*y)",
+      measure(out,
+              true,
+              scalarLoop(vx, vy, out, [](float x, float y) { return std::sqrt(x * x + y * y); }),
+              hypotReference) },
+    { "fastHypot (scalar)",
+      measure(out, true, scalarLoop(vx, vy, out, [](float x, float y) { return fastHypot(x, y); }), hypotReference) },
+    { "fastHypotBatch",
+      measure(
+        out, true, [&]() { fastHypotBatch(vx.data(), vy.data(), out.data(), Count); }, hypotReference) },
+  };
+
+  std::cout << std::format(
+    "fast math benchmark: {} inputs x {} rounds, SIMD = {}\n", Count, Rounds, Core::Simd::IsaName);
+  std::cout << std::format("{:<24}{:>16}{:>14}\n", "method", "max error", "ns / call");
+  for (Case const& c : cases) {
+    std::cout << std::format("{:<24}{:>16.3e}{:>14.3f}\n", c.name, c.result.maxError, c.result.nsPerCall);
+  }
+  std::cout << "(atan2: max absolute error in radians; rsqrt / hypot: max relative error)\n";
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+#include "Core/FramePacer.hpp"
+#include "Core/Timer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// 帧节奏的抖动测量: 以 60 Hz 的固定时刻表等待若干帧, 记录每帧醒来时刻晚于截止时间多少 (us), 报告分位数
+// 对比原来的 "每次休眠 1 ms 直到截止时间", 一次休眠到截止时间, 以及 FramePacer 的先休眠后自旋
+// 可移植, 在 Linux 上同样运行; 命令行参数为每种方式的帧数 (默认 180, 即 3 秒)
+
+namespace {
+constexpr double FramePeriod = 1.0 / 60.0;
+
+struct Jitter
+{
+  double p50;
+  double p90;
+  double p99;
+  double max;
+};
+
+Jitter summarize(std::vector<double> errors)
+{
+  std::sort(errors.begin(), errors.end());
+  auto const at = [&](std::size_t percent) { return errors[(errors.size() - 1) * percent / 100]; };
+  return { at(50), at(90), at(99), errors.back() };
+}
+
+// 按固定时刻表调用 wait(deadline) frames 次, 返回每次醒来的误差 (us)
+template <typename F>
+std::vector<double> run(std::size_t frames, F&& wait)
+{
+  std::vector<double> errors;
+  errors.reserve(frames);
+  std::int64_t const period = Core::Timer::toCounter(FramePeriod);
+  std::int64_t deadline = Core::Timer::getCounter() + period;
+  for (std::size_t i = 0; i < frames; ++i, deadline += period) {
+    wait(deadline);
+    errors.push_back((Core::Timer::getCounter() - deadline) * Core::Timer::getSecondsPerCount() * 1e6);
+  }
+  return errors;
+}
+
+void report(char const* name, std::vector<double> const& errors)
+{
+  Jitter const jitter = summarize(errors);
+  std::cout << std::format("{:<24} p50 {:>8.1f} us  p90 {:>8.1f} us  p99 {:>8.1f} us  max {:>8.1f} us\n",
+                           name,
+                           jitter.p50,
+                           jitter.p90,
+                           jitter.p99,
+                           jitter.max);
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  std::size_t const frames = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 180;
+  if (frames == 0) {
+    return 1;
+  }
+  std::cout << std::format("== wake-up lateness at 60 Hz, {} frames each ==\n", frames);
+
+  report("sleep 1 ms loop", run(frames, [](std::int64_t deadline) {
+           while (Core::Timer::getCounter() < deadline) {
+             std::this_thread::sleep_for(std::chrono::milliseconds(1));
+           }
+         }));
+
+  report("sleep to deadline", run(frames, [](std::int64_t deadline) {
+           double const remaining = (deadline - Core::Timer::getCounter()) * Core::Timer::getSecondsPerCount();
+           if (remaining > 0.0) {
+             std::this_thread::sleep_for(std::chrono::duration<double>(remaining));
+           }
+         }));
+
+  Core::FramePacer pacer;
+  report("FramePacer", run(frames, [&](std::int64_t deadline) { pacer.waitUntil(deadline); }));
+
+  Core::FramePacer::Stats const stats = pacer.getStats();
+  std::cout << std::format("FramePacer: sleep overshoot {:.1f} us, spin margin {:.1f} us, spin {:.1f} us per frame "
+                           "({:.1f}% of the frame)\n",
+                           stats.overshootMeanUs,
+                           stats.spinMarginUs,
+                           stats.spinMeanUs,
+                           stats.spinMeanUs / (FramePeriod * 1e6) * 100.0);
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include "AnalyticBulletPool.hpp"
+#include "Core/Logger.hpp"
+
+#include <format>
+#include <stdexcept>
+#include <string>
+
+namespace Game {
+
+void AnalyticBulletPool::init(std::size_t capacity)
+{
+  m_entries.clear();
+  m_entries.reserve(capacity);
+  m_capacity = capacity;
+  m_frame = 0;
+  m_lastCullFrame = 0;
+  LOG_INFO("AnalyticBulletPool initialized with capacity: {}", capacity);
+}
+
+bool AnalyticBulletPool::spawn(Bullet const& bullet, std::uint32_t frame, BulletBounds const& bounds) noexcept
+{
+  if (m_entries.size() >= m_capacity || !Trajectory::isAnalytic(bullet)) {
+    return false;
+  }
+
+  Entry entry{ .trajectory = Trajectory::fromBullet(bullet),
+               .spawnFrame = frame,
+               .type = bullet.type,
+               .color = bullet.color };
+  std::uint32_t const exitFrames = entry.trajectory.exitFrames(bounds);
+  if (exitFrames != Trajectory::NEVER && exitFrames < Trajectory::NEVER - frame) {
+    entry.expiryFrame = frame + exitFrames;
+  }
+  m_entries.push_back(entry);
+  return true;
+}
+
+void AnalyticBulletPool::advanceTo(std::uint32_t frame, BulletBounds const& bounds)
+{
+  // 已回收的子弹不再保存, 无法向回推进
+  if (frame < m_frame) {
+    std::string const message =
+      std::format("AnalyticBulletPool cannot seek backwards: frame {} is before frame {}", frame, m_frame);
+    LOG_ERROR(message);
+    throw std::runtime_error(message);
+  }
+  m_frame = frame;
+
+  bool const sweep = frame - m_lastCullFrame >= CULL_INTERVAL;
+  if (sweep) {
+    m_lastCullFrame = frame;
+  }
+
+  // 子弹之间没有顺序要求, 用交换删除
+  for (std::size_t i = 0; i < m_entries.size();) {
+    Entry const& entry = m_entries[i];
+    bool dead = entry.expiryFrame <= frame;
+    if (!dead && sweep && entry.expiryFrame == Trajectory::NEVER) {
+      TrajectoryState const state = entry.trajectory.evaluate(frame - entry.spawnFrame);
+      dead = state.x < bounds.left || state.x > bounds.right || state.y < bounds.top || state.y > bounds.bottom;
+    }
+
+    if (dead) {
+      m_entries[i] = m_entries.back();
+      m_entries.pop_back();
+    } else {
+      ++i;
+    }
+  }
+}
+
+void AnalyticBulletPool::evaluatePositions(std::uint32_t frame, float* outX, float* outY) const noexcept
+{
+  for (std::size_t i = 0; i < m_entries.size(); ++i) {
+    TrajectoryState const state = evaluate(i, frame);
+    outX[i] = state.x;
+    outY[i] = state.y;
+  }
+}
+} // namespace Game
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Game/Bullet.hpp"
+#include "Game/BulletKernel.hpp"
+#include "Game/Trajectory.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Game {
+// 惰性求值的子弹池: 只保存发射状态和发射帧, 不做逐帧积分
+// 位置在渲染或碰撞需要时由 Trajectory 以 O(1) 求出, 因此可以向前直接跳到任意帧 (如快进回放), 不需要逐帧推进
+// 只能向前跳: advanceTo 回收的子弹不再保存, 回滚到更早的帧需要恢复那一帧时池的副本, 而不是向回推进
+// 直线运动的子弹在发射时算出出界帧, 到期直接回收; 转弯的子弹每隔 CULL_INTERVAL 帧统一求值检查一次是否出界
+class AnalyticBulletPool
+{
+public:
+  struct Entry
+  {
+    Trajectory trajectory;
+    std::uint32_t spawnFrame = 0;
+    std::uint32_t expiryFrame = Trajectory::NEVER; // 从这一帧起子弹不再存在
+    std::uint16_t type = 0;
+    std::uint16_t color = 0;
+  };
+
+  static constexpr std::uint32_t CULL_INTERVAL = 30; // 转弯子弹出界扫描的间隔 (帧)
+
+  AnalyticBulletPool() = default;
+  ~AnalyticBulletPool() = default;
+
+  AnalyticBulletPool(AnalyticBulletPool const&) = delete;
+  AnalyticBulletPool& operator=(AnalyticBulletPool const&) = delete;
+
+  void init(std::size_t capacity); // 初始化内存池大小
+
+  // 在 frame 帧发射子弹; 子弹有角加速度 (不能解析求值) 或内存池已满时返回 false
+  bool spawn(Bullet const& bullet, std::uint32_t frame, BulletBounds const& bounds) noexcept;
+
+  // 推进到 frame 帧: 回收已到期的直线子弹, 到达扫描间隔时检查转弯子弹是否出界
+  // frame 可以向前跳跃, 不要求逐帧调用; frame 早于上一次推进到的帧时抛出 std::runtime_error
+  void advanceTo(std::uint32_t frame, BulletBounds const& bounds);
+  // 上一次 advanceTo 推进到的帧
+  std::uint32_t getFrame() const noexcept { return m_frame; }
+
+  // 第 index 颗子弹在 frame 帧的状态; frame 早于发射帧时子弹尚不存在, 返回发射时的状态
+  TrajectoryState evaluate(std::size_t index, std::uint32_t frame) const noexcept
+  {
+    Entry const& entry = m_entries[index];
+    return entry.trajectory.evaluate(frame > entry.spawnFrame ? frame - entry.spawnFrame : 0);
+  }
+  // 求出全部子弹在 frame 帧的位置, 写入 outX / outY (至少 getActiveCount() 个元素)
+  void evaluatePositions(std::uint32_t frame, float* outX, float* outY) const noexcept;
+
+  std::vector<Entry> const& getEntries() const noexcept { return m_entries; }
+  std::size_t getActiveCount() const noexcept { return m_entries.size(); }
+
+  void clear() noexcept { m_entries.clear(); }
+
+private:
+  std::vector<Entry> m_entries;
+  std::size_t m_capacity = 0;
+  std::uint32_t m_frame = 0;
+  std::uint32_t m_lastCullFrame = 0;
+};
+} // namespace Game
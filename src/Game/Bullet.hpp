@@ -17,6 +17,8 @@ struct Bullet
   std::uint16_t type = 0;  // 子弹 (贴图) 类型
   std::uint16_t color = 0; // 颜色
 
+  // 单颗子弹的参考实现, 浮点模式下 BulletManager 使用 BulletKernel 中逐位一致的批量版本
+  // 定点模式 (TOUHOU_FIXED_POINT) 下内存池以整数运算积分, 结果与此处只在舍入误差范围内一致
   __forceinline void updatePosition() noexcept
   {
     // 半隐式欧拉积分: 先更新速度, 再更新位置
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Game {
+// 子弹句柄: 稀疏表槽位 + 代数 (generation)
+// 子弹被回收时其槽位的代数加一, 旧句柄因代数不匹配而失效, 槽位可以被安全复用
+struct BulletHandle
+{
+  static constexpr std::uint32_t INVALID_INDEX = 0xFFFF'FFFF;
+
+  std::uint32_t index = INVALID_INDEX; // 稀疏表槽位, 不随子弹在内存池中的搬移而改变
+  std::uint32_t generation = 0;
+
+  bool isNull() const noexcept { return index == INVALID_INDEX; }
+
+  friend bool operator==(BulletHandle const&, BulletHandle const&) = default;
+};
+} // namespace Game
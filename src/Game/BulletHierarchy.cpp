@@ -0,0 +1,495 @@
+#include "BulletHierarchy.hpp"
+#include "Core/BinaryStream.hpp"
+#include "Core/Logger.hpp"
+#include "Core/MathUtils.hpp"
+#include "Core/Simd.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <numbers>
+#include <type_traits>
+
+namespace Game {
+
+void BulletHierarchy::init(std::size_t capacity)
+{
+  for (Level& level : m_levels) {
+    level.forEachArray([capacity](auto& array) { array.resize(capacity); });
+    level.remap.resize(capacity);
+    level.count = 0;
+  }
+  m_killList.resize(capacity);
+  m_capacity = capacity;
+  m_nodeCount = 0;
+
+  m_locations.assign(capacity, {});
+  m_generation.assign(capacity, 0);
+  m_pendingKills.clear();
+  m_pendingKills.reserve(capacity);
+  // 逆序压栈, 使槽位从 0 开始分配
+  m_freeIds.resize(capacity);
+  for (std::size_t i = 0; i < capacity; ++i) {
+    m_freeIds[i] = static_cast<std::uint32_t>(capacity - 1 - i);
+  }
+  LOG_INFO("BulletHierarchy initialized with capacity: {}", capacity);
+}
+
+bool BulletHierarchy::resolveParent(BulletHandle parent, std::size_t& depth, std::uint32_t& parentIndex) const noexcept
+{
+  if (parent.isNull()) {
+    depth = 0;
+    parentIndex = NO_PARENT;
+    return true;
+  }
+  if (!isAlive(parent)) {
+    return false;
+  }
+  Location const location = m_locations[parent.index];
+  depth = location.depth + 1;
+  parentIndex = location.index;
+  return depth < MAX_DEPTH;
+}
+
+std::size_t BulletHierarchy::reserveNodes(HierarchyNodeParams const& params,
+                                          std::size_t depth,
+                                          std::uint32_t parentIndex,
+                                          std::size_t count,
+                                          BulletHandle* outHandles,
+                                          std::size_t& first) noexcept
+{
+  std::size_t const n = std::min(count, m_capacity - m_nodeCount);
+  m_overflowCount += count - n;
+
+  Level& level = m_levels[depth];
+  first = level.count;
+  level.count += n;
+  m_nodeCount += n;
+
+  std::fill_n(&level.radius[first], n, params.radius);
+  std::fill_n(&level.radialSpeed[first], n, params.radialSpeed);
+  std::fill_n(&level.phase[first], n, params.phase);
+  std::fill_n(&level.angVel[first], n, params.angVel);
+  std::fill_n(&level.spin[first], n, params.spin);
+  std::fill_n(&level.spinVel[first], n, params.spinVel);
+  std::fill_n(&level.anchorX[first], n, params.x);
+  std::fill_n(&level.anchorY[first], n, params.y);
+  std::fill_n(&level.anchorAngle[first], n, params.anchorAngle);
+  std::fill_n(&level.parent[first], n, parentIndex);
+  std::fill_n(&level.type[first], n, params.type);
+  std::fill_n(&level.color[first], n, params.color);
+  std::fill_n(&level.flags[first], n, params.flags);
+
+  // 从空闲栈顶取 n 个槽位, 顺序与逐个生成相同
+  std::size_t const freeTop = m_freeIds.size();
+  for (std::size_t i = 0; i < n; ++i) {
+    std::uint32_t const id = m_freeIds[freeTop - 1 - i];
+    level.id[first + i] = id;
+    m_locations[id] = { static_cast<std::uint32_t>(depth), static_cast<std::uint32_t>(first + i) };
+    if (outHandles) {
+      outHandles[i] = { id, m_generation[id] };
+    }
+  }
+  m_freeIds.resize(freeTop - n);
+  return n;
+}
+
+void BulletHierarchy::resolvePoses(std::size_t depth, std::size_t begin, std::size_t end) noexcept
+{
+  Level& level = m_levels[depth];
+  Level const& parents = m_levels[depth == 0 ? 0 : depth - 1];
+  for (std::size_t i = begin; i < end; ++i) {
+    std::uint32_t const p = level.parent[i];
+    float const baseX = p == NO_PARENT ? level.anchorX[i] : parents.x[p];
+    float const baseY = p == NO_PARENT ? level.anchorY[i] : parents.y[p];
+    float const baseAngle = p == NO_PARENT ? level.anchorAngle[i] : parents.angle[p];
+    float const direction = baseAngle + level.phase[i];
+    level.x[i] = baseX + level.radius[i] * Core::Math::cos(direction);
+    level.y[i] = baseY + level.radius[i] * Core::Math::sin(direction);
+    level.angle[i] = baseAngle + level.spin[i];
+  }
+}
+
+BulletHandle BulletHierarchy::spawn(HierarchyNodeParams const& params, BulletHandle parent) noexcept
+{
+  BulletHandle handle;
+  spawnRing(params, parent, 1, &handle);
+  return handle;
+}
+
+std::size_t BulletHierarchy::spawnRing(HierarchyNodeParams const& params,
+                                       BulletHandle parent,
+                                       std::size_t count,
+                                       BulletHandle* outHandles) noexcept
+{
+  std::size_t depth = 0;
+  std::uint32_t parentIndex = NO_PARENT;
+  if (!resolveParent(parent, depth, parentIndex)) {
+    // 父节点已失效 (如刚被回收) 时静默失败, 超过最大层数计入溢出
+    m_overflowCount += isAlive(parent) ? count : 0;
+    return 0;
+  }
+
+  std::size_t first = 0;
+  std::size_t const n = reserveNodes(params, depth, parentIndex, count, outHandles, first);
+  if (count > 1) {
+    float const step = std::numbers::pi_v<float> * 2.0f / static_cast<float>(count);
+    fillArithmetic(&m_levels[depth].phase[first], n, params.phase, step);
+  }
+  resolvePoses(depth, first, first + n);
+  return n;
+}
+
+bool BulletHierarchy::setAnchor(BulletHandle handle, float x, float y, float angle) noexcept
+{
+  if (!isAlive(handle)) {
+    return false;
+  }
+  Location const location = m_locations[handle.index];
+  Level& level = m_levels[location.depth];
+  if (level.parent[location.index] != NO_PARENT) {
+    return false;
+  }
+  level.anchorX[location.index] = x;
+  level.anchorY[location.index] = y;
+  level.anchorAngle[location.index] = angle;
+  return true;
+}
+
+bool BulletHierarchy::detach(BulletHandle handle) noexcept
+{
+  if (!isAlive(handle)) {
+    return false;
+  }
+  Location const location = m_locations[handle.index];
+  Level& level = m_levels[location.depth];
+  std::uint32_t const p = level.parent[location.index];
+  if (p != NO_PARENT) {
+    Level const& parents = m_levels[location.depth - 1];
+    level.anchorX[location.index] = parents.x[p];
+    level.anchorY[location.index] = parents.y[p];
+    level.anchorAngle[location.index] = parents.angle[p];
+    level.parent[location.index] = NO_PARENT;
+  }
+  return true;
+}
+
+bool BulletHierarchy::getPose(BulletHandle handle, HierarchyPose& out) const noexcept
+{
+  if (!isAlive(handle)) {
+    return false;
+  }
+  Location const location = m_locations[handle.index];
+  Level const& level = m_levels[location.depth];
+  out = { level.x[location.index], level.y[location.index], level.angle[location.index] };
+  return true;
+}
+
+bool BulletHierarchy::kill(BulletHandle handle) noexcept
+{
+  if (!isAlive(handle)) {
+    return false;
+  }
+  // 立即让句柄失效 (回收时代数会再加一次, 不影响正确性), 同一个节点不会被重复登记
+  ++m_generation[handle.index];
+  m_pendingKills.push_back(m_locations[handle.index]);
+  return true;
+}
+
+void BulletHierarchy::integrateLevel(std::size_t depth, BulletBounds const& bounds) noexcept
+{
+  Level& level = m_levels[depth];
+  // 第 0 层没有父节点, 所有通道都取锚点, 上一层的数组不会被访问
+  Level const& parents = m_levels[depth == 0 ? 0 : depth - 1];
+  std::size_t const count = level.count;
+
+  float* const x = level.x.data();
+  float* const y = level.y.data();
+  float* const angle = level.angle.data();
+  float* const radius = level.radius.data();
+  float* const phase = level.phase.data();
+  float* const spin = level.spin.data();
+  std::uint32_t const* const parent = level.parent.data();
+  std::uint32_t* const remap = level.remap.data();
+
+  std::size_t i = 0;
+#if defined(TOUHOU_SIMD_AVX2)
+  __m256 const radToIndex = _mm256_set1_ps(Core::Math::RadToIndex);
+  __m256i const indexMask = _mm256_set1_epi32(Core::Math::DefaultTrigTable::MASK);
+  __m256i const quarterTurn = _mm256_set1_epi32(Core::Math::DefaultTrigTable::QUARTER);
+  __m256i const noParent = _mm256_set1_epi32(static_cast<int>(NO_PARENT));
+  __m256i const laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  __m256 const left = _mm256_set1_ps(bounds.left);
+  __m256 const right = _mm256_set1_ps(bounds.right);
+  __m256 const top = _mm256_set1_ps(bounds.top);
+  __m256 const bottom = _mm256_set1_ps(bounds.bottom);
+  float const* table = Core::Math::sinTable.data();
+  for (; i + 8 <= count; i += 8) {
+    __m256 const r = _mm256_add_ps(_mm256_load_ps(radius + i), _mm256_load_ps(&level.radialSpeed[i]));
+    __m256 const ph = _mm256_add_ps(_mm256_load_ps(phase + i), _mm256_load_ps(&level.angVel[i]));
+    __m256 const sp = _mm256_add_ps(_mm256_load_ps(spin + i), _mm256_load_ps(&level.spinVel[i]));
+    _mm256_store_ps(radius + i, r);
+    _mm256_store_ps(phase + i, ph);
+    _mm256_store_ps(spin + i, sp);
+
+    // 有父节点的通道从上一层 gather 父节点的位姿, 根节点通道保留锚点
+    __m256i const p = _mm256_load_si256(reinterpret_cast<__m256i const*>(parent + i));
+    __m256i const isRoot = _mm256_cmpeq_epi32(p, noParent);
+    __m256 const hasParent = _mm256_castsi256_ps(_mm256_xor_si256(isRoot, _mm256_set1_epi32(-1)));
+    __m256i const safeIndex = _mm256_andnot_si256(isRoot, p);
+    __m256 const baseX =
+      _mm256_mask_i32gather_ps(_mm256_load_ps(&level.anchorX[i]), parents.x.data(), safeIndex, hasParent, 4);
+    __m256 const baseY =
+      _mm256_mask_i32gather_ps(_mm256_load_ps(&level.anchorY[i]), parents.y.data(), safeIndex, hasParent, 4);
+    __m256 const baseAngle =
+      _mm256_mask_i32gather_ps(_mm256_load_ps(&level.anchorAngle[i]), parents.angle.data(), safeIndex, hasParent, 4);
+
+    // 与 Core::Math::sin/cos 相同的截断取整与查表, 乘与加分开做 (不使用 FMA)
+    __m256 const direction = _mm256_add_ps(baseAngle, ph);
+    __m256i const index = _mm256_cvttps_epi32(_mm256_mul_ps(direction, radToIndex));
+    __m256 const sinV = _mm256_i32gather_ps(table, _mm256_and_si256(index, indexMask), 4);
+    __m256 const cosV =
+      _mm256_i32gather_ps(table, _mm256_and_si256(_mm256_add_epi32(index, quarterTurn), indexMask), 4);
+    __m256 const wx = _mm256_add_ps(baseX, _mm256_mul_ps(r, cosV));
+    __m256 const wy = _mm256_add_ps(baseY, _mm256_mul_ps(r, sinV));
+    _mm256_store_ps(x + i, wx);
+    _mm256_store_ps(y + i, wy);
+    _mm256_store_ps(angle + i, _mm256_add_ps(baseAngle, sp));
+
+    // 出界的通道记为死亡, 其余记为自身下标
+    __m256 const out =
+      _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(wx, left, _CMP_LT_OQ), _mm256_cmp_ps(wx, right, _CMP_GT_OQ)),
+                   _mm256_or_ps(_mm256_cmp_ps(wy, top, _CMP_LT_OQ), _mm256_cmp_ps(wy, bottom, _CMP_GT_OQ)));
+    __m256i const self = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)), laneOffsets);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(remap + i), _mm256_or_si256(self, _mm256_castps_si256(out)));
+  }
+#endif
+  // 标量路径, 同时负责 SIMD 路径中不足一个向量宽度的尾部; 运算顺序与 SIMD 路径相同, 结果逐位一致
+  // SSE2 没有 gather, 父节点与查表都要逐通道读取, 直接使用标量路径
+  for (; i < count; ++i) {
+    radius[i] += level.radialSpeed[i];
+    phase[i] += level.angVel[i];
+    spin[i] += level.spinVel[i];
+
+    std::uint32_t const p = parent[i];
+    float const baseX = p == NO_PARENT ? level.anchorX[i] : parents.x[p];
+    float const baseY = p == NO_PARENT ? level.anchorY[i] : parents.y[p];
+    float const baseAngle = p == NO_PARENT ? level.anchorAngle[i] : parents.angle[p];
+    float const direction = baseAngle + phase[i];
+    x[i] = baseX + radius[i] * Core::Math::cos(direction);
+    y[i] = baseY + radius[i] * Core::Math::sin(direction);
+    angle[i] = baseAngle + spin[i];
+
+    bool const out = x[i] < bounds.left || x[i] > bounds.right || y[i] < bounds.top || y[i] > bounds.bottom;
+    remap[i] = out ? NO_PARENT : static_cast<std::uint32_t>(i);
+  }
+}
+
+void BulletHierarchy::removeDead(std::size_t depth) noexcept
+{
+  Level& level = m_levels[depth];
+  Level* const children = depth + 1 < MAX_DEPTH ? &m_levels[depth + 1] : nullptr;
+  std::uint32_t* const remap = level.remap.data();
+
+  // 无分支地收集死亡下标 (升序), 没有死亡节点时下一层的父节点下标不变
+  std::uint32_t* const killList = m_killList.data();
+  std::size_t killCount = 0;
+  for (std::size_t i = 0; i < level.count; ++i) {
+    killList[killCount] = static_cast<std::uint32_t>(i);
+    killCount += remap[i] == NO_PARENT ? 1 : 0;
+  }
+  if (killCount == 0) {
+    return;
+  }
+
+  // 先处理孤儿: 此时死亡节点的位姿还没有被覆盖, 脱离的子节点以它为锚点
+  if (children) {
+    for (std::size_t j = 0; j < children->count; ++j) {
+      std::uint32_t const p = children->parent[j];
+      if (p == NO_PARENT || remap[p] != NO_PARENT) {
+        continue;
+      }
+      if (children->flags[j] & FLAG_DETACH) {
+        children->anchorX[j] = level.x[p];
+        children->anchorY[j] = level.y[p];
+        children->anchorAngle[j] = level.angle[p];
+        children->parent[j] = NO_PARENT;
+      } else {
+        children->remap[j] = NO_PARENT; // 在处理下一层时一起回收, 并继续传给它的子节点
+      }
+    }
+  }
+
+  for (std::size_t k = 0; k < killCount; ++k) {
+    releaseId(level.id[killList[k]]);
+  }
+  m_nodeCount -= killCount;
+
+  // Swap and Pop: 按下标升序用末尾的存活节点填补空位, 末尾的死亡节点直接丢弃
+  // 每个存活节点最多被搬移一次, 映射表中记录的始终是它在本帧开始时的下标
+  std::size_t end = level.count;
+  for (std::size_t k = 0; k < killCount; ++k) {
+    std::size_t const dead = killList[k];
+    while (end > dead && remap[end - 1] == NO_PARENT) {
+      --end;
+    }
+    if (end <= dead) {
+      break; // 剩下的死亡节点都在末尾, 已被丢弃
+    }
+    std::size_t const last = --end;
+    level.forEachArray([dead, last](auto& array) { array[dead] = array[last]; });
+    remap[last] = static_cast<std::uint32_t>(dead);
+    m_locations[level.id[dead]].index = static_cast<std::uint32_t>(dead);
+  }
+  level.count -= killCount;
+
+  // 下一层整批改写父节点下标; 随父节点死亡的子节点得到 NO_PARENT, 反正即将被回收
+  if (children) {
+    std::uint32_t* const parent = children->parent.data();
+    for (std::size_t j = 0; j < children->count; ++j) {
+      parent[j] = parent[j] == NO_PARENT ? NO_PARENT : remap[parent[j]];
+    }
+  }
+}
+
+void BulletHierarchy::update(BulletBounds const& bounds)
+{
+  if (m_overflowCount > 0) {
+    LOG_WARN("BulletHierarchy capacity or depth limit reached. {} nodes dropped this frame.", m_overflowCount);
+  }
+  m_lastFrameOverflow = m_overflowCount;
+  m_overflowCount = 0;
+
+  // 自上而下逐层解算, 每层读取的父节点位姿都是本帧的
+  for (std::size_t depth = 0; depth < MAX_DEPTH; ++depth) {
+    integrateLevel(depth, bounds);
+  }
+  for (Location const location : m_pendingKills) {
+    m_levels[location.depth].remap[location.index] = NO_PARENT;
+  }
+  m_pendingKills.clear();
+
+  // 同样自上而下回收, 父节点的死亡标记在回收它所在的层时传给下一层
+  for (std::size_t depth = 0; depth < MAX_DEPTH; ++depth) {
+    removeDead(depth);
+  }
+}
+
+void BulletHierarchy::clear() noexcept
+{
+  for (Level& level : m_levels) {
+    for (std::size_t i = 0; i < level.count; ++i) {
+      releaseId(level.id[i]);
+    }
+    level.count = 0;
+  }
+  m_pendingKills.clear();
+  m_nodeCount = 0;
+}
+
+HierarchyLevelView BulletHierarchy::getLevel(std::size_t depth) const noexcept
+{
+  Level const& level = m_levels[depth];
+  return { level.x.data(),    level.y.data(),     level.angle.data(), level.type.data(),
+           level.color.data(), level.flags.data(), level.count };
+}
+
+void BulletHierarchy::saveState(Core::BinaryWriter& writer) const
+{
+  writer.write<std::uint64_t>(m_capacity);
+  for (Level const& level : m_levels) {
+    writer.write<std::uint64_t>(level.count);
+    level.forEachArray([&](auto const& array) { writer.writeArray(array.data(), level.count); });
+  }
+  writer.writeArray(m_generation.data(), m_generation.size());
+  writer.write<std::uint64_t>(m_freeIds.size());
+  writer.writeArray(m_freeIds.data(), m_freeIds.size());
+  writer.write<std::uint64_t>(m_pendingKills.size());
+  writer.writeArray(m_pendingKills.data(), m_pendingKills.size());
+  writer.write<std::uint64_t>(m_overflowCount);
+  writer.write<std::uint64_t>(m_lastFrameOverflow);
+}
+
+void BulletHierarchy::loadState(Core::BinaryReader& reader)
+{
+  std::uint64_t const savedCapacity = reader.read<std::uint64_t>();
+  if (savedCapacity != m_capacity) {
+    LOG_ERROR("BulletHierarchy state capacity mismatch: saved {}, current {}", savedCapacity, m_capacity);
+    throw std::runtime_error("BulletHierarchy state capacity mismatch.");
+  }
+
+  m_nodeCount = 0;
+  for (std::size_t depth = 0; depth < MAX_DEPTH; ++depth) {
+    Level& level = m_levels[depth];
+    std::uint64_t const count = reader.read<std::uint64_t>();
+    if (count > m_capacity - m_nodeCount) {
+      throw std::runtime_error("BulletHierarchy state is corrupted.");
+    }
+    level.count = static_cast<std::size_t>(count);
+    m_nodeCount += level.count;
+    level.forEachArray([&](auto& array) { reader.readArray(array.data(), level.count); });
+
+    // 父节点必须在上一层的有效范围内, 槽位必须在容量内; 校验后重建稀疏表
+    std::size_t const parentCount = depth == 0 ? 0 : m_levels[depth - 1].count;
+    for (std::size_t i = 0; i < level.count; ++i) {
+      std::uint32_t const p = level.parent[i];
+      if ((p != NO_PARENT && p >= parentCount) || level.id[i] >= m_capacity) {
+        throw std::runtime_error("BulletHierarchy state is corrupted.");
+      }
+      m_locations[level.id[i]] = { static_cast<std::uint32_t>(depth), static_cast<std::uint32_t>(i) };
+    }
+  }
+  reader.readArray(m_generation.data(), m_generation.size());
+
+  std::uint64_t const freeCount = reader.read<std::uint64_t>();
+  if (freeCount != m_capacity - m_nodeCount) {
+    throw std::runtime_error("BulletHierarchy state is corrupted.");
+  }
+  m_freeIds.resize(static_cast<std::size_t>(freeCount));
+  reader.readArray(m_freeIds.data(), m_freeIds.size());
+  for (std::uint32_t const id : m_freeIds) {
+    if (id >= m_capacity) {
+      throw std::runtime_error("BulletHierarchy state is corrupted.");
+    }
+  }
+
+  std::uint64_t const pendingCount = reader.read<std::uint64_t>();
+  if (pendingCount > m_nodeCount) {
+    throw std::runtime_error("BulletHierarchy state is corrupted.");
+  }
+  m_pendingKills.resize(static_cast<std::size_t>(pendingCount));
+  reader.readArray(m_pendingKills.data(), m_pendingKills.size());
+  for (Location const location : m_pendingKills) {
+    if (location.depth >= MAX_DEPTH || location.index >= m_levels[location.depth].count) {
+      throw std::runtime_error("BulletHierarchy state is corrupted.");
+    }
+  }
+
+  m_overflowCount = static_cast<std::size_t>(reader.read<std::uint64_t>());
+  m_lastFrameOverflow = static_cast<std::size_t>(reader.read<std::uint64_t>());
+}
+
+std::size_t BulletHierarchy::maxStateSize() const noexcept
+{
+  std::size_t bytesPerNode = 0;
+  m_levels[0].forEachArray([&](auto const& array) { bytesPerNode += sizeof(array[0]); });
+  // 容量 + 各层计数 + 空闲栈与待回收列表的长度 + 溢出计数; 各层合计最多 capacity 个节点
+  return sizeof(std::uint64_t) * (MAX_DEPTH + 5) +
+         m_capacity * (bytesPerNode + sizeof(std::uint32_t) * 2 + sizeof(Location));
+}
+
+std::uint64_t BulletHierarchy::computeStateHash(std::uint64_t hash) const noexcept
+{
+  auto const mix = [&hash](std::uint64_t word) { hash = (hash ^ word) * 0x0000'0100'0000'01B3ull; };
+  for (Level const& level : m_levels) {
+    mix(level.count);
+    level.forEachArray([&](auto const& array) {
+      using T = typename std::remove_cvref_t<decltype(array)>::value_type;
+      using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint16_t>;
+      for (std::size_t i = 0; i < level.count; ++i) {
+        mix(std::bit_cast<Bits>(array[i]));
+      }
+    });
+  }
+  return hash;
+}
+} // namespace Game
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "Core/AlignedAllocator.hpp"
+#include "Game/BulletHandle.hpp"
+#include "Game/BulletKernel.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Core {
+class BinaryWriter;
+class BinaryReader;
+}
+
+namespace Game {
+// 挂接节点的生成参数: 节点在父节点的坐标系中做极坐标运动, 父节点移动或旋转时整体跟随
+// 每帧 radius += radialSpeed, phase += angVel, spin += spinVel, 然后
+//   世界坐标 = 父节点位置 + radius * (cos, sin)(父节点朝向 + phase), 世界朝向 = 父节点朝向 + spin
+// 没有父节点的根节点以锚点 (x, y, anchorAngle) 代替父节点, 锚点可以每帧由 setAnchor 移动 (如跟随 Boss)
+struct HierarchyNodeParams
+{
+  float x = 0;           // 锚点, 只对根节点有效
+  float y = 0;           //
+  float anchorAngle = 0; // 锚点的朝向, 只对根节点有效
+  float radius = 0;      // 到父节点 (锚点) 的距离
+  float radialSpeed = 0; // 每帧增加的距离
+  float phase = 0;       // 相对父节点朝向的方位角 (弧度)
+  float angVel = 0;      // 每帧绕父节点转过的弧度
+  float spin = 0;        // 自身朝向相对父节点朝向的角度, 子节点的方位角以此为基准, 也是绘制的朝向
+  float spinVel = 0;     // 每帧自转的弧度
+  std::uint16_t type = 0;
+  std::uint16_t color = 0;
+  std::uint16_t flags = 0; // BulletHierarchy::FLAG_*
+};
+
+// 节点的世界坐标与朝向
+struct HierarchyPose
+{
+  float x;
+  float y;
+  float angle;
+};
+
+// 一层节点的只读视图, 前 count 项有效
+struct HierarchyLevelView
+{
+  float const* x;
+  float const* y;
+  float const* angle;
+  std::uint16_t const* type;
+  std::uint16_t const* color;
+  std::uint16_t const* flags;
+  std::size_t count;
+};
+
+// 层级弹幕: 绕着移动的使魔 (或另一颗子弹) 公转的子弹, 随 Boss 旋转的发射器等
+// 节点按深度分层存放, 每层一个 SoA 池, 子节点记录父节点在上一层中的下标, 因此父节点总是先于子节点被处理
+// 每帧逐层做一遍线性循环: 积分局部运动, 读取上一层已解算的父节点位姿, 解算世界位姿并做出界检测,
+// 不存在逐颗子弹的递归查找; AVX2 下按 8 个一组 gather 父节点位姿 (其余指令集走标量路径, 结果逐位相同)
+// 各层用 swap and pop 回收, 回收时生成 旧下标 -> 新下标 的映射表, 下一层整批改写父节点下标;
+// 父节点死亡时子节点随之死亡, 或带有 FLAG_DETACH 时以父节点最后的位姿为锚点成为根节点, 继续原来的运动
+// 只用 float 的加法与乘法和查表三角函数 (不使用 FMA), 与道具池相同, 定点模式下同样确定
+class BulletHierarchy
+{
+public:
+  static constexpr std::size_t MAX_DEPTH = 4;             // 最大层数 (根节点为第 0 层)
+  static constexpr std::uint32_t NO_PARENT = 0xFFFF'FFFF; // 根节点的父节点下标
+  static constexpr std::uint16_t FLAG_HIDDEN = 1 << 0;    // 不绘制也不参与碰撞 (发射器, 锚点等)
+  static constexpr std::uint16_t FLAG_DETACH = 1 << 1;    // 父节点死亡时脱离成为根节点, 否则一起死亡
+
+public:
+  BulletHierarchy() = default;
+  ~BulletHierarchy() = default;
+
+  BulletHierarchy(BulletHierarchy const&) = delete;
+  BulletHierarchy& operator=(BulletHierarchy const&) = delete;
+
+  // 最多 capacity 个节点 (各层合计), 每层都按 capacity 分配, 所有内存在此分配
+  void init(std::size_t capacity);
+
+  // 生成一个节点, parent 为空句柄时生成根节点; 位姿立即按父节点当前的位姿解算
+  // 节点数已满, 父节点句柄已失效或父节点已在最深一层时返回空句柄
+  BulletHandle spawn(HierarchyNodeParams const& params, BulletHandle parent = {}) noexcept;
+  // 在同一个父节点下生成 count 个节点, 方位角均匀分布在整个圆周上, 第一个为 params.phase
+  // 返回实际生成的个数; outHandles 非空时依次写入每个节点的句柄
+  std::size_t spawnRing(HierarchyNodeParams const& params,
+                        BulletHandle parent,
+                        std::size_t count,
+                        BulletHandle* outHandles = nullptr) noexcept;
+
+  // 移动根节点的锚点 (对子节点无效), 从下一次 update 起生效
+  bool setAnchor(BulletHandle handle, float x, float y, float angle) noexcept;
+  // 立即脱离父节点, 以父节点当前的位姿为锚点成为根节点 (仍留在原来的层中), 位姿保持连续
+  bool detach(BulletHandle handle) noexcept;
+  // 节点当前的世界位姿, 句柄已失效时返回 false
+  bool getPose(BulletHandle handle, HierarchyPose& out) const noexcept;
+  // 击杀节点: 句柄立即失效, 节点在下一次 update 时回收, 其子节点按 FLAG_DETACH 死亡或脱离
+  bool kill(BulletHandle handle) noexcept;
+  bool isAlive(BulletHandle handle) const noexcept
+  {
+    return handle.index < m_locations.size() && m_generation[handle.index] == handle.generation;
+  }
+
+  // 每帧调用: 逐层积分并解算世界位姿, 然后回收出界 / 被击杀的节点及其不脱离的子孙
+  void update(BulletBounds const& bounds);
+  // 清空全部节点, 所有句柄随之失效
+  void clear() noexcept;
+
+  std::size_t getNodeCount() const noexcept { return m_nodeCount; }
+  HierarchyLevelView getLevel(std::size_t depth) const noexcept;
+  // 上一帧因节点数已满或超过最大层数而未能生成的节点数
+  std::size_t getLastFrameOverflow() const noexcept { return m_lastFrameOverflow; }
+
+  // 序列化 / 恢复全部节点, 容量必须与保存时相同, 否则抛出 std::runtime_error
+  void saveState(Core::BinaryWriter& writer) const;
+  void loadState(Core::BinaryReader& reader);
+  std::size_t maxStateSize() const noexcept;
+  // 全部节点的哈希 (64 位 FNV-1a), 以 hash 为初值继续混合
+  std::uint64_t computeStateHash(std::uint64_t hash) const noexcept;
+
+private:
+  template <typename T>
+  using Array = std::vector<T, Core::AlignedAllocator<T, 64>>;
+
+  // 一层节点 (SoA)
+  struct Level
+  {
+    Array<float> x; // 世界位姿, 每帧由 update 解算
+    Array<float> y;
+    Array<float> angle;
+    Array<float> radius; // 局部运动
+    Array<float> radialSpeed;
+    Array<float> phase;
+    Array<float> angVel;
+    Array<float> spin;
+    Array<float> spinVel;
+    Array<float> anchorX; // 根节点的锚点
+    Array<float> anchorY;
+    Array<float> anchorAngle;
+    Array<std::uint32_t> parent; // 父节点在上一层中的下标, 根节点为 NO_PARENT
+    Array<std::uint16_t> type;
+    Array<std::uint16_t> color;
+    Array<std::uint16_t> flags;
+    Array<std::uint32_t> id; // 稀疏表槽位, 随节点一起搬移
+    // 回收时的临时映射表: 存活节点为新下标, 死亡节点为 NO_PARENT; 不属于模拟状态
+    Array<std::uint32_t> remap;
+    std::size_t count = 0;
+
+    // 对每个属于模拟状态的字段数组调用 fn(array), 用于搬移与序列化
+    template <typename F>
+    void forEachArray(F&& fn)
+    {
+      fn(x);
+      fn(y);
+      fn(angle);
+      fn(radius);
+      fn(radialSpeed);
+      fn(phase);
+      fn(angVel);
+      fn(spin);
+      fn(spinVel);
+      fn(anchorX);
+      fn(anchorY);
+      fn(anchorAngle);
+      fn(parent);
+      fn(type);
+      fn(color);
+      fn(flags);
+      fn(id);
+    }
+
+    template <typename F>
+    void forEachArray(F&& fn) const
+    {
+      fn(x);
+      fn(y);
+      fn(angle);
+      fn(radius);
+      fn(radialSpeed);
+      fn(phase);
+      fn(angVel);
+      fn(spin);
+      fn(spinVel);
+      fn(anchorX);
+      fn(anchorY);
+      fn(anchorAngle);
+      fn(parent);
+      fn(type);
+      fn(color);
+      fn(flags);
+      fn(id);
+    }
+  };
+
+  // 稀疏表中节点的位置
+  struct Location
+  {
+    std::uint32_t depth;
+    std::uint32_t index;
+  };
+
+  // 在第 depth 层末尾为 count 个节点分配槽位并写入 params 的公共字段, 父节点为上一层的 parentIndex
+  // 返回实际分配的个数, 第一个节点的下标写入 first
+  std::size_t reserveNodes(HierarchyNodeParams const& params,
+                           std::size_t depth,
+                           std::uint32_t parentIndex,
+                           std::size_t count,
+                           BulletHandle* outHandles,
+                           std::size_t& first) noexcept;
+  // 解析父节点句柄: 空句柄得到 (0, NO_PARENT); 句柄失效或父节点已在最深一层时返回 false
+  bool resolveParent(BulletHandle parent, std::size_t& depth, std::uint32_t& parentIndex) const noexcept;
+  // 解算第 depth 层 [begin, end) 的世界位姿 (不积分), 用于生成时立即得到位姿
+  void resolvePoses(std::size_t depth, std::size_t begin, std::size_t end) noexcept;
+  // 积分第 depth 层并解算世界位姿, 出界的节点在 remap 中记为 NO_PARENT, 其余为自身下标
+  void integrateLevel(std::size_t depth, BulletBounds const& bounds) noexcept;
+  // 回收第 depth 层中 remap 记为死亡的节点, 并把下一层的父节点下标改写为新下标 (孤儿按 FLAG_DETACH 处理)
+  void removeDead(std::size_t depth) noexcept;
+
+  void releaseId(std::uint32_t id) noexcept
+  {
+    ++m_generation[id];
+    m_freeIds.push_back(id);
+  }
+
+private:
+  std::array<Level, MAX_DEPTH> m_levels;
+  std::vector<Location> m_locations;       // 槽位 -> 层与下标
+  std::vector<std::uint32_t> m_generation; // 槽位 -> 当前代数
+  std::vector<std::uint32_t> m_freeIds;    // 空闲槽位栈
+  std::vector<Location> m_pendingKills;    // kill() 登记, 等待下一次 update 回收
+  std::vector<std::uint32_t> m_killList;   // 回收时一层的死亡下标, 与容量等长
+
+  std::size_t m_capacity = 0;
+  std::size_t m_nodeCount = 0;
+  std::size_t m_overflowCount = 0;
+  std::size_t m_lastFrameOverflow = 0;
+};
+} // namespace Game
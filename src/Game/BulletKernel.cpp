@@ -0,0 +1,469 @@
+#include "BulletKernel.hpp"
+#include "Core/MathUtils.hpp"
+#include "Core/Simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace Game {
+
+namespace {
+#if !defined(TOUHOU_FIXED_POINT)
+// 标量路径, 同时负责 SIMD 路径中不足一个向量宽度的尾部
+std::size_t integrateScalar(BulletSoA& b,
+                            std::size_t begin,
+                            std::size_t end,
+                            BulletBounds const& bounds,
+                            std::uint32_t* killList) noexcept
+{
+  std::size_t killCount = 0;
+  for (std::size_t i = begin; i < end; ++i) {
+    b.angVel[i] += b.angAccel[i];
+    b.speed[i] += b.tanAccel[i];
+    b.angle[i] += b.angVel[i];
+    b.x[i] += b.speed[i] * Core::Math::cos(b.angle[i]);
+    b.y[i] += b.speed[i] * Core::Math::sin(b.angle[i]);
+
+    if (b.x[i] < bounds.left || b.x[i] > bounds.right || b.y[i] < bounds.top || b.y[i] > bounds.bottom) {
+      killList[killCount++] = static_cast<std::uint32_t>(i);
+    }
+  }
+  return killCount;
+}
+#endif
+
+// 把比较掩码中置位的通道下标 base + lane 无分支地追加到 out: 每个通道都写入, 只在置位时前进
+// 区域查询的命中分布随机, 比 appendKills 的逐位循环少了难以预测的分支; out 当前位置之后至少要有 width 个空位
+template <int width>
+[[maybe_unused]] __forceinline std::size_t appendSelected(unsigned mask, std::size_t base, std::uint32_t* out) noexcept
+{
+  std::size_t count = 0;
+  for (int lane = 0; lane < width; ++lane) {
+    out[count] = static_cast<std::uint32_t>(base + lane);
+    count += (mask >> lane) & 1u;
+  }
+  return count;
+}
+} // namespace
+
+#if defined(TOUHOU_FIXED_POINT)
+
+// 定点模式: 只有整数加法, 64 位乘法与移位, 各指令集路径共用同一实现, 结果与编译器和优化级别无关
+// 角度为二进制角, 加法自然回绕, 高位直接作为定点 sin 表的下标
+std::size_t integrateBullets(BulletSoA& b,
+                             std::size_t begin,
+                             std::size_t end,
+                             BulletBounds const& bounds,
+                             std::uint32_t* killList) noexcept
+{
+  using namespace Core::Math;
+  Fixed const left = toFixed(bounds.left);
+  Fixed const right = toFixed(bounds.right);
+  Fixed const top = toFixed(bounds.top);
+  Fixed const bottom = toFixed(bounds.bottom);
+
+  std::size_t killCount = 0;
+  for (std::size_t i = begin; i < end; ++i) {
+    b.angVel[i] += b.angAccel[i];
+    b.speed[i] += b.tanAccel[i];
+    b.angle[i] += b.angVel[i];
+    b.x[i] += fixedMul(b.speed[i], cosFixed(b.angle[i]));
+    b.y[i] += fixedMul(b.speed[i], sinFixed(b.angle[i]));
+
+    if (b.x[i] < left || b.x[i] > right || b.y[i] < top || b.y[i] > bottom) {
+      killList[killCount++] = static_cast<std::uint32_t>(i);
+    }
+  }
+  return killCount;
+}
+
+#elif defined(TOUHOU_SIMD_AVX2)
+
+std::size_t integrateBullets(BulletSoA& b,
+                             std::size_t begin,
+                             std::size_t end,
+                             BulletBounds const& bounds,
+                             std::uint32_t* killList) noexcept
+{
+  __m256 const radToIndex = _mm256_set1_ps(Core::Math::RadToIndex);
+  __m256i const indexMask = _mm256_set1_epi32(Core::Math::DefaultTrigTable::MASK);
+  __m256i const quarterTurn = _mm256_set1_epi32(Core::Math::DefaultTrigTable::QUARTER); // cos(x) = sin(x + pi/2)
+  __m256 const left = _mm256_set1_ps(bounds.left);
+  __m256 const right = _mm256_set1_ps(bounds.right);
+  __m256 const top = _mm256_set1_ps(bounds.top);
+  __m256 const bottom = _mm256_set1_ps(bounds.bottom);
+  float const* table = Core::Math::sinTable.data();
+
+  std::size_t killCount = 0;
+  std::size_t i = begin;
+  for (; i + 8 <= end; i += 8) {
+    __m256 angVel = _mm256_add_ps(_mm256_loadu_ps(&b.angVel[i]), _mm256_loadu_ps(&b.angAccel[i]));
+    __m256 speed = _mm256_add_ps(_mm256_loadu_ps(&b.speed[i]), _mm256_loadu_ps(&b.tanAccel[i]));
+    __m256 angle = _mm256_add_ps(_mm256_loadu_ps(&b.angle[i]), angVel);
+    _mm256_storeu_ps(&b.angVel[i], angVel);
+    _mm256_storeu_ps(&b.speed[i], speed);
+    _mm256_storeu_ps(&b.angle[i], angle);
+
+    // 与 Core::Math::sin/cos 相同的截断取整与查表
+    __m256i index = _mm256_cvttps_epi32(_mm256_mul_ps(angle, radToIndex));
+    __m256 sinV = _mm256_i32gather_ps(table, _mm256_and_si256(index, indexMask), 4);
+    __m256 cosV = _mm256_i32gather_ps(table, _mm256_and_si256(_mm256_add_epi32(index, quarterTurn), indexMask), 4);
+
+    // 乘与加分开做, 不使用 FMA, 以保证与标量路径逐位一致
+    __m256 x = _mm256_add_ps(_mm256_loadu_ps(&b.x[i]), _mm256_mul_ps(speed, cosV));
+    __m256 y = _mm256_add_ps(_mm256_loadu_ps(&b.y[i]), _mm256_mul_ps(speed, sinV));
+    _mm256_storeu_ps(&b.x[i], x);
+    _mm256_storeu_ps(&b.y[i], y);
+
+    __m256 out = _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(x, left, _CMP_LT_OQ), _mm256_cmp_ps(x, right, _CMP_GT_OQ)),
+                              _mm256_or_ps(_mm256_cmp_ps(y, top, _CMP_LT_OQ), _mm256_cmp_ps(y, bottom, _CMP_GT_OQ)));
+    killCount += appendKills(static_cast<unsigned>(_mm256_movemask_ps(out)), i, killList + killCount);
+  }
+
+  return killCount + integrateScalar(b, i, end, bounds, killList + killCount);
+}
+
+#elif defined(TOUHOU_SIMD_SSE2)
+
+std::size_t integrateBullets(BulletSoA& b,
+                             std::size_t begin,
+                             std::size_t end,
+                             BulletBounds const& bounds,
+                             std::uint32_t* killList) noexcept
+{
+  __m128 const radToIndex = _mm_set1_ps(Core::Math::RadToIndex);
+  __m128i const quarterTurn = _mm_set1_epi32(Core::Math::DefaultTrigTable::QUARTER);
+  __m128 const left = _mm_set1_ps(bounds.left);
+  __m128 const right = _mm_set1_ps(bounds.right);
+  __m128 const top = _mm_set1_ps(bounds.top);
+  __m128 const bottom = _mm_set1_ps(bounds.bottom);
+  float const* table = Core::Math::sinTable.data();
+
+  std::size_t killCount = 0;
+  std::size_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    __m128 angVel = _mm_add_ps(_mm_loadu_ps(&b.angVel[i]), _mm_loadu_ps(&b.angAccel[i]));
+    __m128 speed = _mm_add_ps(_mm_loadu_ps(&b.speed[i]), _mm_loadu_ps(&b.tanAccel[i]));
+    __m128 angle = _mm_add_ps(_mm_loadu_ps(&b.angle[i]), angVel);
+    _mm_storeu_ps(&b.angVel[i], angVel);
+    _mm_storeu_ps(&b.speed[i], speed);
+    _mm_storeu_ps(&b.angle[i], angle);
+
+    // SSE2 没有 gather 指令, 下标算好后逐通道查表
+    alignas(16) std::int32_t sinIdx[4];
+    alignas(16) std::int32_t cosIdx[4];
+    __m128i index = _mm_cvttps_epi32(_mm_mul_ps(angle, radToIndex));
+    _mm_store_si128(reinterpret_cast<__m128i*>(sinIdx), index);
+    _mm_store_si128(reinterpret_cast<__m128i*>(cosIdx), _mm_add_epi32(index, quarterTurn));
+    constexpr int mask = Core::Math::DefaultTrigTable::MASK;
+    __m128 sinV = _mm_setr_ps(
+      table[sinIdx[0] & mask], table[sinIdx[1] & mask], table[sinIdx[2] & mask], table[sinIdx[3] & mask]);
+    __m128 cosV = _mm_setr_ps(
+      table[cosIdx[0] & mask], table[cosIdx[1] & mask], table[cosIdx[2] & mask], table[cosIdx[3] & mask]);
+
+    __m128 x = _mm_add_ps(_mm_loadu_ps(&b.x[i]), _mm_mul_ps(speed, cosV));
+    __m128 y = _mm_add_ps(_mm_loadu_ps(&b.y[i]), _mm_mul_ps(speed, sinV));
+    _mm_storeu_ps(&b.x[i], x);
+    _mm_storeu_ps(&b.y[i], y);
+
+    __m128 out = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(x, left), _mm_cmpgt_ps(x, right)),
+                           _mm_or_ps(_mm_cmplt_ps(y, top), _mm_cmpgt_ps(y, bottom)));
+    killCount += appendKills(static_cast<unsigned>(_mm_movemask_ps(out)), i, killList + killCount);
+  }
+
+  return killCount + integrateScalar(b, i, end, bounds, killList + killCount);
+}
+
+#else
+
+std::size_t integrateBullets(BulletSoA& b,
+                             std::size_t begin,
+                             std::size_t end,
+                             BulletBounds const& bounds,
+                             std::uint32_t* killList) noexcept
+{
+  return integrateScalar(b, begin, end, bounds, killList);
+}
+
+#endif
+
+#if defined(TOUHOU_FIXED_POINT)
+
+std::size_t selectInCircle(BulletSoA const& b,
+                           std::size_t count,
+                           float cx,
+                           float cy,
+                           float radius,
+                           std::uint32_t* out) noexcept
+{
+  // 16.16 定点坐标差的平方在 64 位整数内精确表示 (坐标差小于 2^15 像素)
+  std::int64_t const x0 = Core::Math::toFixed(cx);
+  std::int64_t const y0 = Core::Math::toFixed(cy);
+  std::int64_t const r = Core::Math::toFixed(radius);
+  std::int64_t const rSq = r * r;
+
+  std::size_t found = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    std::int64_t const dx = b.x[i] - x0;
+    std::int64_t const dy = b.y[i] - y0;
+    out[found] = static_cast<std::uint32_t>(i);
+    found += (dx * dx + dy * dy <= rSq) ? 1 : 0; // 无分支: 总是写入, 命中时才前进
+  }
+  return found;
+}
+
+std::size_t selectInRect(BulletSoA const& b, std::size_t count, BulletBounds const& rect, std::uint32_t* out) noexcept
+{
+  using Core::Math::toFixed;
+  Core::Math::Fixed const left = toFixed(rect.left);
+  Core::Math::Fixed const right = toFixed(rect.right);
+  Core::Math::Fixed const top = toFixed(rect.top);
+  Core::Math::Fixed const bottom = toFixed(rect.bottom);
+
+  std::size_t found = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    out[found] = static_cast<std::uint32_t>(i);
+    found += (b.x[i] >= left && b.x[i] <= right && b.y[i] >= top && b.y[i] <= bottom) ? 1 : 0;
+  }
+  return found;
+}
+
+#else
+
+std::size_t selectInCircle(BulletSoA const& b,
+                           std::size_t count,
+                           float cx,
+                           float cy,
+                           float radius,
+                           std::uint32_t* out) noexcept
+{
+  float const rSq = radius * radius;
+  std::size_t found = 0;
+  std::size_t i = 0;
+#if defined(TOUHOU_SIMD_AVX2)
+  __m256 const cxV = _mm256_set1_ps(cx);
+  __m256 const cyV = _mm256_set1_ps(cy);
+  __m256 const rSqV = _mm256_set1_ps(rSq);
+  for (; i + 8 <= count; i += 8) {
+    __m256 const dx = _mm256_sub_ps(_mm256_loadu_ps(&b.x[i]), cxV);
+    __m256 const dy = _mm256_sub_ps(_mm256_loadu_ps(&b.y[i]), cyV);
+    __m256 const distSq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    unsigned const mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(distSq, rSqV, _CMP_LE_OQ)));
+    found += appendSelected<8>(mask, i, out + found);
+  }
+#elif defined(TOUHOU_SIMD_SSE2)
+  __m128 const cxV = _mm_set1_ps(cx);
+  __m128 const cyV = _mm_set1_ps(cy);
+  __m128 const rSqV = _mm_set1_ps(rSq);
+  for (; i + 4 <= count; i += 4) {
+    __m128 const dx = _mm_sub_ps(_mm_loadu_ps(&b.x[i]), cxV);
+    __m128 const dy = _mm_sub_ps(_mm_loadu_ps(&b.y[i]), cyV);
+    __m128 const distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+    unsigned const mask = static_cast<unsigned>(_mm_movemask_ps(_mm_cmple_ps(distSq, rSqV)));
+    found += appendSelected<4>(mask, i, out + found);
+  }
+#endif
+  for (; i < count; ++i) {
+    float const dx = b.x[i] - cx;
+    float const dy = b.y[i] - cy;
+    out[found] = static_cast<std::uint32_t>(i);
+    found += (dx * dx + dy * dy <= rSq) ? 1 : 0;
+  }
+  return found;
+}
+
+std::size_t selectInRect(BulletSoA const& b, std::size_t count, BulletBounds const& rect, std::uint32_t* out) noexcept
+{
+  std::size_t found = 0;
+  std::size_t i = 0;
+#if defined(TOUHOU_SIMD_AVX2)
+  __m256 const left = _mm256_set1_ps(rect.left);
+  __m256 const right = _mm256_set1_ps(rect.right);
+  __m256 const top = _mm256_set1_ps(rect.top);
+  __m256 const bottom = _mm256_set1_ps(rect.bottom);
+  for (; i + 8 <= count; i += 8) {
+    __m256 const x = _mm256_loadu_ps(&b.x[i]);
+    __m256 const y = _mm256_loadu_ps(&b.y[i]);
+    __m256 const inside =
+      _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(x, left, _CMP_GE_OQ), _mm256_cmp_ps(x, right, _CMP_LE_OQ)),
+                    _mm256_and_ps(_mm256_cmp_ps(y, top, _CMP_GE_OQ), _mm256_cmp_ps(y, bottom, _CMP_LE_OQ)));
+    found += appendSelected<8>(static_cast<unsigned>(_mm256_movemask_ps(inside)), i, out + found);
+  }
+#elif defined(TOUHOU_SIMD_SSE2)
+  __m128 const left = _mm_set1_ps(rect.left);
+  __m128 const right = _mm_set1_ps(rect.right);
+  __m128 const top = _mm_set1_ps(rect.top);
+  __m128 const bottom = _mm_set1_ps(rect.bottom);
+  for (; i + 4 <= count; i += 4) {
+    __m128 const x = _mm_loadu_ps(&b.x[i]);
+    __m128 const y = _mm_loadu_ps(&b.y[i]);
+    __m128 const inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(x, left), _mm_cmple_ps(x, right)),
+                                     _mm_and_ps(_mm_cmpge_ps(y, top), _mm_cmple_ps(y, bottom)));
+    found += appendSelected<4>(static_cast<unsigned>(_mm_movemask_ps(inside)), i, out + found);
+  }
+#endif
+  for (; i < count; ++i) {
+    out[found] = static_cast<std::uint32_t>(i);
+    found += (b.x[i] >= rect.left && b.x[i] <= rect.right && b.y[i] >= rect.top && b.y[i] <= rect.bottom) ? 1 : 0;
+  }
+  return found;
+}
+
+#endif
+
+void fillArithmetic(float* out, std::size_t count, float start, float step) noexcept
+{
+  std::size_t i = 0;
+#if defined(TOUHOU_SIMD_AVX2)
+  __m256 const startV = _mm256_set1_ps(start);
+  __m256 const stepV = _mm256_set1_ps(step);
+  __m256 index = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); // 整数下标在 2^24 以内可被 float 精确表示
+  __m256 const stride = _mm256_set1_ps(8.0f);
+  for (; i + 8 <= count; i += 8) {
+    _mm256_storeu_ps(out + i, _mm256_add_ps(startV, _mm256_mul_ps(index, stepV)));
+    index = _mm256_add_ps(index, stride);
+  }
+#elif defined(TOUHOU_SIMD_SSE2)
+  __m128 const startV = _mm_set1_ps(start);
+  __m128 const stepV = _mm_set1_ps(step);
+  __m128 index = _mm_setr_ps(0, 1, 2, 3);
+  __m128 const stride = _mm_set1_ps(4.0f);
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_ps(out + i, _mm_add_ps(startV, _mm_mul_ps(index, stepV)));
+    index = _mm_add_ps(index, stride);
+  }
+#endif
+  for (; i < count; ++i) {
+    out[i] = start + static_cast<float>(i) * step;
+  }
+}
+
+void fillArithmetic(std::uint32_t* out, std::size_t count, std::uint32_t start, std::uint32_t step) noexcept
+{
+  // 无符号乘加按模 2^32 回绕, 对二进制角即为对一周取模
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = start + static_cast<std::uint32_t>(i) * step;
+  }
+}
+
+void fillArithmetic(std::int32_t* out, std::size_t count, std::int32_t start, std::int32_t step) noexcept
+{
+  // 在无符号域中计算, 避免有符号溢出的未定义行为
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = static_cast<std::int32_t>(static_cast<std::uint32_t>(start) +
+                                       static_cast<std::uint32_t>(i) * static_cast<std::uint32_t>(step));
+  }
+}
+
+namespace {
+// 平均每段存活元素不少于该值时按段搬移, 否则按死亡位图逐元素压实
+constexpr std::size_t minAverageRunForMemmove = 32;
+
+// 密集压实时每次转为位图的元素数, 位图放在栈上 (bitmapBlock / 8 字节)
+constexpr std::size_t bitmapBlock = 4096;
+
+#if defined(TOUHOU_SIMD_AVX2)
+// left-pack 置换表: 下标为 8 位存活掩码, 值为把存活通道依次挪到低位的 vpermd 索引
+alignas(32) constexpr std::array<std::array<std::int32_t, 8>, 256> leftPackTable = [] {
+  std::array<std::array<std::int32_t, 8>, 256> table{};
+  for (int mask = 0; mask < 256; ++mask) {
+    int lane = 0;
+    for (int bit = 0; bit < 8; ++bit) {
+      if (mask & (1 << bit)) {
+        table[mask][lane++] = bit;
+      }
+    }
+    // 其余通道保持为 0: 写出的是无用值, 会被之后的写入覆盖或落在有效区之外
+  }
+  return table;
+}();
+#endif
+
+// 按死亡位图压实一块 [read, end), 位图的第 0 位对应 read; 返回新的写指针
+// 死亡元素写入后不前进写指针, 循环内没有依赖死亡分布的分支
+template <typename T>
+std::size_t compactBlock(T* data,
+                         std::size_t read,
+                         std::size_t write,
+                         std::size_t end,
+                         std::uint8_t const* deadBits) noexcept
+{
+  std::size_t const blockBegin = read;
+#if defined(TOUHOU_SIMD_AVX2)
+  if constexpr (sizeof(T) == 4) {
+    // 4 字节元素: 每次处理 8 个元素, 用存活掩码查表置换后整体写出
+    // 原地压实时写指针不超过读指针, 写出的 8 个通道不会越过当前 8 个元素, 因此不会破坏未读数据
+    auto* const words = reinterpret_cast<std::int32_t*>(data);
+    for (; read + 8 <= end; read += 8) {
+      unsigned const keepMask = ~static_cast<unsigned>(deadBits[(read - blockBegin) / 8]) & 0xFFu;
+      __m256i const values = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(words + read));
+      __m256i const perm = _mm256_load_si256(reinterpret_cast<__m256i const*>(leftPackTable[keepMask].data()));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(words + write), _mm256_permutevar8x32_epi32(values, perm));
+      write += std::popcount(keepMask);
+    }
+  }
+#endif
+  for (; read < end; ++read) {
+    std::size_t const offset = read - blockBegin;
+    unsigned const dead = (deadBits[offset / 8] >> (offset % 8)) & 1u;
+    data[write] = data[read];
+    write += 1 - dead;
+  }
+  return write;
+}
+} // namespace
+
+template <typename T>
+std::size_t compactStable(T* data,
+                          std::size_t count,
+                          std::uint32_t const* killList,
+                          std::size_t killCount) noexcept
+{
+  if (killCount == 0) {
+    return count;
+  }
+
+  std::size_t const first = killList[0]; // 第一个死亡元素之前的数据无需移动
+  if ((count - first) >= killCount * minAverageRunForMemmove) {
+    // 稀疏: 相邻两个死亡下标之间的存活元素是连续的一段, 整段向前搬移
+    std::size_t write = first;
+    for (std::size_t k = 0; k < killCount; ++k) {
+      std::size_t const runBegin = killList[k] + 1;
+      std::size_t const runEnd = k + 1 < killCount ? killList[k + 1] : count;
+      std::copy(data + runBegin, data + runEnd, data + write); // 目标在源之前, 重叠时 std::copy 安全
+      write += runEnd - runBegin;
+    }
+    return write;
+  }
+
+  // 密集: 逐块把死亡下标转为位图, 再按位图逐元素 (AVX2 下 4 字节元素按 8 个一组 left-pack) 压实
+  // 死亡下标随机分布时 (如圆形消弹) 逐个比较下标的分支难以预测, 位图使压实循环与死亡分布无关
+  std::size_t write = first;
+  std::size_t k = 0;
+  for (std::size_t blockBegin = first; blockBegin < count; blockBegin += bitmapBlock) {
+    std::size_t const blockEnd = std::min(blockBegin + bitmapBlock, count);
+    alignas(32) std::uint8_t deadBits[bitmapBlock / 8] = {};
+    for (; k < killCount && killList[k] < blockEnd; ++k) {
+      std::size_t const offset = killList[k] - blockBegin;
+      deadBits[offset / 8] |= static_cast<std::uint8_t>(1u << (offset % 8));
+    }
+    write = compactBlock(data, blockBegin, write, blockEnd, deadBits);
+  }
+  return write;
+}
+
+template std::size_t compactStable<float>(float*, std::size_t, std::uint32_t const*, std::size_t) noexcept;
+template std::size_t compactStable<std::int32_t>(std::int32_t*,
+                                                 std::size_t,
+                                                 std::uint32_t const*,
+                                                 std::size_t) noexcept;
+template std::size_t compactStable<std::uint32_t>(std::uint32_t*,
+                                                  std::size_t,
+                                                  std::uint32_t const*,
+                                                  std::size_t) noexcept;
+template std::size_t compactStable<std::uint16_t>(std::uint16_t*,
+                                                  std::size_t,
+                                                  std::uint32_t const*,
+                                                  std::size_t) noexcept;
+} // namespace Game
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Core/Platform.hpp"
+#include "Game/BulletSoA.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace Game {
+// 子弹的存活区域 (屏幕坐标), 超出该区域的子弹会被回收
+struct BulletBounds
+{
+  float left;
+  float right;
+  float top;
+  float bottom;
+};
+
+// 对 [begin, end) 区间内的子弹做一帧半隐式欧拉积分, 并做出界检测
+// 出界子弹的下标按升序写入 killList (调用者保证至少有 end - begin 个空位), 返回写入的个数
+// 积分公式与 Bullet::updatePosition 一致, 各指令集路径 (AVX2 / SSE2 / 标量) 的结果逐位相同
+// 定点模式 (TOUHOU_FIXED_POINT) 下为整数实现, 任何 x86-64 构建的结果逐位相同
+std::size_t integrateBullets(BulletSoA& bullets,
+                             std::size_t begin,
+                             std::size_t end,
+                             BulletBounds const& bounds,
+                             std::uint32_t* killList) noexcept;
+
+// 区域查询: 选出 [0, count) 中位置在圆 (cx, cy, radius) 内 (含边界) 的子弹, 下标按升序写入 out, 返回个数
+// out 至少要有 count 个空位; 各指令集路径的结果相同, 定点模式下在定点域中比较 (整数运算, 无舍入)
+std::size_t selectInCircle(BulletSoA const& bullets,
+                           std::size_t count,
+                           float cx,
+                           float cy,
+                           float radius,
+                           std::uint32_t* out) noexcept;
+// 选出位置在矩形 rect 内 (含边界) 的子弹
+std::size_t selectInRect(BulletSoA const& bullets,
+                         std::size_t count,
+                         BulletBounds const& rect,
+                         std::uint32_t* out) noexcept;
+
+// 把 SIMD 比较掩码 (movemask 的结果) 中置位的通道下标 base + lane 按升序追加到 out, 返回追加的个数
+// 供各批处理内核 (出界检测, 区域查询, 道具回收等) 把整批比较结果转为下标列表
+__forceinline std::size_t appendKills(unsigned mask, std::size_t base, std::uint32_t* out) noexcept
+{
+  std::size_t count = 0;
+  while (mask != 0) {
+    out[count++] = static_cast<std::uint32_t>(base + std::countr_zero(mask));
+    mask &= mask - 1; // 清除最低位的 1
+  }
+  return count;
+}
+
+// 写入等差数列 out[i] = start + i * step, 用于批量发射时一次算出整批子弹的角度等参数
+// 各指令集路径的结果逐位相同
+void fillArithmetic(float* out, std::size_t count, float start, float step) noexcept;
+// 二进制角 / 定点数版本, 按模 2^32 回绕
+void fillArithmetic(std::uint32_t* out, std::size_t count, std::uint32_t start, std::uint32_t step) noexcept;
+void fillArithmetic(std::int32_t* out, std::size_t count, std::int32_t start, std::int32_t step) noexcept;
+
+// 保序压实: 从 data[0, count) 中删除 killList 指定的 killCount 个元素 (下标升序), 存活元素保持原有的相对顺序
+// 死亡稀疏时按存活段整段搬移; 死亡密集时 (如消弹) 先分块转为位图, 再无分支地逐元素 (AVX2 下按 8 个一组 left-pack) 压实
+// 返回剩余元素个数
+template <typename T>
+std::size_t compactStable(T* data,
+                          std::size_t count,
+                          std::uint32_t const* killList,
+                          std::size_t killCount) noexcept;
+} // namespace Game
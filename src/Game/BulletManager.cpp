@@ -1,83 +1,536 @@
 #include "BulletManager.hpp"
+#include "Core/BinaryStream.hpp"
+#include "Core/FastMath.hpp"
+#include "Core/JobSystem.hpp"
 #include "Core/Logger.hpp"
 #include "Core/MathUtils.hpp"
+#include "Core/Metrics.hpp"
+#include "Core/Profiler.hpp"
 
-#include <format>
+#include <algorithm>
+#include <bit>
+#include <numbers>
+#include <type_traits>
 
 namespace Game {
 
+namespace {
+// 全部 BulletManager 实例共用的逐帧指标
+Core::Counter const spawnedMetric("bullets.spawned");
+Core::Counter const killedMetric("bullets.killed");
+Core::Counter const overflowMetric("bullets.overflow");
+} // namespace
+
 void BulletManager::init(std::size_t capacity)
 {
   m_bullets.resize(capacity);
+  m_killList.resize(capacity);
+  m_chunkKillCounts.resize((capacity + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE);
+  m_killScratch.resize(capacity);
   m_activeCount = 0;
-  LOG_INFO(std::format("BulletManager initialized with capacity: {}", capacity));
+
+  m_sparse.assign(capacity, 0);
+  m_generation.assign(capacity, 0);
+  m_pendingKills.clear();
+  m_pendingKills.reserve(capacity);
+  // 逆序压栈, 使槽位从 0 开始分配
+  m_freeIds.resize(capacity);
+  for (std::size_t i = 0; i < capacity; ++i) {
+    m_freeIds[i] = static_cast<std::uint32_t>(capacity - 1 - i);
+  }
+  LOG_INFO("BulletManager initialized with capacity: {}", capacity);
 }
 
-void BulletManager::spawnBullet(Bullet const& bullet) noexcept
+BulletHandle BulletManager::spawnBullet(Bullet const& bullet) noexcept
 {
-  if (m_bullets.size() <= m_activeCount) {
-    LOG_WARN("BulletManager capacity reached. Cannot spawn more bullets.");
-    return;
+  if (m_bullets.capacity() <= m_activeCount) {
+    ++m_overflowCount; // 不在这里逐颗打印日志, 由 update 每帧汇总报告一次
+    return {};
+  }
+
+  std::uint32_t const id = m_freeIds.back();
+  m_freeIds.pop_back();
+
+  std::size_t const index = m_activeCount++;
+  m_bullets.store(index, bullet);
+  m_bullets.id[index] = id;
+  m_sparse[id] = static_cast<std::uint32_t>(index);
+  spawnedMetric.add();
+  return { id, m_generation[id] };
+}
+
+BulletHandle BulletManager::spawnBulletV(float x,
+                                         float y,
+                                         float vx,
+                                         float vy,
+                                         float accelx,
+                                         float accely,
+                                         std::uint16_t type,
+                                         std::uint16_t color) noexcept
+{
+  // 把矢量速度和加速度换算为 角度 / 速率 / 角速度 / 切向加速度 的表示, 用快速近似代替 atan2 和 sqrt
+  // 只是生成时刻的瞬时分解, 之后角速度与切向加速度不变, 不能表示恒定的世界坐标系加速度 (见头文件)
+  float const speedSq = vx * vx + vy * vy;
+  if (speedSq > 0.0f) {
+    float const invSpeed = Core::Math::fastRsqrt(speedSq);
+    float const speed = speedSq * invSpeed;
+    float const angle = Core::Math::fastAtan2(vy, vx);
+    float const tanAccel = (accelx * vx + accely * vy) * invSpeed;          // 加速度在速度方向上的分量
+    float const angVel = (vx * accely - vy * accelx) * invSpeed * invSpeed; // 法向加速度 / 速率
+    return spawnBullet({ x, y, angle, angVel, 0.0f, speed, tanAccel, type, color });
+  }
+
+  // 初速度为 0 时, 子弹沿加速度方向做匀加速直线运动
+  float const angle = Core::Math::fastAtan2(accely, accelx);
+  float const tanAccel = Core::Math::fastHypot(accelx, accely);
+  return spawnBullet({ x, y, angle, 0.0f, 0.0f, 0.0f, tanAccel, type, color });
+}
+
+BulletHandle BulletManager::spawnBulletA(float x,
+                                         float y,
+                                         float angle,
+                                         float angVel,
+                                         float angAccel,
+                                         float speed,
+                                         float tanAccel,
+                                         std::uint16_t type,
+                                         std::uint16_t color) noexcept
+{
+  return spawnBullet({ x, y, angle, angVel, angAccel, speed, tanAccel, type, color });
+}
+
+std::size_t BulletManager::reserveBatch(EmitParams const& params,
+                                        std::size_t count,
+                                        BulletHandle* outHandles,
+                                        std::size_t& first) noexcept
+{
+  std::size_t const available = m_bullets.capacity() - m_activeCount;
+  std::size_t const n = std::min(count, available);
+  m_overflowCount += count - n;
+
+  first = m_activeCount;
+  if (n == 0) {
+    return 0; // 内存池已满时 first 等于容量, 不能再取 &array[first]
+  }
+  m_activeCount += n;
+
+  // 整批写入公共字段, 每个字段是一段连续内存
+  std::fill_n(&m_bullets.x[first], n, toSimScalar(params.x));
+  std::fill_n(&m_bullets.y[first], n, toSimScalar(params.y));
+  std::fill_n(&m_bullets.angVel[first], n, toSimAngle(params.angVel));
+  std::fill_n(&m_bullets.angAccel[first], n, toSimAngle(params.angAccel));
+  std::fill_n(&m_bullets.speed[first], n, toSimScalar(params.speed));
+  std::fill_n(&m_bullets.tanAccel[first], n, toSimScalar(params.tanAccel));
+  std::fill_n(&m_bullets.type[first], n, params.type);
+  std::fill_n(&m_bullets.color[first], n, params.color);
+
+  // 从空闲栈顶取 n 个槽位, 顺序与逐颗调用 spawnBullet 相同
+  std::size_t const freeTop = m_freeIds.size();
+  for (std::size_t i = 0; i < n; ++i) {
+    std::uint32_t const id = m_freeIds[freeTop - 1 - i];
+    m_bullets.id[first + i] = id;
+    m_sparse[id] = static_cast<std::uint32_t>(first + i);
+    if (outHandles) {
+      outHandles[i] = { id, m_generation[id] };
+    }
+  }
+  m_freeIds.resize(freeTop - n);
+
+  spawnedMetric.add(n);
+  return n;
+}
+
+std::size_t BulletManager::emitRing(EmitParams const& params,
+                                    float baseAngle,
+                                    std::size_t count,
+                                    BulletHandle* outHandles) noexcept
+{
+  std::size_t first = 0;
+  std::size_t const n = reserveBatch(params, count, outHandles, first);
+  if (n == 0) {
+    return 0; // 包括 count 为 0 的情况, 先于下面按 count 等分圆周的除法返回
+  }
+  float const step = std::numbers::pi_v<float> * 2.0f / static_cast<float>(count);
+  fillArithmetic(&m_bullets.angle[first], n, toSimAngle(baseAngle), toSimAngle(step));
+  return n;
+}
+
+std::size_t BulletManager::emitFan(EmitParams const& params,
+                                   float centerAngle,
+                                   float spread,
+                                   std::size_t count,
+                                   BulletHandle* outHandles) noexcept
+{
+  std::size_t first = 0;
+  std::size_t const n = reserveBatch(params, count, outHandles, first);
+  if (n == 0) {
+    return 0;
   }
+  if (count == 1) {
+    fillArithmetic(&m_bullets.angle[first], n, toSimAngle(centerAngle), toSimAngle(0.0f));
+  } else {
+    float const step = spread / static_cast<float>(count - 1);
+    fillArithmetic(&m_bullets.angle[first], n, toSimAngle(centerAngle - spread * 0.5f), toSimAngle(step));
+  }
+  return n;
+}
 
-  m_bullets[m_activeCount++] = bullet;
+std::size_t BulletManager::emitSpiral(EmitParams const& params,
+                                      float baseAngle,
+                                      float angleStep,
+                                      float speedStep,
+                                      std::size_t count,
+                                      BulletHandle* outHandles) noexcept
+{
+  std::size_t first = 0;
+  std::size_t const n = reserveBatch(params, count, outHandles, first);
+  if (n == 0) {
+    return 0;
+  }
+  fillArithmetic(&m_bullets.angle[first], n, toSimAngle(baseAngle), toSimAngle(angleStep));
+  fillArithmetic(&m_bullets.speed[first], n, toSimScalar(params.speed), toSimScalar(speedStep));
+  return n;
 }
 
-void BulletManager::spawnBulletV(float x,
-                                 float y,
-                                 float vx,
-                                 float vy,
-                                 float accelx,
-                                 float accely,
-                                 std::uint16_t type,
-                                 std::uint16_t color) noexcept
+std::size_t BulletManager::emitRandomSpread(EmitParams const& params,
+                                            float centerAngle,
+                                            float spread,
+                                            float speedRange,
+                                            std::size_t count,
+                                            Core::Random::Stream& rng,
+                                            BulletHandle* outHandles) noexcept
 {
-  float angle = std::atan2(vx, vy);           // 与 +y 的夹角
-  float speed = std::sqrt(vx * vx + vy * vy); // 速率
-  // TODO: 计算角加速度和切向加速度
-  // spawnBullet({ });
-  LOG_DEBUG("WARNING! BulletManager::spawnBulletV is called. This may cause extra overhead due to atan2 and sqrt "
-            "calculations.");
+  std::size_t first = 0;
+  std::size_t const n = reserveBatch(params, count, outHandles, first);
+  if (n == 0) {
+    return 0;
+  }
+  float const minAngle = centerAngle - spread * 0.5f;
+#if defined(TOUHOU_FIXED_POINT)
+  // 逐个取数与批量填充的结果逐位相同, 定点模式下逐颗换算写入
+  for (std::size_t i = 0; i < n; ++i) {
+    m_bullets.angle[first + i] = toSimAngle(rng.nextRange(minAngle, spread));
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    m_bullets.speed[first + i] = toSimScalar(rng.nextRange(params.speed, speedRange));
+  }
+#else
+  rng.fillRange(&m_bullets.angle[first], n, minAngle, spread);
+  rng.fillRange(&m_bullets.speed[first], n, params.speed, speedRange);
+#endif
+  return n;
 }
 
-void BulletManager::spawnBulletA(float x,
-                                 float y,
-                                 float angle,
-                                 float angVel,
-                                 float angAccel,
-                                 float speed,
-                                 float tanAccel,
-                                 std::uint16_t type,
-                                 std::uint16_t color) noexcept
+std::size_t BulletManager::spawnBulletsV(EmitParams const& params,
+                                         float const* vx,
+                                         float const* vy,
+                                         std::size_t count,
+                                         BulletHandle* outHandles) noexcept
 {
-  spawnBullet({ x, y, angle, angVel, angAccel, speed, tanAccel, type, color });
+  std::size_t first = 0;
+  std::size_t const n = reserveBatch(params, count, outHandles, first);
+  if (n == 0) {
+    return 0;
+  }
+#if defined(TOUHOU_FIXED_POINT)
+  // 批量版本与标量函数逐位一致, 定点模式下逐颗计算后直接换算写入
+  for (std::size_t i = 0; i < n; ++i) {
+    m_bullets.angle[first + i] = toSimAngle(Core::Math::fastAtan2(vy[i], vx[i]));
+    m_bullets.speed[first + i] = toSimScalar(Core::Math::fastHypot(vx[i], vy[i]));
+  }
+#else
+  Core::Math::fastAtan2Batch(vy, vx, &m_bullets.angle[first], n);
+  Core::Math::fastHypotBatch(vx, vy, &m_bullets.speed[first], n);
+#endif
+  return n;
 }
 
 void BulletManager::update(float screenWidth, float screenHeight)
 {
-  static constexpr float offscreenMargin = 100.0f; // 允许子弹稍微出界一些再回收
-  float const leftBound = -offscreenMargin;
-  float const rightBound = screenWidth + offscreenMargin;
-  float const topBound = -offscreenMargin;
-  float const bottomBound = screenHeight + offscreenMargin;
-
-  for (int i = 0; i < m_activeCount;) {
-    Bullet& b = m_bullets[i];
-    // 更新位置
-    b.updatePosition();
-    // 边界检查
-    if (b.x < leftBound || b.x > rightBound || b.y < topBound || b.y > bottomBound) {
-      // Swap and Pop 回收子弹: 用最后一颗子弹覆盖当前子弹, 然后减少有效子弹计数
-      m_bullets[i] = m_bullets[--m_activeCount];
-      // 无需 ++i, 因为需要立刻检查被交换过来的子弹是否也需要回收
-    } else {
-      ++i; // 只有当子弹没有被回收时才移动到下一个索引
+  PROFILE_FUNCTION();
+
+  // 汇总报告本帧 (上一次 update 以来) 的溢出, 避免内存池满时每颗子弹打印一行日志
+  if (m_overflowCount > 0) {
+    LOG_WARN("BulletManager capacity reached. {} bullets dropped this frame.", m_overflowCount);
+  }
+  overflowMetric.add(m_overflowCount);
+  m_lastFrameOverflow = m_overflowCount;
+  m_overflowCount = 0;
+
+  BulletBounds const bounds{ .left = -OFFSCREEN_MARGIN,
+                             .right = screenWidth + OFFSCREEN_MARGIN,
+                             .top = -OFFSCREEN_MARGIN,
+                             .bottom = screenHeight + OFFSCREEN_MARGIN };
+
+  // 先整体积分并收集出界子弹, 再统一回收, 使积分循环没有数据依赖, 可以按 SIMD 宽度批量执行
+  std::size_t killCount = 0;
+  if (m_jobSystem && m_activeCount >= PARALLEL_MIN_COUNT) {
+    killCount = integrateParallel(bounds);
+  } else {
+    killCount = integrateBullets(m_bullets, 0, m_activeCount, bounds, m_killList.data());
+  }
+  // 回收是串行的第二遍, 输入的下标序列与单线程时完全相同, 因此结果确定
+  killCount = mergePendingKills(killCount);
+  removeKilled(killCount);
+
+  if (m_stateHashEnabled) {
+    m_lastStateHash = computeStateHash();
+  }
+}
+
+std::uint64_t BulletManager::computeStateHash() const noexcept
+{
+  // 64 位 FNV-1a, 以字段的位模式为单位混合, 浮点模式下 -0.0 与 0.0 等也会被区分
+  std::uint64_t hash = 0xCBF2'9CE4'8422'2325ull;
+  auto const mix = [&hash](std::uint64_t word) { hash = (hash ^ word) * 0x0000'0100'0000'01B3ull; };
+  auto const mixArray = [this, &mix](auto const& array) {
+    using T = typename std::remove_cvref_t<decltype(array)>::value_type;
+    using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint16_t>;
+    for (std::size_t i = 0; i < m_activeCount; ++i) {
+      mix(std::bit_cast<Bits>(array[i]));
+    }
+  };
+
+  mix(m_activeCount);
+  mixArray(m_bullets.x);
+  mixArray(m_bullets.y);
+  mixArray(m_bullets.angle);
+  mixArray(m_bullets.angVel);
+  mixArray(m_bullets.angAccel);
+  mixArray(m_bullets.speed);
+  mixArray(m_bullets.tanAccel);
+  mixArray(m_bullets.type);
+  mixArray(m_bullets.color);
+  return hash;
+}
+
+std::size_t BulletManager::mergePendingKills(std::size_t killCount)
+{
+  if (m_pendingKills.empty()) {
+    return killCount;
+  }
+
+  // 同一颗子弹可能既被 kill() 登记又在本帧出界, 合并时去重
+  std::sort(m_pendingKills.begin(), m_pendingKills.end());
+  auto const pendingEnd = std::unique(m_pendingKills.begin(), m_pendingKills.end());
+  auto const mergedEnd = std::set_union(m_killList.begin(),
+                                        m_killList.begin() + killCount,
+                                        m_pendingKills.begin(),
+                                        pendingEnd,
+                                        m_killScratch.begin());
+  m_pendingKills.clear();
+
+  std::size_t const mergedCount = static_cast<std::size_t>(mergedEnd - m_killScratch.begin());
+  m_killList.swap(m_killScratch);
+  return mergedCount;
+}
+
+std::size_t BulletManager::integrateParallel(BulletBounds const& bounds)
+{
+  std::size_t const chunkCount = (m_activeCount + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+
+  // 各块互不重叠, 块的出界下标写在 m_killList[块起点] 处, 块内最多写满块长, 不会越界到下一块
+  m_jobSystem->parallelFor(chunkCount, 1, [this, &bounds](std::size_t firstChunk, std::size_t lastChunk) noexcept {
+    for (std::size_t c = firstChunk; c < lastChunk; ++c) {
+      std::size_t const begin = c * PARALLEL_CHUNK_SIZE;
+      std::size_t const end = std::min(begin + PARALLEL_CHUNK_SIZE, m_activeCount);
+      m_chunkKillCounts[c] = integrateBullets(m_bullets, begin, end, bounds, m_killList.data() + begin);
+    }
+  });
+
+  // 按块顺序把各块的出界下标向前拼接, 得到与单线程积分相同的升序序列
+  std::size_t killCount = 0;
+  for (std::size_t c = 0; c < chunkCount; ++c) {
+    std::uint32_t const* chunkKills = m_killList.data() + c * PARALLEL_CHUNK_SIZE;
+    std::copy(chunkKills, chunkKills + m_chunkKillCounts[c], m_killList.data() + killCount);
+    killCount += m_chunkKillCounts[c];
+  }
+  return killCount;
+}
+
+void BulletManager::removeKilled(std::size_t killCount) noexcept
+{
+  if (killCount == 0) {
+    return;
+  }
+  killedMetric.add(killCount);
+
+  // 先按搬移前的下标释放死亡子弹的槽位
+  for (std::size_t k = 0; k < killCount; ++k) {
+    releaseId(m_bullets.id[m_killList[k]]);
+  }
+  if (killCount == m_activeCount) {
+    m_activeCount = 0; // 全部回收 (如大范围消弹), 无需搬移
+    return;
+  }
+
+  if (m_removalMode == RemovalMode::Stable) {
+    // 各字段数组独立地按同一份下标序列压实, 存活子弹保持生成顺序
+    std::uint32_t const* kills = m_killList.data();
+    std::size_t const count = m_activeCount;
+    m_bullets.forEachArray([=](auto& array) { compactStable(array.data(), count, kills, killCount); });
+    m_activeCount -= killCount;
+
+    // 第一个死亡下标之后的子弹都向前移动过, 更新它们在稀疏表中的下标
+    for (std::size_t i = m_killList[0]; i < m_activeCount; ++i) {
+      m_sparse[m_bullets.id[i]] = static_cast<std::uint32_t>(i);
+    }
+    return;
+  }
+
+  // Swap and Pop 回收子弹: 用最后一颗子弹覆盖当前子弹, 然后减少有效子弹计数
+  // 从下标最大的开始处理: 比当前下标大的死亡子弹都已被移除, 所以搬过来的最后一颗子弹一定存活
+  for (std::size_t k = killCount; k-- > 0;) {
+    std::size_t const dead = m_killList[k];
+    std::size_t const last = --m_activeCount;
+    if (dead != last) {
+      m_bullets.move(dead, last);
+      m_sparse[m_bullets.id[dead]] = static_cast<std::uint32_t>(dead);
+    }
+  }
+}
+
+bool BulletManager::getBullet(BulletHandle handle, Bullet& out) const noexcept
+{
+  std::size_t const index = indexOf(handle);
+  if (index == npos) {
+    return false;
+  }
+  out = m_bullets.load(index);
+  return true;
+}
+
+bool BulletManager::setBullet(BulletHandle handle, Bullet const& bullet) noexcept
+{
+  std::size_t const index = indexOf(handle);
+  if (index == npos) {
+    return false;
+  }
+  m_bullets.store(index, bullet);
+  return true;
+}
+
+bool BulletManager::kill(BulletHandle handle) noexcept
+{
+  std::size_t const index = indexOf(handle);
+  if (index == npos) {
+    return false;
+  }
+  // 立即让句柄失效 (回收时代数会再加一次, 不影响正确性), 同一颗子弹不会被重复登记
+  ++m_generation[handle.index];
+  m_pendingKills.push_back(static_cast<std::uint32_t>(index));
+  return true;
+}
+
+void BulletManager::saveState(Core::BinaryWriter& writer) const
+{
+  writer.write<std::uint64_t>(m_bullets.capacity());
+  writer.write<std::uint64_t>(m_activeCount);
+  // 只写出有效槽位; 稀疏表可由 id 数组重建, 不需要保存
+  m_bullets.forEachArray([&](auto const& array) { writer.writeArray(array.data(), m_activeCount); });
+  writer.writeArray(m_generation.data(), m_generation.size());
+  writer.write<std::uint64_t>(m_freeIds.size());
+  writer.writeArray(m_freeIds.data(), m_freeIds.size());
+  writer.write<std::uint64_t>(m_pendingKills.size());
+  writer.writeArray(m_pendingKills.data(), m_pendingKills.size());
+  writer.write<std::uint64_t>(m_overflowCount);
+  writer.write<std::uint64_t>(m_lastFrameOverflow);
+}
+
+void BulletManager::loadState(Core::BinaryReader& reader)
+{
+  std::size_t const capacity = m_bullets.capacity();
+  std::uint64_t const savedCapacity = reader.read<std::uint64_t>();
+  std::uint64_t const activeCount = reader.read<std::uint64_t>();
+  if (savedCapacity != capacity || activeCount > capacity) {
+    LOG_ERROR("BulletManager state capacity mismatch: saved {}, current {}", savedCapacity, capacity);
+    throw std::runtime_error("BulletManager state capacity mismatch.");
+  }
+
+  m_activeCount = static_cast<std::size_t>(activeCount);
+  m_bullets.forEachArray([&](auto& array) { reader.readArray(array.data(), m_activeCount); });
+  reader.readArray(m_generation.data(), m_generation.size());
+
+  std::uint64_t const freeCount = reader.read<std::uint64_t>();
+  if (freeCount != capacity - m_activeCount) {
+    throw std::runtime_error("BulletManager state is corrupted.");
+  }
+  m_freeIds.resize(static_cast<std::size_t>(freeCount));
+  reader.readArray(m_freeIds.data(), m_freeIds.size());
+  for (std::uint32_t const id : m_freeIds) {
+    if (id >= capacity) {
+      throw std::runtime_error("BulletManager state is corrupted.");
+    }
+  }
+
+  std::uint64_t const pendingCount = reader.read<std::uint64_t>();
+  if (pendingCount > m_activeCount) {
+    throw std::runtime_error("BulletManager state is corrupted.");
+  }
+  m_pendingKills.resize(static_cast<std::size_t>(pendingCount));
+  reader.readArray(m_pendingKills.data(), m_pendingKills.size());
+
+  m_overflowCount = static_cast<std::size_t>(reader.read<std::uint64_t>());
+  m_lastFrameOverflow = static_cast<std::size_t>(reader.read<std::uint64_t>());
+
+  for (std::size_t i = 0; i < m_activeCount; ++i) {
+    if (m_bullets.id[i] >= capacity) {
+      throw std::runtime_error("BulletManager state is corrupted.");
     }
+    m_sparse[m_bullets.id[i]] = static_cast<std::uint32_t>(i);
   }
 }
 
+std::size_t BulletManager::maxStateSize() const noexcept
+{
+  std::size_t bytesPerBullet = 0;
+  m_bullets.forEachArray([&](auto const& array) { bytesPerBullet += sizeof(array[0]); });
+  std::size_t const capacity = m_bullets.capacity();
+  // 计数字段 + 全部子弹 + 代数表 + 空闲栈 + 待回收列表
+  return sizeof(std::uint64_t) * 6 + capacity * (bytesPerBullet + sizeof(std::uint32_t) * 3);
+}
+
 void BulletManager::clearBullets()
 {
+  for (std::size_t i = 0; i < m_activeCount; ++i) {
+    releaseId(m_bullets.id[i]);
+  }
+  m_pendingKills.clear();
   m_activeCount = 0;
 }
+
+std::size_t BulletManager::cancelSelected(std::size_t count, float* outX, float* outY) noexcept
+{
+  for (std::size_t k = 0; k < count; ++k) {
+    std::uint32_t const index = m_killList[k];
+    outX[k] = fromSimScalar(m_bullets.x[index]);
+    outY[k] = fromSimScalar(m_bullets.y[index]);
+  }
+  removeKilled(count);
+  return count;
+}
+
+std::size_t BulletManager::cancelCircle(float x, float y, float radius, float* outX, float* outY)
+{
+  removeKilled(mergePendingKills(0));
+  std::size_t const count = selectInCircle(m_bullets, m_activeCount, x, y, radius, m_killList.data());
+  return cancelSelected(count, outX, outY);
+}
+
+std::size_t BulletManager::cancelRect(BulletBounds const& rect, float* outX, float* outY)
+{
+  removeKilled(mergePendingKills(0));
+  std::size_t const count = selectInRect(m_bullets, m_activeCount, rect, m_killList.data());
+  return cancelSelected(count, outX, outY);
+}
+
+std::size_t BulletManager::cancelAll(float* outX, float* outY)
+{
+  removeKilled(mergePendingKills(0));
+  std::size_t const count = m_activeCount;
+  std::transform(m_bullets.x.begin(), m_bullets.x.begin() + count, outX, fromSimScalar);
+  std::transform(m_bullets.y.begin(), m_bullets.y.begin() + count, outY, fromSimScalar);
+  clearBullets();
+  return count;
+}
 } // namespace Game
@@ -1,13 +1,32 @@
 #pragma once
 
+#include "Core/Random.hpp"
 #include "Game/Bullet.hpp"
+#include "Game/BulletHandle.hpp"
+#include "Game/BulletKernel.hpp"
+#include "Game/BulletPattern.hpp"
+#include "Game/BulletSoA.hpp"
 
 #include <cstdint>
 #include <vector>
 
+namespace Core {
+class JobSystem;
+class BinaryWriter;
+class BinaryReader;
+}
+
 namespace Game {
 class BulletManager
 {
+public:
+  // 回收出界子弹的方式
+  enum class RemovalMode : std::uint8_t
+  {
+    SwapAndPop, // 用末尾的子弹填补空位, 最快, 但每帧都会打乱子弹顺序 (绘制顺序随之变化)
+    Stable      // 保序压实, 存活子弹保持生成顺序, 绘制顺序稳定
+  };
+
 public:
   BulletManager() = default;
   ~BulletManager() = default;
@@ -18,40 +37,184 @@ public:
 
   void init(std::size_t capacity); // 初始化内存池大小
 
-  // 创造一颗新子弹
-  void spawnBullet(Bullet const& bullet) noexcept;
-  // 使用矢量速度创造子弹
-  void spawnBulletV(float x,
-                    float y,
-                    float vx,
-                    float vy,
-                    float accelx,
-                    float accely,
-                    std::uint16_t type,
-                    std::uint16_t color) noexcept;
+  // 设置用于并行更新的线程池 (不管理生命周期), 为 nullptr 时始终单线程更新
+  void setJobSystem(Core::JobSystem* jobSystem) noexcept { m_jobSystem = jobSystem; }
+
+  void setRemovalMode(RemovalMode mode) noexcept { m_removalMode = mode; }
+  RemovalMode getRemovalMode() const noexcept { return m_removalMode; }
+
+  // 创造一颗新子弹, 返回其句柄; 内存池已满时返回空句柄
+  BulletHandle spawnBullet(Bullet const& bullet) noexcept;
+  // 使用矢量速度和矢量加速度创造子弹, 换算为角度表示 (快速近似: 角度绝对误差约 2e-6 弧度, 速率相对误差约 5e-6)
+  // 加速度按生成时刻的速度方向瞬时分解为切向加速度和角速度, 之后两者保持不变, 不会随速度方向重新分解:
+  // 恒定的世界坐标系加速度 (如重力) 无法用这种表示描述, 例如 v = (2, 0), a = (0, 0.1) 得到 angVel = 0.05,
+  // tanAccel = 0, 子弹沿半径 40 的圆周运动而不是抛物线; 只有生成瞬间的加速度与给定值一致
+  // 初速度为 0 时子弹沿加速度方向匀加速 (此时两种表示等价)
+  BulletHandle spawnBulletV(float x,
+                            float y,
+                            float vx,
+                            float vy,
+                            float accelx,
+                            float accely,
+                            std::uint16_t type,
+                            std::uint16_t color) noexcept;
   // 使用角(弧度制)和速率创造子弹
-  void spawnBulletA(float x,
-                    float y,
-                    float angle,
-                    float angVel,
-                    float angAccel,
-                    float speed,
-                    float tanAccel,
-                    std::uint16_t type,
-                    std::uint16_t color) noexcept;
+  BulletHandle spawnBulletA(float x,
+                            float y,
+                            float angle,
+                            float angVel,
+                            float angAccel,
+                            float speed,
+                            float tanAccel,
+                            std::uint16_t type,
+                            std::uint16_t color) noexcept;
+
+  // 批量发射: 整批只检查一次容量, 整批计算角度后直接写入内存池
+  // 返回实际发射的数量 (内存池不足时少于 count); outHandles 非空时依次写入每颗子弹的句柄
+  // 环形: count 颗子弹均匀分布在整个圆周上, 第一颗朝向 baseAngle
+  std::size_t emitRing(EmitParams const& params,
+                       float baseAngle,
+                       std::size_t count,
+                       BulletHandle* outHandles = nullptr) noexcept;
+  // 扇形: count 颗子弹均匀分布在以 centerAngle 为中心, 张角为 spread 的扇形上 (含两端)
+  std::size_t emitFan(EmitParams const& params,
+                      float centerAngle,
+                      float spread,
+                      std::size_t count,
+                      BulletHandle* outHandles = nullptr) noexcept;
+  // 螺旋: 第 i 颗子弹的角度为 baseAngle + i * angleStep, 速率为 speed + i * speedStep
+  std::size_t emitSpiral(EmitParams const& params,
+                         float baseAngle,
+                         float angleStep,
+                         float speedStep,
+                         std::size_t count,
+                         BulletHandle* outHandles = nullptr) noexcept;
+  // 随机散布: 角度在 centerAngle ± spread / 2 内均匀分布, 速率在 [speed, speed + speedRange) 内均匀分布
+  // 先从 rng 批量取 count 个角度, 再取 count 个速率, 结果只取决于流的种子, 流编号与位置
+  std::size_t emitRandomSpread(EmitParams const& params,
+                               float centerAngle,
+                               float spread,
+                               float speedRange,
+                               std::size_t count,
+                               Core::Random::Stream& rng,
+                               BulletHandle* outHandles = nullptr) noexcept;
+  // 矢量速度批量发射: 第 i 颗子弹的速度为 (vx[i], vy[i]), params.speed 被忽略, 其余字段取自 params
+  std::size_t spawnBulletsV(EmitParams const& params,
+                            float const* vx,
+                            float const* vy,
+                            std::size_t count,
+                            BulletHandle* outHandles = nullptr) noexcept;
 
   // 每帧调用, 更新位置并回收出界子弹
+  // 设置了线程池且子弹足够多时, 分块并行积分, 结果与单线程更新逐位一致
   void update(float screenWidth, float screenHeight);
 
-  // 清空全屏子弹
+  // 模拟状态的哈希, 覆盖有效子弹的全部运动字段与类型, 用于比对回放等场合下两次运行的状态是否一致
+  // 只依赖字段的位模式和子弹顺序, 定点模式下任何 x86-64 构建的结果相同
+  std::uint64_t computeStateHash() const noexcept;
+  // 开启后每次 update 结束时计算一次哈希, 逐帧比对可定位发生分歧的帧; 默认关闭 (代价为一次遍历)
+  void setStateHashEnabled(bool enabled) noexcept { m_stateHashEnabled = enabled; }
+  std::uint64_t getLastStateHash() const noexcept { return m_lastStateHash; }
+
+  // 序列化全部模拟状态 (有效子弹, 句柄代数与空闲槽位, 待回收列表), 用于回放检查点等场合
+  // 恢复后的后续模拟 (包括新句柄的分配顺序) 与保存时继续运行的结果逐位相同
+  void saveState(Core::BinaryWriter& writer) const;
+  // 恢复 saveState 写出的状态, 内存池容量必须与保存时相同, 否则抛出 std::runtime_error
+  void loadState(Core::BinaryReader& reader);
+  // saveState 输出的最大字节数 (内存池全满时), 用于预先分配快照缓冲区
+  std::size_t maxStateSize() const noexcept;
+
+  // 清空全屏子弹, 所有句柄随之失效
   void clearBullets();
 
-  // 获取有效子弹数据 buffer
-  Bullet const* getActiveBullets() const noexcept { return m_bullets.data(); }
+  // 消弹: 立即移除区域内 (含边界) 的全部子弹, 被移除子弹的句柄随之失效, 返回移除的个数
+  // 被移除子弹的坐标按原有顺序写入 outX / outY (各至少 getActiveCount() 个空位), 供整批转换为道具
+  // 先回收 kill() 登记的子弹 (它们不会转换为道具), 再用 SIMD 区域查询整批选出, 最后与出界回收共用一次压实
+  // 整个过程没有逐颗子弹的分支和内存分配, 开销与全屏子弹数成正比, 与被消除的数量基本无关
+  std::size_t cancelCircle(float x, float y, float radius, float* outX, float* outY);
+  std::size_t cancelRect(BulletBounds const& rect, float* outX, float* outY);
+  // 全屏消弹
+  std::size_t cancelAll(float* outX, float* outY);
+
+  // 句柄操作, 均为 O(1): 经稀疏表找到子弹在有效数组中的当前下标
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  bool isAlive(BulletHandle handle) const noexcept { return indexOf(handle) != npos; }
+  // 子弹在有效数组中的当前下标, 句柄已失效时返回 npos; 下标只在下一次 update 前有效
+  std::size_t indexOf(BulletHandle handle) const noexcept
+  {
+    if (handle.index >= m_sparse.size() || m_generation[handle.index] != handle.generation) {
+      return npos;
+    }
+    return m_sparse[handle.index];
+  }
+  bool getBullet(BulletHandle handle, Bullet& out) const noexcept;
+  bool setBullet(BulletHandle handle, Bullet const& bullet) noexcept;
+  // 击杀子弹: 句柄立即失效, 子弹在下一次 update 时随出界子弹一起回收
+  bool kill(BulletHandle handle) noexcept;
+  // 有效数组中第 index 颗子弹的句柄 (index < getActiveCount())
+  BulletHandle getHandle(std::size_t index) const noexcept
+  {
+    std::uint32_t const id = m_bullets.id[index];
+    return { id, m_generation[id] };
+  }
+
+  // 获取有效子弹数据 (SoA), 前 getActiveCount() 个槽位有效
+  BulletSoA const& getActiveBullets() const noexcept { return m_bullets; }
   std::size_t getActiveCount() const noexcept { return m_activeCount; }
+  // 上一帧因内存池已满而未能生成的子弹数
+  std::size_t getLastFrameOverflow() const noexcept { return m_lastFrameOverflow; }
+
+public:
+  static constexpr float OFFSCREEN_MARGIN = 100.0f;        // 允许子弹稍微出界一些再回收 (像素)
+  static constexpr std::size_t PARALLEL_CHUNK_SIZE = 8192; // 并行更新时每个任务处理的子弹数, 需为 SIMD 宽度的倍数
+  static constexpr std::size_t PARALLEL_MIN_COUNT = PARALLEL_CHUNK_SIZE * 4; // 少于该数量时并行的调度开销得不偿失
 
 private:
-  std::vector<Bullet> m_bullets;
-  std::size_t m_activeCount;
+  // 分块并行积分, 每块的出界下标先写在 m_killList 中与该块起点对齐的位置, 再按块顺序拼接, 返回总数
+  std::size_t integrateParallel(BulletBounds const& bounds);
+
+  // 为一批子弹预留槽位 (只检查一次容量), 分配句柄槽位并写入 params 中的公共字段
+  // 返回实际预留的个数, 第一颗的下标写入 first; 角度等逐颗不同的字段由调用者随后写入
+  std::size_t reserveBatch(EmitParams const& params,
+                           std::size_t count,
+                           BulletHandle* outHandles,
+                           std::size_t& first) noexcept;
+
+  // 把 kill() 登记的子弹并入 m_killList 的前 killCount 项 (保持升序且去重), 返回合并后的个数
+  std::size_t mergePendingKills(std::size_t killCount);
+
+  // 按 m_removalMode 回收 m_killList 中记录的 killCount 颗子弹 (下标升序), 并维护稀疏表
+  void removeKilled(std::size_t killCount) noexcept;
+
+  // 输出 m_killList 前 count 项子弹的坐标后回收它们, 返回 count
+  std::size_t cancelSelected(std::size_t count, float* outX, float* outY) noexcept;
+
+  // 释放子弹占用的稀疏表槽位, 使指向它的句柄失效
+  void releaseId(std::uint32_t id) noexcept
+  {
+    ++m_generation[id];
+    m_freeIds.push_back(id);
+  }
+
+private:
+  BulletSoA m_bullets;
+  std::vector<std::uint32_t> m_killList;      // 本帧需要回收的子弹下标, 与内存池等长, 避免每帧分配
+  std::vector<std::size_t> m_chunkKillCounts; // 并行更新时每块的出界子弹数
+  std::vector<std::uint32_t> m_killScratch;   // 合并击杀列表时的临时缓冲区
+
+  // 稀疏集 (sparse set): 句柄槽位 -> 有效数组下标, 有效数组本身保持连续以供热循环使用
+  std::vector<std::uint32_t> m_sparse;       // 槽位 -> 有效数组下标
+  std::vector<std::uint32_t> m_generation;   // 槽位 -> 当前代数
+  std::vector<std::uint32_t> m_freeIds;      // 空闲槽位栈
+  std::vector<std::uint32_t> m_pendingKills; // kill() 登记, 等待下一次 update 回收的有效数组下标
+  std::size_t m_activeCount = 0;
+  std::size_t m_overflowCount = 0;     // 本帧因内存池已满而丢弃的子弹数, 每帧汇总报告一次
+  std::size_t m_lastFrameOverflow = 0; // 上一帧的汇总结果
+
+  RemovalMode m_removalMode = RemovalMode::Stable;
+  bool m_stateHashEnabled = false;
+  std::uint64_t m_lastStateHash = 0;
+  Core::JobSystem* m_jobSystem = nullptr;
 };
 } // namespace Game
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Game {
+// 批量发射 (环形, 扇形, 螺旋, 随机散布) 的公共参数, 角度由各发射函数按图案计算
+struct EmitParams
+{
+  float x = 0;             // 发射点
+  float y = 0;             // 发射点
+  float speed = 0;         // 初始速率
+  float angVel = 0;        // 角速度
+  float angAccel = 0;      // 角加速度
+  float tanAccel = 0;      // 切向加速度
+  std::uint16_t type = 0;  // 子弹 (贴图) 类型
+  std::uint16_t color = 0; // 颜色
+};
+
+// 小型随机数发生器 (xorshift32), 状态只有 4 字节, 用于工具与性能测试中生成场景; 模拟中的随机弹幕使用 Core::Random::Stream
+struct PatternRng
+{
+  std::uint32_t state = 0x9E37'79B9; // 不能为 0
+
+  std::uint32_t nextU32() noexcept
+  {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+
+  // [0, 1) 范围的浮点数, 取高 24 位, 结果与编译器无关
+  float nextFloat() noexcept { return static_cast<float>(nextU32() >> 8) * (1.0f / 16777216.0f); }
+};
+} // namespace Game
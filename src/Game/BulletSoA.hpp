@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Core/AlignedAllocator.hpp"
+#include "Game/Bullet.hpp"
+#include "Game/SimTypes.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Game {
+// 子弹池的 SoA (Structure of Arrays) 存储: 每个字段单独一个 64 字节对齐的连续数组
+// 更新内核一次只读写需要的字段, 且可以按 SIMD 宽度整批加载
+// 运动字段的类型由 SimTypes.hpp 决定 (float 或定点), 读取坐标时用 fromSimScalar / fromSimAngle 换算
+struct BulletSoA
+{
+  template <typename T>
+  using Array = std::vector<T, Core::AlignedAllocator<T, 64>>;
+
+  Array<SimScalar> x;
+  Array<SimScalar> y;
+  Array<SimAngle> angle;
+  Array<SimAngle> angVel;
+  Array<SimAngle> angAccel;
+  Array<SimScalar> speed;
+  Array<SimScalar> tanAccel;
+  Array<std::uint16_t> type;
+  Array<std::uint16_t> color;
+  Array<std::uint32_t> id; // 子弹在 BulletManager 稀疏表中的槽位 (BulletHandle::index), 随子弹一起搬移
+
+  // 对每个字段数组调用 fn(array), 用于与字段无关的批量操作 (扩容, 压实等)
+  template <typename F>
+  void forEachArray(F&& fn)
+  {
+    fn(x);
+    fn(y);
+    fn(angle);
+    fn(angVel);
+    fn(angAccel);
+    fn(speed);
+    fn(tanAccel);
+    fn(type);
+    fn(color);
+    fn(id);
+  }
+
+  template <typename F>
+  void forEachArray(F&& fn) const
+  {
+    fn(x);
+    fn(y);
+    fn(angle);
+    fn(angVel);
+    fn(angAccel);
+    fn(speed);
+    fn(tanAccel);
+    fn(type);
+    fn(color);
+    fn(id);
+  }
+
+  void resize(std::size_t capacity)
+  {
+    forEachArray([capacity](auto& array) { array.resize(capacity); });
+  }
+
+  std::size_t capacity() const noexcept { return x.size(); }
+
+  // 把 AoS 形式的子弹写入第 i 个槽位 (不修改 id)
+  void store(std::size_t i, Bullet const& b) noexcept
+  {
+    x[i] = toSimScalar(b.x);
+    y[i] = toSimScalar(b.y);
+    angle[i] = toSimAngle(b.angle);
+    angVel[i] = toSimAngle(b.angVel);
+    angAccel[i] = toSimAngle(b.angAccel);
+    speed[i] = toSimScalar(b.speed);
+    tanAccel[i] = toSimScalar(b.tanAccel);
+    type[i] = b.type;
+    color[i] = b.color;
+  }
+
+  // 读出第 i 个槽位, 组装成 AoS 形式的子弹
+  Bullet load(std::size_t i) const noexcept
+  {
+    return { fromSimScalar(x[i]),
+             fromSimScalar(y[i]),
+             fromSimAngle(angle[i]),
+             fromSimAngle(angVel[i]),
+             fromSimAngle(angAccel[i]),
+             fromSimScalar(speed[i]),
+             fromSimScalar(tanAccel[i]),
+             type[i],
+             color[i] };
+  }
+
+  // 把 src 槽位的所有字段复制到 dst 槽位
+  void move(std::size_t dst, std::size_t src) noexcept
+  {
+    forEachArray([dst, src](auto& array) { array[dst] = array[src]; });
+  }
+};
+} // namespace Game
@@ -0,0 +1,131 @@
+#include "BulletTypeTable.hpp"
+#include "Core/BinaryStream.hpp"
+#include "Core/Logger.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <iterator>
+
+namespace Game {
+
+namespace {
+constexpr std::uint32_t tableMagic = 0x5442'4854; // "THBT"
+constexpr std::uint16_t tableVersion = 1;
+
+[[noreturn]] void failTable(std::string const& message)
+{
+  LOG_ERROR(message);
+  throw std::runtime_error(message);
+}
+} // namespace
+
+BulletTypeTable::BulletTypeTable()
+  : m_styles(1)
+{
+  rebuildRadii();
+}
+
+BulletTypeTable const& BulletTypeTable::getDefault()
+{
+  static BulletTypeTable const table;
+  return table;
+}
+
+void BulletTypeTable::build(std::uint16_t typeCount, std::uint16_t colorCount, std::vector<BulletStyle> styles)
+{
+  if (typeCount == 0 || colorCount == 0 || styles.size() != static_cast<std::size_t>(typeCount) * colorCount) {
+    failTable(std::format("Bullet type table expects {} x {} styles, got {}.", typeCount, colorCount, styles.size()));
+  }
+  m_typeCount = typeCount;
+  m_colorCount = colorCount;
+  m_styles = std::move(styles);
+  rebuildRadii();
+}
+
+void BulletTypeTable::rebuildRadii()
+{
+  m_hitRadius.resize(m_styles.size());
+  m_grazeRadius.resize(m_styles.size());
+  m_maxRadius = 0.0f;
+  for (std::size_t i = 0; i < m_styles.size(); ++i) {
+    m_hitRadius[i] = m_styles[i].hitRadius;
+    m_grazeRadius[i] = m_styles[i].grazeRadius;
+    m_maxRadius = std::max({ m_maxRadius, m_styles[i].hitRadius, m_styles[i].grazeRadius });
+  }
+}
+
+void BulletTypeTable::save(Core::BinaryWriter& writer) const
+{
+  writer.write(tableMagic);
+  writer.write(tableVersion);
+  writer.write(m_typeCount);
+  writer.write(m_colorCount);
+  // 逐字段写入, 文件格式不受结构体填充影响
+  for (BulletStyle const& style : m_styles) {
+    writer.write(style.u0);
+    writer.write(style.v0);
+    writer.write(style.u1);
+    writer.write(style.v1);
+    writer.write(style.width);
+    writer.write(style.height);
+    writer.write(style.hitRadius);
+    writer.write(style.grazeRadius);
+    writer.write(style.blend);
+  }
+}
+
+void BulletTypeTable::load(Core::BinaryReader& reader)
+{
+  if (reader.read<std::uint32_t>() != tableMagic || reader.read<std::uint16_t>() != tableVersion) {
+    failTable("Not a bullet type table or unsupported version.");
+  }
+  auto const typeCount = reader.read<std::uint16_t>();
+  auto const colorCount = reader.read<std::uint16_t>();
+
+  std::vector<BulletStyle> styles(static_cast<std::size_t>(typeCount) * colorCount);
+  for (BulletStyle& style : styles) {
+    style.u0 = reader.read<float>();
+    style.v0 = reader.read<float>();
+    style.u1 = reader.read<float>();
+    style.v1 = reader.read<float>();
+    style.width = reader.read<float>();
+    style.height = reader.read<float>();
+    style.hitRadius = reader.read<float>();
+    style.grazeRadius = reader.read<float>();
+    style.blend = reader.read<BulletBlend>();
+    if (style.blend != BulletBlend::Alpha && style.blend != BulletBlend::Additive) {
+      failTable("Bullet type table is corrupted: unknown blend mode.");
+    }
+  }
+  build(typeCount, colorCount, std::move(styles));
+}
+
+void BulletTypeTable::saveToFile(std::string const& path) const
+{
+  std::vector<std::uint8_t> buffer;
+  Core::BinaryWriter writer(buffer);
+  save(writer);
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    failTable("Failed to open bullet type table for writing: " + path);
+  }
+  file.write(reinterpret_cast<char const*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+  if (!file) {
+    failTable("Failed to write bullet type table: " + path);
+  }
+}
+
+void BulletTypeTable::loadFromFile(std::string const& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    failTable("Failed to open bullet type table: " + path);
+  }
+  std::vector<std::uint8_t> const buffer{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+  Core::BinaryReader reader(buffer);
+  load(reader);
+  LOG_INFO("Bullet type table loaded: {} ({} types x {} colors)", path, m_typeCount, m_colorCount);
+}
+} // namespace Game
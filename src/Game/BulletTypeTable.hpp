@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Core {
+class BinaryWriter;
+class BinaryReader;
+}
+
+namespace Game {
+// 子弹的混合方式, 取值与 Graphics::BlendMode 一一对应
+enum class BulletBlend : std::uint8_t
+{
+  Alpha,    // 普通 Alpha 混合
+  Additive, // 加法混合 (发光弹)
+};
+
+// 一种 (type, color) 组合的外观与判定
+struct BulletStyle
+{
+  float u0 = 0.0f; // 贴图区域, 归一化纹理坐标 [0, 1]
+  float v0 = 0.0f;
+  float u1 = 1.0f;
+  float v1 = 1.0f;
+  float width = 30.0f;      // 绘制大小 (像素)
+  float height = 30.0f;     //
+  float hitRadius = 4.0f;   // 被弹判定半径 (像素)
+  float grazeRadius = 4.0f; // 擦弹判定半径, 与自机擦弹圆相交即擦弹
+  BulletBlend blend = BulletBlend::Alpha;
+};
+
+// 子弹类型表: (Bullet::type, Bullet::color) -> 外观与判定, 由 BulletTableCompiler 从文本编译为二进制文件
+// 表按 type * colorCount + color 连续存放, 渲染和碰撞逐颗子弹按下标查表, 不对子弹字段做分支
+// 超出表范围的 type 或 color 按 0 处理, 表中至少有一项
+//
+// 判定半径参与模拟, 录像不保存类型表: 录制与回放需使用同一份表, 否则会不同步
+class BulletTypeTable
+{
+public:
+  BulletTypeTable(); // 只有一项默认样式的表
+
+  // 共享的默认表 (只有一项默认样式), 供未设置类型表的使用者引用
+  static BulletTypeTable const& getDefault();
+
+  // 以 typeCount * colorCount 项样式 (按 type 主序) 重建表, 数量不符时抛出 std::runtime_error
+  void build(std::uint16_t typeCount, std::uint16_t colorCount, std::vector<BulletStyle> styles);
+
+  // 二进制读写, 格式错误时抛出 std::runtime_error
+  void save(Core::BinaryWriter& writer) const;
+  void load(Core::BinaryReader& reader);
+  void saveToFile(std::string const& path) const;
+  void loadFromFile(std::string const& path);
+
+  // (type, color) 对应的样式下标
+  std::uint32_t indexOf(std::uint16_t type, std::uint16_t color) const noexcept
+  {
+    std::uint32_t const t = type < m_typeCount ? type : 0u;
+    std::uint32_t const c = color < m_colorCount ? color : 0u;
+    return t * m_colorCount + c;
+  }
+
+  BulletStyle const& getStyle(std::uint32_t index) const noexcept { return m_styles[index]; }
+  // 碰撞只需要半径, 单独连续存放, 重建网格时的查表只触及这两个小数组
+  float getHitRadius(std::uint32_t index) const noexcept { return m_hitRadius[index]; }
+  float getGrazeRadius(std::uint32_t index) const noexcept { return m_grazeRadius[index]; }
+  float getMaxRadius() const noexcept { return m_maxRadius; } // 所有样式中最大的判定 / 擦弹半径
+
+  std::uint16_t getTypeCount() const noexcept { return m_typeCount; }
+  std::uint16_t getColorCount() const noexcept { return m_colorCount; }
+  std::size_t size() const noexcept { return m_styles.size(); }
+
+private:
+  void rebuildRadii();
+
+private:
+  std::uint16_t m_typeCount = 1;
+  std::uint16_t m_colorCount = 1;
+  std::vector<BulletStyle> m_styles;
+  std::vector<float> m_hitRadius;
+  std::vector<float> m_grazeRadius;
+  float m_maxRadius = 0.0f;
+};
+} // namespace Game
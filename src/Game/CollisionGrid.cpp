@@ -0,0 +1,144 @@
+#include "CollisionGrid.hpp"
+#include "Core/Logger.hpp"
+#include "Core/Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Game {
+
+void CollisionGrid::init(BulletBounds const& area, float cellSize, std::size_t capacity)
+{
+  m_area = area;
+  m_invCellSize = 1.0f / cellSize;
+  m_columns = std::max(1, static_cast<int>(std::ceil((area.right - area.left) * m_invCellSize)));
+  m_rows = std::max(1, static_cast<int>(std::ceil((area.bottom - area.top) * m_invCellSize)));
+
+  std::size_t const cellCount = static_cast<std::size_t>(m_columns) * m_rows;
+  m_cellStart.assign(cellCount + 1, 0);
+  m_cellCursor.assign(cellCount, 0);
+  m_cellOfBullet.resize(capacity);
+
+  m_sorted.resize(capacity);
+  if (!m_typeTable) {
+    m_typeTable = &BulletTypeTable::getDefault();
+  }
+
+  LOG_INFO("CollisionGrid initialized: {}x{} cells of {} px, capacity: {}", m_columns, m_rows, cellSize, capacity);
+}
+
+void CollisionGrid::setTypeTable(BulletTypeTable const* table) noexcept
+{
+  m_typeTable = table ? table : &BulletTypeTable::getDefault();
+}
+
+int CollisionGrid::cellX(float x) const noexcept
+{
+  // 先在浮点域夹取再转换, 避免远离区域的坐标转换为 int 时溢出
+  float const cx = std::clamp((x - m_area.left) * m_invCellSize, 0.0f, static_cast<float>(m_columns - 1));
+  return static_cast<int>(cx);
+}
+
+int CollisionGrid::cellY(float y) const noexcept
+{
+  float const cy = std::clamp((y - m_area.top) * m_invCellSize, 0.0f, static_cast<float>(m_rows - 1));
+  return static_cast<int>(cy);
+}
+
+void CollisionGrid::rebuild(BulletSoA const& bullets, std::size_t count) noexcept
+{
+  PROFILE_FUNCTION();
+
+  count = std::min(count, m_cellOfBullet.size());
+  std::size_t const cellCount = m_cellCursor.size();
+
+  // 计数: 统计每个格子的子弹数, 先存在 m_cellStart[cell + 1] 中
+  std::fill(m_cellStart.begin(), m_cellStart.end(), 0u);
+  for (std::size_t i = 0; i < count; ++i) {
+    int const cx = cellX(fromSimScalar(bullets.x[i]));
+    int const cy = cellY(fromSimScalar(bullets.y[i]));
+    std::uint32_t const cell = static_cast<std::uint32_t>(cy * m_columns + cx);
+    m_cellOfBullet[i] = cell;
+    ++m_cellStart[cell + 1];
+  }
+
+  // 前缀和: 得到每个格子在排序数组中的起点
+  for (std::size_t c = 0; c < cellCount; ++c) {
+    m_cellStart[c + 1] += m_cellStart[c];
+  }
+  std::copy(m_cellStart.begin(), m_cellStart.end() - 1, m_cellCursor.begin());
+
+  // 散射: 按格子顺序写入排序数组, 同时拷贝查询需要的坐标, 半径按样式下标查表
+  BulletTypeTable const& table = *m_typeTable;
+  m_maxRadius = table.getMaxRadius();
+  for (std::size_t i = 0; i < count; ++i) {
+    std::uint32_t const slot = m_cellCursor[m_cellOfBullet[i]]++;
+    std::uint32_t const style = table.indexOf(bullets.type[i], bullets.color[i]);
+    m_sorted[slot] = { .x = fromSimScalar(bullets.x[i]),
+                       .y = fromSimScalar(bullets.y[i]),
+                       .radius = table.getHitRadius(style),
+                       .grazeRadius = table.getGrazeRadius(style),
+                       .index = static_cast<std::uint32_t>(i) };
+  }
+}
+
+template <typename F>
+void CollisionGrid::forEachRow(float x, float y, float reach, F&& fn) const noexcept
+{
+  int const cx0 = cellX(x - reach);
+  int const cx1 = cellX(x + reach);
+  int const cy0 = cellY(y - reach);
+  int const cy1 = cellY(y + reach);
+
+  // 同一行中相邻格子在排序数组中是连续的, 每行只需一段区间
+  for (int cy = cy0; cy <= cy1; ++cy) {
+    std::size_t const rowBase = static_cast<std::size_t>(cy) * m_columns;
+    fn(m_cellStart[rowBase + cx0], m_cellStart[rowBase + cx1 + 1]);
+  }
+}
+
+std::size_t CollisionGrid::queryCircle(float x,
+                                       float y,
+                                       float radius,
+                                       std::uint32_t* out,
+                                       std::size_t maxOut) const noexcept
+{
+  std::size_t found = 0;
+  forEachRow(x, y, radius + m_maxRadius, [&](std::uint32_t begin, std::uint32_t end) {
+    for (std::uint32_t k = begin; k < end && found < maxOut; ++k) {
+      SortedBullet const& b = m_sorted[k];
+      float const dx = b.x - x;
+      float const dy = b.y - y;
+      float const r = radius + b.radius;
+      if (dx * dx + dy * dy <= r * r) {
+        out[found++] = b.index;
+      }
+    }
+  });
+  return found;
+}
+
+std::size_t CollisionGrid::queryHit(PlayerHitbox const& player, std::uint32_t* out, std::size_t maxOut) const noexcept
+{
+  return queryCircle(player.x, player.y, player.hitRadius, out, maxOut);
+}
+
+std::size_t CollisionGrid::queryGraze(PlayerHitbox const& player, std::uint32_t* out, std::size_t maxOut) const noexcept
+{
+  std::size_t found = 0;
+  forEachRow(player.x, player.y, player.grazeRadius + m_maxRadius, [&](std::uint32_t begin, std::uint32_t end) {
+    for (std::uint32_t k = begin; k < end && found < maxOut; ++k) {
+      SortedBullet const& b = m_sorted[k];
+      float const dx = b.x - player.x;
+      float const dy = b.y - player.y;
+      float const distSq = dx * dx + dy * dy;
+      float const grazeR = player.grazeRadius + b.grazeRadius;
+      float const hitR = player.hitRadius + b.radius;
+      if (distSq <= grazeR * grazeR && distSq > hitR * hitR) {
+        out[found++] = b.index;
+      }
+    }
+  });
+  return found;
+}
+} // namespace Game
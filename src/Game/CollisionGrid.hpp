@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Game/BulletKernel.hpp"
+#include "Game/BulletSoA.hpp"
+#include "Game/BulletTypeTable.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Game {
+// 自机判定: 被弹判定圆与擦弹判定圆同心
+struct PlayerHitbox
+{
+  float x;
+  float y;
+  float hitRadius;   // 被弹判定半径
+  float grazeRadius; // 擦弹判定半径, 应大于 hitRadius
+};
+
+// 均匀网格粗筛 (broadphase): 每帧由有效子弹重建, 查询时只检查查询圆覆盖到的格子
+// 重建是一次计数排序, 所有缓冲区在 init 时分配, 之后每帧不再分配内存
+class CollisionGrid
+{
+public:
+  CollisionGrid() = default;
+  ~CollisionGrid() = default;
+
+  CollisionGrid(CollisionGrid const&) = delete;
+  CollisionGrid& operator=(CollisionGrid const&) = delete;
+
+  // 网格覆盖 area 区域, 格子边长 cellSize (像素), 最多容纳 capacity 颗子弹
+  // 区域外的子弹会被归入最近的边缘格子, 不会丢失
+  void init(BulletBounds const& area, float cellSize, std::size_t capacity);
+
+  // 设置子弹的判定 / 擦弹半径来源 (不管理生命周期), 未设置时使用只有默认样式的表
+  // 重建网格时按 (type, color) 查表, 表的内容改变后需等下一次 rebuild 才生效
+  void setTypeTable(BulletTypeTable const* table) noexcept;
+
+  // 用前 count 颗有效子弹重建网格, 每帧在子弹更新后调用
+  void rebuild(BulletSoA const& bullets, std::size_t count) noexcept;
+
+  // 查询判定圆与 (x, y, radius) 相交的子弹, 把其在有效子弹数组中的下标写入 out (最多 maxOut 个), 返回写入个数
+  std::size_t queryCircle(float x, float y, float radius, std::uint32_t* out, std::size_t maxOut) const noexcept;
+
+  // 被弹查询: 判定圆与自机被弹判定圆相交的子弹
+  std::size_t queryHit(PlayerHitbox const& player, std::uint32_t* out, std::size_t maxOut) const noexcept;
+  // 擦弹查询: 子弹的擦弹圆与自机擦弹圆相交, 但子弹的判定圆尚未与自机被弹判定圆相交
+  std::size_t queryGraze(PlayerHitbox const& player, std::uint32_t* out, std::size_t maxOut) const noexcept;
+
+private:
+  // 对覆盖 (x, y) 周围 reach 范围的每一行格子, 以该行在排序数组中的连续区间 [begin, end) 调用 fn
+  template <typename F>
+  void forEachRow(float x, float y, float reach, F&& fn) const noexcept;
+
+  int cellX(float x) const noexcept;
+  int cellY(float y) const noexcept;
+
+private:
+  BulletBounds m_area{};
+  float m_invCellSize = 0.0f;
+  int m_columns = 0;
+  int m_rows = 0;
+
+  BulletTypeTable const* m_typeTable = nullptr;
+  float m_maxRadius = 0.0f; // 上一次重建时表中最大的判定 / 擦弹半径, 查询时据此扩大检查范围
+
+  std::vector<std::uint32_t> m_cellStart;    // 每个格子在排序数组中的起点, 长度为格子数 + 1
+  std::vector<std::uint32_t> m_cellCursor;   // 计数排序散射时的写入游标
+  std::vector<std::uint32_t> m_cellOfBullet; // 每颗子弹所在的格子
+
+  // 按格子排序后的子弹数据, 查询时按行连续访问
+  // 散射的写入位置是随机的, 一颗子弹的全部字段放在一起, 每颗只触及一条缓存行 (分成多个数组时每个数组各触及一条)
+  struct SortedBullet
+  {
+    float x;
+    float y;
+    float radius;
+    float grazeRadius;
+    std::uint32_t index; // 在有效子弹数组中的下标
+  };
+  std::vector<SortedBullet> m_sorted;
+};
+} // namespace Game
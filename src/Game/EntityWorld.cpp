@@ -0,0 +1,337 @@
+#include "EntityWorld.hpp"
+#include "Core/Logger.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <mutex>
+
+namespace Game {
+
+namespace {
+std::mutex registryMutex;
+
+// 组件注册表, 通常在第一次使用某种组件时 (componentIdOf 的静态初始化) 追加
+std::vector<ComponentInfo>& componentRegistry()
+{
+  static std::vector<ComponentInfo> registry = [] {
+    std::vector<ComponentInfo> infos;
+    infos.reserve(MaxComponentTypes); // 之后不再扩容, getComponentInfo 返回的引用一直有效
+    return infos;
+  }();
+  return registry;
+}
+
+constexpr std::uint8_t noColumn = 0xFF;
+
+constexpr std::size_t alignUp(std::size_t value, std::size_t alignment) noexcept
+{
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+ComponentId Detail::registerComponentType(ComponentInfo const& info)
+{
+  std::lock_guard lock(registryMutex);
+  std::vector<ComponentInfo>& registry = componentRegistry();
+  if (registry.size() >= MaxComponentTypes) {
+    LOG_ERROR("Too many component types (max {}).", MaxComponentTypes);
+    throw std::runtime_error("Too many component types.");
+  }
+  registry.push_back(info);
+  return static_cast<ComponentId>(registry.size() - 1);
+}
+
+ComponentInfo const& getComponentInfo(ComponentId id) noexcept
+{
+  return componentRegistry()[id];
+}
+
+void EntityCommandBuffer::appendData(void const* data, std::size_t size)
+{
+  std::size_t const offset = m_data.size();
+  m_data.resize(offset + size);
+  std::memcpy(m_data.data() + offset, data, size);
+}
+
+void EntityCommandBuffer::destroy(Entity entity)
+{
+  m_commands.push_back({ .op = Op::Destroy, .value = 0, .entity = entity, .dataOffset = 0 });
+}
+
+void EntityCommandBuffer::clear() noexcept
+{
+  m_commands.clear();
+  m_data.clear();
+}
+
+EntityWorld::EntityWorld()
+  : m_commands(*this)
+{
+  findArchetype(0); // 空原型, 下标为 0
+}
+
+void EntityWorld::reserve(std::size_t entityCount)
+{
+  m_records.reserve(entityCount);
+  m_freeIds.reserve(entityCount);
+}
+
+Entity EntityWorld::reserveEntity()
+{
+  if (m_freeIds.empty()) {
+    m_records.emplace_back();
+    return { static_cast<std::uint32_t>(m_records.size() - 1), 0 };
+  }
+  std::uint32_t const index = m_freeIds.back();
+  m_freeIds.pop_back();
+  return { index, m_records[index].generation };
+}
+
+void EntityWorld::releaseEntity(Entity entity) noexcept
+{
+  EntityRecord& record = m_records[entity.index];
+  record.archetype = PENDING;
+  ++record.generation;
+  m_freeIds.push_back(entity.index);
+}
+
+std::uint32_t EntityWorld::findArchetype(ComponentMask mask)
+{
+  if (auto const it = m_archetypeIndex.find(mask); it != m_archetypeIndex.end()) {
+    return it->second;
+  }
+
+  Archetype archetype;
+  archetype.mask = mask;
+  archetype.column.fill(noColumn);
+  archetype.edges.fill(NO_EDGE);
+
+  // 列 0 为实体句柄, 之后按组件编号升序排列
+  archetype.sizes.push_back(sizeof(Entity));
+  for (ComponentMask bits = mask; bits != 0; bits &= bits - 1) {
+    ComponentId const id = static_cast<ComponentId>(std::countr_zero(bits));
+    archetype.column[id] = static_cast<std::uint8_t>(archetype.sizes.size());
+    archetype.components.push_back(id);
+    archetype.sizes.push_back(getComponentInfo(id).size);
+  }
+
+  // 每列起点按 COLUMN_ALIGNMENT 对齐, 对齐最多浪费 (列数 * COLUMN_ALIGNMENT) 字节, 先扣除再按行大小求容量
+  std::size_t rowSize = 0;
+  for (std::uint32_t const size : archetype.sizes) {
+    rowSize += size;
+  }
+  std::size_t const padding = archetype.sizes.size() * COLUMN_ALIGNMENT;
+  std::size_t const capacity = CHUNK_SIZE > padding ? (CHUNK_SIZE - padding) / rowSize : 0;
+  if (capacity == 0) {
+    LOG_ERROR("Archetype row of {} bytes does not fit in a {} byte chunk.", rowSize, CHUNK_SIZE);
+    throw std::runtime_error("Archetype does not fit in a chunk.");
+  }
+  archetype.capacity = static_cast<std::uint32_t>(capacity);
+
+  std::size_t offset = 0;
+  for (std::uint32_t const size : archetype.sizes) {
+    offset = alignUp(offset, COLUMN_ALIGNMENT);
+    archetype.offsets.push_back(static_cast<std::uint32_t>(offset));
+    offset += size * capacity;
+  }
+
+  std::uint32_t const index = static_cast<std::uint32_t>(m_archetypes.size());
+  m_archetypes.push_back(std::move(archetype));
+  m_archetypeIndex.emplace(mask, index);
+  return index;
+}
+
+std::uint32_t EntityWorld::toggleComponent(std::uint32_t archetype, ComponentId id)
+{
+  std::uint32_t target = m_archetypes[archetype].edges[id];
+  if (target == NO_EDGE) {
+    target = findArchetype(m_archetypes[archetype].mask ^ (ComponentMask{ 1 } << id));
+    m_archetypes[archetype].edges[id] = target; // findArchetype 可能使引用失效, 重新取下标
+  }
+  return target;
+}
+
+void EntityWorld::placeEntity(Entity entity, std::uint32_t archetypeIndex)
+{
+  Archetype& archetype = m_archetypes[archetypeIndex];
+  std::size_t const row = archetype.entityCount;
+  std::size_t const chunk = row / archetype.capacity;
+  std::size_t const slot = row % archetype.capacity;
+  if (chunk == archetype.chunks.size()) {
+    archetype.chunks.emplace_back(CHUNK_SIZE);
+  }
+  ++archetype.entityCount;
+  ++m_entityCount;
+
+  std::memcpy(archetype.chunks[chunk].data() + slot * sizeof(Entity), &entity, sizeof(Entity));
+  m_records[entity.index] = { .archetype = archetypeIndex,
+                              .chunk = static_cast<std::uint32_t>(chunk),
+                              .slot = static_cast<std::uint32_t>(slot),
+                              .generation = entity.generation };
+}
+
+void EntityWorld::removeRow(std::uint32_t archetypeIndex, std::uint32_t chunk, std::uint32_t slot) noexcept
+{
+  Archetype& archetype = m_archetypes[archetypeIndex];
+  std::size_t const last = archetype.entityCount - 1;
+  std::size_t const lastChunk = last / archetype.capacity;
+  std::size_t const lastSlot = last % archetype.capacity;
+  --archetype.entityCount;
+  --m_entityCount;
+  if (lastChunk == chunk && lastSlot == slot) {
+    return;
+  }
+
+  // 用原型的最后一行填补空位, 保持所有块紧密排列
+  std::byte* const dst = archetype.chunks[chunk].data();
+  std::byte const* const src = archetype.chunks[lastChunk].data();
+  for (std::size_t column = 0; column < archetype.sizes.size(); ++column) {
+    std::size_t const size = archetype.sizes[column];
+    std::size_t const offset = archetype.offsets[column];
+    std::memcpy(dst + offset + slot * size, src + offset + lastSlot * size, size);
+  }
+
+  Entity moved;
+  std::memcpy(&moved, dst + slot * sizeof(Entity), sizeof(Entity));
+  m_records[moved.index].chunk = chunk;
+  m_records[moved.index].slot = slot;
+}
+
+void EntityWorld::moveEntity(Entity entity, std::uint32_t target)
+{
+  EntityRecord const source = m_records[entity.index];
+  placeEntity(entity, target);
+  EntityRecord const& placed = m_records[entity.index];
+
+  Archetype const& from = m_archetypes[source.archetype];
+  Archetype& to = m_archetypes[target];
+  std::byte const* const src = from.chunks[source.chunk].data();
+  std::byte* const dst = to.chunks[placed.chunk].data();
+  for (ComponentId const id : to.components) {
+    std::uint8_t const fromColumn = from.column[id];
+    if (fromColumn == noColumn) {
+      continue;
+    }
+    std::uint8_t const toColumn = to.column[id];
+    std::size_t const size = to.sizes[toColumn];
+    std::memcpy(dst + to.offsets[toColumn] + placed.slot * size,
+                src + from.offsets[fromColumn] + source.slot * size,
+                size);
+  }
+
+  // 搬走后删除旧行, placeEntity 与 removeRow 对实体总数的增减相互抵消
+  removeRow(source.archetype, source.chunk, source.slot);
+}
+
+std::byte* EntityWorld::componentData(Entity entity, ComponentId id) noexcept
+{
+  if (!isAlive(entity)) {
+    return nullptr;
+  }
+  EntityRecord const& record = m_records[entity.index];
+  Archetype& archetype = m_archetypes[record.archetype];
+  std::uint8_t const column = archetype.column[id];
+  if (column == noColumn) {
+    return nullptr;
+  }
+  return archetype.chunks[record.chunk].data() + archetype.offsets[column] + record.slot * archetype.sizes[column];
+}
+
+bool EntityWorld::destroy(Entity entity)
+{
+  if (entity.index >= m_records.size() || m_records[entity.index].generation != entity.generation) {
+    return false;
+  }
+  EntityRecord const record = m_records[entity.index];
+  if (record.archetype != PENDING) {
+    removeRow(record.archetype, record.chunk, record.slot);
+  }
+  // 命令缓冲区中尚未创建的实体同样可以销毁, 之后回放到它的创建命令时因代数不匹配而跳过
+  releaseEntity(entity);
+  return true;
+}
+
+bool EntityWorld::addComponent(Entity entity, ComponentId id, void const* data)
+{
+  if (!isAlive(entity)) {
+    return false;
+  }
+  std::uint32_t const archetype = m_records[entity.index].archetype;
+  if ((m_archetypes[archetype].mask & (ComponentMask{ 1 } << id)) == 0) {
+    moveEntity(entity, toggleComponent(archetype, id));
+  }
+  std::memcpy(componentData(entity, id), data, getComponentInfo(id).size);
+  return true;
+}
+
+bool EntityWorld::removeComponent(Entity entity, ComponentId id)
+{
+  if (!isAlive(entity)) {
+    return false;
+  }
+  std::uint32_t const archetype = m_records[entity.index].archetype;
+  if ((m_archetypes[archetype].mask & (ComponentMask{ 1 } << id)) != 0) {
+    moveEntity(entity, toggleComponent(archetype, id));
+  }
+  return true;
+}
+
+void EntityWorld::createFromCommand(Entity entity, std::uint32_t componentCount, std::byte const* data)
+{
+  // 先读出全部组件编号确定原型, 再一次写入各组件
+  ComponentMask mask = 0;
+  std::byte const* cursor = data;
+  for (std::uint32_t i = 0; i < componentCount; ++i) {
+    ComponentId id;
+    std::memcpy(&id, cursor, sizeof(id));
+    mask |= ComponentMask{ 1 } << id;
+    cursor += sizeof(id) + getComponentInfo(id).size;
+  }
+
+  placeEntity(entity, findArchetype(mask));
+  cursor = data;
+  for (std::uint32_t i = 0; i < componentCount; ++i) {
+    ComponentId id;
+    std::memcpy(&id, cursor, sizeof(id));
+    std::size_t const size = getComponentInfo(id).size;
+    std::memcpy(componentData(entity, id), cursor + sizeof(id), size);
+    cursor += sizeof(id) + size;
+  }
+}
+
+void EntityWorld::playback(EntityCommandBuffer& buffer)
+{
+  using Op = EntityCommandBuffer::Op;
+  for (EntityCommandBuffer::Command const& command : buffer.m_commands) {
+    Entity const entity = command.entity;
+    std::byte const* const data = buffer.m_data.data() + command.dataOffset;
+    switch (command.op) {
+      case Op::Create:
+        // 创建前实体已被销毁 (代数已变) 时跳过
+        if (entity.index < m_records.size() && m_records[entity.index].generation == entity.generation) {
+          createFromCommand(entity, command.value, data);
+        }
+        break;
+      case Op::Destroy:
+        destroy(entity);
+        break;
+      case Op::Add:
+        addComponent(entity, command.value, data);
+        break;
+      case Op::Remove:
+        removeComponent(entity, command.value);
+        break;
+    }
+  }
+  buffer.clear();
+}
+
+std::size_t EntityWorld::getChunkCount() const noexcept
+{
+  std::size_t count = 0;
+  for (Archetype const& archetype : m_archetypes) {
+    count += archetype.usedChunks();
+  }
+  return count;
+}
+} // namespace Game
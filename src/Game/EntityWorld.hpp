@@ -0,0 +1,343 @@
+#pragma once
+
+#include "Core/AlignedAllocator.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Game {
+// 实体句柄: 实体表槽位 + 代数, 与 BulletHandle 相同, 实体被销毁后旧句柄因代数不匹配而失效
+struct Entity
+{
+  static constexpr std::uint32_t INVALID_INDEX = 0xFFFF'FFFF;
+
+  std::uint32_t index = INVALID_INDEX;
+  std::uint32_t generation = 0;
+
+  bool isNull() const noexcept { return index == INVALID_INDEX; }
+
+  friend bool operator==(Entity const&, Entity const&) = default;
+};
+
+// 组件类型编号, 按第一次使用的顺序分配; 一个实体的组件集合用 64 位掩码表示
+using ComponentId = std::uint32_t;
+using ComponentMask = std::uint64_t;
+inline constexpr std::size_t MaxComponentTypes = 64;
+
+struct ComponentInfo
+{
+  std::uint32_t size;
+  std::uint32_t alignment;
+};
+
+namespace Detail {
+// 注册一种组件类型, 超过 MaxComponentTypes 种时抛出 std::runtime_error
+ComponentId registerComponentType(ComponentInfo const& info);
+} // namespace Detail
+
+ComponentInfo const& getComponentInfo(ComponentId id) noexcept;
+
+// 组件类型 T 的编号; 组件按字节搬移, 必须可平凡复制
+template <typename T>
+ComponentId componentIdOf()
+{
+  if constexpr (!std::is_same_v<T, std::remove_cv_t<T>>) {
+    return componentIdOf<std::remove_cv_t<T>>(); // const T 与 T 是同一种组件
+  } else {
+    static_assert(std::is_trivially_copyable_v<T>, "Components must be trivially copyable.");
+    static_assert(alignof(T) <= 64, "Component alignment must not exceed the chunk column alignment.");
+    static ComponentId const id = Detail::registerComponentType({ sizeof(T), alignof(T) });
+    return id;
+  }
+}
+
+template <typename... Cs>
+ComponentMask componentMaskOf()
+{
+  return (ComponentMask{ 0 } | ... | (ComponentMask{ 1 } << componentIdOf<Cs>()));
+}
+
+class EntityWorld;
+
+// 结构性修改 (创建 / 销毁实体, 增删组件) 的命令缓冲区
+// 遍历查询时不能直接修改实体布局, 改为记录到命令缓冲区, 在帧末由 EntityWorld::playback 按记录顺序一次性执行
+// 组件数据按字节追加到一块连续缓冲区, 清空后容量保留, 稳定运行时不再分配内存
+// 记录不是线程安全的: 并行的系统应各用一个缓冲区, 再按固定顺序回放以保证结果确定
+class EntityCommandBuffer
+{
+public:
+  explicit EntityCommandBuffer(EntityWorld& world) noexcept
+    : m_world(world)
+  {
+  }
+
+  EntityCommandBuffer(EntityCommandBuffer const&) = delete;
+  EntityCommandBuffer& operator=(EntityCommandBuffer const&) = delete;
+
+  // 延迟创建: 立即返回句柄 (回放前 isAlive 为 false), 回放时一次放入最终的原型, 不经过中间原型
+  template <typename... Cs>
+  Entity create(Cs const&... components);
+  void destroy(Entity entity);
+  // 延迟添加 (已有该组件时覆盖其值) / 删除组件; 回放时实体已被销毁则忽略
+  template <typename T>
+  void add(Entity entity, T const& value);
+  template <typename T>
+  void remove(Entity entity);
+
+  bool isEmpty() const noexcept { return m_commands.empty(); }
+  std::size_t size() const noexcept { return m_commands.size(); }
+  void clear() noexcept;
+
+private:
+  friend class EntityWorld;
+
+  enum class Op : std::uint8_t
+  {
+    Create,  // value 为组件个数, 数据为 (编号, 字节) 序列
+    Destroy, //
+    Add,     // value 为组件编号, 数据为组件的字节
+    Remove,  // value 为组件编号
+  };
+
+  struct Command
+  {
+    Op op;
+    std::uint32_t value;
+    Entity entity;
+    std::uint32_t dataOffset;
+  };
+
+  void appendData(void const* data, std::size_t size);
+
+private:
+  EntityWorld& m_world;
+  std::vector<Command> m_commands;
+  std::vector<std::byte> m_data;
+};
+
+// 原型 (archetype) 式 ECS 存储
+// 组件集合相同的实体属于同一个原型, 原型的实体存放在若干 16 KB 的块 (chunk) 中
+// 块内按 SoA 布局: 先是实体句柄数组, 然后每种组件一个 64 字节对齐的连续数组, 与弹幕池相同可按 SIMD 宽度整批处理
+// 原型内的实体始终紧密排列: 除最后一块外每块都是满的, 删除时用最后一个实体填补空位
+// 查询按组件掩码匹配原型, 再线性遍历匹配原型的每一块, 回调直接拿到各组件数组的指针
+//
+// 遍历期间不能做结构性修改 (会搬移实体), 应使用命令缓冲区; 块在实体减少后保留, 不会反复分配释放
+// 遍历顺序只取决于原型的创建顺序和实体在块中的位置, 相同的操作序列得到相同的结果
+class EntityWorld
+{
+public:
+  static constexpr std::size_t CHUNK_SIZE = 16 * 1024;
+  static constexpr std::size_t COLUMN_ALIGNMENT = 64;
+
+public:
+  EntityWorld();
+  ~EntityWorld() = default;
+
+  EntityWorld(EntityWorld const&) = delete;
+  EntityWorld& operator=(EntityWorld const&) = delete;
+
+  // 预留实体表, 避免运行时扩容
+  void reserve(std::size_t entityCount);
+
+  // 立即创建实体 (不能在遍历中调用)
+  template <typename... Cs>
+  Entity create(Cs const&... components);
+  // 立即销毁实体, 句柄已失效时返回 false
+  bool destroy(Entity entity);
+  // 添加组件, 已有时覆盖其值; 组件集合改变时实体被搬到对应的原型
+  template <typename T>
+  bool add(Entity entity, T const& value)
+  {
+    return addComponent(entity, componentIdOf<T>(), &value);
+  }
+  template <typename T>
+  bool remove(Entity entity)
+  {
+    return removeComponent(entity, componentIdOf<T>());
+  }
+
+  // 组件指针, 实体不存在或没有该组件时返回 nullptr; 指针只在下一次结构性修改前有效
+  template <typename T>
+  T* get(Entity entity) noexcept
+  {
+    return reinterpret_cast<T*>(componentData(entity, componentIdOf<T>()));
+  }
+  template <typename T>
+  T const* get(Entity entity) const noexcept
+  {
+    return reinterpret_cast<T const*>(const_cast<EntityWorld*>(this)->componentData(entity, componentIdOf<T>()));
+  }
+  template <typename T>
+  bool has(Entity entity) const noexcept
+  {
+    return get<T>(entity) != nullptr;
+  }
+  bool isAlive(Entity entity) const noexcept
+  {
+    return entity.index < m_records.size() && m_records[entity.index].generation == entity.generation &&
+           m_records[entity.index].archetype != PENDING;
+  }
+
+  // 对每个同时拥有 Cs... 的块调用 fn(count, entities, Cs*... columns), 各数组的前 count 项有效
+  // Cs 可以带 const, 表示只读访问
+  template <typename... Cs, typename F>
+  void forEachChunk(F&& fn);
+  // 逐实体调用 fn(entity, Cs&... components), 内部仍按块遍历
+  template <typename... Cs, typename F>
+  void forEach(F&& fn);
+
+  // 默认的命令缓冲区, flush 时回放并清空, 通常在每帧末尾调用
+  EntityCommandBuffer& getCommandBuffer() noexcept { return m_commands; }
+  void flush() { playback(m_commands); }
+  // 按记录顺序执行 buffer 中的命令, 然后清空它
+  void playback(EntityCommandBuffer& buffer);
+
+  std::size_t getEntityCount() const noexcept { return m_entityCount; }
+  std::size_t getArchetypeCount() const noexcept { return m_archetypes.size(); }
+  std::size_t getChunkCount() const noexcept; // 正在使用的块数
+
+private:
+  friend class EntityCommandBuffer;
+
+  static constexpr std::uint32_t PENDING = 0xFFFF'FFFF; // 已分配句柄但尚未创建 (命令缓冲区中) 或已销毁
+  static constexpr std::uint32_t NO_EDGE = 0xFFFF'FFFF;
+
+  template <typename T>
+  using Array = std::vector<T, Core::AlignedAllocator<T, 64>>;
+
+  struct Archetype
+  {
+    ComponentMask mask = 0;
+    std::vector<ComponentId> components;                // 升序
+    std::array<std::uint8_t, MaxComponentTypes> column; // 组件编号 -> 列号, 0xFF 表示没有该组件
+    std::array<std::uint32_t, MaxComponentTypes> edges; // 增删组件 i 后到达的原型, 首次使用时建立
+    std::vector<std::uint32_t> offsets;                 // 各列在块中的字节偏移 (实体句柄数组为第 0 列)
+    std::vector<std::uint32_t> sizes;                   // 各列的元素大小
+    std::uint32_t capacity = 0;                         // 每块的实体数
+    std::size_t entityCount = 0;
+    std::vector<Array<std::byte>> chunks; // 每块 CHUNK_SIZE 字节, 前 usedChunks() 块在使用中
+
+    std::size_t usedChunks() const noexcept { return (entityCount + capacity - 1) / capacity; }
+    std::size_t countInChunk(std::size_t chunk) const noexcept
+    {
+      std::size_t const begin = chunk * capacity;
+      return entityCount - begin < capacity ? entityCount - begin : capacity;
+    }
+  };
+
+  struct EntityRecord
+  {
+    std::uint32_t archetype = PENDING;
+    std::uint32_t chunk = 0;
+    std::uint32_t slot = 0;
+    std::uint32_t generation = 0;
+  };
+
+  Entity reserveEntity();
+  void releaseEntity(Entity entity) noexcept;
+  std::uint32_t findArchetype(ComponentMask mask);
+  std::uint32_t toggleComponent(std::uint32_t archetype, ComponentId id);
+  // 在原型末尾为实体分配一行并写入句柄, 组件内容未初始化
+  void placeEntity(Entity entity, std::uint32_t archetype);
+  // 删除原型中的一行, 用最后一行填补
+  void removeRow(std::uint32_t archetype, std::uint32_t chunk, std::uint32_t slot) noexcept;
+  // 把实体搬到另一个原型, 复制两者共有的组件
+  void moveEntity(Entity entity, std::uint32_t target);
+  std::byte* componentData(Entity entity, ComponentId id) noexcept;
+  bool addComponent(Entity entity, ComponentId id, void const* data);
+  bool removeComponent(Entity entity, ComponentId id);
+  void createFromCommand(Entity entity, std::uint32_t componentCount, std::byte const* data);
+
+private:
+  std::vector<Archetype> m_archetypes; // 下标 0 为没有组件的空原型
+  std::unordered_map<ComponentMask, std::uint32_t> m_archetypeIndex;
+  std::vector<EntityRecord> m_records; // 实体表: 槽位 -> 所在原型与位置
+  std::vector<std::uint32_t> m_freeIds;
+  std::size_t m_entityCount = 0;
+  EntityCommandBuffer m_commands;
+};
+
+template <typename... Cs>
+Entity EntityWorld::create(Cs const&... components)
+{
+  Entity const entity = reserveEntity();
+  placeEntity(entity, findArchetype(componentMaskOf<Cs...>()));
+  (std::memcpy(componentData(entity, componentIdOf<Cs>()), &components, sizeof(Cs)), ...);
+  return entity;
+}
+
+template <typename... Cs, typename F>
+void EntityWorld::forEachChunk(F&& fn)
+{
+  ComponentMask const mask = componentMaskOf<Cs...>();
+  std::array<ComponentId, sizeof...(Cs)> const ids{ componentIdOf<Cs>()... };
+
+  for (Archetype& archetype : m_archetypes) {
+    if ((archetype.mask & mask) != mask || archetype.entityCount == 0) {
+      continue;
+    }
+    std::array<std::uint32_t, sizeof...(Cs)> offsets{};
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+      offsets[i] = archetype.offsets[archetype.column[ids[i]]];
+    }
+
+    std::size_t const chunkCount = archetype.usedChunks();
+    for (std::size_t c = 0; c < chunkCount; ++c) {
+      std::byte* const base = archetype.chunks[c].data();
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        fn(archetype.countInChunk(c),
+           reinterpret_cast<Entity const*>(base),
+           reinterpret_cast<Cs*>(base + offsets[I])...);
+      }(std::index_sequence_for<Cs...>{});
+    }
+  }
+}
+
+template <typename... Cs, typename F>
+void EntityWorld::forEach(F&& fn)
+{
+  forEachChunk<Cs...>([&fn](std::size_t count, Entity const* entities, Cs*... columns) {
+    for (std::size_t i = 0; i < count; ++i) {
+      fn(entities[i], columns[i]...);
+    }
+  });
+}
+
+template <typename... Cs>
+Entity EntityCommandBuffer::create(Cs const&... components)
+{
+  Entity const entity = m_world.reserveEntity();
+  m_commands.push_back({ .op = Op::Create,
+                         .value = sizeof...(Cs),
+                         .entity = entity,
+                         .dataOffset = static_cast<std::uint32_t>(m_data.size()) });
+  auto const append = [this](ComponentId id, void const* data, std::size_t size) {
+    appendData(&id, sizeof(id));
+    appendData(data, size);
+  };
+  (append(componentIdOf<Cs>(), &components, sizeof(Cs)), ...);
+  return entity;
+}
+
+template <typename T>
+void EntityCommandBuffer::add(Entity entity, T const& value)
+{
+  m_commands.push_back({ .op = Op::Add,
+                         .value = componentIdOf<T>(),
+                         .entity = entity,
+                         .dataOffset = static_cast<std::uint32_t>(m_data.size()) });
+  appendData(&value, sizeof(T));
+}
+
+template <typename T>
+void EntityCommandBuffer::remove(Entity entity)
+{
+  m_commands.push_back({ .op = Op::Remove, .value = componentIdOf<T>(), .entity = entity, .dataOffset = 0 });
+}
+} // namespace Game
@@ -0,0 +1,85 @@
+#include "FramePacket.hpp"
+#include "Game/Stage.hpp"
+
+#include <algorithm>
+
+namespace Game {
+
+void FramePacket::reserve(Stage const& stage)
+{
+  std::size_t const capacity = stage.getConfig().bulletCapacity;
+  for (Array<float>* array : { &x, &y, &angle, &prevX, &prevY, &prevAngle, &itemX, &itemY }) {
+    array->resize(capacity);
+  }
+  type.resize(capacity);
+  color.resize(capacity);
+  id.resize(capacity);
+  generation.resize(capacity);
+
+  lasers.reserve(Stage::LASER_CAPACITY);
+  laserX.resize(Stage::LASER_CAPACITY * Stage::LASER_MAX_NODES);
+  laserY.resize(Stage::LASER_CAPACITY * Stage::LASER_MAX_NODES);
+}
+
+void FramePacketBuilder::init(Stage const& stage)
+{
+  m_indexOfId.assign(stage.getConfig().bulletCapacity, 0);
+}
+
+void FramePacketBuilder::build(Stage const& stage, FramePacket const& previous, FramePacket& out)
+{
+  out.frame = stage.getFrame();
+  out.playerX = stage.getPlayer().x;
+  out.playerY = stage.getPlayer().y;
+
+  // 子弹: 内存池中的状态可能是定点数, 换算为 float
+  BulletManager const& bulletManager = stage.getBulletManager();
+  BulletSoA const& bullets = bulletManager.getActiveBullets();
+  std::size_t const count = bulletManager.getActiveCount();
+  for (std::size_t i = 0; i < count; ++i) {
+    out.x[i] = fromSimScalar(bullets.x[i]);
+    out.y[i] = fromSimScalar(bullets.y[i]);
+    out.angle[i] = fromSimAngle(bullets.angle[i]);
+  }
+  std::copy_n(bullets.type.data(), count, out.type.data());
+  std::copy_n(bullets.color.data(), count, out.color.data());
+  for (std::size_t i = 0; i < count; ++i) {
+    BulletHandle const handle = bulletManager.getHandle(i);
+    out.id[i] = handle.index;
+    out.generation[i] = handle.generation;
+  }
+  out.bulletCount = count;
+
+  // 按槽位找到上一份数据中的同一颗子弹; 槽位表中过期的下标由 id 排除,
+  // 槽位在两次发布之间被回收又分配给新子弹时代数不同, 新子弹不插值
+  for (std::size_t i = 0; i < count; ++i) {
+    std::uint32_t const slot = out.id[i];
+    std::uint32_t const prev = m_indexOfId[slot];
+    bool const matched =
+      prev < previous.bulletCount && previous.id[prev] == slot && previous.generation[prev] == out.generation[i];
+    out.prevX[i] = matched ? previous.x[prev] : out.x[i];
+    out.prevY[i] = matched ? previous.y[prev] : out.y[i];
+    out.prevAngle[i] = matched ? previous.angle[prev] : out.angle[i];
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    m_indexOfId[out.id[i]] = static_cast<std::uint32_t>(i);
+  }
+
+  // 曲线激光: 节点依次拼接
+  LaserManager const& laserManager = stage.getLaserManager();
+  out.lasers.clear();
+  std::uint32_t nodes = 0;
+  for (std::size_t k = 0; k < laserManager.getLaserCount(); ++k) {
+    LaserView const laser = laserManager.getLaser(k);
+    std::copy_n(laser.x, laser.count, &out.laserX[nodes]);
+    std::copy_n(laser.y, laser.count, &out.laserY[nodes]);
+    out.lasers.push_back({ nodes, static_cast<std::uint32_t>(laser.count), laser.type, laser.color });
+    nodes += static_cast<std::uint32_t>(laser.count);
+  }
+
+  ItemManager const& itemManager = stage.getItemManager();
+  out.itemCount = itemManager.getActiveCount();
+  std::copy_n(itemManager.getX(), out.itemCount, out.itemX.data());
+  std::copy_n(itemManager.getY(), out.itemCount, out.itemY.data());
+}
+} // namespace Game
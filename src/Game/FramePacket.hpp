@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Core/AlignedAllocator.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <vector>
+
+namespace Game {
+class Stage;
+
+// 模拟线程每帧发布给渲染线程的一帧画面数据, 发布后不再修改
+// 只包含绘制需要的字段 (已换算为 float): 子弹的位置, 朝向与外观, 曲线激光的节点, 道具的位置
+// 子弹同时带有上一次发布时同一颗子弹的位置与朝向, 渲染时可以在两次模拟之间插值, 不需要同时持有两份数据
+// 数组在 reserve 时按容量分配一次, 之后每帧只写入前 count 项, 不分配内存
+struct FramePacket
+{
+  template <typename T>
+  using Array = std::vector<T, Core::AlignedAllocator<T, 64>>;
+
+  struct LaserRange
+  {
+    std::uint32_t first; // 节点在 laserX / laserY 中的起始下标
+    std::uint32_t count;
+    std::uint16_t type;
+    std::uint16_t color;
+  };
+
+  std::uint32_t frame = 0;          // 模拟的帧号 (Stage::getFrame)
+  std::int64_t publishCounter = 0;  // 发布时的 Core::Timer 计数值, 用于计算插值系数
+  float playerX = 0.0f;
+  float playerY = 0.0f;
+
+  std::size_t bulletCount = 0;
+  Array<float> x;
+  Array<float> y;
+  Array<float> angle;
+  Array<float> prevX; // 上一次发布时的状态; 新出现的子弹与当前状态相同
+  Array<float> prevY;
+  Array<float> prevAngle;
+  Array<std::uint16_t> type;
+  Array<std::uint16_t> color;
+  Array<std::uint32_t> id;         // BulletHandle::index, 用于与上一次发布的子弹对应
+  Array<std::uint32_t> generation; // BulletHandle::generation, 区分同一槽位被回收后分配给的新子弹
+
+  std::vector<LaserRange> lasers;
+  Array<float> laserX;
+  Array<float> laserY;
+
+  std::size_t itemCount = 0;
+  Array<float> itemX;
+  Array<float> itemY;
+
+  // 按 stage 的容量分配全部数组
+  void reserve(Stage const& stage);
+
+  // 第 i 颗子弹在上一次与本次模拟之间 alpha (0 ~ 1) 处的位置与朝向; alpha 为 1 时即本次的状态
+  // 朝向沿较短的一侧插值, 避免在 -pi / pi 处绕一整圈
+  void bulletAt(std::size_t i, float alpha, float& outX, float& outY, float& outAngle) const noexcept
+  {
+    outX = prevX[i] + (x[i] - prevX[i]) * alpha;
+    outY = prevY[i] + (y[i] - prevY[i]) * alpha;
+    float delta = angle[i] - prevAngle[i];
+    delta -= std::round(delta / (2.0f * std::numbers::pi_v<float>)) * (2.0f * std::numbers::pi_v<float>);
+    outAngle = prevAngle[i] + delta * alpha;
+  }
+};
+
+// 在模拟线程上由 Stage 生成 FramePacket, 并记录每个子弹槽位在上一份数据中的下标, 用于查找上一次的状态
+class FramePacketBuilder
+{
+public:
+  void init(Stage const& stage);
+
+  // 把 stage 的当前状态写入 out; previous 为上一次 build 写出的数据 (第一次调用时为空的一份)
+  void build(Stage const& stage, FramePacket const& previous, FramePacket& out);
+
+private:
+  std::vector<std::uint32_t> m_indexOfId; // 子弹槽位 -> 在上一次 build 写出的数据中的下标
+};
+} // namespace Game
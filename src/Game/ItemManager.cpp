@@ -0,0 +1,254 @@
+#include "ItemManager.hpp"
+#include "Core/BinaryStream.hpp"
+#include "Core/Logger.hpp"
+#include "Core/Profiler.hpp"
+#include "Core/Simd.hpp"
+#include "Game/BulletKernel.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace Game {
+
+namespace {
+// 一帧的道具参数, 由 update 预先算好平方等常量
+struct ItemStep
+{
+  float px;
+  float py;
+  float collectSq;
+  float attractSq;
+  std::uint32_t attractAll; // 0 或 0xFFFFFFFF
+  float bottom;
+};
+
+// 标量路径, 同时负责 SIMD 路径中不足一个向量宽度的尾部; 与 SIMD 路径的运算顺序相同, 结果逐位一致
+// 被回收的道具下标按升序写入 killList, 返回回收个数, 收取个数累加到 collected
+std::size_t updateScalar(float* x,
+                         float* y,
+                         float* vy,
+                         std::uint32_t* attracted,
+                         std::size_t begin,
+                         std::size_t end,
+                         ItemStep const& s,
+                         std::uint32_t* killList,
+                         std::size_t& collected) noexcept
+{
+  std::size_t killCount = 0;
+  for (std::size_t i = begin; i < end; ++i) {
+    float const dx = s.px - x[i];
+    float const dy = s.py - y[i];
+    float const distSq = dx * dx + dy * dy;
+    bool const isCollected = distSq <= s.collectSq;
+    attracted[i] |= (distSq <= s.attractSq ? 0xFFFF'FFFFu : 0u) | s.attractAll;
+
+    float const dist = std::sqrt(distSq);
+    float const scale = dist > ItemManager::ATTRACT_SPEED ? ItemManager::ATTRACT_SPEED / dist : 1.0f;
+    float const fallSpeed = std::min(vy[i] + ItemManager::GRAVITY, ItemManager::MAX_FALL_SPEED);
+    vy[i] = fallSpeed;
+    if (attracted[i] != 0) {
+      x[i] = x[i] + dx * scale;
+      y[i] = y[i] + dy * scale;
+    } else {
+      y[i] = y[i] + fallSpeed;
+    }
+
+    collected += isCollected ? 1 : 0;
+    if (isCollected || (attracted[i] == 0 && y[i] > s.bottom)) {
+      killList[killCount++] = static_cast<std::uint32_t>(i);
+    }
+  }
+  return killCount;
+}
+} // namespace
+
+void ItemManager::init(std::size_t capacity)
+{
+  forEachArray([capacity](auto& array) { array.resize(capacity); });
+  m_killList.resize(capacity);
+  m_activeCount = 0;
+  LOG_INFO("ItemManager initialized with capacity: {}", capacity);
+}
+
+std::size_t ItemManager::spawnBatch(float const* xs,
+                                    float const* ys,
+                                    std::size_t count,
+                                    ItemType type,
+                                    bool attracted) noexcept
+{
+  std::size_t const n = std::min(count, m_x.size() - m_activeCount);
+  m_overflowCount += count - n;
+
+  std::size_t const first = m_activeCount;
+  std::copy_n(xs, n, &m_x[first]);
+  std::copy_n(ys, n, &m_y[first]);
+  std::fill_n(&m_vy[first], n, INITIAL_VY);
+  std::fill_n(&m_attracted[first], n, attracted ? 0xFFFF'FFFFu : 0u);
+  std::fill_n(&m_type[first], n, static_cast<std::uint16_t>(type));
+  m_activeCount += n;
+  return n;
+}
+
+std::size_t ItemManager::update(ItemCollector const& collector, float bottom) noexcept
+{
+  PROFILE_FUNCTION();
+
+  m_lastFrameOverflow = m_overflowCount;
+  m_overflowCount = 0;
+
+  ItemStep const s{ .px = collector.x,
+                    .py = collector.y,
+                    .collectSq = COLLECT_RADIUS * COLLECT_RADIUS,
+                    .attractSq = ATTRACT_RADIUS * ATTRACT_RADIUS,
+                    .attractAll = collector.collectAll ? 0xFFFF'FFFFu : 0u,
+                    .bottom = bottom };
+
+  float* const x = m_x.data();
+  float* const y = m_y.data();
+  float* const vy = m_vy.data();
+  std::uint32_t* const attracted = m_attracted.data();
+  std::uint32_t* const killList = m_killList.data();
+  std::size_t const count = m_activeCount;
+
+  // 一遍完成移动与回收判定: SIMD 路径逐通道计算两种运动的结果, 再按吸引掩码混合, 循环内没有分支
+  std::size_t killCount = 0;
+  std::size_t collected = 0;
+  std::size_t i = 0;
+#if defined(TOUHOU_SIMD_AVX2)
+  __m256 const px = _mm256_set1_ps(s.px);
+  __m256 const py = _mm256_set1_ps(s.py);
+  __m256 const collectSq = _mm256_set1_ps(s.collectSq);
+  __m256 const attractSq = _mm256_set1_ps(s.attractSq);
+  __m256 const attractAll = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(s.attractAll)));
+  __m256 const bottomV = _mm256_set1_ps(s.bottom);
+  __m256 const speed = _mm256_set1_ps(ATTRACT_SPEED);
+  __m256 const gravity = _mm256_set1_ps(GRAVITY);
+  __m256 const maxFall = _mm256_set1_ps(MAX_FALL_SPEED);
+  __m256 const one = _mm256_set1_ps(1.0f);
+  for (; i + 8 <= count; i += 8) {
+    __m256 const xi = _mm256_load_ps(x + i);
+    __m256 const yi = _mm256_load_ps(y + i);
+    __m256 const dx = _mm256_sub_ps(px, xi);
+    __m256 const dy = _mm256_sub_ps(py, yi);
+    __m256 const distSq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    __m256 const isCollected = _mm256_cmp_ps(distSq, collectSq, _CMP_LE_OQ);
+    __m256 const isAttracted =
+      _mm256_or_ps(_mm256_or_ps(_mm256_load_ps(reinterpret_cast<float const*>(attracted + i)), attractAll),
+                   _mm256_cmp_ps(distSq, attractSq, _CMP_LE_OQ));
+
+    __m256 const dist = _mm256_sqrt_ps(distSq);
+    __m256 const scale = _mm256_blendv_ps(one, _mm256_div_ps(speed, dist), _mm256_cmp_ps(dist, speed, _CMP_GT_OQ));
+    __m256 const fallSpeed = _mm256_min_ps(_mm256_add_ps(_mm256_load_ps(vy + i), gravity), maxFall);
+    __m256 const newX = _mm256_blendv_ps(xi, _mm256_add_ps(xi, _mm256_mul_ps(dx, scale)), isAttracted);
+    __m256 const newY =
+      _mm256_blendv_ps(_mm256_add_ps(yi, fallSpeed), _mm256_add_ps(yi, _mm256_mul_ps(dy, scale)), isAttracted);
+    _mm256_store_ps(x + i, newX);
+    _mm256_store_ps(y + i, newY);
+    _mm256_store_ps(vy + i, fallSpeed);
+    _mm256_store_ps(reinterpret_cast<float*>(attracted + i), isAttracted);
+
+    __m256 const fellOut = _mm256_andnot_ps(isAttracted, _mm256_cmp_ps(newY, bottomV, _CMP_GT_OQ));
+    unsigned const collectMask = static_cast<unsigned>(_mm256_movemask_ps(isCollected));
+    collected += static_cast<std::size_t>(std::popcount(collectMask));
+    unsigned const removeMask = collectMask | static_cast<unsigned>(_mm256_movemask_ps(fellOut));
+    killCount += appendKills(removeMask, i, killList + killCount);
+  }
+#elif defined(TOUHOU_SIMD_SSE2)
+  __m128 const px = _mm_set1_ps(s.px);
+  __m128 const py = _mm_set1_ps(s.py);
+  __m128 const collectSq = _mm_set1_ps(s.collectSq);
+  __m128 const attractSq = _mm_set1_ps(s.attractSq);
+  __m128 const attractAll = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(s.attractAll)));
+  __m128 const bottomV = _mm_set1_ps(s.bottom);
+  __m128 const speed = _mm_set1_ps(ATTRACT_SPEED);
+  __m128 const gravity = _mm_set1_ps(GRAVITY);
+  __m128 const maxFall = _mm_set1_ps(MAX_FALL_SPEED);
+  __m128 const one = _mm_set1_ps(1.0f);
+  // SSE2 没有 blendv, 用与或实现按掩码选择
+  auto const select = [](__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+  };
+  for (; i + 4 <= count; i += 4) {
+    __m128 const xi = _mm_load_ps(x + i);
+    __m128 const yi = _mm_load_ps(y + i);
+    __m128 const dx = _mm_sub_ps(px, xi);
+    __m128 const dy = _mm_sub_ps(py, yi);
+    __m128 const distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+    __m128 const isCollected = _mm_cmple_ps(distSq, collectSq);
+    __m128 const isAttracted =
+      _mm_or_ps(_mm_or_ps(_mm_load_ps(reinterpret_cast<float const*>(attracted + i)), attractAll),
+                _mm_cmple_ps(distSq, attractSq));
+
+    __m128 const dist = _mm_sqrt_ps(distSq);
+    __m128 const scale = select(_mm_cmpgt_ps(dist, speed), one, _mm_div_ps(speed, dist));
+    __m128 const fallSpeed = _mm_min_ps(_mm_add_ps(_mm_load_ps(vy + i), gravity), maxFall);
+    __m128 const newX = select(isAttracted, xi, _mm_add_ps(xi, _mm_mul_ps(dx, scale)));
+    __m128 const newY = select(isAttracted, _mm_add_ps(yi, fallSpeed), _mm_add_ps(yi, _mm_mul_ps(dy, scale)));
+    _mm_store_ps(x + i, newX);
+    _mm_store_ps(y + i, newY);
+    _mm_store_ps(vy + i, fallSpeed);
+    _mm_store_ps(reinterpret_cast<float*>(attracted + i), isAttracted);
+
+    __m128 const fellOut = _mm_andnot_ps(isAttracted, _mm_cmpgt_ps(newY, bottomV));
+    unsigned const collectMask = static_cast<unsigned>(_mm_movemask_ps(isCollected));
+    collected += static_cast<std::size_t>(std::popcount(collectMask));
+    unsigned const removeMask = collectMask | static_cast<unsigned>(_mm_movemask_ps(fellOut));
+    killCount += appendKills(removeMask, i, killList + killCount);
+  }
+#endif
+  killCount += updateScalar(x, y, vy, attracted, i, count, s, killList + killCount, collected);
+
+  if (killCount > 0) {
+    forEachArray([=](auto& array) { compactStable(array.data(), count, killList, killCount); });
+    m_activeCount -= killCount;
+  }
+  return collected;
+}
+
+void ItemManager::saveState(Core::BinaryWriter& writer) const
+{
+  writer.write<std::uint64_t>(m_x.size());
+  writer.write<std::uint64_t>(m_activeCount);
+  forEachArray([&](auto const& array) { writer.writeArray(array.data(), m_activeCount); });
+  writer.write<std::uint64_t>(m_overflowCount);
+  writer.write<std::uint64_t>(m_lastFrameOverflow);
+}
+
+void ItemManager::loadState(Core::BinaryReader& reader)
+{
+  std::size_t const capacity = m_x.size();
+  std::uint64_t const savedCapacity = reader.read<std::uint64_t>();
+  std::uint64_t const activeCount = reader.read<std::uint64_t>();
+  if (savedCapacity != capacity || activeCount > capacity) {
+    LOG_ERROR("ItemManager state capacity mismatch: saved {}, current {}", savedCapacity, capacity);
+    throw std::runtime_error("ItemManager state capacity mismatch.");
+  }
+
+  m_activeCount = static_cast<std::size_t>(activeCount);
+  forEachArray([&](auto& array) { reader.readArray(array.data(), m_activeCount); });
+  m_overflowCount = static_cast<std::size_t>(reader.read<std::uint64_t>());
+  m_lastFrameOverflow = static_cast<std::size_t>(reader.read<std::uint64_t>());
+}
+
+std::size_t ItemManager::maxStateSize() const noexcept
+{
+  std::size_t bytesPerItem = 0;
+  forEachArray([&](auto const& array) { bytesPerItem += sizeof(array[0]); });
+  return sizeof(std::uint64_t) * 4 + m_x.size() * bytesPerItem;
+}
+
+std::uint64_t ItemManager::computeStateHash(std::uint64_t hash) const noexcept
+{
+  auto const mix = [&hash](std::uint64_t word) { hash = (hash ^ word) * 0x0000'0100'0000'01B3ull; };
+  mix(m_activeCount);
+  for (std::size_t i = 0; i < m_activeCount; ++i) {
+    mix(std::bit_cast<std::uint32_t>(m_x[i]));
+    mix(std::bit_cast<std::uint32_t>(m_y[i]));
+    mix(std::bit_cast<std::uint32_t>(m_vy[i]));
+    mix(m_attracted[i]);
+    mix(m_type[i]);
+  }
+  return hash;
+}
+} // namespace Game
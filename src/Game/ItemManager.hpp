@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Core/AlignedAllocator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Core {
+class BinaryWriter;
+class BinaryReader;
+}
+
+namespace Game {
+// 道具的种类, 目前只决定外观
+enum class ItemType : std::uint16_t
+{
+  Cancel, // 消弹产生的小道具
+  Point,  // 得点道具
+};
+
+// 一次更新的自机参数
+struct ItemCollector
+{
+  float x;
+  float y;
+  bool collectAll; // 为 true 时所有道具都被吸向自机 (如自机位于收点线以上)
+};
+
+// 道具池: 消弹时被消除的子弹整批转换为道具, 道具先下落, 进入自机吸引范围后飞向自机并被回收
+// 与弹幕池相同采用 SoA 存储, 每帧的移动, 吸引, 回收判定在一遍 SIMD 循环中完成, 回收与子弹共用 compactStable
+// 道具只用 float 的加减乘除与开方 (IEEE 754 正确舍入, 不使用 FMA), 各指令集路径逐位一致, 定点模式下同样确定
+class ItemManager
+{
+public:
+  ItemManager() = default;
+  ~ItemManager() = default;
+
+  ItemManager(ItemManager const&) = delete;
+  ItemManager& operator=(ItemManager const&) = delete;
+
+  void init(std::size_t capacity); // 初始化道具池大小, 所有内存在此分配
+
+  // 在 (xs[i], ys[i]) 处整批生成 count 个道具, attracted 为 true 时生成后直接飞向自机
+  // 返回实际生成的个数 (道具池不足时少于 count)
+  std::size_t spawnBatch(float const* xs, float const* ys, std::size_t count, ItemType type, bool attracted) noexcept;
+
+  // 每帧调用: 下落 / 吸引移动, 回收被自机收取或落出 bottom 的道具, 返回本帧收取的个数
+  // 收取判定使用移动前的位置; 被吸引的道具每帧向自机移动 ATTRACT_SPEED, 不会落出画面
+  std::size_t update(ItemCollector const& collector, float bottom) noexcept;
+  void clear() noexcept { m_activeCount = 0; }
+
+  std::size_t getActiveCount() const noexcept { return m_activeCount; }
+  float const* getX() const noexcept { return m_x.data(); }
+  float const* getY() const noexcept { return m_y.data(); }
+  ItemType getType(std::size_t i) const noexcept { return static_cast<ItemType>(m_type[i]); }
+  // 上一帧因道具池已满而未能生成的道具数
+  std::size_t getLastFrameOverflow() const noexcept { return m_lastFrameOverflow; }
+
+  // 序列化 / 恢复全部道具, 容量必须与保存时相同, 否则抛出 std::runtime_error
+  void saveState(Core::BinaryWriter& writer) const;
+  void loadState(Core::BinaryReader& reader);
+  std::size_t maxStateSize() const noexcept;
+  // 全部道具的哈希 (64 位 FNV-1a), 以 hash 为初值继续混合
+  std::uint64_t computeStateHash(std::uint64_t hash) const noexcept;
+
+public:
+  static constexpr float GRAVITY = 0.05f;        // 下落加速度 (像素 / 帧^2)
+  static constexpr float INITIAL_VY = -1.5f;     // 生成时的竖直速度, 先向上弹起
+  static constexpr float MAX_FALL_SPEED = 2.5f;  // 最大下落速率
+  static constexpr float ATTRACT_SPEED = 8.0f;   // 被吸引时的移动速率
+  static constexpr float ATTRACT_RADIUS = 64.0f; // 进入该范围后开始被吸引
+  static constexpr float COLLECT_RADIUS = 16.0f; // 进入该范围后被收取
+
+private:
+  // 对每个字段数组调用 fn(array), 用于压实与序列化
+  template <typename F>
+  void forEachArray(F&& fn)
+  {
+    fn(m_x);
+    fn(m_y);
+    fn(m_vy);
+    fn(m_attracted);
+    fn(m_type);
+  }
+
+  template <typename F>
+  void forEachArray(F&& fn) const
+  {
+    fn(m_x);
+    fn(m_y);
+    fn(m_vy);
+    fn(m_attracted);
+    fn(m_type);
+  }
+
+private:
+  template <typename T>
+  using Array = std::vector<T, Core::AlignedAllocator<T, 64>>;
+
+  Array<float> m_x;
+  Array<float> m_y;
+  Array<float> m_vy;
+  Array<std::uint32_t> m_attracted; // 0 或 0xFFFFFFFF, 可以直接作为 SIMD 混合掩码
+  Array<std::uint16_t> m_type;
+  std::vector<std::uint32_t> m_killList; // 本帧回收的道具下标, 与道具池等长
+
+  std::size_t m_activeCount = 0;
+  std::size_t m_overflowCount = 0;
+  std::size_t m_lastFrameOverflow = 0;
+};
+} // namespace Game
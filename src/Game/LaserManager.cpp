@@ -0,0 +1,343 @@
+#include "LaserManager.hpp"
+#include "Core/BinaryStream.hpp"
+#include "Core/Logger.hpp"
+#include "Core/Platform.hpp"
+#include "Core/Profiler.hpp"
+#include "Core/Simd.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace Game {
+
+namespace {
+constexpr float minSegmentLengthSq = 1e-12f; // 激光头静止时相邻节点重合, 避免除以 0
+
+// 点 (px, py) 到线段 (ax, ay) - (bx, by) 的最短距离的平方
+// 与下面各 SIMD 路径的运算顺序相同 (不使用 FMA), 结果逐位一致
+__forceinline float segmentDistanceSq(float ax, float ay, float bx, float by, float px, float py) noexcept
+{
+  float const dx = bx - ax;
+  float const dy = by - ay;
+  float const rx = px - ax;
+  float const ry = py - ay;
+  float const lengthSq = std::max(dx * dx + dy * dy, minSegmentLengthSq);
+  float const t = std::min(std::max((rx * dx + ry * dy) / lengthSq, 0.0f), 1.0f);
+  float const ex = rx - t * dx;
+  float const ey = ry - t * dy;
+  return ex * ex + ey * ey;
+}
+
+// 折线 (x[i], y[i]) (i 在 [0, count) 内, count >= 2) 上各线段到点的最短距离的平方
+float polylineDistanceSq(float const* x, float const* y, std::size_t count, float px, float py) noexcept
+{
+  std::size_t const segments = count - 1;
+  float best = std::numeric_limits<float>::max();
+  std::size_t i = 0;
+
+#if defined(TOUHOU_SIMD_AVX2)
+  __m256 const pxV = _mm256_set1_ps(px);
+  __m256 const pyV = _mm256_set1_ps(py);
+  __m256 const minLengthSq = _mm256_set1_ps(minSegmentLengthSq);
+  __m256 const zero = _mm256_setzero_ps();
+  __m256 const one = _mm256_set1_ps(1.0f);
+  __m256 bestV = _mm256_set1_ps(best);
+  for (; i + 8 <= segments; i += 8) {
+    // 线段 i 的两端是节点 i 与 i + 1, 两次非对齐加载即可得到整批线段
+    __m256 const ax = _mm256_loadu_ps(x + i);
+    __m256 const ay = _mm256_loadu_ps(y + i);
+    __m256 const dx = _mm256_sub_ps(_mm256_loadu_ps(x + i + 1), ax);
+    __m256 const dy = _mm256_sub_ps(_mm256_loadu_ps(y + i + 1), ay);
+    __m256 const rx = _mm256_sub_ps(pxV, ax);
+    __m256 const ry = _mm256_sub_ps(pyV, ay);
+    __m256 const lengthSq = _mm256_max_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), minLengthSq);
+    __m256 t = _mm256_div_ps(_mm256_add_ps(_mm256_mul_ps(rx, dx), _mm256_mul_ps(ry, dy)), lengthSq);
+    t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+    __m256 const ex = _mm256_sub_ps(rx, _mm256_mul_ps(t, dx));
+    __m256 const ey = _mm256_sub_ps(ry, _mm256_mul_ps(t, dy));
+    bestV = _mm256_min_ps(bestV, _mm256_add_ps(_mm256_mul_ps(ex, ex), _mm256_mul_ps(ey, ey)));
+  }
+  alignas(32) float lanes[8];
+  _mm256_store_ps(lanes, bestV);
+  best = *std::min_element(lanes, lanes + 8);
+#elif defined(TOUHOU_SIMD_SSE2)
+  __m128 const pxV = _mm_set1_ps(px);
+  __m128 const pyV = _mm_set1_ps(py);
+  __m128 const minLengthSq = _mm_set1_ps(minSegmentLengthSq);
+  __m128 const zero = _mm_setzero_ps();
+  __m128 const one = _mm_set1_ps(1.0f);
+  __m128 bestV = _mm_set1_ps(best);
+  for (; i + 4 <= segments; i += 4) {
+    __m128 const ax = _mm_loadu_ps(x + i);
+    __m128 const ay = _mm_loadu_ps(y + i);
+    __m128 const dx = _mm_sub_ps(_mm_loadu_ps(x + i + 1), ax);
+    __m128 const dy = _mm_sub_ps(_mm_loadu_ps(y + i + 1), ay);
+    __m128 const rx = _mm_sub_ps(pxV, ax);
+    __m128 const ry = _mm_sub_ps(pyV, ay);
+    __m128 const lengthSq = _mm_max_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), minLengthSq);
+    __m128 t = _mm_div_ps(_mm_add_ps(_mm_mul_ps(rx, dx), _mm_mul_ps(ry, dy)), lengthSq);
+    t = _mm_min_ps(_mm_max_ps(t, zero), one);
+    __m128 const ex = _mm_sub_ps(rx, _mm_mul_ps(t, dx));
+    __m128 const ey = _mm_sub_ps(ry, _mm_mul_ps(t, dy));
+    bestV = _mm_min_ps(bestV, _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)));
+  }
+  alignas(16) float lanes[4];
+  _mm_store_ps(lanes, bestV);
+  best = *std::min_element(lanes, lanes + 4);
+#endif
+
+  // 取最小值与顺序无关, 尾部和标量路径的结果与 SIMD 路径相同
+  for (; i < segments; ++i) {
+    best = std::min(best, segmentDistanceSq(x[i], y[i], x[i + 1], y[i + 1], px, py));
+  }
+  return best;
+}
+} // namespace
+
+void LaserManager::init(std::size_t maxLasers, std::size_t maxNodes)
+{
+  m_maxNodes = std::max<std::size_t>(maxNodes, 1);
+  m_activeCount = 0;
+
+  m_heads.resize(maxLasers);
+  m_writePos.assign(maxLasers, 0);
+  m_nodeCount.assign(maxLasers, 0);
+  m_length.assign(maxLasers, 0);
+  m_outsideFrames.assign(maxLasers, 0);
+  m_killList.resize(maxLasers);
+
+  m_nodeX.assign(maxLasers * 2 * m_maxNodes, 0.0f);
+  m_nodeY.assign(maxLasers * 2 * m_maxNodes, 0.0f);
+  clear();
+  if (!m_typeTable) {
+    m_typeTable = &BulletTypeTable::getDefault();
+  }
+
+  LOG_INFO("LaserManager initialized: {} lasers x {} nodes", maxLasers, m_maxNodes);
+}
+
+void LaserManager::setTypeTable(BulletTypeTable const* table) noexcept
+{
+  m_typeTable = table ? table : &BulletTypeTable::getDefault();
+}
+
+void LaserManager::clear() noexcept
+{
+  m_activeCount = 0;
+  // 倒序压栈, 使缓冲区按 0, 1, 2 ... 的顺序分配
+  std::size_t const capacity = m_heads.capacity();
+  m_freeBuffers.resize(capacity);
+  for (std::size_t i = 0; i < capacity; ++i) {
+    m_freeBuffers[i] = static_cast<std::uint32_t>(capacity - 1 - i);
+  }
+}
+
+bool LaserManager::fire(LaserParams const& params) noexcept
+{
+  if (m_freeBuffers.empty()) {
+    return false;
+  }
+
+  std::size_t const k = m_activeCount++;
+  m_heads.store(k,
+                { .x = params.x,
+                  .y = params.y,
+                  .angle = params.angle,
+                  .angVel = params.angVel,
+                  .angAccel = params.angAccel,
+                  .speed = params.speed,
+                  .tanAccel = params.tanAccel,
+                  .type = params.type,
+                  .color = params.color });
+  m_heads.id[k] = m_freeBuffers.back();
+  m_freeBuffers.pop_back();
+  m_writePos[k] = static_cast<std::uint32_t>(m_maxNodes - 1); // 第一个节点写在位置 0
+  m_nodeCount[k] = 0;
+  m_length[k] = static_cast<std::uint32_t>(std::clamp<std::size_t>(params.length, 1, m_maxNodes));
+  m_outsideFrames[k] = 0;
+  // 节点记录的是激光头换算后的坐标, 与之后每帧追加的节点一致
+  pushNode(k, fromSimScalar(m_heads.x[k]), fromSimScalar(m_heads.y[k]));
+  return true;
+}
+
+void LaserManager::pushNode(std::size_t k, float x, float y) noexcept
+{
+  std::uint32_t const pos = static_cast<std::uint32_t>((m_writePos[k] + 1) % m_maxNodes);
+  std::size_t const base = static_cast<std::size_t>(m_heads.id[k]) * 2 * m_maxNodes;
+  m_nodeX[base + pos] = x;
+  m_nodeY[base + pos] = y;
+  m_nodeX[base + pos + m_maxNodes] = x;
+  m_nodeY[base + pos + m_maxNodes] = y;
+  m_writePos[k] = pos;
+  m_nodeCount[k] = std::min(m_nodeCount[k] + 1, m_length[k]);
+}
+
+void LaserManager::removeLaser(std::size_t k) noexcept
+{
+  m_freeBuffers.push_back(m_heads.id[k]);
+  std::size_t const last = --m_activeCount;
+  if (k != last) {
+    m_heads.move(k, last);
+    m_writePos[k] = m_writePos[last];
+    m_nodeCount[k] = m_nodeCount[last];
+    m_length[k] = m_length[last];
+    m_outsideFrames[k] = m_outsideFrames[last];
+  }
+}
+
+void LaserManager::update(BulletBounds const& bounds)
+{
+  PROFILE_FUNCTION();
+
+  std::size_t const count = m_activeCount;
+  std::size_t const outsideCount = integrateBullets(m_heads, 0, count, bounds, m_killList.data());
+
+  // 出界下标升序, 与激光下标同步扫描
+  std::size_t next = 0;
+  for (std::size_t k = 0; k < count; ++k) {
+    bool const outside = next < outsideCount && m_killList[next] == k;
+    next += outside ? 1 : 0;
+    m_outsideFrames[k] = outside ? m_outsideFrames[k] + 1 : 0;
+    pushNode(k, fromSimScalar(m_heads.x[k]), fromSimScalar(m_heads.y[k]));
+  }
+
+  // 节点产生后不再移动, 激光头在区域外停留的帧数达到节点数时, 所有节点都在区域外
+  // 从后往前回收, 搬过来的最后一条激光都已检查过
+  for (std::size_t k = count; k-- > 0;) {
+    if (m_outsideFrames[k] >= m_nodeCount[k]) {
+      removeLaser(k);
+    }
+  }
+}
+
+LaserView LaserManager::getLaser(std::size_t k) const noexcept
+{
+  std::size_t const first = firstNode(k);
+  return { m_nodeX.data() + first, m_nodeY.data() + first, m_nodeCount[k], m_heads.type[k], m_heads.color[k] };
+}
+
+float LaserManager::distanceSquared(std::size_t k, float px, float py) const noexcept
+{
+  LaserView const laser = getLaser(k);
+  if (laser.count == 1) {
+    float const dx = px - laser.x[0];
+    float const dy = py - laser.y[0];
+    return dx * dx + dy * dy;
+  }
+  return polylineDistanceSq(laser.x, laser.y, laser.count, px, py);
+}
+
+LaserContacts LaserManager::collide(PlayerHitbox const& player) const noexcept
+{
+  PROFILE_FUNCTION();
+
+  LaserContacts contacts{ 0, 0 };
+  BulletTypeTable const& table = *m_typeTable;
+  for (std::size_t k = 0; k < m_activeCount; ++k) {
+    std::uint32_t const style = table.indexOf(m_heads.type[k], m_heads.color[k]);
+    float const distSq = distanceSquared(k, player.x, player.y);
+    float const hitR = player.hitRadius + table.getHitRadius(style);
+    float const grazeR = player.grazeRadius + table.getGrazeRadius(style);
+    if (distSq <= hitR * hitR) {
+      ++contacts.hits;
+    } else if (distSq <= grazeR * grazeR) {
+      ++contacts.grazes;
+    }
+  }
+  return contacts;
+}
+
+void LaserManager::saveState(Core::BinaryWriter& writer) const
+{
+  writer.write<std::uint64_t>(m_heads.capacity());
+  writer.write<std::uint64_t>(m_maxNodes);
+  writer.write<std::uint64_t>(m_activeCount);
+  // 缓冲区编号与节点在环中的位置不影响模拟, 只按从尾到头的顺序写出有效节点
+  m_heads.forEachArray([&](auto const& array) { writer.writeArray(array.data(), m_activeCount); });
+  for (std::size_t k = 0; k < m_activeCount; ++k) {
+    LaserView const laser = getLaser(k);
+    writer.write(m_nodeCount[k]);
+    writer.write(m_length[k]);
+    writer.write(m_outsideFrames[k]);
+    writer.writeArray(laser.x, laser.count);
+    writer.writeArray(laser.y, laser.count);
+  }
+}
+
+void LaserManager::loadState(Core::BinaryReader& reader)
+{
+  std::size_t const capacity = m_heads.capacity();
+  std::uint64_t const savedCapacity = reader.read<std::uint64_t>();
+  std::uint64_t const savedMaxNodes = reader.read<std::uint64_t>();
+  std::uint64_t const activeCount = reader.read<std::uint64_t>();
+  if (savedCapacity != capacity || savedMaxNodes != m_maxNodes || activeCount > capacity) {
+    LOG_ERROR("LaserManager state capacity mismatch: saved {} x {}, current {} x {}",
+              savedCapacity,
+              savedMaxNodes,
+              capacity,
+              m_maxNodes);
+    throw std::runtime_error("LaserManager state capacity mismatch.");
+  }
+
+  clear();
+  m_activeCount = static_cast<std::size_t>(activeCount);
+  m_heads.forEachArray([&](auto& array) { reader.readArray(array.data(), m_activeCount); });
+  for (std::size_t k = 0; k < m_activeCount; ++k) {
+    std::uint32_t const nodeCount = reader.read<std::uint32_t>();
+    std::uint32_t const length = reader.read<std::uint32_t>();
+    m_outsideFrames[k] = reader.read<std::uint32_t>();
+    if (nodeCount == 0 || nodeCount > length || length > m_maxNodes) {
+      throw std::runtime_error("LaserManager state is corrupted.");
+    }
+
+    // 按下标重新分配缓冲区, 节点从位置 0 开始存放, 同样写两份
+    m_heads.id[k] = m_freeBuffers.back();
+    m_freeBuffers.pop_back();
+    std::size_t const base = static_cast<std::size_t>(m_heads.id[k]) * 2 * m_maxNodes;
+    reader.readArray(&m_nodeX[base], nodeCount);
+    reader.readArray(&m_nodeY[base], nodeCount);
+    std::copy_n(&m_nodeX[base], nodeCount, &m_nodeX[base + m_maxNodes]);
+    std::copy_n(&m_nodeY[base], nodeCount, &m_nodeY[base + m_maxNodes]);
+    m_writePos[k] = nodeCount - 1;
+    m_nodeCount[k] = nodeCount;
+    m_length[k] = length;
+  }
+}
+
+std::size_t LaserManager::maxStateSize() const noexcept
+{
+  std::size_t bytesPerHead = 0;
+  m_heads.forEachArray([&](auto const& array) { bytesPerHead += sizeof(array[0]); });
+  std::size_t const bytesPerLaser = bytesPerHead + sizeof(std::uint32_t) * 3 + m_maxNodes * sizeof(float) * 2;
+  return sizeof(std::uint64_t) * 3 + m_heads.capacity() * bytesPerLaser;
+}
+
+std::uint64_t LaserManager::computeStateHash(std::uint64_t hash) const noexcept
+{
+  auto const mix = [&hash](std::uint64_t word) { hash = (hash ^ word) * 0x0000'0100'0000'01B3ull; };
+  mix(m_activeCount);
+  for (std::size_t k = 0; k < m_activeCount; ++k) {
+    // 激光头的运动字段与类型 (缓冲区编号 id 不参与)
+    mix(std::bit_cast<std::uint32_t>(m_heads.x[k]));
+    mix(std::bit_cast<std::uint32_t>(m_heads.y[k]));
+    mix(std::bit_cast<std::uint32_t>(m_heads.angle[k]));
+    mix(std::bit_cast<std::uint32_t>(m_heads.angVel[k]));
+    mix(std::bit_cast<std::uint32_t>(m_heads.angAccel[k]));
+    mix(std::bit_cast<std::uint32_t>(m_heads.speed[k]));
+    mix(std::bit_cast<std::uint32_t>(m_heads.tanAccel[k]));
+    mix(m_heads.type[k]);
+    mix(m_heads.color[k]);
+    mix(m_nodeCount[k]);
+    mix(m_length[k]);
+    mix(m_outsideFrames[k]);
+
+    LaserView const laser = getLaser(k);
+    for (std::size_t i = 0; i < laser.count; ++i) {
+      mix(std::bit_cast<std::uint32_t>(laser.x[i]));
+      mix(std::bit_cast<std::uint32_t>(laser.y[i]));
+    }
+  }
+  return hash;
+}
+} // namespace Game
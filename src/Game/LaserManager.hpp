@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Core/AlignedAllocator.hpp"
+#include "Game/BulletKernel.hpp"
+#include "Game/BulletSoA.hpp"
+#include "Game/BulletTypeTable.hpp"
+#include "Game/CollisionGrid.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Core {
+class BinaryWriter;
+class BinaryReader;
+}
+
+namespace Game {
+// 曲线激光的发射参数: 激光头按与子弹相同的运动参数移动, 激光身体是激光头最近 length 帧走过的轨迹
+struct LaserParams
+{
+  float x = 0;
+  float y = 0;
+  float angle = 0;
+  float angVel = 0;
+  float angAccel = 0;
+  float speed = 0;
+  float tanAccel = 0;
+  std::uint16_t length = 64; // 节点数 (即轨迹的帧数), 超过 LaserManager 的 maxNodes 时截断
+  std::uint16_t type = 0;    // 外观与判定宽度查子弹类型表: 宽度为 BulletStyle::width, 判定为 hitRadius / grazeRadius
+  std::uint16_t color = 0;
+};
+
+// 一条激光的只读视图, 节点按从尾到头的顺序连续存放
+struct LaserView
+{
+  float const* x;
+  float const* y;
+  std::size_t count;
+  std::uint16_t type;
+  std::uint16_t color;
+};
+
+// 一次碰撞查询的结果
+struct LaserContacts
+{
+  std::size_t hits;   // 与自机被弹判定相交的激光数
+  std::size_t grazes; // 进入擦弹范围但未被弹的激光数
+};
+
+// 曲线激光: 每条激光有一个激光头和一段节点轨迹, 不占用弹幕池
+// 激光头存放在一个小 BulletSoA 中, 每帧用 integrateBullets 整批积分 (与子弹相同的 SIMD 路径和数值模式)
+// 节点只在产生时写入一次, 存放在每条激光独占的环形缓冲区中: 每个节点同时写入 p 与 p + maxNodes 两处,
+// 任意时刻最近 count 个节点在内存中都是连续的, 碰撞和绘制不需要处理回绕
+// 与自机的碰撞把相邻节点看作胶囊体 (线段 + 半径), 按 SIMD 宽度整批求点到线段的最短距离
+class LaserManager
+{
+public:
+  LaserManager() = default;
+  ~LaserManager() = default;
+
+  LaserManager(LaserManager const&) = delete;
+  LaserManager& operator=(LaserManager const&) = delete;
+
+  // 最多 maxLasers 条激光, 每条最多 maxNodes 个节点, 所有内存在此分配
+  void init(std::size_t maxLasers, std::size_t maxNodes);
+  // 设置宽度与判定半径的来源 (不管理生命周期), 为 nullptr 时使用只有默认样式的表
+  void setTypeTable(BulletTypeTable const* table) noexcept;
+
+  // 发射一条激光, 第一个节点在发射位置; 激光数已满时返回 false
+  bool fire(LaserParams const& params) noexcept;
+  // 每帧调用: 积分激光头并追加节点; 激光头连续在 bounds 外的帧数达到节点数时 (所有节点都在区域外) 回收该激光
+  void update(BulletBounds const& bounds);
+  void clear() noexcept;
+
+  // 自机与所有激光的碰撞, 每条激光最多计一次
+  LaserContacts collide(PlayerHitbox const& player) const noexcept;
+  // 点 (px, py) 到第 k 条激光中心线的最短距离的平方
+  float distanceSquared(std::size_t k, float px, float py) const noexcept;
+
+  std::size_t getLaserCount() const noexcept { return m_activeCount; }
+  LaserView getLaser(std::size_t k) const noexcept;
+  std::size_t getMaxNodes() const noexcept { return m_maxNodes; }
+
+  // 序列化 / 恢复全部激光, 容量必须与保存时相同, 否则抛出 std::runtime_error
+  void saveState(Core::BinaryWriter& writer) const;
+  void loadState(Core::BinaryReader& reader);
+  std::size_t maxStateSize() const noexcept;
+  // 激光头与全部节点的哈希 (64 位 FNV-1a), 以 hash 为初值继续混合
+  std::uint64_t computeStateHash(std::uint64_t hash) const noexcept;
+
+private:
+  // 第 k 条激光的最近 count 个节点的起始下标 (在 m_nodeX / m_nodeY 中)
+  std::size_t firstNode(std::size_t k) const noexcept
+  {
+    std::size_t const base = static_cast<std::size_t>(m_heads.id[k]) * 2 * m_maxNodes;
+    return base + (m_writePos[k] + 1 + m_maxNodes - m_nodeCount[k]) % m_maxNodes;
+  }
+  // 在第 k 条激光的环形缓冲区中追加一个节点
+  void pushNode(std::size_t k, float x, float y) noexcept;
+  // 用最后一条激光覆盖第 k 条, 回收其缓冲区
+  void removeLaser(std::size_t k) noexcept;
+
+private:
+  template <typename T>
+  using Array = std::vector<T, Core::AlignedAllocator<T, 64>>;
+
+  std::size_t m_maxNodes = 0;
+  std::size_t m_activeCount = 0;
+
+  // 以下按激光下标索引, 前 m_activeCount 项有效
+  BulletSoA m_heads;                        // 激光头; id 为该激光占用的环形缓冲区编号
+  std::vector<std::uint32_t> m_writePos;    // 最新节点在环形缓冲区中的位置 [0, maxNodes)
+  std::vector<std::uint32_t> m_nodeCount;   // 当前节点数
+  std::vector<std::uint32_t> m_length;      // 最大节点数
+  std::vector<std::uint32_t> m_outsideFrames; // 激光头连续在区域外的帧数
+
+  Array<float> m_nodeX; // 每条激光 2 * maxNodes 个节点, 见类说明
+  Array<float> m_nodeY;
+  std::vector<std::uint32_t> m_freeBuffers; // 空闲的环形缓冲区编号
+  std::vector<std::uint32_t> m_killList;    // 积分时的出界下标
+
+  BulletTypeTable const* m_typeTable = nullptr;
+};
+} // namespace Game
@@ -0,0 +1,250 @@
+#include "Replay.hpp"
+#include "Core/BinaryStream.hpp"
+#include "Core/Logger.hpp"
+#include "Core/Profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace Game {
+
+namespace {
+constexpr std::uint32_t replayMagic = 0x5052'4854; // "THRP"
+constexpr std::uint16_t replayVersion = 4; // 2: 检查点中加入曲线激光; 3: 加入 Bomb 消弹与道具; 4: 随机数改为计数器式随机数流
+constexpr std::uint8_t flagFixedPoint = 1 << 0; // 检查点中的状态为定点模式
+
+[[noreturn]] void failReplay(std::string const& message)
+{
+  LOG_ERROR(message);
+  throw std::runtime_error(message);
+}
+} // namespace
+
+void Replay::saveToFile(std::string const& path) const
+{
+  std::vector<std::uint8_t> buffer;
+  Core::BinaryWriter writer(buffer);
+
+  writer.write(replayMagic);
+  writer.write(replayVersion);
+  writer.write<std::uint8_t>(FixedPointSim ? flagFixedPoint : 0);
+  writer.write(config.width);
+  writer.write(config.height);
+  writer.write<std::uint64_t>(config.bulletCapacity);
+  writer.write(config.seed);
+  writer.write(frameCount);
+
+  // 事件: 与上一个事件的帧号差 + 类型 + 值, 均为变长整数, 一次按键变化通常只占 3 ~ 4 字节
+  writer.writeVarint(events.size());
+  std::uint32_t prevFrame = 0;
+  for (Event const& event : events) {
+    writer.writeVarint(event.frame - prevFrame);
+    writer.write(event.kind);
+    writer.writeVarint(event.value);
+    prevFrame = event.frame;
+  }
+
+  writer.writeVarint(checkpoints.size());
+  for (Checkpoint const& checkpoint : checkpoints) {
+    writer.writeVarint(checkpoint.frame);
+    writer.write(checkpoint.stateHash);
+    writer.writeVarint(checkpoint.state.size());
+    writer.writeArray(checkpoint.state.data(), checkpoint.state.size());
+  }
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    failReplay("Failed to open replay file for writing: " + path);
+  }
+  file.write(reinterpret_cast<char const*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+  if (!file) {
+    failReplay("Failed to write replay file: " + path);
+  }
+  LOG_INFO("Replay saved: {} ({} frames, {} events, {} checkpoints, {} bytes)",
+           path,
+           frameCount,
+           events.size(),
+           checkpoints.size(),
+           buffer.size());
+}
+
+Replay Replay::loadFromFile(std::string const& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    failReplay("Failed to open replay file: " + path);
+  }
+  std::vector<std::uint8_t> const buffer{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+  Core::BinaryReader reader(buffer);
+
+  if (reader.read<std::uint32_t>() != replayMagic || reader.read<std::uint16_t>() != replayVersion) {
+    failReplay("Not a replay file or unsupported version: " + path);
+  }
+  std::uint8_t const flags = reader.read<std::uint8_t>();
+  if (((flags & flagFixedPoint) != 0) != FixedPointSim) {
+    failReplay("Replay was recorded with a different TOUHOU_FIXED_POINT setting: " + path);
+  }
+
+  Replay replay;
+  replay.config.width = reader.read<float>();
+  replay.config.height = reader.read<float>();
+  replay.config.bulletCapacity = static_cast<std::size_t>(reader.read<std::uint64_t>());
+  replay.config.seed = reader.read<std::uint32_t>();
+  replay.frameCount = reader.read<std::uint32_t>();
+
+  std::uint64_t const eventCount = reader.readVarint();
+  replay.events.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(eventCount, reader.remaining())));
+  std::uint32_t frame = 0;
+  for (std::uint64_t i = 0; i < eventCount; ++i) {
+    frame += static_cast<std::uint32_t>(reader.readVarint());
+    auto const kind = reader.read<EventKind>();
+    auto const value = static_cast<std::uint32_t>(reader.readVarint());
+    if (kind != EventKind::Input && kind != EventKind::Seed) {
+      failReplay("Replay file is corrupted: " + path);
+    }
+    replay.events.push_back({ frame, kind, value });
+  }
+
+  std::uint64_t const checkpointCount = reader.readVarint();
+  for (std::uint64_t i = 0; i < checkpointCount; ++i) {
+    Checkpoint checkpoint;
+    checkpoint.frame = static_cast<std::uint32_t>(reader.readVarint());
+    checkpoint.stateHash = reader.read<std::uint64_t>();
+    auto const state = reader.readSpan(static_cast<std::size_t>(reader.readVarint()));
+    checkpoint.state.assign(state.begin(), state.end());
+    replay.checkpoints.push_back(std::move(checkpoint));
+  }
+
+  LOG_INFO("Replay loaded: {} ({} frames, {} events, {} checkpoints)",
+           path,
+           replay.frameCount,
+           replay.events.size(),
+           replay.checkpoints.size());
+  return replay;
+}
+
+void ReplayRecorder::begin(Stage const& stage)
+{
+  m_replay = {};
+  m_replay.config = stage.getConfig();
+  m_replay.frameCount = stage.getFrame();
+  m_lastInput = {};
+}
+
+void ReplayRecorder::recordFrame(Stage const& stage, FrameInput const& input)
+{
+  if (input != m_lastInput) {
+    m_replay.events.push_back({ stage.getFrame(), Replay::EventKind::Input, input.buttons });
+    m_lastInput = input;
+  }
+  m_replay.frameCount = stage.getFrame() + 1;
+}
+
+void ReplayRecorder::recordReseed(Stage const& stage, std::uint32_t seed)
+{
+  m_replay.events.push_back({ stage.getFrame(), Replay::EventKind::Seed, seed });
+}
+
+void ReplayRecorder::recordCheckpoint(Stage const& stage)
+{
+  std::uint32_t const frame = stage.getFrame();
+  if (m_checkpointInterval == 0 || frame == 0 || frame % m_checkpointInterval != 0) {
+    return;
+  }
+
+  m_scratch.clear();
+  Core::BinaryWriter writer(m_scratch);
+  stage.saveState(writer);
+  m_replay.checkpoints.push_back({ frame, stage.computeStateHash(), m_scratch });
+}
+
+void ReplayPlayer::reset(Stage& stage)
+{
+  stage.reset();
+  syncEventsTo(0);
+}
+
+void ReplayPlayer::syncEventsTo(std::uint32_t frame) noexcept
+{
+  // 种子事件的效果已经包含在 Stage 的状态中, 这里只需恢复当前的按键状态
+  m_input = {};
+  m_nextEvent = 0;
+  while (m_nextEvent < m_replay.events.size() && m_replay.events[m_nextEvent].frame < frame) {
+    Replay::Event const& event = m_replay.events[m_nextEvent++];
+    if (event.kind == Replay::EventKind::Input) {
+      m_input.buttons = static_cast<std::uint16_t>(event.value);
+    }
+  }
+
+  auto const& checkpoints = m_replay.checkpoints;
+  m_nextCheckpoint = static_cast<std::size_t>(
+    std::upper_bound(checkpoints.begin(),
+                     checkpoints.end(),
+                     frame,
+                     [](std::uint32_t f, Replay::Checkpoint const& checkpoint) { return f < checkpoint.frame; }) -
+    checkpoints.begin());
+}
+
+std::uint32_t ReplayPlayer::runTo(Stage& stage, std::uint32_t targetFrame)
+{
+  targetFrame = std::min(targetFrame, m_replay.frameCount);
+  auto const& events = m_replay.events;
+  auto const& checkpoints = m_replay.checkpoints;
+
+  std::uint32_t simulated = 0;
+  while (stage.getFrame() < targetFrame) {
+    std::uint32_t const frame = stage.getFrame();
+    for (; m_nextEvent < events.size() && events[m_nextEvent].frame <= frame; ++m_nextEvent) {
+      Replay::Event const& event = events[m_nextEvent];
+      if (event.kind == Replay::EventKind::Input) {
+        m_input.buttons = static_cast<std::uint16_t>(event.value);
+      } else {
+        stage.reseed(event.value);
+      }
+    }
+
+    PROFILE_FRAME();
+    stage.step(m_input);
+    ++simulated;
+
+    for (; m_nextCheckpoint < checkpoints.size() && checkpoints[m_nextCheckpoint].frame <= stage.getFrame();
+         ++m_nextCheckpoint) {
+      Replay::Checkpoint const& checkpoint = checkpoints[m_nextCheckpoint];
+      if (checkpoint.frame == stage.getFrame() && checkpoint.stateHash != stage.computeStateHash()) {
+        ++m_desyncCount;
+        LOG_WARN("Replay desync detected at frame {}", checkpoint.frame);
+      }
+    }
+  }
+  return simulated;
+}
+
+void ReplayPlayer::seek(Stage& stage, std::uint32_t targetFrame)
+{
+  targetFrame = std::min(targetFrame, m_replay.frameCount);
+  auto const& checkpoints = m_replay.checkpoints;
+
+  // 不晚于目标帧的最近检查点
+  auto const it =
+    std::upper_bound(checkpoints.begin(),
+                     checkpoints.end(),
+                     targetFrame,
+                     [](std::uint32_t f, Replay::Checkpoint const& checkpoint) { return f < checkpoint.frame; });
+  Replay::Checkpoint const* checkpoint = it == checkpoints.begin() ? nullptr : &*(it - 1);
+  std::uint32_t const checkpointFrame = checkpoint ? checkpoint->frame : 0;
+
+  // 当前帧已经位于检查点与目标帧之间时, 直接向后模拟更快
+  std::uint32_t const current = stage.getFrame();
+  if (current > targetFrame || current < checkpointFrame) {
+    if (checkpoint) {
+      Core::BinaryReader reader(checkpoint->state);
+      stage.loadState(reader);
+      syncEventsTo(stage.getFrame());
+    } else {
+      reset(stage);
+    }
+  }
+  runTo(stage, targetFrame);
+}
+} // namespace Game
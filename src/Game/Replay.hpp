@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Game/Stage.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Game {
+// 一局游戏的录像: 初始配置 + 逐帧输入与随机数种子的变化 + 周期性的状态检查点
+// 输入只在变化时记录 (帧号差分 + 新值), 按键不变的帧不占空间; 检查点用于跳转, 避免从第 0 帧开始模拟
+struct Replay
+{
+  enum class EventKind : std::uint8_t
+  {
+    Input, // 从该帧起的按键状态
+    Seed,  // 在该帧开始前重新设置随机数种子
+  };
+
+  struct Event
+  {
+    std::uint32_t frame; // 在模拟第 frame 帧 (Stage::getFrame() == frame 时调用 step) 之前生效
+    EventKind kind;
+    std::uint32_t value; // Input: FrameInput::buttons; Seed: 种子
+  };
+
+  struct Checkpoint
+  {
+    std::uint32_t frame;             // 已模拟的帧数
+    std::uint64_t stateHash;         // 该帧的 Stage::computeStateHash, 回放时用于检测不同步
+    std::vector<std::uint8_t> state; // Stage::saveState 的输出
+  };
+
+  Stage::Config config{};
+  std::uint32_t frameCount = 0;        // 录像的总帧数
+  std::vector<Event> events;           // 按帧号升序
+  std::vector<Checkpoint> checkpoints; // 按帧号升序
+
+  // 文件读写, 失败时抛出 std::runtime_error
+  // 文件中的事件以变长整数差分编码; 检查点依赖模拟的数值模式 (TOUHOU_FIXED_POINT), 模式不同的录像无法读取
+  void saveToFile(std::string const& path) const;
+  static Replay loadFromFile(std::string const& path);
+};
+
+// 录像录制: 每帧在 Stage::step 之前调用 recordFrame, 之后调用 recordCheckpoint
+class ReplayRecorder
+{
+public:
+  static constexpr std::uint32_t DEFAULT_CHECKPOINT_INTERVAL = 600; // 默认每 10 秒一个检查点
+
+public:
+  explicit ReplayRecorder(std::uint32_t checkpointInterval = DEFAULT_CHECKPOINT_INTERVAL) noexcept
+    : m_checkpointInterval(checkpointInterval)
+  {
+  }
+
+  // 从 stage 的当前配置开始录制 (stage 应处于第 0 帧)
+  void begin(Stage const& stage);
+  // 记录即将模拟的这一帧的输入
+  void recordFrame(Stage const& stage, FrameInput const& input);
+  // 记录在即将模拟的这一帧之前发生的 Stage::reseed
+  void recordReseed(Stage const& stage, std::uint32_t seed);
+  // 在 step 之后调用, 到达检查点间隔时保存一份状态
+  void recordCheckpoint(Stage const& stage);
+
+  Replay const& getReplay() const noexcept { return m_replay; }
+
+private:
+  Replay m_replay;
+  std::uint32_t m_checkpointInterval;
+  FrameInput m_lastInput{};
+  std::vector<std::uint8_t> m_scratch; // 序列化检查点时复用的缓冲区
+};
+
+// 录像回放: 不需要窗口和渲染器, 以 CPU 允许的最快速度驱动 Stage::step
+class ReplayPlayer
+{
+public:
+  explicit ReplayPlayer(Replay const& replay) noexcept
+    : m_replay(replay)
+  {
+  }
+
+  // 把 stage 重置到录像的第 0 帧 (stage 应已按 replay.config 初始化)
+  void reset(Stage& stage);
+  // 从 stage 的当前帧模拟到 targetFrame (不超过录像长度), 返回模拟的帧数
+  // 经过检查点时比对状态哈希, 不一致时记录警告并计入 getDesyncCount()
+  std::uint32_t runTo(Stage& stage, std::uint32_t targetFrame);
+  // 跳转到 targetFrame: 从不晚于目标帧的最近检查点恢复, 再模拟剩余的帧
+  // 目标在当前帧之后且比最近的检查点更近时直接向后模拟
+  void seek(Stage& stage, std::uint32_t targetFrame);
+
+  std::size_t getDesyncCount() const noexcept { return m_desyncCount; }
+
+private:
+  // 把事件游标与当前输入同步到 frame 帧 (frame 之前的事件已全部生效)
+  void syncEventsTo(std::uint32_t frame) noexcept;
+
+private:
+  Replay const& m_replay;
+  std::size_t m_nextEvent = 0;      // 下一个未生效的事件
+  std::size_t m_nextCheckpoint = 0; // 下一个待比对的检查点
+  FrameInput m_input{};
+  std::size_t m_desyncCount = 0;
+};
+} // namespace Game
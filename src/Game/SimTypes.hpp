@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Core/FixedPoint.hpp"
+#include "Core/Platform.hpp"
+
+namespace Game {
+// 子弹模拟状态的数值类型, 由 CMake 选项 TOUHOU_FIXED_POINT 在编译期选择 (见根目录 CMakeLists.txt)
+// 定点模式下位置 / 速率为 16.16 定点数, 角度为二进制角, 任何 x86-64 构建的模拟结果逐位相同, 可用于跨机器回放
+// 对外接口 (Bullet, EmitParams 等) 始终使用 float, 只在写入和读出内存池时换算
+#if defined(TOUHOU_FIXED_POINT)
+using SimScalar = Core::Math::Fixed; // 位置, 速率, 切向加速度
+using SimAngle = Core::Math::Angle;  // 角, 角速度, 角加速度
+inline constexpr bool FixedPointSim = true;
+
+__forceinline SimScalar toSimScalar(float value) noexcept
+{
+  return Core::Math::toFixed(value);
+}
+
+__forceinline float fromSimScalar(SimScalar value) noexcept
+{
+  return Core::Math::fixedToFloat(value);
+}
+
+__forceinline SimAngle toSimAngle(float radians) noexcept
+{
+  return Core::Math::toAngle(radians);
+}
+
+__forceinline float fromSimAngle(SimAngle angle) noexcept
+{
+  return Core::Math::angleToRadians(angle);
+}
+#else
+using SimScalar = float;
+using SimAngle = float;
+inline constexpr bool FixedPointSim = false;
+
+__forceinline SimScalar toSimScalar(float value) noexcept
+{
+  return value;
+}
+
+__forceinline float fromSimScalar(SimScalar value) noexcept
+{
+  return value;
+}
+
+__forceinline SimAngle toSimAngle(float radians) noexcept
+{
+  return radians;
+}
+
+__forceinline float fromSimAngle(SimAngle angle) noexcept
+{
+  return angle;
+}
+#endif
+} // namespace Game
@@ -0,0 +1,96 @@
+#include "SimulationThread.hpp"
+#include "Core/FramePacer.hpp"
+#include "Core/Logger.hpp"
+#include "Core/Profiler.hpp"
+#include "Core/Timer.hpp"
+#include "Game/Stage.hpp"
+
+#include <exception>
+#include <utility>
+
+namespace Game {
+
+SimulationThread::~SimulationThread()
+{
+  stop();
+}
+
+void SimulationThread::start(Stage& stage, Config const& config, StepFn step)
+{
+  stop();
+  m_stage = &stage;
+  m_config = config;
+  m_step = std::move(step);
+  m_stepCount.store(0, std::memory_order_relaxed);
+  m_stopRequested.store(false, std::memory_order_relaxed);
+
+  m_packets.forEachSlot([&stage](FramePacket& packet) { packet.reserve(stage); });
+  m_builder.init(stage);
+
+  // 第一份数据在启动前发布, 渲染线程从一开始就有画面可画
+  FramePacket& first = m_packets.back();
+  m_builder.build(stage, m_packets.published(), first);
+  first.publishCounter = Core::Timer::getCounter();
+  m_packets.publish();
+
+  m_running.store(true, std::memory_order_release);
+  m_thread = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop()
+{
+  m_stopRequested.store(true, std::memory_order_release);
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+FramePacket const& SimulationThread::acquire(bool* fresh) noexcept
+{
+  bool const acquired = m_packets.acquire();
+  if (fresh != nullptr) {
+    *fresh = acquired;
+  }
+  return m_packets.front();
+}
+
+void SimulationThread::run()
+{
+  PROFILE_THREAD_NAME("Simulation");
+  Core::FramePacer pacer;
+  std::int64_t const period = Core::Timer::toCounter(m_config.stepSeconds);
+  std::int64_t deadline = Core::Timer::getCounter() + period;
+
+  try {
+    while (!m_stopRequested.load(std::memory_order_acquire)) {
+      if (m_config.paced) {
+        // 落后超过 maxCatchUp 步时放弃落后的时间, 与原来单线程主循环的处理落相同
+        std::int64_t const now = Core::Timer::getCounter();
+        if (now - deadline > period * static_cast<std::int64_t>(m_config.maxCatchUp)) {
+          deadline = now;
+        }
+        pacer.waitUntil(deadline);
+        deadline += period;
+      }
+
+      m_step();
+
+      {
+        PROFILE_SCOPE("SimulationThread::publish");
+        FramePacket& packet = m_packets.back();
+        m_builder.build(*m_stage, m_packets.published(), packet);
+        packet.publishCounter = Core::Timer::getCounter();
+        m_packets.publish();
+      }
+
+      std::uint64_t const steps = m_stepCount.fetch_add(1, std::memory_order_relaxed) + 1;
+      if (m_config.stepLimit != 0 && steps >= m_config.stepLimit) {
+        break;
+      }
+    }
+  } catch (std::exception const& e) {
+    LOG_ERROR("Simulation thread stopped: {}", e.what());
+  }
+  m_running.store(false, std::memory_order_release);
+}
+} // namespace Game
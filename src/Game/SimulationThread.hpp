@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Core/TripleBuffer.hpp"
+#include "Game/FramePacket.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+namespace Game {
+class Stage;
+
+// 在独立线程上以固定步长推进 Stage, 每一步之后生成一份 FramePacket 发布到三缓冲
+// 渲染线程随时取走最新的一份绘制, 两边互不等待: 指令提交与实例构建的耗时不再占用模拟的时间
+// 启动后 Stage 只由模拟线程访问, 渲染线程只读取 FramePacket (以及初始化后不再修改的类型表)
+class SimulationThread
+{
+public:
+  // 执行一步模拟 (读取输入, 录像, Stage::step 等), 在模拟线程上调用
+  using StepFn = std::function<void()>;
+
+  struct Config
+  {
+    double stepSeconds = 1.0 / 60.0; // 固定步长 (s)
+    bool paced = true;               // false 时不等待, 以最快速度模拟 (无窗口测试等)
+    std::uint32_t maxCatchUp = 2;    // 落后时连续追赶的最大步数, 超过后放弃落后的时间 (处理落)
+    std::uint64_t stepLimit = 0;     // 模拟到该步数后线程自行结束, 0 为不限
+  };
+
+public:
+  SimulationThread() = default;
+  ~SimulationThread();
+
+  SimulationThread(SimulationThread const&) = delete;
+  SimulationThread& operator=(SimulationThread const&) = delete;
+
+  // 发布 stage 的当前状态作为第一份数据, 然后启动模拟线程
+  void start(Stage& stage, Config const& config, StepFn step);
+  // 请求停止并等待模拟线程结束; 之后可以在调用线程上安全地访问 Stage
+  void stop();
+  // 模拟线程正在运行 (没有因 stop, stepLimit 或 step 抛出异常而结束)
+  bool isRunning() const noexcept { return m_running.load(std::memory_order_acquire); }
+
+  // 渲染线程: 取得最新发布的一份, 返回是否为上次调用之后新发布的; 返回的引用在下一次调用之前有效
+  FramePacket const& acquire(bool* fresh = nullptr) noexcept;
+
+  std::uint64_t getStepCount() const noexcept { return m_stepCount.load(std::memory_order_relaxed); }
+
+private:
+  void run();
+
+private:
+  Stage* m_stage = nullptr;
+  StepFn m_step;
+  Config m_config;
+  Core::TripleBuffer<FramePacket> m_packets;
+  FramePacketBuilder m_builder;
+
+  std::thread m_thread;
+  std::atomic<bool> m_stopRequested{ false };
+  std::atomic<bool> m_running{ false };
+  std::atomic<std::uint64_t> m_stepCount{ 0 };
+};
+} // namespace Game
@@ -0,0 +1,150 @@
+#include "SnapshotRing.hpp"
+#include "Core/BinaryStream.hpp"
+#include "Core/DeltaCodec.hpp"
+
+#include <utility>
+
+namespace Game {
+
+void SnapshotRing::init(Stage const& stage, std::size_t slotCount, Compression compression)
+{
+  m_compression = compression;
+  m_slots.assign(slotCount, {});
+  m_first = 0;
+  m_count = 0;
+
+  // 差分最坏情况下 (每个字都不同) 比完整数据多几个字节的游程头
+  std::size_t const bufferSize = stage.maxStateSize() + 64;
+  for (Slot& slot : m_slots) {
+    slot.data.reserve(bufferSize);
+  }
+  m_current.reserve(bufferSize);
+  m_scratch.reserve(bufferSize);
+}
+
+void SnapshotRing::clear() noexcept
+{
+  m_first = 0;
+  m_count = 0;
+}
+
+std::size_t SnapshotRing::findSlot(std::uint32_t frame) const noexcept
+{
+  // 回滚通常只回到最近几帧, 从最新的一份向前找
+  for (std::size_t k = m_count; k-- > 0;) {
+    if (m_slots[slotAt(k)].frame == frame) {
+      return k;
+    }
+  }
+  return npos;
+}
+
+void SnapshotRing::decodeInto(std::size_t k, std::vector<std::uint8_t>& out) const
+{
+  // 从最新的完整快照开始, 逐帧向前应用差分, 直到第 k 份
+  out.assign(m_slots[slotAt(m_count - 1)].data.begin(), m_slots[slotAt(m_count - 1)].data.end());
+  for (std::size_t j = m_count - 1; j-- > k;) {
+    Slot const& slot = m_slots[slotAt(j)];
+    Core::Delta::xorRleApply(slot.data, out, slot.rawSize);
+  }
+}
+
+void SnapshotRing::truncate(std::size_t keep)
+{
+  if (keep == 0) {
+    clear();
+    return;
+  }
+  if (keep < m_count) {
+    // 保留下来的最新一份必须是完整数据, 之后的差分才有基准
+    Slot& newest = m_slots[slotAt(keep - 1)];
+    if (newest.isDelta) {
+      decodeInto(keep - 1, m_scratch);
+      newest.data.swap(m_scratch);
+      newest.isDelta = false;
+    }
+    m_count = keep;
+  }
+}
+
+void SnapshotRing::push(Stage const& stage)
+{
+  if (m_slots.empty()) {
+    return;
+  }
+
+  std::uint32_t const frame = stage.getFrame();
+  m_current.clear();
+  Core::BinaryWriter writer(m_current);
+  stage.saveState(writer);
+
+  // 回滚后重新模拟: 丢弃不早于当前帧的快照
+  if (m_count > 0 && m_slots[slotAt(m_count - 1)].frame >= frame) {
+    std::size_t keep = m_count;
+    while (keep > 0 && m_slots[slotAt(keep - 1)].frame >= frame) {
+      --keep;
+    }
+    truncate(keep);
+  }
+
+  // 原来最新的一份改为相对新快照的差分
+  if (m_compression == Compression::XorRle && m_count > 0) {
+    Slot& previous = m_slots[slotAt(m_count - 1)];
+    Core::Delta::xorRleEncode(m_current, previous.data, m_scratch);
+    previous.data.swap(m_scratch);
+    previous.isDelta = true;
+  }
+
+  if (m_count == m_slots.size()) {
+    m_first = (m_first + 1) % m_slots.size(); // 覆盖最旧的一份, 它不是任何快照的差分基准
+    --m_count;
+  }
+  Slot& slot = m_slots[slotAt(m_count++)];
+  slot.frame = frame;
+  slot.isDelta = false;
+  slot.rawSize = m_current.size();
+  slot.data.swap(m_current); // 交换缓冲区, 两边的预留容量都保留下来
+}
+
+bool SnapshotRing::restore(Stage& stage, std::uint32_t frame)
+{
+  std::size_t const k = findSlot(frame);
+  if (k == npos) {
+    return false;
+  }
+
+  Slot& slot = m_slots[slotAt(k)];
+  if (slot.isDelta) {
+    decodeInto(k, m_scratch);
+    Core::BinaryReader reader(m_scratch);
+    stage.loadState(reader);
+    // 恢复出的完整数据直接作为该帧的快照, 之后的快照随之丢弃
+    slot.data.swap(m_scratch);
+    slot.isDelta = false;
+  } else {
+    Core::BinaryReader reader(slot.data);
+    stage.loadState(reader);
+  }
+  m_count = k + 1;
+  return true;
+}
+
+std::uint32_t SnapshotRing::getOldestFrame() const noexcept
+{
+  return m_count > 0 ? m_slots[slotAt(0)].frame : 0;
+}
+
+std::uint32_t SnapshotRing::getNewestFrame() const noexcept
+{
+  return m_count > 0 ? m_slots[slotAt(m_count - 1)].frame : 0;
+}
+
+std::size_t SnapshotRing::getStoredBytes() const noexcept
+{
+  std::size_t bytes = 0;
+  for (std::size_t k = 0; k < m_count; ++k) {
+    bytes += m_slots[slotAt(k)].data.size();
+  }
+  return bytes;
+}
+} // namespace Game
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Game/Stage.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Game {
+// 最近 N 帧的 Stage 状态快照环, 用于回滚联机与练习模式的倒带
+// 所有缓冲区在 init 时按最大状态大小预先分配, 之后每帧保存与恢复都不分配内存
+// 每份快照只包含弹幕池的有效部分 (见 BulletManager::saveState)
+//
+// 开启 XorRle 压缩时使用逆向差分: 最新的快照保存完整数据, 更早的快照保存与后一帧的 XOR / RLE 差分
+// 回滚通常只回到最近几帧, 恢复时从最新的快照向前逐帧应用差分; 最旧的快照被覆盖时不影响其余快照
+class SnapshotRing
+{
+public:
+  enum class Compression : std::uint8_t
+  {
+    None,   // 每份快照都是完整数据, 保存和恢复最快
+    XorRle, // 逆向 XOR / RLE 差分, 内存占用通常小得多, 保存和恢复多一次编解码
+  };
+
+public:
+  SnapshotRing() = default;
+  ~SnapshotRing() = default;
+
+  SnapshotRing(SnapshotRing const&) = delete;
+  SnapshotRing& operator=(SnapshotRing const&) = delete;
+
+  // 最多保存 slotCount 帧, 按 stage 的最大状态大小预分配
+  void init(Stage const& stage, std::size_t slotCount, Compression compression);
+  void clear() noexcept;
+
+  // 保存 stage 当前帧的快照; 环已满时覆盖最旧的一份
+  // 帧号不大于最新快照时 (回滚后重新模拟), 先丢弃该帧及之后的快照
+  void push(Stage const& stage);
+  // 把 stage 恢复到 frame 帧, 并丢弃该帧之后的快照; 该帧不在环中时返回 false, stage 不变
+  bool restore(Stage& stage, std::uint32_t frame);
+
+  bool contains(std::uint32_t frame) const noexcept { return findSlot(frame) != npos; }
+  std::size_t size() const noexcept { return m_count; }
+  std::uint32_t getOldestFrame() const noexcept; // 环为空时返回 0
+  std::uint32_t getNewestFrame() const noexcept; // 环为空时返回 0
+  std::size_t getStoredBytes() const noexcept;   // 当前所有快照数据的总字节数 (不含预留容量)
+
+private:
+  struct Slot
+  {
+    std::uint32_t frame = 0;
+    bool isDelta = false;    // data 为与后一帧的差分
+    std::size_t rawSize = 0; // 该帧完整状态的字节数
+    std::vector<std::uint8_t> data;
+  };
+
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  // 第 k 份快照 (0 为最旧) 在 m_slots 中的下标
+  std::size_t slotAt(std::size_t k) const noexcept { return (m_first + k) % m_slots.size(); }
+  // frame 帧对应的 k, 不存在时返回 npos
+  std::size_t findSlot(std::uint32_t frame) const noexcept;
+  // 解码出第 k 份快照的完整数据
+  void decodeInto(std::size_t k, std::vector<std::uint8_t>& out) const;
+  // 只保留最旧的 keep 份快照
+  void truncate(std::size_t keep);
+
+private:
+  std::vector<Slot> m_slots;
+  std::size_t m_first = 0; // 最旧一份快照的下标
+  std::size_t m_count = 0;
+  Compression m_compression = Compression::None;
+
+  std::vector<std::uint8_t> m_current; // 序列化当前帧的缓冲区
+  std::vector<std::uint8_t> m_scratch; // 编码差分 / 恢复时解码的缓冲区
+};
+} // namespace Game
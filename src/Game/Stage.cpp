@@ -0,0 +1,254 @@
+#include "Stage.hpp"
+#include "Core/BinaryStream.hpp"
+#include "Core/FastMath.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/Profiler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <numbers>
+
+namespace Game {
+
+void Stage::init(Config const& config, Core::JobSystem* jobSystem)
+{
+  m_config = config;
+  m_jobSystem = jobSystem;
+
+  m_bulletManager.init(config.bulletCapacity);
+  m_bulletManager.setJobSystem(jobSystem);
+
+  // 碰撞网格覆盖子弹的整个存活区域 (屏幕加上回收边距)
+  constexpr float margin = BulletManager::OFFSCREEN_MARGIN;
+  m_area = { .left = -margin, .right = config.width + margin, .top = -margin, .bottom = config.height + margin };
+  m_collisionGrid.setTypeTable(&m_typeTable);
+  m_collisionGrid.init(m_area, 32.0f, config.bulletCapacity);
+  m_laserManager.setTypeTable(&m_typeTable);
+  m_laserManager.init(LASER_CAPACITY, LASER_MAX_NODES);
+  m_collisionResults.resize(config.bulletCapacity);
+  // 道具只由消弹产生, 数量不会超过弹幕池容量
+  m_itemManager.init(config.bulletCapacity);
+  m_cancelX.resize(config.bulletCapacity);
+  m_cancelY.resize(config.bulletCapacity);
+
+  reset();
+}
+
+void Stage::reset()
+{
+  m_bulletManager.clearBullets();
+  m_laserManager.clear();
+  m_itemManager.clear();
+
+  // 自机初始位置在屏幕下方中央
+  m_player = { .x = m_config.width / 2.0f, .y = m_config.height * 0.85f, .hitRadius = 2.0f, .grazeRadius = 24.0f };
+  reseed(m_config.seed);
+  m_frame = 0;
+  m_spawnAngle = 0.0f;
+  m_spawnAngVel = 0.0f;
+  m_hitCount = 0;
+  m_grazeCount = 0;
+  m_itemCount = 0;
+  m_bombCooldown = 0;
+  m_lastButtons = 0;
+}
+
+void Stage::reseed(std::uint32_t seed) noexcept
+{
+  m_rng = Core::Random::Stream(seed, AIMED_STREAM);
+}
+
+void Stage::movePlayer(FrameInput const& input) noexcept
+{
+  float dx = 0.0f;
+  float dy = 0.0f;
+  dx += input.isDown(FrameInput::Right) ? 1.0f : 0.0f;
+  dx -= input.isDown(FrameInput::Left) ? 1.0f : 0.0f;
+  dy += input.isDown(FrameInput::Down) ? 1.0f : 0.0f;
+  dy -= input.isDown(FrameInput::Up) ? 1.0f : 0.0f;
+
+  float speed = input.isDown(FrameInput::Focus) ? PLAYER_FOCUS_SPEED : PLAYER_SPEED;
+  if (dx != 0.0f && dy != 0.0f) {
+    speed *= std::numbers::sqrt2_v<float> / 2.0f; // 斜向移动时保持速率不变
+  }
+  m_player.x = std::clamp(m_player.x + dx * speed, 0.0f, m_config.width);
+  m_player.y = std::clamp(m_player.y + dy * speed, 0.0f, m_config.height);
+}
+
+void Stage::fireLasers() noexcept
+{
+  // 从画面中央向四周发射一圈曲线激光, 相邻激光向相反方向弯曲
+  static constexpr int laserCount = 6;
+  static constexpr float turnRate = 0.012f;
+  for (int i = 0; i < laserCount; ++i) {
+    LaserParams const params{ .x = m_config.width / 2.0f,
+                              .y = m_config.height / 2.0f,
+                              .angle = m_spawnAngle + i * (2.0f * std::numbers::pi_v<float> / laserCount),
+                              .angVel = (i % 2 == 0) ? turnRate : -turnRate,
+                              .speed = 5.0f,
+                              .length = 120,
+                              .type = 3 };
+    m_laserManager.fire(params);
+  }
+}
+
+void Stage::cancelAroundPlayer(float radius, bool attracted)
+{
+  std::size_t const count =
+    m_bulletManager.cancelCircle(m_player.x, m_player.y, radius, m_cancelX.data(), m_cancelY.data());
+  m_itemManager.spawnBatch(m_cancelX.data(), m_cancelY.data(), count, ItemType::Cancel, attracted);
+}
+
+void Stage::step(FrameInput const& input)
+{
+  PROFILE_FUNCTION();
+
+  ++m_frame;
+  movePlayer(input);
+
+  // Bomb 在按下的瞬间触发, 消除自机周围的子弹, 转换成的道具直接飞向自机
+  bool const bombPressed = input.isDown(FrameInput::Bomb) && (m_lastButtons & FrameInput::Bomb) == 0;
+  m_lastButtons = input.buttons;
+  if (m_bombCooldown > 0) {
+    --m_bombCooldown;
+  } else if (bombPressed) {
+    m_bombCooldown = BOMB_COOLDOWN;
+    cancelAroundPlayer(BOMB_RADIUS, true);
+  }
+
+  static constexpr float spawnAngAccel = 0.001f;
+  m_spawnAngVel += spawnAngAccel; // 逐渐加速旋转
+  m_spawnAngle += m_spawnAngVel;
+  EmitParams params{ .x = m_config.width / 2.0f, .y = m_config.height / 2.0f, .speed = 8.0f };
+
+  // 每帧以环形发射 3 颗子弹, 相邻子弹间隔 120 度
+  m_bulletManager.emitRing(params, m_spawnAngle, 3);
+
+  // 定期朝自机方向发射一簇随机散布的子弹
+  if (m_frame % AIMED_INTERVAL == 0) {
+    float const aim = Core::Math::fastAtan2(m_player.y - params.y, m_player.x - params.x);
+    params.speed = 4.0f;
+    m_bulletManager.emitRandomSpread(params, aim, std::numbers::pi_v<float> / 6.0f, 2.0f, 16, m_rng);
+  }
+
+  if (m_frame % LASER_INTERVAL == LASER_INTERVAL / 2) {
+    fireLasers();
+  }
+
+  // 更新子弹与激光的位置, 并回收出界子弹与激光
+  auto const updateBullets = [this]() noexcept { m_bulletManager.update(m_config.width, m_config.height); };
+  auto const updateLasers = [this]() noexcept { m_laserManager.update(m_area); };
+
+  // 由存活子弹重建碰撞网格, 再做自机的被弹与擦弹查询
+  bool bulletHit = false;
+  std::size_t bulletGrazes = 0;
+  auto const collideBullets = [this, &bulletHit, &bulletGrazes]() noexcept {
+    m_collisionGrid.rebuild(m_bulletManager.getActiveBullets(), m_bulletManager.getActiveCount());
+    std::size_t const maxResults = m_collisionResults.size();
+    bulletHit = m_collisionGrid.queryHit(m_player, m_collisionResults.data(), maxResults) > 0;
+    bulletGrazes = m_collisionGrid.queryGraze(m_player, m_collisionResults.data(), maxResults);
+  };
+
+  // 激光按胶囊体判定, 每条激光每帧最多计一次
+  LaserContacts laserContacts{};
+  auto const collideLasers = [this, &laserContacts]() noexcept { laserContacts = m_laserManager.collide(m_player); };
+
+  // 子弹 (更新 -> 碰撞) 与激光 (更新 -> 判定) 两条链只访问各自的数据, 组成任务图并行执行, 结果与顺序执行相同
+  // 依赖计数器在依赖它的任务开始之前就不再被访问, 只需等待最后的 collided
+  if (m_jobSystem != nullptr) {
+    Core::JobCounter bulletsUpdated;
+    Core::JobCounter lasersUpdated;
+    Core::JobCounter collided;
+    m_jobSystem->run(bulletsUpdated, updateBullets);
+    m_jobSystem->run(lasersUpdated, updateLasers);
+    m_jobSystem->runAfter(bulletsUpdated, collided, collideBullets);
+    m_jobSystem->runAfter(lasersUpdated, collided, collideLasers);
+    m_jobSystem->wait(collided);
+  } else {
+    updateBullets();
+    updateLasers();
+    collideBullets();
+    collideLasers();
+  }
+  m_hitCount += bulletHit ? 1 : 0;
+  m_grazeCount += static_cast<int>(bulletGrazes);
+  m_hitCount += laserContacts.hits > 0 ? 1 : 0;
+  m_grazeCount += static_cast<int>(laserContacts.grazes);
+
+  // 被弹时消除自机周围的子弹, 转换成的道具自由下落
+  if (bulletHit || laserContacts.hits > 0) {
+    cancelAroundPlayer(HIT_CANCEL_RADIUS, false);
+  }
+
+  // 道具: 自机在收点线以上时收取全部道具, 落出画面底部的道具被回收
+  ItemCollector const collector{ .x = m_player.x,
+                                 .y = m_player.y,
+                                 .collectAll = m_player.y < m_config.height * COLLECT_LINE };
+  m_itemCount += static_cast<int>(m_itemManager.update(collector, m_config.height));
+}
+
+void Stage::saveState(Core::BinaryWriter& writer) const
+{
+  writer.write(m_frame);
+  writer.write(m_player);
+  writer.write(m_rng.getSeed());
+  writer.write(m_rng.getPosition());
+  writer.write(m_spawnAngle);
+  writer.write(m_spawnAngVel);
+  writer.write(m_hitCount);
+  writer.write(m_grazeCount);
+  writer.write(m_itemCount);
+  writer.write(m_bombCooldown);
+  writer.write(m_lastButtons);
+  m_bulletManager.saveState(writer);
+  m_laserManager.saveState(writer);
+  m_itemManager.saveState(writer);
+}
+
+void Stage::loadState(Core::BinaryReader& reader)
+{
+  m_frame = reader.read<std::uint32_t>();
+  m_player = reader.read<PlayerHitbox>();
+  std::uint64_t const rngSeed = reader.read<std::uint64_t>();
+  m_rng = Core::Random::Stream(rngSeed, AIMED_STREAM, reader.read<std::uint64_t>());
+  m_spawnAngle = reader.read<float>();
+  m_spawnAngVel = reader.read<float>();
+  m_hitCount = reader.read<int>();
+  m_grazeCount = reader.read<int>();
+  m_itemCount = reader.read<int>();
+  m_bombCooldown = reader.read<std::uint32_t>();
+  m_lastButtons = reader.read<std::uint16_t>();
+  m_bulletManager.loadState(reader);
+  m_laserManager.loadState(reader);
+  m_itemManager.loadState(reader);
+}
+
+std::size_t Stage::maxStateSize() const noexcept
+{
+  return sizeof(m_frame) + sizeof(m_player) + 2 * sizeof(std::uint64_t) + sizeof(m_spawnAngle) + sizeof(m_spawnAngVel) +
+         sizeof(m_hitCount) + sizeof(m_grazeCount) + sizeof(m_itemCount) + sizeof(m_bombCooldown) +
+         sizeof(m_lastButtons) + m_bulletManager.maxStateSize() + m_laserManager.maxStateSize() +
+         m_itemManager.maxStateSize();
+}
+
+std::uint64_t Stage::computeStateHash() const noexcept
+{
+  // 以弹幕, 激光与道具的哈希为初值, 继续混合其余状态 (64 位 FNV-1a)
+  std::uint64_t hash =
+    m_itemManager.computeStateHash(m_laserManager.computeStateHash(m_bulletManager.computeStateHash()));
+  auto const mix = [&hash](std::uint64_t word) { hash = (hash ^ word) * 0x0000'0100'0000'01B3ull; };
+  mix(m_frame);
+  mix(std::bit_cast<std::uint32_t>(m_player.x));
+  mix(std::bit_cast<std::uint32_t>(m_player.y));
+  mix(m_rng.getSeed());
+  mix(m_rng.getPosition());
+  mix(std::bit_cast<std::uint32_t>(m_spawnAngle));
+  mix(std::bit_cast<std::uint32_t>(m_spawnAngVel));
+  mix(static_cast<std::uint32_t>(m_hitCount));
+  mix(static_cast<std::uint32_t>(m_grazeCount));
+  mix(static_cast<std::uint32_t>(m_itemCount));
+  mix(m_bombCooldown);
+  mix(m_lastButtons);
+  return hash;
+}
+} // namespace Game
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "Core/Random.hpp"
+#include "Game/BulletManager.hpp"
+#include "Game/BulletPattern.hpp"
+#include "Game/BulletTypeTable.hpp"
+#include "Game/CollisionGrid.hpp"
+#include "Game/ItemManager.hpp"
+#include "Game/LaserManager.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Core {
+class JobSystem;
+class BinaryWriter;
+class BinaryReader;
+}
+
+namespace Game {
+// 一帧的玩家输入, 每个按键一位
+struct FrameInput
+{
+  enum Button : std::uint16_t
+  {
+    Up = 1 << 0,
+    Down = 1 << 1,
+    Left = 1 << 2,
+    Right = 1 << 3,
+    Shot = 1 << 4,
+    Bomb = 1 << 5,
+    Focus = 1 << 6, // 低速移动
+    Skip = 1 << 7,
+  };
+
+  std::uint16_t buttons = 0;
+
+  bool isDown(Button button) const noexcept { return (buttons & button) != 0; }
+
+  friend bool operator==(FrameInput const&, FrameInput const&) = default;
+};
+
+// 一局游戏的模拟状态: 弹幕, 自机, 随机数与计数器, 不依赖窗口和渲染器
+// 模拟只由初始配置, 随机数种子和逐帧输入决定, 因此可以录制回放并在无窗口的环境中快进
+class Stage
+{
+public:
+  struct Config
+  {
+    float width;                      // 画面宽度 (像素)
+    float height;                     // 画面高度 (像素)
+    std::size_t bulletCapacity;       // 弹幕池容量
+    std::uint32_t seed = 0x9E37'79B9; // 初始随机数种子, 为 0 时使用默认种子
+  };
+
+public:
+  Stage() = default;
+  ~Stage() = default;
+
+  Stage(Stage const&) = delete;
+  Stage& operator=(Stage const&) = delete;
+
+  // 分配全部内存并重置到第 0 帧; jobSystem 用于并行更新弹幕, 可以为 nullptr
+  void init(Config const& config, Core::JobSystem* jobSystem);
+  // 回到第 0 帧 (不重新分配内存)
+  void reset();
+  // 重新设置随机数种子, 影响之后所有的随机弹幕
+  void reseed(std::uint32_t seed) noexcept;
+
+  // 替换子弹类型表 (判定 / 擦弹半径参与模拟, 应在第 0 帧之前设置), 从下一帧起生效
+  void setBulletTypeTable(BulletTypeTable const& table) { m_typeTable = table; }
+
+  // 以 input 推进一帧
+  void step(FrameInput const& input);
+
+  // 序列化 / 恢复全部模拟状态, 恢复时配置 (容量等) 必须与保存时相同, 否则抛出 std::runtime_error
+  void saveState(Core::BinaryWriter& writer) const;
+  void loadState(Core::BinaryReader& reader);
+  // saveState 输出的最大字节数
+  std::size_t maxStateSize() const noexcept;
+  // 模拟状态的哈希, 用于比对两次运行 (如录制与回放) 是否一致
+  std::uint64_t computeStateHash() const noexcept;
+
+  Config const& getConfig() const noexcept { return m_config; }
+  std::uint32_t getFrame() const noexcept { return m_frame; } // 已经模拟的帧数
+  BulletManager const& getBulletManager() const noexcept { return m_bulletManager; }
+  BulletManager& getBulletManager() noexcept { return m_bulletManager; } // 供脚本等额外发射子弹
+  LaserManager const& getLaserManager() const noexcept { return m_laserManager; }
+  LaserManager& getLaserManager() noexcept { return m_laserManager; }
+  ItemManager const& getItemManager() const noexcept { return m_itemManager; }
+  BulletTypeTable const& getBulletTypeTable() const noexcept { return m_typeTable; }
+  PlayerHitbox const& getPlayer() const noexcept { return m_player; }
+  int getHitCount() const noexcept { return m_hitCount; }
+  int getGrazeCount() const noexcept { return m_grazeCount; }
+  int getItemCount() const noexcept { return m_itemCount; }
+
+public:
+  static constexpr float PLAYER_SPEED = 4.5f;         // 自机移动速率 (像素 / 帧)
+  static constexpr float PLAYER_FOCUS_SPEED = 2.0f;   // 低速移动时的速率
+  static constexpr std::uint32_t AIMED_INTERVAL = 60; // 自机狙随机弹的发射间隔 (帧)
+  static constexpr std::uint32_t AIMED_STREAM = 0;    // 自机狙随机弹的随机数流编号, 每个随机发射器各用一个
+  static constexpr std::uint32_t LASER_INTERVAL = 240; // 曲线激光的发射间隔 (帧)
+  static constexpr std::size_t LASER_CAPACITY = 64;    // 同时存在的激光数上限
+  static constexpr std::size_t LASER_MAX_NODES = 256;  // 每条激光的节点数上限
+  static constexpr std::uint32_t BOMB_COOLDOWN = 180;  // Bomb 的冷却时间 (帧)
+  static constexpr float BOMB_RADIUS = 240.0f;         // Bomb 消弹的半径
+  static constexpr float HIT_CANCEL_RADIUS = 96.0f;    // 被弹时消除自机周围子弹的半径
+  static constexpr float COLLECT_LINE = 0.25f;         // 自机高于画面的这个比例时收取全部道具
+
+private:
+  void movePlayer(FrameInput const& input) noexcept;
+  void fireLasers() noexcept;
+  // 消除以自机为圆心, 半径为 radius 的子弹并整批转换为道具; attracted 为 true 时道具直接飞向自机
+  void cancelAroundPlayer(float radius, bool attracted);
+
+private:
+  Config m_config{};
+  BulletBounds m_area{};                  // 子弹与激光的存活区域 (屏幕加上回收边距)
+  Core::JobSystem* m_jobSystem = nullptr; // 为空时单线程执行
+
+  BulletManager m_bulletManager;
+  LaserManager m_laserManager;
+  ItemManager m_itemManager;
+  BulletTypeTable m_typeTable; // 渲染与碰撞共用
+  CollisionGrid m_collisionGrid;
+  std::vector<std::uint32_t> m_collisionResults; // 碰撞查询结果缓冲区, 与弹幕池等长
+  std::vector<float> m_cancelX;                  // 消弹时被消除子弹的坐标, 与弹幕池等长
+  std::vector<float> m_cancelY;
+
+  // 以下为模拟状态, 由 saveState / loadState 保存和恢复
+  PlayerHitbox m_player{};
+  Core::Random::Stream m_rng; // 自机狙随机弹, 流编号为 AIMED_STREAM
+  std::uint32_t m_frame = 0;
+  float m_spawnAngle = 0.0f;  // 环形弹的当前朝向
+  float m_spawnAngVel = 0.0f; // 环形弹的旋转角速度, 逐渐加快
+  int m_hitCount = 0;         // 累计被弹次数
+  int m_grazeCount = 0;       // 累计擦弹判定数 (暂未去重, 同一颗子弹每帧都会计入)
+  int m_itemCount = 0;        // 累计收取的道具数
+  std::uint32_t m_bombCooldown = 0; // Bomb 剩余的冷却帧数
+  std::uint16_t m_lastButtons = 0;  // 上一帧的按键, 用于检测 Bomb 按下的瞬间
+};
+} // namespace Game
@@ -0,0 +1,113 @@
+#include "Trajectory.hpp"
+#include "Core/MathUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Game {
+
+namespace {
+// 设 n 帧的下标 k = 1..n 关于中点 c = (n + 1) / 2 对称, j = k - c, w 为每帧转过的角度
+// D = Σ cos(j w) = sin(n w / 2) / sin(w / 2)
+// E = Σ j sin(j w) = -dD/dw
+// 当 n w 很小时闭式解有严重的相消误差, 改用按 w 展开的级数 (用到对称下标的偶次幂和)
+struct ArcSums
+{
+  double d;
+  double e;
+};
+
+ArcSums arcSums(double n, double w) noexcept
+{
+  double const h = w * 0.5;
+  if (std::abs(n * h) < 0.05) {
+    double const n2 = n * n;
+    double const sum2 = n * (n2 - 1.0) / 12.0;                                        // Σ j^2
+    double const sum4 = n * (n2 - 1.0) * (3.0 * n2 - 7.0) / 240.0;                    // Σ j^4
+    double const sum6 = n * (n2 - 1.0) * (3.0 * n2 * n2 - 18.0 * n2 + 31.0) / 1344.0; // Σ j^6
+    double const w2 = w * w;
+    return { .d = n - w2 * sum2 / 2.0 + w2 * w2 * sum4 / 24.0 - w2 * w2 * w2 * sum6 / 720.0,
+             .e = w * (sum2 - w2 * sum4 / 6.0 + w2 * w2 * sum6 / 120.0) };
+  }
+
+  double const sinH = std::sin(h);
+  double const cosH = std::cos(h);
+  double const sinNH = std::sin(n * h);
+  double const cosNH = std::cos(n * h);
+  // dD/dh = (n cos(nh) sin(h) - sin(nh) cos(h)) / sin(h)^2, dw = 2 dh
+  return { .d = sinNH / sinH, .e = -(n * cosNH * sinH - sinNH * cosH) / (sinH * sinH) * 0.5 };
+}
+} // namespace
+
+TrajectoryState Trajectory::evaluate(std::uint32_t frames) const noexcept
+{
+  // 第 k 帧 (k = 1..n) 的速率为 s0 + k t, 角度为 a0 + k w, 位移为两者之积的和:
+  // p(n) = p0 + Σ (s0 + k t) e^{i (a0 + k w)}
+  //      = p0 + e^{i (a0 + c w)} [ (s0 + c t) D + i t E ]
+  double const n = frames;
+  double const w = angVel;
+  double const t = tanAccel;
+  double const c = (n + 1.0) * 0.5;
+  ArcSums const sums = arcSums(n, w);
+
+  double const radial = (speed0 + c * t) * sums.d; // 沿中间时刻方向的分量
+  double const lateral = t * sums.e;               // 垂直于中间时刻方向的分量
+  // 直线运动每帧的方向都是同一个查表值, 直接用它, 结果与逐帧积分只差舍入误差
+  // 转弯时方向逐帧落在不同的表项上, 用精确的三角函数, 与逐帧积分相差查表误差 (每帧方向最多偏一个表项间隔)
+  double const phase = angle0 + c * w;
+  double const cosP = isStraight() ? Core::Math::cos(angle0) : std::cos(phase);
+  double const sinP = isStraight() ? Core::Math::sin(angle0) : std::sin(phase);
+
+  return { .x = static_cast<float>(x0 + radial * cosP - lateral * sinP),
+           .y = static_cast<float>(y0 + radial * sinP + lateral * cosP),
+           .angle = static_cast<float>(angle0 + n * w),
+           .speed = static_cast<float>(speed0 + n * t) };
+}
+
+std::uint32_t Trajectory::exitFrames(BulletBounds const& bounds) const noexcept
+{
+  // 只处理单调远离发射点的直线运动, 其余情况 (转弯, 减速折返) 交给周期性的出界扫描
+  if (!isStraight() || speed0 < 0.0f || tanAccel < 0.0f || (speed0 == 0.0f && tanAccel == 0.0f)) {
+    return NEVER;
+  }
+  if (x0 < bounds.left || x0 > bounds.right || y0 < bounds.top || y0 > bounds.bottom) {
+    return 1; // 已经在界外, 下一帧即回收
+  }
+
+  // 沿运动方向 (与 evaluate 相同, 取查表值) 到达边界所需的路程
+  double const dirX = Core::Math::cos(angle0);
+  double const dirY = Core::Math::sin(angle0);
+  double limit = std::numeric_limits<double>::infinity();
+  if (dirX > 0.0) {
+    limit = std::min(limit, (bounds.right - x0) / dirX);
+  } else if (dirX < 0.0) {
+    limit = std::min(limit, (bounds.left - x0) / dirX);
+  }
+  if (dirY > 0.0) {
+    limit = std::min(limit, (bounds.bottom - y0) / dirY);
+  } else if (dirY < 0.0) {
+    limit = std::min(limit, (bounds.top - y0) / dirY);
+  }
+
+  // n 帧的路程 L(n) = n s0 + t n (n + 1) / 2 单调递增, 求使 L(n) > limit 的最小 n
+  double const s = speed0;
+  double const t = tanAccel;
+  auto const distance = [s, t](double n) { return n * s + t * n * (n + 1.0) * 0.5; };
+  double n = 0.0;
+  if (t == 0.0) {
+    n = std::floor(limit / s) + 1.0;
+  } else {
+    double const b = s + t * 0.5;
+    n = std::floor((-b + std::sqrt(b * b + 2.0 * t * limit)) / t) + 1.0;
+  }
+  // 修正浮点求根可能带来的一帧偏差
+  while (n > 1.0 && distance(n - 1.0) > limit) {
+    n -= 1.0;
+  }
+  while (distance(n) <= limit) {
+    n += 1.0;
+  }
+  return n >= static_cast<double>(NEVER) ? NEVER : static_cast<std::uint32_t>(n);
+}
+} // namespace Game
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Game/Bullet.hpp"
+#include "Game/BulletKernel.hpp"
+
+#include <cstdint>
+
+namespace Game {
+// 某一时刻的运动状态
+struct TrajectoryState
+{
+  float x = 0;
+  float y = 0;
+  float angle = 0;
+  float speed = 0;
+};
+
+// 解析运动模型: 由发射时的状态和经过的帧数以 O(1) 直接求出位置, 不需要逐帧积分
+// 适用于角加速度为 0 的子弹, 即匀速直线, 切向匀加速直线, 以及匀角速度的圆弧 / 螺旋线
+// 给出的是 Bullet::updatePosition 这一离散递推在实数意义下的精确和 (而非连续运动的积分)
+// 直线运动使用与逐帧积分相同的查表方向, 两者只差舍入误差; 转弯时还有三角函数查表误差,
+// 每帧的方向最多偏差一个表项间隔 (2pi / 1024), 位置偏差不超过路程的约 0.6% (TrajectoryBench 检查)
+struct Trajectory
+{
+  float x0 = 0;       // 发射位置
+  float y0 = 0;       // 发射位置
+  float angle0 = 0;   // 发射角度
+  float speed0 = 0;   // 初始速率
+  float angVel = 0;   // 角速度 (常量)
+  float tanAccel = 0; // 切向加速度 (常量)
+
+  // 子弹是否可以用解析模型描述 (角加速度为 0)
+  static bool isAnalytic(Bullet const& bullet) noexcept { return bullet.angAccel == 0.0f; }
+  // 由子弹当前状态构造, 调用者保证 isAnalytic(bullet)
+  static Trajectory fromBullet(Bullet const& bullet) noexcept
+  {
+    return { bullet.x, bullet.y, bullet.angle, bullet.speed, bullet.angVel, bullet.tanAccel };
+  }
+
+  // 是否为直线运动 (角速度为 0), 直线运动可以解析地求出出界时刻
+  bool isStraight() const noexcept { return angVel == 0.0f; }
+
+  // 经过 frames 帧 (即调用 frames 次 updatePosition) 之后的状态
+  TrajectoryState evaluate(std::uint32_t frames) const noexcept;
+
+  // 直线运动的出界帧数: 经过返回值帧后位置第一次超出 bounds; 永远不会出界, 或者不是单调远离发射点的直线运动时返回 NEVER
+  static constexpr std::uint32_t NEVER = 0xFFFF'FFFF;
+  std::uint32_t exitFrames(BulletBounds const& bounds) const noexcept;
+};
+} // namespace Game
@@ -1,5 +1,6 @@
 #include "DX11Device.hpp"
 #include "Core/Logger.hpp"
+#include "Core/Profiler.hpp"
 
 namespace Graphics {
 DX11Device::DX11Device(HWND hWnd, int width, int height, bool vsync)
@@ -86,6 +87,8 @@ void DX11Device::clear(float r, float g, float b, float a)
 
 void DX11Device::present()
 {
+  PROFILE_FUNCTION();
+
   // 将后台缓冲区内容翻转到前台显示, 参数 1 表示启用垂直同步 (VSync), 0 表示关闭 VSync, 显卡能跑多快就跑多快
   HRESULT hr = m_swapChain->Present(m_vsync, 0);
   // Present 可能在某些极端情况失败, 例如设备丢失 (Device Lost), 这时需要重新创建设备和交换链, 目前先简单抛出异常
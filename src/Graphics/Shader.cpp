@@ -57,7 +57,7 @@ Microsoft::WRL::ComPtr<ID3DBlob> ShaderCompiler::compile(std::string const& file
   // 读取 HLSL 文件内容
   std::ifstream file(filename, std::ios::binary | std::ios::ate); // HLSL 文件
   if (!file.is_open()) {
-    LOG_ERROR("Failed to open shader file: " + filename);
+    LOG_ERROR("Failed to open shader file: {}", filename);
     throw std::runtime_error("Shader file not found");
   }
   std::streamsize size = file.tellg();
@@ -90,7 +90,7 @@ Microsoft::WRL::ComPtr<ID3DBlob> ShaderCompiler::compile(std::string const& file
   if (FAILED(hr)) {
     if (errorBlob) {
       std::string errorMsg = static_cast<char*>(errorBlob->GetBufferPointer());
-      LOG_ERROR(std::format("Shader compilation error in {}: \n{}", filename, errorMsg));
+      LOG_ERROR("Shader compilation error in {}: \n{}", filename, errorMsg);
     } else {
       LOG_DX11_CHECK(hr,
                      std::format("Shader compilation error in {}: D3DCompile failed with unknown error.", filename));
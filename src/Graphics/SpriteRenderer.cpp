@@ -1,10 +1,21 @@
 #include "SpriteRenderer.hpp"
 
+#include "Core/FastMath.hpp"
 #include "Core/Logger.hpp"
+#include "Core/Metrics.hpp"
+#include "Core/Profiler.hpp"
 #include "Vertex.hpp"
 
 namespace Graphics {
 
+namespace {
+// 由渲染线程在每次渲染后结束一帧 (见 Application::recordFrameMetrics)
+Core::Counter const drawCallMetric("render.drawCalls", Core::Metrics::Timeline::Render);
+Core::Counter const instanceMetric("render.instances", Core::Metrics::Timeline::Render);
+// 每帧上传到实例缓冲区的字节数
+Core::Counter const instanceBytesMetric("render.instanceBytes", Core::Metrics::Timeline::Render);
+} // namespace
+
 SpriteRenderer::SpriteRenderer(DX11Device* device)
   : m_device(device)
 {
@@ -41,6 +52,7 @@ void SpriteRenderer::begin()
   // 开始新的一帧, 清空实例数据和当前绑定的贴图
   m_instances.clear();
   m_currentTexture = nullptr;
+  m_currentBlend = BlendMode::Alpha;
 
   auto context = m_device->getContext();
 
@@ -52,8 +64,6 @@ void SpriteRenderer::begin()
   context->RSSetState(m_rasterizerState.Get());
   // 把采样器绑定到像素着色器 (PS) 的第 0 号槽位
   context->PSSetSamplers(0, 1, m_samplerState.GetAddressOf());
-  // 绑定混合状态, nullptr 表示不使用混合因子常量, 0xffffffff 表示所有多重采样遮罩全开
-  context->OMSetBlendState(m_blendState.Get(), nullptr, 0xffffffff);
   // 拓扑结构: 告诉 GPU 传来的是一系列三角形
   context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
@@ -75,15 +85,28 @@ void SpriteRenderer::end()
 }
 
 void SpriteRenderer::drawSprite(Texture* texture, float x, float y, float angle, float scaleX, float scaleY)
+{
+  drawSprite(texture, x, y, angle, scaleX, scaleY, SpriteRegion{}, BlendMode::Alpha);
+}
+
+void SpriteRenderer::drawSprite(Texture* texture,
+                                float x,
+                                float y,
+                                float angle,
+                                float scaleX,
+                                float scaleY,
+                                SpriteRegion const& region,
+                                BlendMode blend)
 {
   if (!texture) {
     return;
   }
 
-  // 核心批处理逻辑: 如果我们换了一张贴图, 或者 m_instances 已经塞满了, 立刻把现有的货物发走 (flush)，然后再装新货
-  if (texture != m_currentTexture || m_instances.size() >= m_maxInstances) {
+  // 核心批处理逻辑: 如果我们换了一张贴图或混合方式, 或者 m_instances 已经塞满了, 立刻把现有的货物发走 (flush)，然后再装新货
+  if (texture != m_currentTexture || blend != m_currentBlend || m_instances.size() >= m_maxInstances) {
     flush();
     m_currentTexture = texture;
+    m_currentBlend = blend;
   }
 
   // 悄悄把数据塞进 vector, 先不呼叫 GPU
@@ -92,16 +115,58 @@ void SpriteRenderer::drawSprite(Texture* texture, float x, float y, float angle,
   data.scale = { scaleX, scaleY };
   data.rotation = angle;
   data.color = { 1.0f, 1.0f, 1.0f, 1.0f }; // 默认白色 (原图颜色)
+  data.uvRect = { region.u0, region.v0, region.u1, region.v1 };
 
   m_instances.push_back(data);
 }
 
+void SpriteRenderer::drawStrip(Texture* texture,
+                               float const* x,
+                               float const* y,
+                               std::size_t count,
+                               float width,
+                               SpriteRegion const& region,
+                               BlendMode blend)
+{
+  if (!texture || count < 2) {
+    return;
+  }
+
+  // 整条带放不进当前批次时先提交, 使一条带只对应一次实例化绘制
+  std::size_t const segments = count - 1;
+  if (texture != m_currentTexture || blend != m_currentBlend ||
+      m_instances.size() + std::min(segments, m_maxInstances) > m_maxInstances) {
+    flush();
+    m_currentTexture = texture;
+    m_currentBlend = blend;
+  }
+
+  float const uStep = (region.u1 - region.u0) / static_cast<float>(segments);
+  for (std::size_t i = 0; i < segments; ++i) {
+    if (m_instances.size() >= m_maxInstances) {
+      flush(); // 超长的带只能拆成多批
+    }
+    float const dx = x[i + 1] - x[i];
+    float const dy = y[i + 1] - y[i];
+
+    // 每段是一个沿线段方向旋转的矩形, 长度略微加长, 盖住折线拐角处的缝隙
+    InstanceData data;
+    data.position = { (x[i] + x[i + 1]) * 0.5f, (y[i] + y[i + 1]) * 0.5f };
+    data.scale = { Core::Math::fastHypot(dx, dy) + 1.0f, width };
+    data.rotation = Core::Math::fastAtan2(dy, dx);
+    data.color = { 1.0f, 1.0f, 1.0f, 1.0f };
+    float const u = region.u0 + uStep * static_cast<float>(i);
+    data.uvRect = { u, region.v0, u + uStep, region.v1 };
+    m_instances.push_back(data);
+  }
+}
+
 void SpriteRenderer::initShaders()
 {
   // 检测文件是否存在
   std::filesystem::path shaderPath = std::filesystem::current_path() / "assets/shaders/Sprite.hlsl";
   if (!std::filesystem::exists(shaderPath)) {
-    LOG_ERROR("Shader file missing: " + shaderPath.string());
+    LOG_ERROR("Shader file missing: {}", shaderPath.string());
     throw std::runtime_error("Shader file missing.");
   }
 
@@ -128,7 +193,8 @@ void SpriteRenderer::initShaders()
       1,
       D3D11_APPEND_ALIGNED_ELEMENT,
       D3D11_INPUT_PER_INSTANCE_DATA,
-      1 }
+      1 },
+    { "INST_UV", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 }
   };
   m_inputLayout = std::make_unique<InputLayout>(m_device->getDevice(), layoutDesc, vsBytecode.Get());
 }
@@ -241,12 +307,21 @@ void SpriteRenderer::initStates()
   // 允许写入所有颜色通道
   blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
 
-  hr = m_device->getDevice()->CreateBlendState(&blendDesc, m_blendState.GetAddressOf());
+  hr = m_device->getDevice()->CreateBlendState(
+    &blendDesc, m_blendStates[static_cast<std::size_t>(BlendMode::Alpha)].GetAddressOf());
   LOG_DX11_CHECK(hr, "Failed to create Blend State.");
+
+  // 加法混合: 最终颜色 = (贴图颜色 * 贴图Alpha) + 背景颜色
+  blendDesc.RenderTarget[0].DestBlend = D3D11_BLEND_ONE;
+  hr = m_device->getDevice()->CreateBlendState(
+    &blendDesc, m_blendStates[static_cast<std::size_t>(BlendMode::Additive)].GetAddressOf());
+  LOG_DX11_CHECK(hr, "Failed to create additive Blend State.");
 }
 
 void SpriteRenderer::flush()
 {
+  PROFILE_FUNCTION();
+
   if (m_instances.empty() || !m_currentTexture) {
     return;
   }
@@ -270,12 +345,18 @@ void SpriteRenderer::flush()
 
   context->IASetIndexBuffer(m_indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
 
+  // 绑定当前批次的混合状态, nullptr 表示不使用混合因子常量, 0xffffffff 表示所有多重采样遮罩全开
+  context->OMSetBlendState(m_blendStates[static_cast<std::size_t>(m_currentBlend)].Get(), nullptr, 0xffffffff);
+
   // 绑定当前批次的贴图
   ID3D11ShaderResourceView* srvs[] = { m_currentTexture->getSRV() };
   context->PSSetShaderResources(0, 1, srvs);
 
   // 参数: 每个实例的索引数(6), 实例总数, 起始索引(0), 顶点起始偏移(0), 实例起始偏移(0)
   context->DrawIndexedInstanced(6, static_cast<UINT>(m_instances.size()), 0, 0, 0);
+  drawCallMetric.add();
+  instanceMetric.add(m_instances.size());
+  instanceBytesMetric.add(sizeof(InstanceData) * m_instances.size());
 
   // 货物送达, 清空车厢, 准备装下一批货物
   m_instances.clear();
@@ -15,6 +15,23 @@ struct TransformCBuffer
   DirectX::XMFLOAT4X4 projection; // 投影矩阵
 };
 
+// 混合方式, 切换时需要结束当前批次
+enum class BlendMode : std::uint8_t
+{
+  Alpha,    // 最终颜色 = 贴图颜色 * 贴图Alpha + 背景颜色 * (1 - 贴图Alpha)
+  Additive, // 最终颜色 = 贴图颜色 * 贴图Alpha + 背景颜色, 用于发光效果
+  Count
+};
+
+// 贴图中的矩形区域, 归一化纹理坐标
+struct SpriteRegion
+{
+  float u0 = 0.0f;
+  float v0 = 0.0f;
+  float u1 = 1.0f;
+  float v1 = 1.0f;
+};
+
 class SpriteRenderer
 {
 public:
@@ -34,6 +51,24 @@ public:
 
   // x, y 屏幕像素坐标, angle 弧度, scaleX/Y 宽高像素大小
   void drawSprite(Texture* texture, float x, float y, float angle, float scaleX, float scaleY);
+  // 只绘制贴图中的 region 区域 (图集), 贴图或混合方式与当前批次不同时先提交当前批次
+  void drawSprite(Texture* texture,
+                  float x,
+                  float y,
+                  float angle,
+                  float scaleX,
+                  float scaleY,
+                  SpriteRegion const& region,
+                  BlendMode blend);
+  // 沿折线 (x[i], y[i]) 绘制一条宽度为 width 的带 (曲线激光等), 每段一个实例, 整条带在同一批次中
+  // 贴图的 u 方向沿折线从头到尾铺开, v 方向横跨带宽
+  void drawStrip(Texture* texture,
+                 float const* x,
+                 float const* y,
+                 std::size_t count,
+                 float width,
+                 SpriteRegion const& region,
+                 BlendMode blend);
 
 private:
   void initShaders();
@@ -57,7 +92,7 @@ private:
 
   Microsoft::WRL::ComPtr<ID3D11RasterizerState> m_rasterizerState; // 光栅化状态
   Microsoft::WRL::ComPtr<ID3D11SamplerState> m_samplerState;       // 采样器状态
-  Microsoft::WRL::ComPtr<ID3D11BlendState> m_blendState;           // 混合状态
+  Microsoft::WRL::ComPtr<ID3D11BlendState> m_blendStates[static_cast<std::size_t>(BlendMode::Count)]; // 按混合方式索引
 
   // 缓存的投影矩阵 (只要窗口大小不变, 投影矩阵就不变)
   DirectX::XMFLOAT4X4 m_projectionMatrix;
@@ -65,6 +100,7 @@ private:
   // 批处理数据
   std::vector<InstanceData> m_instances; // 存储当前帧所有待渲染的 Sprite 实例数据
   Texture* m_currentTexture = nullptr;   // 当前批次使用的贴图
+  BlendMode m_currentBlend = BlendMode::Alpha; // 当前批次使用的混合方式
   std::size_t m_maxInstances = 20000;    // 最大 Sprite 实例数量
 };
 } // namespace Graphics
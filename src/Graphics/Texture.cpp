@@ -7,14 +7,14 @@ namespace Graphics {
 
 Texture::Texture(DX11Device* device, std::string const& filePath)
 {
-  LOG_INFO("Loading texture: " + filePath);
+  LOG_INFO("Loading texture: {}", filePath);
 
   int channels;
 
   // CPU 解码
   auto pixels = stbi_load(filePath.c_str(), &m_width, &m_height, &channels, STBI_rgb_alpha);
   if (!pixels) {
-    LOG_ERROR("Failed to load image: " + filePath);
+    LOG_ERROR("Failed to load image: {}", filePath);
     throw std::runtime_error("Failed to load image.");
   }
 
@@ -22,5 +22,6 @@ struct InstanceData
   DirectX::XMFLOAT2 scale;    // 8 bytes
   float rotation;             // 4 bytes
   DirectX::XMFLOAT4 color;    // 16 bytes, RGBA 颜色, 每个分量范围 [0, 1]
+  DirectX::XMFLOAT4 uvRect;   // 16 bytes, 贴图区域 (u0, v0, u1, v1), 用于从图集中取出一个精灵
 };
 } // namespace Graphics
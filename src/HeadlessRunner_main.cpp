@@ -0,0 +1,201 @@
+#include "Core/JobSystem.hpp"
+#include "Core/Logger.hpp"
+#include "Core/Metrics.hpp"
+#include "Core/Profiler.hpp"
+#include "Core/Timer.hpp"
+#include "Game/BulletTypeTable.hpp"
+#include "Game/Replay.hpp"
+#include "Game/Stage.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 无窗口的模拟运行器: 不创建窗口与图形设备, 按 Application 的方式初始化关卡, 并像 Application::update 一样逐帧推进
+// 只依赖 Game 与 Core 的平台无关部分, 可以用 GCC / Clang 在 Linux 上构建, 用于在服务器上做性能测试
+// 参数: --frames N        模拟的帧数 (默认 3600, 即 60 秒)
+//       --workers N       线程池的工作线程数 (默认按 CPU 核数)
+//       --pin             把工作线程固定在各自的逻辑处理器上
+//       --replay <file>   按录像中的输入模拟整段录像 (忽略 --frames), 检查点的状态哈希不一致时返回 1
+//       --metrics <file>  导出逐帧指标 (.json 为 JSON, 否则为 CSV)
+//       --profile <file>  写出 Chrome trace (需以 TOUHOU_PROFILE 构建)
+// 没有录像时的输入是固定的脚本: 一直按住射击, 每 2 秒换一次左右移动的方向
+
+namespace {
+struct Options
+{
+  std::uint32_t frames = 3600;
+  std::size_t workers = 0;
+  bool pinned = false;
+  std::string replayPath;
+  std::string metricsPath;
+  std::string profilePath;
+};
+
+Core::Gauge const stepTimeMetric("stage.stepMs");
+
+Options parseOptions(int argc, char* argv[])
+{
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view const arg = argv[i];
+    if (arg == "--pin") {
+      options.pinned = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      break;
+    }
+    if (arg == "--frames") {
+      options.frames = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+    } else if (arg == "--workers") {
+      options.workers = static_cast<std::size_t>(std::stoul(argv[++i]));
+    } else if (arg == "--replay") {
+      options.replayPath = argv[++i];
+    } else if (arg == "--metrics") {
+      options.metricsPath = argv[++i];
+    } else if (arg == "--profile") {
+      options.profilePath = argv[++i];
+    }
+  }
+  return options;
+}
+
+Game::FrameInput scriptedInput(std::uint32_t frame) noexcept
+{
+  Game::FrameInput input{};
+  input.buttons = Game::FrameInput::Shot;
+  input.buttons |= (frame / 120) % 2 == 0 ? Game::FrameInput::Left : Game::FrameInput::Right;
+  return input;
+}
+
+double percentile(std::vector<double> const& sorted, double p) noexcept
+{
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  std::size_t const rank = static_cast<std::size_t>(p / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+  return sorted[rank];
+}
+
+int run(Options const& options)
+{
+  std::optional<Game::Replay> replay;
+  if (!options.replayPath.empty()) {
+    replay = Game::Replay::loadFromFile(options.replayPath);
+  }
+
+  // 与 Application 相同的关卡配置; 有录像时使用录像中的配置
+  Game::Stage::Config const stageConfig =
+    replay ? replay->config : Game::Stage::Config{ .width = 1280.0f, .height = 960.0f, .bulletCapacity = 20000 };
+  using Affinity = Core::JobSystem::Affinity;
+  Core::JobSystem jobSystem(
+    { .workerCount = options.workers, .affinity = options.pinned ? Affinity::Pinned : Affinity::None });
+  Game::Stage stage;
+  stage.init(stageConfig, &jobSystem);
+
+  // 子弹类型表影响判定半径, 与 Application 一样从当前目录加载, 不存在时使用默认样式
+  auto const tablePath = std::filesystem::current_path() / "assets/data/bullet_types.bin";
+  if (std::filesystem::exists(tablePath)) {
+    Game::BulletTypeTable table;
+    table.loadFromFile(tablePath.string());
+    stage.setBulletTypeTable(table);
+  } else {
+    LOG_WARN("Bullet type table missing, using default style: {}", tablePath.string());
+  }
+
+  std::unique_ptr<Game::ReplayPlayer> player;
+  std::uint32_t frames = options.frames;
+  if (replay) {
+    player = std::make_unique<Game::ReplayPlayer>(*replay);
+    player->reset(stage);
+    frames = replay->frameCount;
+  }
+
+  PROFILE_THREAD_NAME("Main");
+  if (!options.profilePath.empty()) {
+#if defined(TOUHOU_PROFILE)
+    Core::Profiler::beginCapture();
+#else
+    LOG_WARN("Built without TOUHOU_PROFILE, profiling is unavailable.");
+#endif
+  }
+
+  std::vector<double> stepMs;
+  stepMs.reserve(frames);
+  std::size_t peakBullets = 0;
+  double const msPerCount = Core::Timer::getSecondsPerCount() * 1000.0;
+  std::int64_t const runStart = Core::Timer::getCounter();
+  for (std::uint32_t frame = 0; frame < frames; ++frame) {
+    PROFILE_FRAME();
+    std::int64_t const start = Core::Timer::getCounter();
+    if (player) {
+      player->runTo(stage, stage.getFrame() + 1);
+    } else {
+      stage.step(scriptedInput(frame));
+    }
+    double const ms = static_cast<double>(Core::Timer::getCounter() - start) * msPerCount;
+    stepMs.push_back(ms);
+    stepTimeMetric.set(ms);
+    Core::Metrics::endFrame();
+    peakBullets = std::max(peakBullets, stage.getBulletManager().getActiveCount());
+  }
+  double const totalMs = static_cast<double>(Core::Timer::getCounter() - runStart) * msPerCount;
+
+  if (Core::Profiler::isCapturing()) {
+    Core::Profiler::writeChromeTrace(options.profilePath);
+  }
+  if (!options.metricsPath.empty()) {
+    if (options.metricsPath.ends_with(".json")) {
+      Core::Metrics::writeJson(options.metricsPath);
+    } else {
+      Core::Metrics::writeCsv(options.metricsPath);
+    }
+  }
+
+  double mean = 0.0;
+  for (double const ms : stepMs) {
+    mean += ms;
+  }
+  mean /= std::max<std::size_t>(stepMs.size(), 1);
+  std::sort(stepMs.begin(), stepMs.end());
+
+  std::cout << std::format(
+    "== {} frames, {} threads, peak {} bullets ==\n", stepMs.size(), jobSystem.getThreadCount(), peakBullets);
+  std::cout << std::format("sim ms/frame  mean {:>8.4f}  p50 {:>8.4f}  p90 {:>8.4f}  p99 {:>8.4f}  max {:>8.4f}\n",
+                           mean,
+                           percentile(stepMs, 50.0),
+                           percentile(stepMs, 90.0),
+                           percentile(stepMs, 99.0),
+                           stepMs.empty() ? 0.0 : stepMs.back());
+  std::cout << std::format("total {:.2f} ms ({:.1f}x real time at 60 fps)\n",
+                           totalMs,
+                           totalMs > 0.0 ? stepMs.size() * (1000.0 / 60.0) / totalMs : 0.0);
+  std::cout << std::format("final frame {}, state hash {:016X}\n", stage.getFrame(), stage.computeStateHash());
+
+  if (player && player->getDesyncCount() != 0) {
+    std::cout << std::format("{} desyncs against replay checkpoints\n", player->getDesyncCount());
+    return 1;
+  }
+  return 0;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  try {
+    return run(parseOptions(argc, argv));
+  } catch (std::exception const& e) {
+    LOG_FATAL(e.what());
+    return -1;
+  }
+}
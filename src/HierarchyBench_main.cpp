@@ -0,0 +1,247 @@
+#include "Core/MathUtils.hpp"
+#include "Core/Simd.hpp"
+#include "Game/BulletHierarchy.hpp"
+#include "Game/BulletPattern.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <numbers>
+#include <vector>
+
+// 层级弹幕的开销测量: 50 个旋转的发射器, 每个挂 100 个公转的使魔 (共 5000 组), 每个使魔挂 20 颗公转的子弹 (共 10 万颗)
+// 1. 逐层 SoA 解算与逐颗递归查找父节点的对比, 并逐位比对两者的结果
+// 2. 每帧击杀并补充 1% 的使魔 (子弹随之死亡) 时的开销
+// 3. 一次击杀全部发射器, 使魔脱离成为根节点时的开销
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double elapsedMicros(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+constexpr float ScreenWidth = 1280.0f;
+constexpr float ScreenHeight = 960.0f;
+constexpr std::size_t EmitterCount = 50;
+constexpr std::size_t FamiliarsPerEmitter = 100;
+constexpr std::size_t BulletsPerFamiliar = 20;
+constexpr std::size_t NodeCount =
+  EmitterCount * (1 + FamiliarsPerEmitter * (1 + BulletsPerFamiliar)); // 50 + 5000 + 100000
+constexpr std::size_t ChurnPerFrame = 50;                              // 每帧击杀并补充的使魔数 (1%)
+constexpr int Frames = 300;
+
+// 足够大的存活区域, 只测量解算本身, 不让节点出界
+constexpr Game::BulletBounds Bounds{ .left = -1.0e6f, .right = 1.0e6f, .top = -1.0e6f, .bottom = 1.0e6f };
+
+Game::HierarchyNodeParams emitterParams(std::size_t e)
+{
+  return { .x = ScreenWidth * (static_cast<float>(e % 10) + 0.5f) / 10.0f,
+           .y = ScreenHeight * (static_cast<float>(e / 10) + 0.5f) / 5.0f,
+           .spinVel = 0.01f,
+           .flags = Game::BulletHierarchy::FLAG_HIDDEN };
+}
+
+Game::HierarchyNodeParams familiarParams(std::uint16_t flags)
+{
+  return { .radius = 48.0f, .angVel = 0.02f, .spinVel = 0.05f, .type = 1, .flags = flags };
+}
+
+Game::HierarchyNodeParams bulletParams()
+{
+  return { .radius = 12.0f, .angVel = 0.1f, .type = 2 };
+}
+
+// 生成一个使魔和它的子弹
+Game::BulletHandle spawnGroup(Game::BulletHierarchy& hierarchy, Game::BulletHandle emitter, std::uint16_t flags)
+{
+  Game::BulletHandle const familiar = hierarchy.spawn(familiarParams(flags), emitter);
+  hierarchy.spawnRing(bulletParams(), familiar, BulletsPerFamiliar);
+  return familiar;
+}
+
+struct Scene
+{
+  std::vector<Game::BulletHandle> emitters;
+  std::vector<Game::BulletHandle> familiars;
+};
+
+Scene buildScene(Game::BulletHierarchy& hierarchy, std::uint16_t familiarFlags)
+{
+  hierarchy.clear();
+  Scene scene;
+  for (std::size_t e = 0; e < EmitterCount; ++e) {
+    scene.emitters.push_back(hierarchy.spawn(emitterParams(e)));
+  }
+  for (std::size_t e = 0; e < EmitterCount; ++e) {
+    for (std::size_t f = 0; f < FamiliarsPerEmitter; ++f) {
+      scene.familiars.push_back(spawnGroup(hierarchy, scene.emitters[e], familiarFlags));
+    }
+  }
+  return scene;
+}
+
+// ---- 对照: AoS 节点, 每个节点递归地向上查找父节点求世界位姿 ----
+
+struct NaiveNode
+{
+  float radius, radialSpeed, phase, angVel, spin, spinVel;
+  float anchorX, anchorY, anchorAngle;
+  int parent; // 在节点数组中的下标, 根节点为 -1
+  float x, y, angle;
+};
+
+Game::HierarchyPose naiveWorld(std::vector<NaiveNode> const& nodes, int i)
+{
+  NaiveNode const& n = nodes[i];
+  Game::HierarchyPose const base =
+    n.parent < 0 ? Game::HierarchyPose{ n.anchorX, n.anchorY, n.anchorAngle } : naiveWorld(nodes, n.parent);
+  float const direction = base.angle + n.phase;
+  return { base.x + n.radius * Core::Math::cos(direction),
+           base.y + n.radius * Core::Math::sin(direction),
+           base.angle + n.spin };
+}
+
+NaiveNode naiveNode(Game::HierarchyNodeParams const& p, int parent)
+{
+  return { p.radius, p.radialSpeed, p.phase, p.angVel, p.spin, p.spinVel, p.x, p.y, p.anchorAngle, parent, 0, 0, 0 };
+}
+
+// 以与 buildScene 相同的顺序和参数建立对照场景
+std::vector<NaiveNode> buildNaiveScene()
+{
+  std::vector<NaiveNode> nodes;
+  nodes.reserve(NodeCount);
+  for (std::size_t e = 0; e < EmitterCount; ++e) {
+    nodes.push_back(naiveNode(emitterParams(e), -1));
+  }
+  float const step = std::numbers::pi_v<float> * 2.0f / static_cast<float>(BulletsPerFamiliar);
+  for (std::size_t e = 0; e < EmitterCount; ++e) {
+    for (std::size_t f = 0; f < FamiliarsPerEmitter; ++f) {
+      int const familiar = static_cast<int>(nodes.size());
+      nodes.push_back(naiveNode(familiarParams(0), static_cast<int>(e)));
+      for (std::size_t b = 0; b < BulletsPerFamiliar; ++b) {
+        NaiveNode bullet = naiveNode(bulletParams(), familiar);
+        bullet.phase = static_cast<float>(b) * step; // 与 fillArithmetic 相同: start + i * step
+        nodes.push_back(bullet);
+      }
+    }
+  }
+  return nodes;
+}
+
+void naiveUpdate(std::vector<NaiveNode>& nodes)
+{
+  for (NaiveNode& n : nodes) {
+    n.radius += n.radialSpeed;
+    n.phase += n.angVel;
+    n.spin += n.spinVel;
+  }
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    Game::HierarchyPose const pose = naiveWorld(nodes, static_cast<int>(i));
+    nodes[i].x = pose.x;
+    nodes[i].y = pose.y;
+    nodes[i].angle = pose.angle;
+  }
+}
+
+// 两边的子弹按相同顺序生成且没有回收, 第 2 层的第 k 颗子弹对应对照场景中第 k 个子弹节点
+std::size_t countMismatches(Game::BulletHierarchy const& hierarchy, std::vector<NaiveNode> const& nodes)
+{
+  Game::HierarchyLevelView const bullets = hierarchy.getLevel(2);
+  std::size_t mismatches = 0;
+  std::size_t k = 0;
+  for (NaiveNode const& n : nodes) {
+    if (n.parent < static_cast<int>(EmitterCount)) {
+      continue; // 发射器与使魔
+    }
+    mismatches += (bullets.x[k] != n.x || bullets.y[k] != n.y || bullets.angle[k] != n.angle) ? 1 : 0;
+    ++k;
+  }
+  return mismatches + (k != bullets.count ? 1 : 0);
+}
+} // namespace
+
+int main()
+{
+  std::cout << std::format("== {} bullets in {} groups ({} nodes, {} levels, {}) ==\n",
+                           EmitterCount * FamiliarsPerEmitter * BulletsPerFamiliar,
+                           EmitterCount * FamiliarsPerEmitter,
+                           NodeCount,
+                           Game::BulletHierarchy::MAX_DEPTH,
+                           Core::Simd::IsaName);
+
+  Game::BulletHierarchy hierarchy;
+  // 被击杀的节点在 update 时才释放, 同一个使魔在一帧内可能被选中两次, 预留两倍的补充量
+  hierarchy.init(NodeCount + 2 * ChurnPerFrame * (1 + BulletsPerFamiliar));
+
+  // 1. 静态结构下的解算
+  {
+    Scene const scene = buildScene(hierarchy, 0);
+    std::vector<NaiveNode> naive = buildNaiveScene();
+
+    double micros = 0.0;
+    for (int f = 0; f < Frames; ++f) {
+      auto const start = Clock::now();
+      hierarchy.update(Bounds);
+      micros += elapsedMicros(start);
+    }
+    double naiveMicros = 0.0;
+    for (int f = 0; f < Frames; ++f) {
+      auto const start = Clock::now();
+      naiveUpdate(naive);
+      naiveMicros += elapsedMicros(start);
+    }
+    std::cout << std::format("level-ordered SoA  {:>8.1f} us per frame\n", micros / Frames);
+    std::cout << std::format("recursive lookup   {:>8.1f} us per frame ({} mismatching bullets)\n",
+                             naiveMicros / Frames,
+                             countMismatches(hierarchy, naive));
+  }
+
+  // 2. 每帧击杀 1% 的使魔, 子弹随之死亡, 再在随机的发射器下补充
+  {
+    Scene scene = buildScene(hierarchy, 0);
+    Game::PatternRng rng;
+    double micros = 0.0;
+    bool stable = true;
+    for (int f = 0; f < Frames; ++f) {
+      auto const start = Clock::now();
+      for (std::size_t c = 0; c < ChurnPerFrame; ++c) {
+        Game::BulletHandle& familiar = scene.familiars[rng.nextU32() % scene.familiars.size()];
+        hierarchy.kill(familiar);
+        familiar = spawnGroup(hierarchy, scene.emitters[rng.nextU32() % EmitterCount], 0);
+      }
+      hierarchy.update(Bounds);
+      micros += elapsedMicros(start);
+      stable = stable && hierarchy.getNodeCount() == NodeCount;
+    }
+    std::cout << std::format("1% churn per frame {:>8.1f} us per frame (node count {})\n",
+                             micros / Frames,
+                             stable ? "stable" : "DRIFTED");
+  }
+
+  // 3. 击杀全部发射器, 使魔带着子弹脱离成为根节点, 位姿保持连续
+  {
+    Scene const scene = buildScene(hierarchy, Game::BulletHierarchy::FLAG_DETACH);
+    hierarchy.update(Bounds);
+    Game::HierarchyPose before{};
+    hierarchy.getPose(scene.familiars[0], before);
+    for (Game::BulletHandle const emitter : scene.emitters) {
+      hierarchy.kill(emitter);
+    }
+    auto const start = Clock::now();
+    hierarchy.update(Bounds);
+    double const micros = elapsedMicros(start);
+    Game::HierarchyPose after{};
+    hierarchy.getPose(scene.familiars[0], after);
+    std::cout << std::format("detach all groups  {:>8.1f} us ({} nodes left, familiar moved {:.2f} px)\n",
+                             micros,
+                             hierarchy.getNodeCount(),
+                             std::hypot(after.x - before.x, after.y - before.y));
+  }
+  return 0;
+}
@@ -0,0 +1,291 @@
+#include "Core/JobSystem.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 任务系统的开销, 与朴素的 std::thread 线程池 (互斥锁 + 条件变量 + std::function 队列) 对比:
+//   - 派发延迟: 提交一个空任务到它开始执行的时间, 分连续提交 (工作线程在自旋) 与间隔 2 ms 提交 (工作线程已休眠)
+//   - 吞吐量: 成批提交大量小任务, 每个任务的平均开销
+//   - parallelFor: 对 400 万个元素做一次简单运算, 与单线程对比
+//   - 任务图: 与 Stage::step 相同形状的 4 个任务 (两条 "更新 -> 碰撞" 链), 每张图的耗时
+// 参数: [工作线程数] [pin], 默认按 CPU 核数 (至少 1 个), pin 时把工作线程固定在各自的逻辑处理器上
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr int HotSamples = 20000;
+constexpr int ColdSamples = 200;
+constexpr std::size_t ThroughputJobs = 200'000;
+constexpr std::size_t BatchSize = 1024; // 每批提交的任务数, 不超过任务池大小
+constexpr std::size_t ForCount = 1 << 22;
+constexpr std::size_t ForGrain = 16384;
+constexpr int GraphRepeats = 20000;
+
+std::int64_t nowNanos()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+double elapsedMicros(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+// 一小段不会被优化掉的计算, 模拟一个很小的任务
+void spinWork(std::atomic<std::uint64_t>& sink, std::uint32_t iterations)
+{
+  std::uint64_t x = iterations;
+  for (std::uint32_t i = 0; i < iterations; ++i) {
+    x = x * 6364136223846793005ull + 1442695040888963407ull;
+  }
+  sink.fetch_add(x & 1, std::memory_order_relaxed);
+}
+
+// 对照: 全局一个队列, 互斥锁保护, 条件变量唤醒
+class NaivePool
+{
+public:
+  explicit NaivePool(std::size_t workerCount)
+  {
+    for (std::size_t i = 0; i < workerCount; ++i) {
+      m_workers.emplace_back([this] { workerLoop(); });
+    }
+  }
+
+  ~NaivePool()
+  {
+    {
+      std::lock_guard lock(m_mutex);
+      m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers) {
+      worker.join();
+    }
+  }
+
+  void submit(std::function<void()> fn)
+  {
+    {
+      std::lock_guard lock(m_mutex);
+      m_tasks.push(std::move(fn));
+      ++m_pending;
+    }
+    m_wake.notify_one();
+  }
+
+  void waitIdle()
+  {
+    std::unique_lock lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_pending == 0; });
+  }
+
+private:
+  void workerLoop()
+  {
+    while (true) {
+      std::function<void()> fn;
+      {
+        std::unique_lock lock(m_mutex);
+        m_wake.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+        if (m_tasks.empty()) {
+          return;
+        }
+        fn = std::move(m_tasks.front());
+        m_tasks.pop();
+      }
+      fn();
+      std::lock_guard lock(m_mutex);
+      if (--m_pending == 0) {
+        m_idle.notify_all();
+      }
+    }
+  }
+
+private:
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::condition_variable m_idle;
+  std::queue<std::function<void()>> m_tasks;
+  std::size_t m_pending = 0;
+  bool m_stop = false;
+};
+
+void printLatency(char const* name, std::vector<double>& samples)
+{
+  std::sort(samples.begin(), samples.end());
+  auto const at = [&samples](double p) {
+    return samples[static_cast<std::size_t>(p / 100.0 * static_cast<double>(samples.size() - 1))];
+  };
+  std::cout << std::format(
+    "{:<28} p50 {:>8.2f} us  p90 {:>8.2f}  p99 {:>8.2f}  max {:>9.2f}\n", name, at(50), at(90), at(99), at(100));
+}
+
+// 提交一个任务到它开始执行的时间; 任务由工作线程执行 (提交线程只看计数器, 不参与执行)
+template <typename Submit, typename Wait>
+std::vector<double> measureLatency(int samples, std::chrono::microseconds gap, Submit&& submit, Wait&& wait)
+{
+  std::vector<double> latencies;
+  latencies.reserve(samples);
+  std::atomic<std::int64_t> started{ 0 };
+  for (int i = 0; i < samples; ++i) {
+    if (gap.count() > 0) {
+      std::this_thread::sleep_for(gap);
+    }
+    std::int64_t const submitted = nowNanos();
+    submit([&started]() noexcept { started.store(nowNanos(), std::memory_order_relaxed); });
+    wait();
+    latencies.push_back(static_cast<double>(started.load(std::memory_order_relaxed) - submitted) / 1000.0);
+  }
+  return latencies;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  unsigned const hardwareThreads = std::thread::hardware_concurrency();
+  std::size_t workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+  if (argc > 1) {
+    workerCount = std::max<std::size_t>(std::stoul(argv[1]), 1);
+  }
+  bool const pinned = argc > 2 && std::string(argv[2]) == "pin";
+
+  using Affinity = Core::JobSystem::Affinity;
+  Core::JobSystem jobSystem({ .workerCount = workerCount, .affinity = pinned ? Affinity::Pinned : Affinity::None });
+  NaivePool naive(workerCount);
+  std::atomic<std::uint64_t> sink{ 0 };
+
+  std::cout << std::format(
+    "== {} workers{}, {} hardware threads ==\n", workerCount, pinned ? " (pinned)" : "", hardwareThreads);
+
+  // 派发延迟: 提交线程自旋等待计数器, 不窃取任务, 因此测到的是工作线程取到任务的时间
+  std::cout << "-- dispatch latency (submit -> job starts on a worker) --\n";
+  for (auto const gap : { std::chrono::microseconds(0), std::chrono::microseconds(2000) }) {
+    int const samples = gap.count() == 0 ? HotSamples : ColdSamples;
+    char const* const mode = gap.count() == 0 ? "hot" : "parked";
+
+    Core::JobCounter counter;
+    std::vector<double> jobLatency = measureLatency(
+      samples,
+      gap,
+      [&](auto&& fn) { jobSystem.run(counter, fn); },
+      [&] {
+        while (!counter.isDone()) {
+          std::this_thread::yield();
+        }
+      });
+    jobSystem.wait(counter);
+    std::vector<double> naiveLatency =
+      measureLatency(samples, gap, [&](auto&& fn) { naive.submit(fn); }, [&] { naive.waitIdle(); });
+
+    printLatency(std::format("JobSystem ({})", mode).c_str(), jobLatency);
+    printLatency(std::format("naive pool ({})", mode).c_str(), naiveLatency);
+  }
+
+  // 吞吐量: 每个任务约 100 次乘加, 成批提交后等待; JobSystem 的提交线程同时参与执行
+  std::cout << std::format("-- throughput ({} small jobs in batches of {}) --\n", ThroughputJobs, BatchSize);
+  {
+    auto const start = Clock::now();
+    for (std::size_t done = 0; done < ThroughputJobs; done += BatchSize) {
+      Core::JobCounter counter;
+      for (std::size_t i = 0; i < BatchSize; ++i) {
+        jobSystem.run(counter, [&sink]() noexcept { spinWork(sink, 100); });
+      }
+      jobSystem.wait(counter);
+    }
+    double const jobMicros = elapsedMicros(start);
+
+    auto const naiveStart = Clock::now();
+    for (std::size_t done = 0; done < ThroughputJobs; done += BatchSize) {
+      for (std::size_t i = 0; i < BatchSize; ++i) {
+        naive.submit([&sink]() noexcept { spinWork(sink, 100); });
+      }
+      naive.waitIdle();
+    }
+    double const naiveMicros = elapsedMicros(naiveStart);
+
+    std::cout << std::format("{:<28} {:>8.1f} ns per job\n", "JobSystem::run", jobMicros * 1000.0 / ThroughputJobs);
+    std::cout << std::format("{:<28} {:>8.1f} ns per job\n", "naive pool", naiveMicros * 1000.0 / ThroughputJobs);
+  }
+
+  // parallelFor: 对每个元素开方, 与单线程以及把各块作为 std::function 提交给朴素线程池对比
+  std::cout << std::format("-- parallel for ({} elements, grain {}) --\n", ForCount, ForGrain);
+  {
+    std::vector<float> data(ForCount);
+    for (std::size_t i = 0; i < ForCount; ++i) {
+      data[i] = static_cast<float>(i);
+    }
+    auto const kernel = [&data](std::size_t begin, std::size_t end) noexcept {
+      for (std::size_t i = begin; i < end; ++i) {
+        data[i] = std::sqrt(data[i] + 1.0f);
+      }
+    };
+
+    auto start = Clock::now();
+    kernel(0, ForCount);
+    double const serialMicros = elapsedMicros(start);
+
+    start = Clock::now();
+    jobSystem.parallelFor(ForCount, ForGrain, kernel);
+    double const jobMicros = elapsedMicros(start);
+
+    start = Clock::now();
+    for (std::size_t begin = 0; begin < ForCount; begin += ForGrain) {
+      naive.submit([&kernel, begin] { kernel(begin, std::min(begin + ForGrain, ForCount)); });
+    }
+    naive.waitIdle();
+    double const naiveMicros = elapsedMicros(start);
+
+    std::cout << std::format("{:<28} {:>8.1f} us\n", "single thread", serialMicros);
+    std::cout << std::format("{:<28} {:>8.1f} us\n", "JobSystem::parallelFor", jobMicros);
+    std::cout << std::format("{:<28} {:>8.1f} us\n", "naive pool", naiveMicros);
+  }
+
+  // 任务图: 两条 "更新 -> 碰撞" 链, 朴素线程池只能分两个阶段各等待一次
+  std::cout << std::format("-- frame graph (2 chains of update -> collide, {} times) --\n", GraphRepeats);
+  {
+    auto const start = Clock::now();
+    for (int r = 0; r < GraphRepeats; ++r) {
+      Core::JobCounter bulletsUpdated;
+      Core::JobCounter lasersUpdated;
+      Core::JobCounter collided;
+      jobSystem.run(bulletsUpdated, [&sink]() noexcept { spinWork(sink, 400); });
+      jobSystem.run(lasersUpdated, [&sink]() noexcept { spinWork(sink, 100); });
+      jobSystem.runAfter(bulletsUpdated, collided, [&sink]() noexcept { spinWork(sink, 200); });
+      jobSystem.runAfter(lasersUpdated, collided, [&sink]() noexcept { spinWork(sink, 100); });
+      jobSystem.wait(collided);
+    }
+    double const jobMicros = elapsedMicros(start);
+
+    auto const naiveStart = Clock::now();
+    for (int r = 0; r < GraphRepeats; ++r) {
+      naive.submit([&sink]() noexcept { spinWork(sink, 400); });
+      naive.submit([&sink]() noexcept { spinWork(sink, 100); });
+      naive.waitIdle();
+      naive.submit([&sink]() noexcept { spinWork(sink, 200); });
+      naive.submit([&sink]() noexcept { spinWork(sink, 100); });
+      naive.waitIdle();
+    }
+    double const naiveMicros = elapsedMicros(naiveStart);
+
+    std::cout << std::format("{:<28} {:>8.2f} us per graph\n", "JobSystem counters", jobMicros / GraphRepeats);
+    std::cout << std::format("{:<28} {:>8.2f} us per graph\n", "naive pool (2 phases)", naiveMicros / GraphRepeats);
+  }
+
+  std::cout << std::format("(sink {})\n", sink.load());
+  return 0;
+}
@@ -0,0 +1,166 @@
+#include "Core/Simd.hpp"
+#include "Game/BulletManager.hpp"
+#include "Game/CollisionGrid.hpp"
+#include "Game/LaserManager.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <numbers>
+#include <vector>
+
+// 曲线激光的开销测量: 64 条激光 x 256 个节点
+// 对比把同样多的节点当作普通子弹处理 (积分 + 重建碰撞网格 + 查询) 的每帧开销
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double elapsedMicros(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+constexpr float ScreenWidth = 1280.0f;
+constexpr float ScreenHeight = 960.0f;
+constexpr std::size_t LaserCount = 64;
+constexpr std::size_t NodeCount = 256;
+constexpr int Frames = 1000;
+
+constexpr Game::BulletBounds Area{
+  .left = -100.0f, .right = ScreenWidth + 100.0f, .top = -100.0f, .bottom = ScreenHeight + 100.0f
+};
+// 自机放在一条激光的发射点上, 激光头绕圈时会反复经过
+constexpr Game::PlayerHitbox Player{
+  .x = ScreenWidth * 3.5f / 8.0f, .y = ScreenHeight * 3.5f / 8.0f, .hitRadius = 2.0f, .grazeRadius = 24.0f
+};
+
+// 第 k 条激光: 8 x 8 排列, 激光头绕圈飞行, 不会出界
+Game::LaserParams laserParams(std::size_t k)
+{
+  constexpr float turn = 2.0f * std::numbers::pi_v<float> / 300.0f;
+  return { .x = ScreenWidth * (static_cast<float>(k % 8) + 0.5f) / 8.0f,
+           .y = ScreenHeight * (static_cast<float>(k / 8) + 0.5f) / 8.0f,
+           .angle = static_cast<float>(k) * 0.7f,
+           .angVel = (k % 2 == 0) ? turn : -turn,
+           .speed = 1.5f,
+           .length = static_cast<std::uint16_t>(NodeCount) };
+}
+
+// 点到折线的最短距离平方, 双精度参考实现
+double referenceDistanceSq(Game::LaserView const& laser, double px, double py)
+{
+  double best = 1e300;
+  for (std::size_t i = 0; i + 1 < laser.count; ++i) {
+    double const ax = laser.x[i];
+    double const ay = laser.y[i];
+    double const dx = laser.x[i + 1] - ax;
+    double const dy = laser.y[i + 1] - ay;
+    double const lengthSq = std::max(dx * dx + dy * dy, 1e-12);
+    double const t = std::clamp(((px - ax) * dx + (py - ay) * dy) / lengthSq, 0.0, 1.0);
+    double const ex = px - ax - t * dx;
+    double const ey = py - ay - t * dy;
+    best = std::min(best, ex * ex + ey * ey);
+  }
+  return best;
+}
+
+void benchmarkLasers()
+{
+  Game::LaserManager lasers;
+  lasers.init(LaserCount, NodeCount);
+  for (std::size_t k = 0; k < LaserCount; ++k) {
+    lasers.fire(laserParams(k));
+  }
+  // 先让每条激光的节点填满
+  for (std::size_t f = 0; f < NodeCount; ++f) {
+    lasers.update(Area);
+  }
+
+  double updateMicros = 0.0;
+  double collideMicros = 0.0;
+  std::size_t contacts = 0;
+  for (int f = 0; f < Frames; ++f) {
+    auto const updateStart = Clock::now();
+    lasers.update(Area);
+    updateMicros += elapsedMicros(updateStart);
+
+    auto const collideStart = Clock::now();
+    Game::LaserContacts const result = lasers.collide(Player);
+    collideMicros += elapsedMicros(collideStart);
+    contacts += result.hits + result.grazes;
+  }
+
+  // 与双精度参考实现比较最短距离
+  double maxRelError = 0.0;
+  for (std::size_t k = 0; k < lasers.getLaserCount(); ++k) {
+    double const expected = referenceDistanceSq(lasers.getLaser(k), Player.x, Player.y);
+    double const actual = lasers.distanceSquared(k, Player.x, Player.y);
+    maxRelError = std::max(maxRelError, std::fabs(actual - expected) / std::max(expected, 1.0));
+  }
+
+  std::cout << std::format("lasers   {} x {} nodes: update {:>7.2f} us  capsule collide {:>7.2f} us  per frame "
+                           "({} contacts, max rel. error {:.1e})\n",
+                           lasers.getLaserCount(),
+                           lasers.getLaser(0).count,
+                           updateMicros / Frames,
+                           collideMicros / Frames,
+                           contacts,
+                           maxRelError);
+}
+
+// 把同样多的节点作为静止的普通子弹: 每帧积分, 重建碰撞网格, 做被弹与擦弹查询
+void benchmarkBullets()
+{
+  Game::LaserManager lasers;
+  lasers.init(LaserCount, NodeCount);
+  for (std::size_t k = 0; k < LaserCount; ++k) {
+    lasers.fire(laserParams(k));
+  }
+  for (std::size_t f = 0; f < NodeCount; ++f) {
+    lasers.update(Area);
+  }
+
+  std::size_t const capacity = LaserCount * NodeCount;
+  Game::BulletManager bullets;
+  bullets.init(capacity);
+  for (std::size_t k = 0; k < lasers.getLaserCount(); ++k) {
+    Game::LaserView const laser = lasers.getLaser(k);
+    for (std::size_t i = 0; i < laser.count; ++i) {
+      bullets.spawnBulletA(laser.x[i], laser.y[i], 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0, 0);
+    }
+  }
+
+  Game::CollisionGrid grid;
+  grid.init(Area, 32.0f, capacity);
+  std::vector<std::uint32_t> results(capacity);
+
+  double micros = 0.0;
+  std::size_t contacts = 0;
+  for (int f = 0; f < Frames; ++f) {
+    auto const start = Clock::now();
+    bullets.update(ScreenWidth, ScreenHeight);
+    grid.rebuild(bullets.getActiveBullets(), bullets.getActiveCount());
+    contacts += grid.queryHit(Player, results.data(), results.size());
+    contacts += grid.queryGraze(Player, results.data(), results.size());
+    micros += elapsedMicros(start);
+  }
+
+  std::cout << std::format("bullets  {} nodes as bullets: update + grid + queries {:>7.2f} us per frame "
+                           "({} contacts)\n",
+                           bullets.getActiveCount(),
+                           micros / Frames,
+                           contacts);
+}
+} // namespace
+
+int main()
+{
+  std::cout << std::format("== curvy lasers ({}) ==\n", Core::Simd::IsaName);
+  benchmarkLasers();
+  benchmarkBullets();
+  return 0;
+}
@@ -0,0 +1,149 @@
+#include "Core/JobSystem.hpp"
+#include "Game/SimulationThread.hpp"
+#include "Game/Stage.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// 模拟线程与渲染线程流水线的检查: 模拟线程推进关卡并发布 FramePacket, 主线程作为空消费者 (不绘制) 不断取走最新的一份
+// 模拟线程分别以最快速度 (报告吞吐量, 消费者会跳过帧) 与 240 Hz (消费者跟得上, 检查每一对相邻帧) 运行, 检查:
+//   - 帧号单调递增
+//   - 连续两帧之间, 每颗插值的子弹的上一次状态与上一份数据中同一颗子弹的状态一致
+//   - 结束时的状态哈希与单线程模拟相同帧数的结果一致 (发布不影响模拟)
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr std::uint64_t Steps = 3000;
+constexpr std::uint64_t PacedSteps = 600;
+constexpr Game::Stage::Config StageConfig{ .width = 1280.0f, .height = 960.0f, .bulletCapacity = 20000 };
+
+struct ConsumerStats
+{
+  std::uint64_t packets = 0;        // 取到的新数据份数
+  std::uint64_t consecutive = 0;    // 与上一份帧号相邻的份数, 只有这些做插值一致性检查
+  std::uint64_t checkedBullets = 0; // 做过一致性检查的子弹数
+  std::uint64_t mismatches = 0;     // 上一次状态与上一份数据不一致的子弹数
+  std::uint64_t orderErrors = 0;    // 帧号没有递增的次数
+};
+
+// 上一份数据的副本: 消费者下一次 acquire 后手中的引用会指向另一份, 需要自己保存
+struct PreviousPacket
+{
+  std::uint32_t frame = 0;
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<std::uint32_t> id;
+  std::vector<std::uint32_t> generation;
+  std::vector<std::uint32_t> indexOfId;
+};
+
+void checkPacket(Game::FramePacket const& packet, PreviousPacket& previous, ConsumerStats& stats)
+{
+  if (stats.packets > 0 && packet.frame <= previous.frame) {
+    ++stats.orderErrors;
+  }
+  if (stats.packets > 0 && packet.frame == previous.frame + 1) {
+    ++stats.consecutive;
+    for (std::size_t i = 0; i < packet.bulletCount; ++i) {
+      bool const interpolated = packet.prevX[i] != packet.x[i] || packet.prevY[i] != packet.y[i];
+      if (!interpolated) {
+        continue;
+      }
+      std::uint32_t const prev = previous.indexOfId[packet.id[i]];
+      ++stats.checkedBullets;
+      if (prev >= previous.id.size() || previous.id[prev] != packet.id[i] ||
+          previous.generation[prev] != packet.generation[i] || previous.x[prev] != packet.prevX[i] ||
+          previous.y[prev] != packet.prevY[i]) {
+        ++stats.mismatches;
+      }
+    }
+  }
+  ++stats.packets;
+
+  previous.frame = packet.frame;
+  previous.x.assign(packet.x.begin(), packet.x.begin() + packet.bulletCount);
+  previous.y.assign(packet.y.begin(), packet.y.begin() + packet.bulletCount);
+  previous.id.assign(packet.id.begin(), packet.id.begin() + packet.bulletCount);
+  previous.generation.assign(packet.generation.begin(), packet.generation.begin() + packet.bulletCount);
+  for (std::size_t i = 0; i < packet.bulletCount; ++i) {
+    previous.indexOfId[packet.id[i]] = static_cast<std::uint32_t>(i);
+  }
+}
+
+// 以 config 运行一次流水线, 报告结果, 返回是否通过检查
+bool runPipeline(char const* name, Game::SimulationThread::Config const& config, Core::JobSystem& jobSystem)
+{
+  Game::FrameInput const input{};
+
+  // 单线程: 只推进关卡, 作为对照
+  Game::Stage reference;
+  reference.init(StageConfig, &jobSystem);
+  auto const referenceStart = Clock::now();
+  for (std::uint64_t step = 0; step < config.stepLimit; ++step) {
+    reference.step(input);
+  }
+  double const referenceMs = std::chrono::duration<double, std::milli>(Clock::now() - referenceStart).count();
+
+  // 流水线: 模拟线程推进并发布, 主线程取走并检查
+  Game::Stage stage;
+  stage.init(StageConfig, &jobSystem);
+  Game::SimulationThread simThread;
+  ConsumerStats stats;
+  PreviousPacket previous;
+  previous.indexOfId.assign(StageConfig.bulletCapacity, 0);
+
+  auto const start = Clock::now();
+  simThread.start(stage, config, [&stage, &input] { stage.step(input); });
+  while (true) {
+    // 先读取运行状态: 模拟线程结束之后的最后一次 acquire 一定能取到最后发布的一份
+    bool const running = simThread.isRunning();
+    bool fresh = false;
+    Game::FramePacket const& packet = simThread.acquire(&fresh);
+    if (fresh) {
+      checkPacket(packet, previous, stats);
+    } else if (running) {
+      std::this_thread::yield();
+    }
+    if (!running) {
+      break;
+    }
+  }
+  simThread.stop();
+  double const pipelineMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  std::uint64_t const pipelineHash = stage.computeStateHash();
+  std::uint64_t const referenceHash = reference.computeStateHash();
+  double const steps = static_cast<double>(config.stepLimit);
+
+  std::cout << std::format(
+    "== {}: {} steps, {} bullets at end ==\n", name, config.stepLimit, stage.getBulletManager().getActiveCount());
+  std::cout << std::format("single thread   {:>8.3f} ms per step\n", referenceMs / steps);
+  std::cout << std::format("pipelined       {:>8.3f} ms per step (step + publish + wait)\n", pipelineMs / steps);
+  std::cout << std::format("packets consumed {} / {}, consecutive {}, last frame {}\n",
+                           stats.packets,
+                           simThread.getStepCount() + 1,
+                           stats.consecutive,
+                           previous.frame);
+  std::cout << std::format(
+    "interpolation   {} bullets checked, {} mismatches\n", stats.checkedBullets, stats.mismatches);
+  std::cout << std::format("ordering        {} errors\n", stats.orderErrors);
+  std::cout << std::format("state hash      {:016x} (single thread {:016x})\n", pipelineHash, referenceHash);
+
+  return pipelineHash == referenceHash && stats.mismatches == 0 && stats.orderErrors == 0 &&
+         previous.frame == stage.getFrame();
+}
+} // namespace
+
+int main()
+{
+  Core::JobSystem jobSystem;
+  bool ok = runPipeline("unpaced", { .paced = false, .stepLimit = Steps }, jobSystem);
+  ok = runPipeline("paced 240 Hz", { .stepSeconds = 1.0 / 240.0, .stepLimit = PacedSteps }, jobSystem) && ok;
+  std::cout << (ok ? "OK\n" : "FAILED\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+#include "Core/Profiler.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+
+// 剖析区间的开销测量 (每个区间 ns): 采集中记录一个区间, 未采集时的空区间, 以及作为参照的 steady_clock::now
+// 直接使用 Core::ProfileScope, 与是否以 TOUHOU_PROFILE 构建无关; 未定义 TOUHOU_PROFILE 时 PROFILE_* 宏为空语句, 开销为 0
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t ScopesPerRun = Core::Profiler::EVENTS_PER_THREAD / 2; // 每轮不超过缓冲区容量
+constexpr int Runs = 20;
+
+// 防止空循环被优化掉
+std::uint64_t volatile sink = 0;
+
+template <typename F>
+double nanosPerScope(bool capture, F&& body)
+{
+  Clock::duration total{};
+  for (int r = 0; r < Runs; ++r) {
+    if (capture) {
+      Core::Profiler::beginCapture();
+    }
+    auto const start = Clock::now();
+    for (std::size_t i = 0; i < ScopesPerRun; ++i) {
+      body(i);
+    }
+    total += Clock::now() - start;
+    Core::Profiler::endCapture();
+  }
+  return std::chrono::duration<double, std::nano>(total).count() / static_cast<double>(ScopesPerRun * Runs);
+}
+} // namespace
+
+int main()
+{
+  double const baseline = nanosPerScope(false, [](std::size_t i) { sink = sink + i; });
+
+  double const idle = nanosPerScope(false, [](std::size_t i) {
+    Core::ProfileScope const scope("idle scope");
+    sink = sink + i;
+  });
+
+  double const recorded = nanosPerScope(true, [](std::size_t i) {
+    Core::ProfileScope const scope("recorded scope");
+    sink = sink + i;
+  });
+
+  double const clock = nanosPerScope(false, [](std::size_t) {
+    sink = sink + static_cast<std::uint64_t>(Clock::now().time_since_epoch().count());
+  });
+
+  std::cout << std::format("== profiler scope cost, {} runs of {} scopes ==\n", Runs, ScopesPerRun);
+  std::cout << std::format("empty loop               {:>6.2f} ns per iteration\n", baseline);
+  std::cout << std::format("scope, not capturing     {:>6.2f} ns per scope\n", idle - baseline);
+  std::cout << std::format("scope, capturing         {:>6.2f} ns per scope\n", recorded - baseline);
+  std::cout << std::format("steady_clock::now        {:>6.2f} ns per call (reference)\n", clock - baseline);
+  std::cout << std::format("dropped                  {}\n", Core::Profiler::getDroppedCount());
+  return 0;
+}
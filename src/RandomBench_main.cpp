@@ -0,0 +1,114 @@
+#include "Core/Random.hpp"
+#include "Core/Simd.hpp"
+#include "Game/BulletPattern.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// 随机数发生器的开销测量: 每种发生器生成 100 万个 [0, 2pi) 内的角度, 重复多次取平均
+// 对比 std::mt19937 + std::uniform_real_distribution, 现有的 xorshift32, xoshiro128++, PCG32,
+// 以及计数器式随机数流的逐个取数与 SIMD 批量填充; 最后检查批量填充与逐个取数的结果逐位相同
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double elapsedMicros(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+constexpr std::size_t Count = 1'000'000;
+constexpr int Repeats = 20;
+constexpr float TwoPi = 6.28318530718f;
+
+template <typename F>
+void measure(char const* name, std::vector<float>& out, F&& fill)
+{
+  double micros = 0.0;
+  for (int r = 0; r < Repeats; ++r) {
+    auto const start = Clock::now();
+    fill(out.data(), out.size());
+    micros += elapsedMicros(start);
+  }
+  double checksum = 0.0;
+  for (float const v : out) {
+    checksum += v;
+  }
+  micros /= Repeats;
+  std::cout << std::format("{:<22} {:>8.1f} us ({:>5.2f} ns per value, mean {:.4f})\n",
+                           name,
+                           micros,
+                           micros * 1000.0 / static_cast<double>(out.size()),
+                           checksum / static_cast<double>(out.size()));
+}
+} // namespace
+
+int main()
+{
+  std::cout << std::format("== {} random angles ({}) ==\n", Count, Core::Simd::IsaName);
+  std::vector<float> out(Count);
+
+  std::mt19937 mt(12345);
+  std::uniform_real_distribution<float> angle(0.0f, TwoPi);
+  measure("mt19937 + distribution", out, [&](float* o, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      o[i] = angle(mt);
+    }
+  });
+
+  Game::PatternRng xorshift;
+  measure("xorshift32", out, [&](float* o, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      o[i] = xorshift.nextFloat() * TwoPi;
+    }
+  });
+
+  Core::Random::Xoshiro128 xoshiro = Core::Random::Xoshiro128::fromSeed(12345);
+  measure("xoshiro128++", out, [&](float* o, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      o[i] = xoshiro.nextFloat() * TwoPi;
+    }
+  });
+
+  Core::Random::Pcg32 pcg = Core::Random::Pcg32::fromSeed(12345);
+  measure("pcg32", out, [&](float* o, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      o[i] = pcg.nextFloat() * TwoPi;
+    }
+  });
+
+  Core::Random::Stream scalar(12345, 0);
+  measure("philox stream (next)", out, [&](float* o, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      o[i] = scalar.nextRange(0.0f, TwoPi);
+    }
+  });
+
+  Core::Random::Stream batch(12345, 0);
+  measure("philox stream (fill)", out, [&](float* o, std::size_t n) { batch.fillRange(o, n, 0.0f, TwoPi); });
+
+  // 逐个取数与批量填充交替进行 (每次长度不同, 起点不对齐块边界), 与一直逐个取数的结果应逐位相同
+  Core::Random::Stream mixed(0xC0FF'EE00'1234'5678ull, 7);
+  Core::Random::Stream reference(0xC0FF'EE00'1234'5678ull, 7);
+  std::size_t mismatches = 0;
+  std::size_t offset = 0;
+  for (std::size_t length = 1; offset + length <= Count; ++length) {
+    if (length % 3 == 0) {
+      mismatches += mixed.nextRange(-1.0f, 2.0f) != reference.nextRange(-1.0f, 2.0f) ? 1 : 0;
+      ++offset;
+      continue;
+    }
+    mixed.fillRange(&out[offset], length, -1.0f, 2.0f);
+    for (std::size_t i = 0; i < length; ++i) {
+      mismatches += out[offset + i] != reference.nextRange(-1.0f, 2.0f) ? 1 : 0;
+    }
+    offset += length;
+  }
+  std::cout << std::format("batch vs sequential    {} values, {} mismatches\n", offset, mismatches);
+  return 0;
+}
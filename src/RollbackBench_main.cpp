@@ -0,0 +1,262 @@
+#include "Core/JobSystem.hpp"
+#include "Game/SnapshotRing.hpp"
+#include "Game/Stage.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <format>
+#include <iostream>
+#include <vector>
+
+// 回滚快照的开销测量, 以及在同一进程内模拟两个对等端的回滚联机 (loopback)
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double elapsedMicros(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+constexpr float ScreenWidth = 1280.0f;
+constexpr float ScreenHeight = 960.0f;
+
+// ===== 快照开销 =====
+
+constexpr std::size_t BenchBulletCount = 100'000;
+constexpr std::size_t BenchFrames = 240;
+constexpr std::uint32_t RollbackDistance = 4; // 每次回滚的帧数, 相当于约 4 帧的网络延迟
+
+void benchmarkSnapshots(Core::JobSystem& jobSystem, Game::SnapshotRing::Compression compression, char const* name)
+{
+  // 留出余量, 避免每帧的常规发射使内存池溢出
+  Game::Stage stage;
+  stage.init({ .width = ScreenWidth, .height = ScreenHeight, .bulletCapacity = BenchBulletCount + 10'000 },
+             &jobSystem);
+
+  // 一次铺满 10 万颗慢速子弹, 在测量期间不会出界
+  Game::EmitParams const params{ .x = ScreenWidth / 2.0f, .y = ScreenHeight / 2.0f, .speed = 0.25f, .angVel = 0.001f };
+  stage.getBulletManager().emitRing(params, 0.0f, BenchBulletCount);
+
+  Game::SnapshotRing ring;
+  ring.init(stage, 16, compression);
+  ring.push(stage);
+
+  double pushMicros = 0.0;
+  double restoreMicros = 0.0;
+  std::size_t restores = 0;
+  for (std::size_t f = 0; f < BenchFrames; ++f) {
+    stage.step({});
+    auto const pushStart = Clock::now();
+    ring.push(stage);
+    pushMicros += elapsedMicros(pushStart);
+
+    // 每隔一段时间回滚若干帧再重新模拟, 回滚后的 push 也计入保存开销
+    if (f % 16 == 15) {
+      std::uint32_t const target = stage.getFrame() - RollbackDistance;
+      auto const restoreStart = Clock::now();
+      ring.restore(stage, target);
+      restoreMicros += elapsedMicros(restoreStart);
+      ++restores;
+      for (std::uint32_t r = 0; r < RollbackDistance; ++r) {
+        stage.step({});
+        auto const start = Clock::now();
+        ring.push(stage);
+        pushMicros += elapsedMicros(start);
+      }
+    }
+  }
+  std::size_t const pushes = BenchFrames + restores * RollbackDistance;
+
+  std::cout << std::format("{:<8} {:>9} bullets  snapshot {:>9.1f} us  restore({} frames back) {:>9.1f} us  "
+                           "ring {:>7.2f} MiB ({} frames)\n",
+                           name,
+                           stage.getBulletManager().getActiveCount(),
+                           pushMicros / static_cast<double>(pushes),
+                           RollbackDistance,
+                           restores > 0 ? restoreMicros / static_cast<double>(restores) : 0.0,
+                           static_cast<double>(ring.getStoredBytes()) / (1024.0 * 1024.0),
+                           ring.size());
+}
+
+// ===== loopback 回滚联机 =====
+
+constexpr std::uint32_t LoopbackFrames = 1200;
+constexpr std::uint32_t LoopbackLatency = 5; // 对方输入延迟到达的帧数
+constexpr std::size_t LoopbackRingSize = 16; // 需大于延迟, 否则无法回滚到需要修正的帧
+
+// 两个玩家分别控制的按键: 0 号负责移动, 1 号负责低速 / 射击 / 炸弹
+constexpr std::array<std::uint16_t, 2> PeerButtonMasks = {
+  Game::FrameInput::Up | Game::FrameInput::Down | Game::FrameInput::Left | Game::FrameInput::Right,
+  Game::FrameInput::Focus | Game::FrameInput::Shot | Game::FrameInput::Bomb,
+};
+
+// 脚本化的玩家输入: 每 12 帧随机换一次按键, 由玩家编号和帧号唯一确定
+std::uint16_t scriptedInput(std::size_t peer, std::uint32_t frame)
+{
+  Game::PatternRng rng{ .state = static_cast<std::uint32_t>((frame / 12 + 1) * 2654435761u) ^
+                                 static_cast<std::uint32_t>(peer * 0x85EB'CA6Bu + 1) };
+  rng.nextU32();
+  return static_cast<std::uint16_t>(rng.nextU32() & PeerButtonMasks[peer]);
+}
+
+class LoopbackPeer
+{
+public:
+  LoopbackPeer(std::size_t index, Core::JobSystem& jobSystem)
+    : m_index(index)
+  {
+    m_stage.init({ .width = ScreenWidth, .height = ScreenHeight, .bulletCapacity = 20'000 }, &jobSystem);
+    m_ring.init(m_stage, LoopbackRingSize, Game::SnapshotRing::Compression::XorRle);
+    m_ring.push(m_stage);
+  }
+
+  // 本地输入在本帧立即可用, 返回需要发送给对方的输入
+  std::uint16_t localInput(std::uint32_t frame)
+  {
+    std::uint16_t const buttons = scriptedInput(m_index, frame);
+    inputsAt(frame)[m_index] = buttons;
+    return buttons;
+  }
+
+  // 收到对方 frame 帧的输入; 与当时的预测不同时回滚到该帧重新模拟
+  void receiveRemote(std::uint32_t frame, std::uint16_t buttons)
+  {
+    std::size_t const remote = 1 - m_index;
+    m_confirmedRemote = frame + 1;
+    std::uint16_t& slot = inputsAt(frame)[remote];
+    bool const mispredicted = frame < m_stage.getFrame() && slot != buttons;
+    slot = buttons;
+    if (!mispredicted) {
+      return;
+    }
+
+    auto const start = Clock::now();
+    std::uint32_t const resumeFrame = m_stage.getFrame();
+    if (!m_ring.restore(m_stage, frame)) {
+      throw std::runtime_error("Rollback target is no longer in the snapshot ring.");
+    }
+    while (m_stage.getFrame() < resumeFrame) {
+      simulateOne();
+    }
+    m_rollbackMicros += elapsedMicros(start);
+    ++m_rollbacks;
+    m_resimulatedFrames += resumeFrame - frame;
+  }
+
+  // 以当前已知 (或预测) 的输入推进一帧
+  void advance() { simulateOne(); }
+
+  Game::Stage const& getStage() const noexcept { return m_stage; }
+  std::size_t getRollbacks() const noexcept { return m_rollbacks; }
+  std::size_t getResimulatedFrames() const noexcept { return m_resimulatedFrames; }
+  double getRollbackMicros() const noexcept { return m_rollbackMicros; }
+
+private:
+  std::array<std::uint16_t, 2>& inputsAt(std::uint32_t frame)
+  {
+    if (m_inputs.size() <= frame) {
+      m_inputs.resize(frame + 1, { 0, 0 });
+    }
+    return m_inputs[frame];
+  }
+
+  void simulateOne()
+  {
+    std::uint32_t const frame = m_stage.getFrame();
+    std::size_t const remote = 1 - m_index;
+    auto& inputs = inputsAt(frame);
+    // 对方输入未到达时, 预测为最后一次确认的输入
+    if (frame >= m_confirmedRemote && m_confirmedRemote > 0) {
+      inputs[remote] = inputsAt(m_confirmedRemote - 1)[remote];
+    }
+    Game::FrameInput const input{ static_cast<std::uint16_t>(inputs[0] | inputs[1]) };
+    m_stage.step(input);
+    m_ring.push(m_stage);
+  }
+
+private:
+  std::size_t m_index;
+  Game::Stage m_stage;
+  Game::SnapshotRing m_ring;
+  std::vector<std::array<std::uint16_t, 2>> m_inputs; // 按帧号索引的双方输入 (对方的可能是预测值)
+  std::uint32_t m_confirmedRemote = 0;                // 对方输入已确认到的帧数
+
+  std::size_t m_rollbacks = 0;
+  std::size_t m_resimulatedFrames = 0;
+  double m_rollbackMicros = 0.0;
+};
+
+bool runLoopback(Core::JobSystem& jobSystem)
+{
+  LoopbackPeer peers[2] = { LoopbackPeer(0, jobSystem), LoopbackPeer(1, jobSystem) };
+
+  struct Packet
+  {
+    std::uint32_t deliverAt; // 到达时对方的帧号
+    std::uint32_t frame;
+    std::uint16_t buttons;
+  };
+  std::deque<Packet> inFlight[2]; // inFlight[i]: 发往 i 号的数据包
+
+  auto const deliver = [&](std::size_t to, std::uint32_t now) {
+    while (!inFlight[to].empty() && inFlight[to].front().deliverAt <= now) {
+      peers[to].receiveRemote(inFlight[to].front().frame, inFlight[to].front().buttons);
+      inFlight[to].pop_front();
+    }
+  };
+
+  for (std::uint32_t frame = 0; frame < LoopbackFrames; ++frame) {
+    for (std::size_t i = 0; i < 2; ++i) {
+      std::uint16_t const buttons = peers[i].localInput(frame);
+      inFlight[1 - i].push_back({ frame + LoopbackLatency, frame, buttons });
+    }
+    for (std::size_t i = 0; i < 2; ++i) {
+      deliver(i, frame);
+      peers[i].advance();
+    }
+  }
+  // 结束后送达剩余的数据包, 双方都得到完整的输入
+  for (std::size_t i = 0; i < 2; ++i) {
+    deliver(i, LoopbackFrames + LoopbackLatency);
+  }
+
+  // 参照: 一开始就知道双方全部输入的单机模拟
+  Game::Stage reference;
+  reference.init({ .width = ScreenWidth, .height = ScreenHeight, .bulletCapacity = 20'000 }, &jobSystem);
+  for (std::uint32_t frame = 0; frame < LoopbackFrames; ++frame) {
+    reference.step({ static_cast<std::uint16_t>(scriptedInput(0, frame) | scriptedInput(1, frame)) });
+  }
+
+  std::uint64_t const expected = reference.computeStateHash();
+  bool ok = true;
+  for (std::size_t i = 0; i < 2; ++i) {
+    std::uint64_t const hash = peers[i].getStage().computeStateHash();
+    ok = ok && hash == expected;
+    std::size_t const rollbacks = peers[i].getRollbacks();
+    std::cout << std::format("peer {}: {} rollbacks, {} frames resimulated, {:.1f} us per rollback, hash {:016X}\n",
+                             i,
+                             rollbacks,
+                             peers[i].getResimulatedFrames(),
+                             rollbacks > 0 ? peers[i].getRollbackMicros() / static_cast<double>(rollbacks) : 0.0,
+                             hash);
+  }
+  std::cout << std::format("reference hash {:016X}: {}\n", expected, ok ? "in sync" : "DESYNC");
+  return ok;
+}
+} // namespace
+
+int main()
+{
+  Core::JobSystem jobSystem;
+
+  std::cout << "== snapshot / restore cost ==\n";
+  benchmarkSnapshots(jobSystem, Game::SnapshotRing::Compression::None, "raw");
+  benchmarkSnapshots(jobSystem, Game::SnapshotRing::Compression::XorRle, "xor-rle");
+
+  std::cout << std::format("== loopback rollback ({} frames, {} frames latency) ==\n", LoopbackFrames, LoopbackLatency);
+  return runLoopback(jobSystem) ? 0 : 1;
+}
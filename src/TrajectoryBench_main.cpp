@@ -0,0 +1,203 @@
+#include "Core/Simd.hpp"
+#include "Game/AnalyticBulletPool.hpp"
+#include "Game/Bullet.hpp"
+#include "Game/BulletManager.hpp"
+#include "Game/BulletPattern.hpp"
+#include "Game/Trajectory.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// 解析轨迹 (Trajectory / AnalyticBulletPool) 的精度与开销
+//   - 精度: 每类运动各 Samples 颗子弹, 比较 Trajectory::evaluate(n) 与逐帧调用 n 次 Bullet::updatePosition 的位置
+//     直线运动两者只差 float 逐帧累积的舍入误差; 转弯时每帧的方向还有最多一个表项间隔的查表误差,
+//     位置偏差超过路程的 Kind::tolerance 倍即视为不一致
+//   - 开销: 10 万颗绕圈的子弹, 逐帧推进一帧, 以及向前跳 SeekFrames 帧, BulletManager 与 AnalyticBulletPool 对比
+// 最后检查 AnalyticBulletPool 拒绝向回推进
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr float ScreenWidth = 1280.0f;
+constexpr float ScreenHeight = 960.0f;
+constexpr std::size_t Samples = 1000;
+constexpr std::uint32_t Checkpoints[] = { 1, 60, 600, 3600 };
+constexpr std::size_t BulletCount = 100'000;
+constexpr int Frames = 200;
+constexpr std::uint32_t SeekFrames = 600;
+
+struct Kind
+{
+  char const* name;
+  float angVel;     // 角速度的上限, 实际取 [-angVel, angVel]
+  float tanAccel;   // 切向加速度的上限, 实际取 [-tanAccel, tanAccel]
+  double tolerance; // 位置偏差与路程之比的上限
+};
+
+// 坐标在 2048 以内时 float 每帧的舍入误差最多约 6e-5 像素, 最慢的子弹每帧只走 0.5 像素
+constexpr double RoundingTolerance = 5e-4;
+// 每帧的方向最多偏一个表项间隔 (弧度), 位移偏差不超过该帧路程的同样倍数
+constexpr double TableTolerance = 6.2831853 / Core::Math::DefaultTrigTable::SIZE + RoundingTolerance;
+
+constexpr Kind Kinds[] = {
+  { "straight", 0.0f, 0.0f, RoundingTolerance },
+  { "accelerating", 0.0f, 0.01f, RoundingTolerance },
+  { "arc", 0.05f, 0.0f, TableTolerance },
+  { "spiral", 0.05f, 0.01f, TableTolerance },
+};
+
+double elapsedMicros(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+float symmetric(Game::PatternRng& rng, float limit)
+{
+  return (rng.nextFloat() * 2.0f - 1.0f) * limit;
+}
+
+// 返回是否全部在容差内
+bool checkAccuracy(Kind const& kind)
+{
+  Game::PatternRng rng;
+  std::vector<Game::Bullet> bullets(Samples);
+  std::vector<Game::Trajectory> trajectories(Samples);
+  std::vector<double> paths(Samples, 0.0); // 逐帧累计的路程
+  for (std::size_t i = 0; i < Samples; ++i) {
+    Game::Bullet& b = bullets[i];
+    b.x = rng.nextFloat() * ScreenWidth;
+    b.y = rng.nextFloat() * ScreenHeight;
+    b.angle = rng.nextFloat() * 6.2831853f;
+    b.angVel = symmetric(rng, kind.angVel);
+    b.speed = 0.5f + rng.nextFloat() * 4.0f;
+    b.tanAccel = symmetric(rng, kind.tanAccel);
+    trajectories[i] = Game::Trajectory::fromBullet(b);
+  }
+
+  bool ok = true;
+  std::uint32_t frame = 0;
+  for (std::uint32_t const checkpoint : Checkpoints) {
+    for (; frame < checkpoint; ++frame) {
+      for (std::size_t i = 0; i < Samples; ++i) {
+        bullets[i].updatePosition();
+        paths[i] += std::fabs(bullets[i].speed);
+      }
+    }
+
+    double maxError = 0.0;
+    double maxRelative = 0.0;
+    for (std::size_t i = 0; i < Samples; ++i) {
+      Game::TrajectoryState const state = trajectories[i].evaluate(checkpoint);
+      double const error = std::hypot(state.x - bullets[i].x, state.y - bullets[i].y);
+      maxError = std::max(maxError, error);
+      maxRelative = std::max(maxRelative, error / std::max(paths[i], 1.0));
+    }
+    ok = ok && maxRelative <= kind.tolerance;
+    std::cout << std::format("{:<14}{:>7}{:>14.5f}{:>14.2e}  {}\n",
+                             kind.name,
+                             checkpoint,
+                             maxError,
+                             maxRelative,
+                             maxRelative <= kind.tolerance ? "OK" : "MISMATCH");
+  }
+  return ok;
+}
+
+// 与 BulletUpdateBench 相同的绕圈子弹, 不会出界, 两边的子弹数保持不变
+void spawnCircling(Game::BulletManager& manager, Game::AnalyticBulletPool& pool, Game::BulletBounds const& bounds)
+{
+  Game::PatternRng rng;
+  for (std::size_t i = 0; i < BulletCount; ++i) {
+    Game::Bullet const b{ .x = 200.0f + rng.nextFloat() * (ScreenWidth - 400.0f),
+                          .y = 200.0f + rng.nextFloat() * (ScreenHeight - 400.0f),
+                          .angle = rng.nextFloat() * 6.2831853f,
+                          .angVel = 0.02f + rng.nextFloat() * 0.03f,
+                          .speed = 1.0f + rng.nextFloat() * 2.0f };
+    manager.spawnBullet(b);
+    pool.spawn(b, 0, bounds);
+  }
+}
+
+void measureCost()
+{
+  constexpr float margin = Game::BulletManager::OFFSCREEN_MARGIN;
+  Game::BulletBounds const bounds{ -margin, ScreenWidth + margin, -margin, ScreenHeight + margin };
+  Game::BulletManager manager;
+  Game::AnalyticBulletPool pool;
+  manager.init(BulletCount);
+  pool.init(BulletCount);
+  spawnCircling(manager, pool, bounds);
+  std::vector<float> outX(BulletCount);
+  std::vector<float> outY(BulletCount);
+
+  auto start = Clock::now();
+  for (int f = 0; f < Frames; ++f) {
+    manager.update(ScreenWidth, ScreenHeight);
+  }
+  double const stepManager = elapsedMicros(start) / Frames;
+
+  start = Clock::now();
+  for (std::uint32_t f = 1; f <= Frames; ++f) {
+    pool.advanceTo(f, bounds);
+    pool.evaluatePositions(f, outX.data(), outY.data());
+  }
+  double const stepPool = elapsedMicros(start) / Frames;
+
+  start = Clock::now();
+  for (std::uint32_t f = 0; f < SeekFrames; ++f) {
+    manager.update(ScreenWidth, ScreenHeight);
+  }
+  double const seekManager = elapsedMicros(start);
+
+  std::uint32_t const target = Frames + SeekFrames;
+  start = Clock::now();
+  pool.advanceTo(target, bounds);
+  pool.evaluatePositions(target, outX.data(), outY.data());
+  double const seekPool = elapsedMicros(start);
+
+  std::cout << std::format("{} circling bullets, us (SIMD = {})\n", BulletCount, Core::Simd::IsaName);
+  std::cout << std::format("{:<24}{:>16}{:>20}\n", "", "BulletManager", "AnalyticBulletPool");
+  std::cout << std::format("{:<24}{:>16.1f}{:>20.1f}\n", "one frame", stepManager, stepPool);
+  std::string const seek = std::format("seek {} frames", SeekFrames);
+  std::cout << std::format("{:<24}{:>16.1f}{:>20.1f}\n", seek, seekManager, seekPool);
+  std::cout << std::format("bullets alive: {} / {}\n", manager.getActiveCount(), pool.getActiveCount());
+}
+
+// 已回收的子弹不再保存, 向回推进必须被拒绝
+bool checkBackwardSeek()
+{
+  Game::AnalyticBulletPool pool;
+  pool.init(1);
+  pool.advanceTo(100, { 0.0f, ScreenWidth, 0.0f, ScreenHeight });
+  try {
+    pool.advanceTo(50, { 0.0f, ScreenWidth, 0.0f, ScreenHeight });
+  } catch (std::runtime_error const&) {
+    return true;
+  }
+  return false;
+}
+} // namespace
+
+int main()
+{
+  std::cout << std::format("Trajectory::evaluate(n) vs n x Bullet::updatePosition, {} bullets per kind\n", Samples);
+  std::cout << std::format("{:<14}{:>7}{:>14}{:>14}\n", "motion", "frames", "max error px", "/ path");
+  bool ok = true;
+  for (Kind const& kind : Kinds) {
+    ok = checkAccuracy(kind) && ok;
+  }
+
+  measureCost();
+
+  bool const rejected = checkBackwardSeek();
+  std::cout << std::format("backward seek {}\n", rejected ? "rejected" : "NOT REJECTED");
+  return ok && rejected ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+#include "Core/MathUtils.hpp"
+#include "Core/Simd.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <vector>
+
+// 三角函数的精度 / 吞吐对比: 查表 (最近项 / 线性插值) 与极小极大多项式, 标量与批量版本
+// 输入规模对应一帧十万量级的子弹, 用于按调用处选择 TrigMethod
+
+namespace {
+constexpr std::size_t Count = 100'000; // 每轮的输入个数
+constexpr int Rounds = 200;            // 计时轮数, 取平均
+
+struct Result
+{
+  double maxAbsError; // 相对 std::sin / std::cos (双精度) 的最大绝对误差
+  double nsPerCall;   // 平均每个输入的耗时 (ns)
+};
+
+template <typename VFunc>
+Result measure(std::vector<float> const& radians, std::vector<float>& outSin, std::vector<float>& outCos, VFunc func)
+{
+  func(); // 预热, 同时让查找表进入缓存
+
+  double maxError = 0.0;
+  for (std::size_t i = 0; i < radians.size(); ++i) {
+    double const x = radians[i];
+    maxError = std::max(maxError, std::fabs(outSin[i] - std::sin(x)));
+    maxError = std::max(maxError, std::fabs(outCos[i] - std::cos(x)));
+  }
+
+  auto const start = std::chrono::steady_clock::now();
+  for (int r = 0; r < Rounds; ++r) {
+    func();
+  }
+  auto const elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  return { maxError, elapsed / (static_cast<double>(Rounds) * static_cast<double>(radians.size())) };
+}
+
+template <typename VScalar>
+auto scalarLoop(std::vector<float> const& radians, std::vector<float>& outSin, std::vector<float>& outCos, VScalar f)
+{
+  return [&radians, &outSin, &outCos, f]() {
+    for (std::size_t i = 0; i < radians.size(); ++i) {
+      f(radians[i], outSin[i], outCos[i]);
+    }
+  };
+}
+} // namespace
+
+int main()
+{
+  using namespace Core::Math;
+
+  // 子弹角度通常落在 [-4pi, 4pi], 用固定种子的线性同余生成器得到可复现的输入
+  std::vector<float> radians(Count);
+  std::uint32_t state = 12345u;
+  for (float& x : radians) {
+    state = state * 1664525u + 1013904223u;
+    x = (static_cast<float>(state >> 8) / 16777216.0f - 0.5f) * 8.0f * std::numbers::pi_v<float>;
+  }
+  std::vector<float> outSin(Count);
+  std::vector<float> outCos(Count);
+
+  struct Case
+  {
+    char const* name;
+    Result result;
+  };
+
+  Case const cases[] = {
+    { "table nearest (scalar)",
+      measure(radians, outSin, outCos, scalarLoop(radians, outSin, outCos, [](float x, float& s, float& c) {
+                s = sin(x);
+                c = cos(x);
+              })) },
+    { "table lerp (scalar)",
+      measure(radians, outSin, outCos, scalarLoop(radians, outSin, outCos, [](float x, float& s, float& c) {
+                s = sinLerp(x);
+                c = cosLerp(x);
+              })) },
+    { "table 4096 lerp (scalar)",
+      measure(radians, outSin, outCos, scalarLoop(radians, outSin, outCos, [](float x, float& s, float& c) {
+                s = TrigTable<4096, TrigInterp::Linear>::sin(x);
+                c = TrigTable<4096, TrigInterp::Linear>::cos(x);
+              })) },
+    { "polynomial (scalar)",
+      measure(radians,
+              outSin,
+              outCos,
+              scalarLoop(radians, outSin, outCos, [](float x, float& s, float& c) { sincosPoly(x, s, c); })) },
+    { "table nearest (batch)",
+      measure(radians,
+              outSin,
+              outCos,
+              [&]() { sincosBatch(radians.data(), outSin.data(), outCos.data(), Count, TrigMethod::Table); }) },
+    { "polynomial (batch)",
+      measure(radians,
+              outSin,
+              outCos,
+              [&]() { sincosBatch(radians.data(), outSin.data(), outCos.data(), Count, TrigMethod::Polynomial); }) },
+  };
+
+  std::cout << std::format("sincos benchmark: {} inputs x {} rounds, SIMD = {}\n", Count, Rounds, Core::Simd::IsaName);
+  std::cout << std::format("{:<28}{:>16}{:>14}\n", "method", "max abs error", "ns / call");
+  for (Case const& c : cases) {
+    std::cout << std::format("{:<28}{:>16.3e}{:>14.3f}\n", c.name, c.result.maxAbsError, c.result.nsPerCall);
+  }
+
+  return 0;
+}
@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#if defined(_WIN32)
 // DirectX 11
 #include <DirectXMath.h>
 #include <d3d11.h>
@@ -35,3 +36,4 @@
 #include <windows.h>
 
 #include <wrl/client.h>
+#endif